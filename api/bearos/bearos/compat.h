@@ -6,8 +6,18 @@
 #pragma once
 
 #include <stdio.h>
+#include <stdint.h>
 #include <sys/types.h>
 
+#ifdef BEAROS_HOST
+// The host C library has a syscall() function of its own. Include this
+//   file after the host's unistd.h
+#define syscall bearos_syscall
+// The host C library has its own errno, and the library must set it.
+//   Include this file after errno.h
+#define errno__ errno
+#endif
+
 #define DT_REG 0
 #define DT_BLK 1
 #define DT_CHR 2
@@ -34,7 +44,8 @@ extern "C" {
 
 extern ssize_t getline (char **lineptr, size_t *n, FILE *stream);
 extern int read_timeout(int fd, int msec);
-extern int32_t syscall (int32_t num, int32_t arg1, int32_t arg2, int32_t arg3);
+extern intptr_t syscall (intptr_t num, intptr_t arg1, intptr_t arg2, 
+          intptr_t arg3);
 
 DIR *opendir (const char *path);
 int closedir (DIR *self);
@@ -29,6 +29,20 @@
 //   areas of the screen that are empty.
 #define DC_GFX_SET_USED_AREA 46 
 
+// Takes a DevCtlGfxStats object, and fills it in with the number of 
+//   operations and pixels the device has handled. Only the host 
+//   framebuffer device supports this at present.
+#define DC_GFX_GET_STATS 47
+
+// Takes a filename (in the host's filesystem), and writes the screen,
+//   as it would be seen, as a PPM image. Only the host framebuffer 
+//   device supports this.
+#define DC_GFX_SNAPSHOT 48
+
+// Takes a DevCtlGfxDrawList, and carries out all the drawing commands in
+//   it, clipped to the screen and to the list's clipping rectangle.
+#define DC_GFX_DRAW 49
+
 // General flags, could apply to all devices 
 #define DC_FLAG_ISTTY  0x0001
 #define DC_FLAG_ISGFX  0x0002
@@ -93,6 +107,62 @@ typedef struct _DevCtlGfxWrite
   int length; // In bytes, not pixels
   } DevCtlGfxWrite;
 
+// DevCtlGfxStats is used with DC_GFX_GET_STATS. Pixel counts include 
+//   pixels that fell outside the screen, and were discarded. last_pixels
+//   is the number of pixels written by the most recent fill or write.
+typedef struct _DevCtlGfxStats
+  {
+  uint32_t regions;
+  uint32_t fills;
+  uint32_t writes;
+  uint32_t scrolls;
+  uint32_t clears;
+  uint64_t fill_pixels;
+  uint64_t write_pixels;
+  uint32_t last_pixels;
+  } DevCtlGfxStats;
+
+// Drawing operations for DC_GFX_DRAW. Colours are RGB565.
+typedef enum _DevCtlGfxDrawOp
+  {
+  DC_GFX_OP_HLINE = 1,  // x, y, w, colour
+  DC_GFX_OP_VLINE,      // x, y, h, colour
+  DC_GFX_OP_RECT,       // x, y, w, h, colour -- outline only
+  DC_GFX_OP_FILL_RECT,  // x, y, w, h, colour
+  DC_GFX_OP_LINE,       // From x, y to x2, y2 inclusive, colour
+  DC_GFX_OP_BLIT,       // w x h pixels to x, y; key, if flags has
+                        //   DC_GFX_DRAW_KEY
+  DC_GFX_OP_COPY_RECT   // w x h pixels from x2, y2 to x, y
+  } DevCtlGfxDrawOp;
+
+// In a blit, pixels that are the same as the key colour are not drawn
+#define DC_GFX_DRAW_KEY 0x0001
+
+// One drawing command. Only the fields the operation needs are used. 
+typedef struct _DevCtlGfxDrawCmd
+  {
+  int op; // One of the DevCtlGfxDrawOp values
+  int x;
+  int y;
+  int x2;
+  int y2;
+  int w;
+  int h;
+  uint16_t colour;
+  uint16_t key;
+  int flags;
+  const uint16_t *pixels; // For DC_GFX_OP_BLIT, w * h pixels, row by row
+  } DevCtlGfxDrawCmd;
+
+// Used with DC_GFX_DRAW. If clip.cx or clip.cy is zero, drawing is clipped 
+//   only to the screen.
+typedef struct _DevCtlGfxDrawList
+  {
+  const DevCtlGfxDrawCmd *cmds;
+  int count;
+  DevCtlGfxRegion clip;
+  } DevCtlGfxDrawList;
+
 #ifdef __cplusplus
 extern "C" {
 #endif
@@ -5,6 +5,8 @@
  * ==========================================================================*/
 #pragma once
 
+#include <stdint.h>
+
 // Address in RAM at which programs will be loaded
 //#define BEAROS_LOAD_ADDRESS 0x20004000
 //#define BEAROS_LOAD_ADDRESS 0x20005000
@@ -17,6 +19,24 @@
 //#define BEAROS_SYSCALL_VECTOR 0x20004F00
 #define BEAROS_SYSCALL_VECTOR 0x20005700
 
+// Magic number at the start of a packed executable ("BRZ1")
+#define BEAROS_PACKED_MAGIC 0x315A5242
+
+/** A packed executable is this header, followed by an LZ4 block that
+    decompresses to the program image. The image is everything from the
+    lowest to the highest loadable address that is stored in the ELF file,
+    with any gaps filled with zeros. All fields are little-endian. */
+typedef struct _BearosPackedHeader
+  {
+  uint32_t magic;       // BEAROS_PACKED_MAGIC
+  uint32_t entry;       // Entry point
+  uint32_t load;        // Address of the first byte of the image
+  uint32_t size;        // Size of the image when unpacked
+  uint32_t memsz;       // Memory used from the load address, including BSS
+  uint32_t packed_size; // Size of the LZ4 block that follows the header
+  uint32_t reserved[2];
+  } BearosPackedHeader;
+
 #ifdef __cplusplus
 extern "C" {
 #endif
@@ -34,7 +34,10 @@ typedef struct _DirEntry
   } DirEntry;
 
 
+#ifndef BEAROS_HOST
+// Defined in lib.c. On the host, compat.h makes this the host's errno
 extern int errno__;
+#endif
 
 /*===========================================================================
   getdelim
@@ -141,8 +144,8 @@ int closedir (DIR *self)
 struct dirent *readdir (DIR *self)
   {
   DirEntry de;
-  int r = syscall (BEAROS_SYSCALL_GETDENT, (int32_t)self->fd, 
-      (int32_t)&de, 0); 
+  int r = syscall (BEAROS_SYSCALL_GETDENT, (intptr_t)self->fd, 
+      (intptr_t)&de, 0); 
 
   if (r == 1) 
     {
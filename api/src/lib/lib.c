@@ -8,6 +8,11 @@
     are, for the most part, implemented as syscalls into the BearOS 
     kernel.
 
+  When BEAROS_HOST is defined, the library is built for a program that
+    the host build of BearOS runs as a shared object. Such a program
+    uses the host C library, so this file also provides the POSIX
+    functions that must go to BearOS rather than to the host.
+
   Copyright (c)2022 Kevin Boone, GPL v3.0 
 
 ===========================================================================*/
@@ -25,11 +30,19 @@
 #include <bearos/exec.h>	
 #include <bearos/devctl.h>	
 #include <bearos/syscalls.h>	
+#include <bearos/compat.h>	
 
-typedef int (*FnSyscall)(int32_t x, int32_t p1, int32_t p2, int32_t p3);
-int32_t *syscall_pointer = (int32_t *)BEAROS_SYSCALL_VECTOR;
+typedef intptr_t (*FnSyscall)(intptr_t x, intptr_t p1, intptr_t p2, 
+           intptr_t p3);
 
+#ifdef BEAROS_HOST
+// The loader stores the address of the syscall function here
+intptr_t bearos_syscall_vector;
+intptr_t *syscall_pointer = &bearos_syscall_vector;
+#else
+intptr_t *syscall_pointer = (intptr_t *)BEAROS_SYSCALL_VECTOR;
 int errno__;
+#endif
 
 int _open (const char *pathname, int flags);
 
@@ -47,11 +60,15 @@ int *__errno (void)
 /*===========================================================================
   syscall 
 ===========================================================================*/
-int32_t syscall (int32_t num, int32_t arg1, int32_t arg2, int32_t arg3) 
+intptr_t syscall (intptr_t num, intptr_t arg1, intptr_t arg2, intptr_t arg3) 
   {
-  int32_t syscall_addr = *(syscall_pointer) | 1;
+#ifdef BEAROS_HOST
+  intptr_t syscall_addr = *(syscall_pointer);
+#else
+  intptr_t syscall_addr = *(syscall_pointer) | 1;
+#endif
   FnSyscall syscall_entry = (FnSyscall)syscall_addr;
-  int32_t ret = syscall_entry (num, arg1, arg2, arg3);
+  intptr_t ret = syscall_entry (num, arg1, arg2, arg3);
   return ret;
   }
 
@@ -60,7 +77,7 @@ int32_t syscall (int32_t num, int32_t arg1, int32_t arg2, int32_t arg3)
 ===========================================================================*/
 //int atoi (const char *s)
 //  {
-//  return (int)syscall (BEAROS_SYSCALL_ATOI, (int32_t)s, 0, 0); 
+//  return (int)syscall (BEAROS_SYSCALL_ATOI, (intptr_t)s, 0, 0); 
 //  }
 
 /*===========================================================================
@@ -79,7 +96,7 @@ char *basename (char *path)
 ===========================================================================*/
 int chdir (const char *path)
   {
-  int err = syscall (BEAROS_SYSCALL_CHDIR, (int32_t)path, 0, 0); 
+  int err = syscall (BEAROS_SYSCALL_CHDIR, (intptr_t)path, 0, 0); 
   errno__ = err;
   return (errno__ ? -1 : 0);
   }
@@ -89,7 +106,7 @@ int chdir (const char *path)
 ===========================================================================*/
 int _close (int fd)
   {
-  int err = syscall (BEAROS_SYSCALL_CLOSE, (int32_t)fd, 0, 0); 
+  int err = syscall (BEAROS_SYSCALL_CLOSE, (intptr_t)fd, 0, 0); 
   errno__ = err;
   return (errno__ ? -1 : 0);
   }
@@ -99,8 +116,8 @@ int _close (int fd)
 ===========================================================================*/
 int devctl (int fd, intptr_t arg1, intptr_t arg2)
   {
-  int err = syscall (BEAROS_SYSCALL_DEVCTL, (int32_t)fd, (int32_t)arg1,
-              (int32_t) arg2); 
+  int err = syscall (BEAROS_SYSCALL_DEVCTL, (intptr_t)fd, (intptr_t)arg1,
+              (intptr_t)arg2); 
   errno__ = err;
   return (errno__ ? -1 : 0);
   }
@@ -111,7 +128,7 @@ int devctl (int fd, intptr_t arg1, intptr_t arg2)
 int isatty (int fd)
   {
   int32_t flags = 0;
-  if (devctl (fd, DC_GET_GEN_FLAGS, (int32_t)&flags) == 0)
+  if (devctl (fd, DC_GET_GEN_FLAGS, (intptr_t)&flags) == 0)
     {
     if (flags & DC_FLAG_ISTTY) 
       return 1;
@@ -128,7 +145,7 @@ int isatty (int fd)
 __attribute__ ((noreturn)) void _exit (int status)  
   {
   syscall (BEAROS_SYSCALL_EXIT, 
-    (int32_t)status, 0, 0); 
+    (intptr_t)status, 0, 0); 
   while(1); // Never get here
   }
 
@@ -138,7 +155,7 @@ __attribute__ ((noreturn)) void _exit (int status)
 int _fstat (int fd, struct stat *sb)
   {
   int err = syscall (BEAROS_SYSCALL_FSTAT, 
-    (int32_t)fd, (int32_t)sb, 0); 
+    (intptr_t)fd, (intptr_t)sb, 0); 
   errno__ = err;
   return (errno__ ? -1 : 0);
   }
@@ -149,7 +166,7 @@ int _fstat (int fd, struct stat *sb)
 int ftruncate (int fd, off_t len)
   {
   int err = syscall (BEAROS_SYSCALL_FTRUNCATE, 
-    (int32_t)fd, (int32_t)len, 0); 
+    (intptr_t)fd, (intptr_t)len, 0); 
   errno__ = err;
   return (errno__ ? -1 : 0);
   }
@@ -196,7 +213,7 @@ int _kill (pid_t pid, int sig)
 int _gettimeofday (struct timeval *tv, struct timezone *tz)
   {
   syscall (BEAROS_SYSCALL_GETTIMEOFDAY, 
-     (int32_t)tv, (int32_t)tz, 0); 
+     (intptr_t)tv, (intptr_t)tz, 0); 
   return 0;
   }
 
@@ -215,7 +232,7 @@ int _isatty (int fd)
 ===========================================================================*/
 //char *itoa (int num, char *s, int base)
 //  {
-//  return (char *)syscall (BEAROS_SYSCALL_ITOA, num, (int32_t)s, base); 
+//  return (char *)syscall (BEAROS_SYSCALL_ITOA, num, (intptr_t)s, base); 
 //  }
 
 /*===========================================================================
@@ -236,7 +253,7 @@ int _link (const char *oldpath, const char *newpath)
 ===========================================================================*/
 int _open (const char *pathname, int flags)
   {
-  int fd = syscall (BEAROS_SYSCALL_OPEN, (int32_t)pathname, (int32_t)flags, 0); 
+  int fd = syscall (BEAROS_SYSCALL_OPEN, (intptr_t)pathname, (intptr_t)flags, 0); 
   if (fd < 0) errno__ = -fd; else errno__ = 0;
   int ret = (errno__ > 0 ? -1 : fd);
   return ret;
@@ -248,7 +265,7 @@ int _open (const char *pathname, int flags)
 off_t _lseek (int fd, off_t offset, int origin)
   {
   int pos = (int)syscall (BEAROS_SYSCALL_LSEEK, 
-    (int32_t)fd, (int32_t)offset, (int32_t) origin); 
+    (intptr_t)fd, (intptr_t)offset, (intptr_t)origin); 
   if (pos < 0) errno__ = -pos; else errno__ = 0;
   return (off_t)(pos < 0 ? -1 : pos);
   }
@@ -298,7 +315,7 @@ int _puts (const char *s)
 ===========================================================================*/
 int _read(int fd, void *buffer, size_t len)
   {
-  int count = syscall (BEAROS_SYSCALL_READ, fd, (int32_t)buffer, len); 
+  int count = syscall (BEAROS_SYSCALL_READ, fd, (intptr_t)buffer, len); 
   if (count < 0) errno__ = -count; else errno__ = 0;
   return (errno__ ? -1 : count);
   }
@@ -316,7 +333,7 @@ int read_timeout(int fd, int msec)
 ===========================================================================*/
 int _write (int fd, const void *buffer, size_t len)
   {
-  int count = syscall (BEAROS_SYSCALL_WRITE, fd, (int32_t)buffer, len); 
+  int count = syscall (BEAROS_SYSCALL_WRITE, fd, (intptr_t)buffer, len); 
   if (count < 0) errno__ = -count; else errno__ = 0;
   return (errno__ ? -1 : count);
   }
@@ -346,7 +363,7 @@ clock_t _times (struct tms *buff)
 ===========================================================================*/
 int _unlink (char *filename)
   {
-  int ret = syscall (BEAROS_SYSCALL_UNLINK, (int32_t)filename, 0, 0); 
+  int ret = syscall (BEAROS_SYSCALL_UNLINK, (intptr_t)filename, 0, 0); 
   errno__ = ret; 
   return errno__ ? -1 : 0;
   }
@@ -362,3 +379,64 @@ int usleep (useconds_t usec)
 
 
 
+
+#ifdef BEAROS_HOST
+/*===========================================================================
+  Host wrappers. In a program built for the host, the host C library
+    does not call the underscore functions above, so the program's own
+    calls to the POSIX functions are directed to them here. The program
+    must be linked with -Bsymbolic, so these take precedence over the
+    host's functions of the same name. Note that output from stdio goes
+    straight to the host's stdout.
+===========================================================================*/
+int open (const char *pathname, int flags, ...)
+  {
+  return _open (pathname, flags);
+  }
+
+int close (int fd)
+  {
+  return _close (fd);
+  }
+
+ssize_t read (int fd, void *buffer, size_t len)
+  {
+  return _read (fd, buffer, len);
+  }
+
+ssize_t write (int fd, const void *buffer, size_t len)
+  {
+  return _write (fd, buffer, len);
+  }
+
+off_t lseek (int fd, off_t offset, int origin)
+  {
+  return _lseek (fd, offset, origin);
+  }
+
+int fstat (int fd, struct stat *sb)
+  {
+  return _fstat (fd, sb);
+  }
+
+int stat (const char *filename, struct stat *sb)
+  {
+  return _stat (filename, sb);
+  }
+
+int unlink (const char *filename)
+  {
+  return _unlink ((char *)filename);
+  }
+
+void *sbrk (intptr_t increment)
+  {
+  return _sbrk (increment);
+  }
+
+__attribute__ ((noreturn)) void exit (int status)  
+  {
+  fflush (NULL);
+  _exit (status);
+  }
+#endif
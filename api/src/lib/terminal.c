@@ -43,7 +43,7 @@ int terminal_init (int fd_in, int fd_out)
   {
   (void)fd_out;
   // TODO -- what if term is not a TTY?
-  devctl (fd_in, DC_TERM_GET_FLAGS, (int32_t)&oldflags);
+  devctl (fd_in, DC_TERM_GET_FLAGS, (intptr_t)&oldflags);
   // TODO -- not a tty
   return 0;
   }
@@ -64,7 +64,7 @@ void terminal_set_raw (int fd_in)
 void terminal_reset (int fd_in, int fd_out)
   {
   (void)fd_out;
-  devctl (fd_in, DC_TERM_SET_FLAGS, (int32_t)oldflags);
+  devctl (fd_in, DC_TERM_SET_FLAGS, (intptr_t)oldflags);
   }
 
 
@@ -75,7 +75,7 @@ void terminal_reset (int fd_in, int fd_out)
 =========================================================================*/
 int terminal_get_props (int fd_in, DevCtlTermProps *props)
   {
-  return devctl (fd_in, DC_TERM_GET_PROPS, (int32_t)props);
+  return devctl (fd_in, DC_TERM_GET_PROPS, (intptr_t)props);
   }
 
 /*=========================================================================
@@ -85,8 +85,8 @@ int terminal_get_props (int fd_in, DevCtlTermProps *props)
 =========================================================================*/
 int terminal_get_line (int fd_in, char *buff, int len)
   {
-  return syscall (BEAROS_SYSCALL_GET_LINE, (int32_t)fd_in, 
-           (int32_t)buff, (int32_t)len);
+  return syscall (BEAROS_SYSCALL_GET_LINE, (intptr_t)fd_in, 
+           (intptr_t)buff, (intptr_t)len);
   }
 
 
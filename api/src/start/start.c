@@ -5,10 +5,25 @@
  *   are appropriately defined as the start and ends of the BSS section,
  *   which is the job of the linker script.
  *
+ * When BEAROS_HOST is defined, the program is a shared object for the
+ *   host build of BearOS. The host's dynamic loader has already zeroed
+ *   BSS, and the host C library initializes its own memory allocator.
+ *
  * Copyright (c)2022 Kevin Boone
 ============================================================================*/
 
 extern int main (int argc, char **argv);
+
+#ifdef BEAROS_HOST
+extern char **environ;
+
+unsigned int start (int argc, char **argv, char **envp)
+  {
+  // The host environment is restored by BearOS when the program ends
+  environ = envp;
+  return (unsigned int)main (argc, argv);
+  }
+#else
 void *_sbrk (int increment);
 char **environ;
 extern int __bss_start__, __bss_end__;
@@ -39,4 +54,4 @@ unsigned int start (int argc, char **argv, char **envp)
   // Just call main.
   return main (argc, argv);
   }
-
+#endif
@@ -0,0 +1,46 @@
+/*============================================================================
+ *  chardev/fbgfxdev.h
+ *
+ * A graphics device for the host build, that draws into an RGB565
+ * framebuffer in memory. It behaves like the LCD panel, including its
+ * vertical scrolling, so that everything above the panel driver can be
+ * run, checked, and measured without the hardware.
+ *
+ * Copyright (c)2023 Kevin Boone, GPL v3.0
+ * ==========================================================================*/
+
+#pragma once
+
+/*============================================================================
+ * ==========================================================================*/
+
+#include <stdint.h>
+#include <sys/error.h>
+#include <devmgr/devmgr.h>
+#include <bearos/devctl.h>
+
+struct _FbGfxDev;
+typedef struct _FbGfxDev FbGfxDev;
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/** Create a framebuffer of width x height pixels. */
+extern FbGfxDev *fbgfxdev_new (const char *name, int width, int height);
+extern void fbgfxdev_destroy (FbGfxDev *self);
+extern DevDescriptor *fbgfxdev_get_desc (FbGfxDev *self);
+
+/** Write the screen, as it would appear on the panel, as a binary PPM
+    file. */
+extern Error fbgfxdev_dump_ppm (const FbGfxDev *self, const char *filename);
+
+extern void fbgfxdev_get_stats (const FbGfxDev *self, DevCtlGfxStats *stats);
+
+/** Returns the pixel at (x,y) on the screen, after scrolling. */
+extern uint16_t fbgfxdev_get_pixel (const FbGfxDev *self, int x, int y);
+
+#ifdef __cplusplus
+}
+#endif
+
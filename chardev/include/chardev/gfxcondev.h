@@ -44,6 +44,11 @@ extern void gfxcondev_cursor_back (GfxConDev *self, int rows);
 extern void gfxcondev_cursor_forward (GfxConDev *self, int rows);
 extern void gfxcondev_set_cursor (GfxConDev *self, int row, int col);
 
+/** Save and restore the cursor position and attributes, as esc-7 and 
+    esc-8 do. */
+extern void gfxcondev_save_cursor (GfxConDev *self);
+extern void gfxcondev_restore_cursor (GfxConDev *self);
+
 #ifdef __cplusplus
 }
 #endif
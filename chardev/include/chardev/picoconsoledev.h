@@ -24,6 +24,19 @@ extern PicoConsoleDev *picoconsoledev_new (const char *name);
 extern void picoconsoledev_destroy (PicoConsoleDev *self);
 extern DevDescriptor *picoconsoledev_get_desc (PicoConsoleDev *self); 
 
+/** Pass any buffered console output to the stdio driver. Output is
+    normally flushed automatically, at the end of each line, before 
+    waiting for input, when the console is polled for an interrupt, and
+    at the first write or system call after a short delay. Anything
+    that writes to stdio directly, rather than through the console 
+    device, should call this first, so that output stays in order. */
+extern void picoconsoledev_flush (void);
+
+/** Flush buffered console output if it has waited for longer than the
+    console's delay. This is cheap enough to call on every system call,
+    and must be called from thread context. */
+extern void picoconsoledev_poll (void);
+
 #ifdef __cplusplus
 }
 #endif
@@ -29,6 +29,11 @@ extern WSLCDDev *wslcddev_new (const char *name);
 extern void wslcddev_destroy (WSLCDDev *self);
 extern DevDescriptor *wslcddev_get_desc (WSLCDDev *self); 
 
+/** Wait for any drawing operation that is still running to finish. This
+    takes a void pointer so that it can be used as the bus fence of 
+    another device on the same SPI bus. */
+extern void wslcddev_bus_fence (void *self);
+
 #if PICO_ON_DEVICE
 extern void wslcddev_init (WSLCDDev *self, spi_inst_t *spi, uint gpio_cs, 
     uint gpio_miso, uint gpio_mosi, uint gpio_sck, uint gpio_rst, uint gpio_dc, 
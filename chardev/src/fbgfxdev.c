@@ -0,0 +1,301 @@
+/*============================================================================
+ *  chardev/fbgfxdev.c
+ *
+ * Copyright (c)2023 Kevin Boone, GPL v3.0
+ * ==========================================================================*/
+
+#if PICO_ON_DEVICE
+#else
+
+/*============================================================================
+ * ==========================================================================*/
+
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include <pico/stdlib.h>
+#include <stdio.h>
+#include <bearos/devctl.h>
+#include <sys/error.h>
+#include <errno.h>
+#include <chardev/fbgfxdev.h>
+#include <gfx/gfxdraw.h>
+
+struct _FbGfxDev
+  {
+  DevDescriptor *desc;
+  int width;
+  int height;
+  // Pixels, in the order they are stored in the panel's memory. That
+  //   is, before scrolling is applied.
+  uint16_t *fb;
+  // As on the panel, only the top used_height rows scroll. The rest are
+  //   fixed.
+  int used_width;
+  int used_height;
+  int scroll_pos;
+  // The region set by DC_GFX_SET_REGION, and the position in it that
+  //   the next pixel will be written to
+  DevCtlGfxRegion region;
+  int next;
+  DevCtlGfxStats stats;
+  };
+
+/*============================================================================
+ * fbgfxdev_map_row
+ * Returns the row of panel memory that appears as screen row y.
+* ==========================================================================*/
+static int fbgfxdev_map_row (const FbGfxDev *self, int y)
+  {
+  if (y < self->used_height)
+    return (y + self->scroll_pos) % self->used_height;
+  return y;
+  }
+
+/*============================================================================
+ * fbgfxdev_put
+ * Write n pixels to the current region, starting at the current position.
+ *   If src is NULL, all the pixels are 'colour'. Pixels that fall
+ *   outside the screen are discarded, but still counted.
+* ==========================================================================*/
+static void fbgfxdev_put (FbGfxDev *self, const uint16_t *src,
+               uint16_t colour, int n)
+  {
+  const DevCtlGfxRegion *r = &self->region;
+  int area = r->cx * r->cy;
+  for (int i = 0; i < n && self->next < area; i++, self->next++)
+    {
+    int x = r->x + self->next % r->cx;
+    int y = r->y + self->next / r->cx;
+    if (x < 0 || x >= self->width || y < 0 || y >= self->height) continue;
+    self->fb[fbgfxdev_map_row (self, y) * self->width + x] =
+      src ? src[i] : colour;
+    }
+  self->stats.last_pixels = (uint32_t)n;
+  }
+
+/*============================================================================
+ * fbgfxdev_get_pixel
+* ==========================================================================*/
+uint16_t fbgfxdev_get_pixel (const FbGfxDev *self, int x, int y)
+  {
+  if (x < 0 || x >= self->width || y < 0 || y >= self->height) return 0;
+  return self->fb[fbgfxdev_map_row (self, y) * self->width + x];
+  }
+
+/*============================================================================
+ * fbgfxdev_read_pixels
+ * Read-back for copy-rect
+* ==========================================================================*/
+static void fbgfxdev_read_pixels (void *ctx, int x, int y, int n, 
+              uint16_t *out)
+  {
+  const FbGfxDev *self = ctx;
+  for (int i = 0; i < n; i++)
+    out[i] = fbgfxdev_get_pixel (self, x + i, y);
+  }
+
+/*============================================================================
+ * fbgfxdev_dump_ppm
+* ==========================================================================*/
+Error fbgfxdev_dump_ppm (const FbGfxDev *self, const char *filename)
+  {
+  FILE *f = fopen (filename, "wb");
+  if (!f) return errno;
+  fprintf (f, "P6\n%d %d\n255\n", self->width, self->height);
+  uint8_t *line = malloc ((size_t)self->width * 3);
+  for (int y = 0; y < self->height; y++)
+    {
+    for (int x = 0; x < self->width; x++)
+      {
+      uint16_t p = fbgfxdev_get_pixel (self, x, y);
+      uint8_t r = (uint8_t)((p >> 11) & 0x1F);
+      uint8_t g = (uint8_t)((p >> 5) & 0x3F);
+      uint8_t b = (uint8_t)(p & 0x1F);
+      line[x * 3] = (uint8_t)((r << 3) | (r >> 2));
+      line[x * 3 + 1] = (uint8_t)((g << 2) | (g >> 4));
+      line[x * 3 + 2] = (uint8_t)((b << 3) | (b >> 2));
+      }
+    fwrite (line, 3, (size_t)self->width, f);
+    }
+  free (line);
+  Error ret = ferror (f) ? EIO : 0;
+  if (fclose (f) != 0) ret = EIO;
+  return ret;
+  }
+
+/*============================================================================
+ * fbgfxdev_get_stats
+* ==========================================================================*/
+void fbgfxdev_get_stats (const FbGfxDev *self, DevCtlGfxStats *stats)
+  {
+  *stats = self->stats;
+  }
+
+/*============================================================================
+ * fbgfxdev_read
+* ==========================================================================*/
+static int fbgfxdev_read (FileDesc *f, void *buffer, int len)
+  {
+  (void)f; (void)buffer; (void)len;
+  return 0;
+  }
+
+/*============================================================================
+ * fbgfxdev_write
+* ==========================================================================*/
+static int fbgfxdev_write (FileDesc *f, const void *buffer, int len)
+  {
+  FbGfxDev *self = f->self;
+  fbgfxdev_put (self, buffer, 0, len / 2);
+  self->stats.writes++;
+  self->stats.write_pixels += (uint32_t)(len / 2);
+  return len;
+  }
+
+/*============================================================================
+ * fbgfxdev_close
+* ==========================================================================*/
+static Error fbgfxdev_close (FileDesc *f)
+  {
+  free (f);
+  return 0;
+  }
+
+/*============================================================================
+ * fbgfxdev_devctl
+* ==========================================================================*/
+static Error fbgfxdev_devctl (FileDesc *f, intptr_t arg1, intptr_t arg2)
+  {
+  FbGfxDev *self = f->self;
+  switch (arg1)
+    {
+    case DC_GFX_RESET_AND_CLEAR:
+      self->scroll_pos = 0;
+      memset (self->fb, 0,
+        (size_t)(self->width * self->height) * sizeof (uint16_t));
+      self->stats.clears++;
+      return 0;
+
+    case DC_GFX_GET_PROPS:
+      DevCtlGfxProps *props = (DevCtlGfxProps*)arg2;
+      props->width = self->width;
+      props->height = self->height;
+      props->colmode = DC_GFX_COLMODE_RGB565;
+      return 0;
+
+    case DC_GFX_SET_USED_AREA:
+      props = (DevCtlGfxProps*)arg2;
+      if (props->width <= 0 || props->width > self->width
+           || props->height <= 0 || props->height > self->height)
+        return EINVAL;
+      self->used_width = props->width;
+      self->used_height = props->height;
+      self->scroll_pos %= self->used_height;
+      return 0;
+
+    case DC_GFX_SET_REGION:
+      self->region = *(DevCtlGfxRegion *)arg2;
+      self->next = 0;
+      self->stats.regions++;
+      return 0;
+
+    case DC_GFX_FILL:
+      {
+      const DevCtlGfxColour *colour = (DevCtlGfxColour *)arg2;
+      int n = self->region.cx * self->region.cy;
+      fbgfxdev_put (self, NULL, colour->rgb565, n);
+      self->stats.fills++;
+      self->stats.fill_pixels += (uint32_t)n;
+      }
+      return 0;
+
+    case DC_GFX_SCROLL_UP:
+      self->scroll_pos = (self->scroll_pos + (int)arg2) % self->used_height;
+      self->stats.scrolls++;
+      return 0;
+
+    case DC_GFX_WRITE:
+      {
+      DevCtlGfxWrite *wr = (DevCtlGfxWrite *)arg2;
+      fbgfxdev_write (f, wr->buffer, wr->length);
+      }
+      return 0;
+
+    case DC_GFX_DRAW:
+      return gfxdraw_run (f, self->width, self->height, 
+        (DevCtlGfxDrawList *)arg2, fbgfxdev_read_pixels, self);
+
+    case DC_GFX_GET_STATS:
+      fbgfxdev_get_stats (self, (DevCtlGfxStats *)arg2);
+      return 0;
+
+    case DC_GFX_SNAPSHOT:
+      return fbgfxdev_dump_ppm (self, (const char *)arg2);
+
+    case DC_GET_GEN_FLAGS:
+      *((int32_t *)arg2) = DC_FLAG_ISGFX;
+      return 0;
+    }
+  return EINVAL;
+  }
+
+/*============================================================================
+ * fbgfxdev_get_file_desc
+* ==========================================================================*/
+static FileDesc *fbgfxdev_get_file_desc (DevDescriptor *dev_desc)
+  {
+  FbGfxDev *self = dev_desc->self;
+  FileDesc *f = malloc (sizeof (FileDesc));
+  memset (f, 0, sizeof (FileDesc));
+  f->self = self;
+  f->close = fbgfxdev_close;
+  f->write = fbgfxdev_write;
+  f->read = fbgfxdev_read;
+  f->read_timeout = NULL;
+  f->devctl = fbgfxdev_devctl;
+  return f;
+  }
+
+/*============================================================================
+ * fbgfxdev_new
+* ==========================================================================*/
+FbGfxDev *fbgfxdev_new (const char *name, int width, int height)
+  {
+  FbGfxDev *self = malloc (sizeof (FbGfxDev));
+  memset (self, 0, sizeof (FbGfxDev));
+  DevDescriptor *desc = malloc (sizeof (DevDescriptor));
+  memset (desc, 0, sizeof (DevDescriptor));
+  self->desc = desc;
+  desc->name = name;
+  desc->get_file_desc = fbgfxdev_get_file_desc;
+  desc->self = self;
+  self->width = width;
+  self->height = height;
+  self->used_width = width;
+  self->used_height = height;
+  self->fb = malloc ((size_t)(width * height) * sizeof (uint16_t));
+  memset (self->fb, 0, (size_t)(width * height) * sizeof (uint16_t));
+  return self;
+  }
+
+/*============================================================================
+ * fbgfxdev_destroy
+ * ==========================================================================*/
+void fbgfxdev_destroy (FbGfxDev *self)
+  {
+  free (self->fb);
+  free (self->desc);
+  free (self);
+  }
+
+/*============================================================================
+ * fbgfxdev_get_desc
+ * ==========================================================================*/
+DevDescriptor *fbgfxdev_get_desc (FbGfxDev *self)
+  {
+  return self->desc;
+  }
+
+#endif
+
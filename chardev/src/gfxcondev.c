@@ -21,8 +21,9 @@
 #include <ctype.h>
 #include <fatfs_loopback/fatloopback.h>
 #include <chardev/gfxcondev.h>
-#include <gfx/fonts.h>
+#include <gfx/packedfont.h>
 #include <gfx/gfx_util.h>
+#include <gfx/glyphcache.h>
 
 // Modes of the character parser -- used when parsing esc sequences
 // MODE_NORMAL -- initials state, or unknown
@@ -30,14 +31,49 @@
 // MODE_ESC -- I have received an ESC, and now I must determine whether it
 //   is the start of a CSI or something else
 #define MODE_ESC 1
-// I have received ESC-[, and must wait for a character that is not a number
-//   or ;
+// I have received ESC-[, and must wait for the final character of the 
+//   sequence, which is in the range 0x40-0x7E
 #define MODE_CSI 2
 
 #define CURSOR_HEIGHT 1 
 
-// Maximum length of a CSI escape sequence, not including the esc-[ header
-#define MAX_CSI 10
+// The console font, and the factor it is enlarged by. The font must be one
+//   of those selected by GFX_FONTS in CMakeLists.txt, which normally sets
+//   these as well
+#ifndef GFXCON_FONT
+#define GFXCON_FONT PackedFont16
+#endif
+#ifndef GFXCON_FONT_SCALE
+#define GFXCON_FONT_SCALE 1
+#endif
+
+// Maximum length of a CSI escape sequence, not including the esc-[ header.
+//   Longer sequences are read to the end, and then ignored
+#define MAX_CSI 32
+
+// Maximum number of numeric arguments in a CSI sequence
+#define MAX_CSI_ARGS 8
+
+// Bits of GfxConCell.attr
+#define ATTR_REVERSE 0x01
+
+// Memory allowed for expanded glyphs. With Font16 in RGB565, a glyph is
+//   352 bytes, so this holds about 45 of them -- more than the number of
+//   different characters on a typical screen of text
+#define GLYPH_CACHE_BUDGET (16 * 1024)
+
+// The largest number of adjacent changed cells that are sent to the
+//   device in one region. Each cell needs font_width * font_height * 
+//   bytes_pp bytes of buffer; for Font16 in RGB565, this is 2816 bytes
+#define SPAN_CELLS 8
+
+/* One character cell of the shadow grid. attr is a set of ATTR_XXX bits,
+   set by SGR sequences. */
+typedef struct _GfxConCell
+  {
+  uint8_t c;
+  uint8_t attr;
+  } GfxConCell;
 
 struct _GfxConDev
   {
@@ -48,16 +84,45 @@ struct _GfxConDev
   DevDescriptor *gfxdevdesc;
   // File descriptor of the underlying gfx device
   FileDesc *gfx_file_desc;
-  sFONT *font;
+  const PackedFont *font;
+  int font_scale;
   int font_width;
   int font_height;
   // row_height is the height of the font plus space for the cursor
   int row_height;
   int32_t flags;
   int bytes_pp;
-  void *glyph_buffer;
+  // Foreground and background colours, in the device's pixel format
+  uint32_t fg;
+  uint32_t bg;
+  GlyphCache *glyph_cache;
+  // The shadow grid. 'cells' is the text as it should be, and 'shown' 
+  //   what has been sent to the device. Changes are only drawn when the 
+  //   grid is flushed, at the end of each write(). For each row, 
+  //   dirty_lo and dirty_hi are the first and last columns that might 
+  //   differ; dirty_lo > dirty_hi means the row is clean.
+  GfxConCell *cells;
+  GfxConCell *shown;
+  int16_t *dirty_lo;
+  int16_t *dirty_hi;
+  int grid_rows;
+  int grid_cols;
+  // Pixels of up to SPAN_CELLS glyphs, assembled for a single write
+  uint8_t *span_buff;
+  // Whether the device can copy a rectangle of pixels (DC_GFX_OP_COPY_RECT)
+  bool can_copy_rect;
   int row;
   int col;
+  // The attributes given to characters as they are written
+  uint8_t attr;
+  bool cursor_visible;
+  // The scrolling region set by DECSTBM, as the first and last rows
+  int scroll_top;
+  int scroll_bottom;
+  // The cursor position and attributes stored by DECSC (esc-7)
+  int saved_row;
+  int saved_col;
+  uint8_t saved_attr;
   // temp_rows, temp_cols, etc are the text height and width for a specific 
   //   write operation. We don't cache these values in the long term, because
   //   the hardware properties could change. However, they are unlikely to
@@ -69,121 +134,464 @@ struct _GfxConDev
   int tab_size;
   int mode; // One of the MODE_XXX constants
   int csilen;
+  bool csi_overflow;
   char csibuf[MAX_CSI + 1];
   };
 
 static void gfxcon_write_printing_char (FileDesc *f, uint8_t c); // FWD
 
 /*============================================================================
- * gfxcondev_get_glyph_offset
- * Returns the pixel x and y of the TL corner of the current glyph, that is,
- *   at the position self->row,self->col
+ * gfxcondev_grid_clear_row
+ * Set a row of the grid to spaces, and mark it as clean. This is for 
+ *   use when the same row has been cleared on the device.
 * ==========================================================================*/
-#if PICO_ON_DEVICE
-static void gfxcondev_get_glyph_offset (GfxConDev *self, int *x, int *y)
+static void gfxcondev_grid_clear_row (GfxConDev *self, int row)
   {
-  *x = self->col * self->font_width;
-  *y = self->row * self->row_height;
+  GfxConCell *cells = self->cells + row * self->grid_cols;
+  GfxConCell *shown = self->shown + row * self->grid_cols;
+  for (int i = 0; i < self->grid_cols; i++)
+    {
+    cells[i].c = ' '; cells[i].attr = 0;
+    }
+  memcpy (shown, cells, (size_t)self->grid_cols * sizeof (GfxConCell));
+  self->dirty_lo[row] = (int16_t)self->grid_cols;
+  self->dirty_hi[row] = -1;
   }
-#endif
 
 /*============================================================================
- * gfxcondev_get_text_size
+ * gfxcondev_grid_clear
 * ==========================================================================*/
-static void gfxcondev_get_text_size (GfxConDev *self, int *rows, int *cols,
-              int *pixel_width)
+static void gfxcondev_grid_clear (GfxConDev *self)
   {
-#if PICO_ON_DEVICE
-  DevCtlGfxProps gfx_props;
-  self->gfx_file_desc->devctl 
-        (self->gfx_file_desc, DC_GFX_GET_PROPS, (int32_t)&gfx_props);      
+  if (!self->cells) return;
+  for (int i = 0; i < self->grid_rows; i++)
+    gfxcondev_grid_clear_row (self, i);
+  }
 
-  *pixel_width = gfx_props.width;
-  *rows = gfx_props.height / self->row_height;
-  *cols = gfx_props.width / self->font_width; 
-#else
-  *rows = 24; 
-  *cols = 80;
-  (void)self; (void)pixel_width;
-#endif
+/*============================================================================
+ * gfxcondev_grid_mark
+ * Mark columns lo to hi of a row as possibly changed.
+* ==========================================================================*/
+static void gfxcondev_grid_mark (GfxConDev *self, int row, int lo, int hi)
+  {
+  if (lo < self->dirty_lo[row]) self->dirty_lo[row] = (int16_t)lo;
+  if (hi > self->dirty_hi[row]) self->dirty_hi[row] = (int16_t)hi;
   }
 
 /*============================================================================
- * gfxcondev_read
+ * gfxcondev_grid_erase
+ * Set columns lo to hi of a row to spaces. Unlike grid_clear_row, this
+ *   only changes the text, which is then drawn by the next flush.
 * ==========================================================================*/
-int gfxcon_read (FileDesc *f, void *buffer, int len)
+static void gfxcondev_grid_erase (GfxConDev *self, int row, int lo, int hi)
   {
-  // TODO
-  return 0;
+  if (!self->cells || row < 0 || row >= self->grid_rows) return;
+  if (lo < 0) lo = 0;
+  if (hi >= self->grid_cols) hi = self->grid_cols - 1;
+  if (lo > hi) return;
+  GfxConCell *cells = self->cells + row * self->grid_cols;
+  for (int i = lo; i <= hi; i++)
+    {
+    cells[i].c = ' '; cells[i].attr = 0;
+    }
+  gfxcondev_grid_mark (self, row, lo, hi);
   }
 
 /*============================================================================
- * gfxcondev_read_timeout
+ * gfxcondev_grid_put
+ * Store a character at the cursor position, and mark the cell dirty if 
+ *   it has changed.
 * ==========================================================================*/
-int gfxcon_read_timeout (FileDesc *f, int msec)
+static void gfxcondev_grid_put (GfxConDev *self, uint8_t c)
   {
-  GfxConDev *self = f->self;
-  
-  return -1;
+  if (!self->cells || self->row >= self->grid_rows 
+       || self->col >= self->grid_cols) return;
+  GfxConCell *cell = self->cells + self->row * self->grid_cols + self->col;
+  if (cell->c == c && cell->attr == self->attr) return;
+  cell->c = c;
+  cell->attr = self->attr;
+  gfxcondev_grid_mark (self, self->row, self->col, self->col);
   }
 
 /*============================================================================
- * gfxcon_font_get_offset
+ * gfxcondev_grid_shift_chars
+ * Move the text of the cursor row, from the cursor to the right margin,
+ *   n places right (n > 0) or left (n < 0). This is ICH or DCH. Cells that 
+ *   are vacated become spaces, and text that is pushed off the margin 
+ *   is lost.
 * ==========================================================================*/
-const uint8_t *gfxcon_font_get_offset (int c, const sFONT *font)
+static void gfxcondev_grid_shift_chars (GfxConDev *self, int n)
   {
-  if (c < ' ') return NULL;
-  if (c > 126) return NULL; 
-  return font->table + ((c - 32) * (font->Bytes * font->Height));
-  return 0;
+  if (!self->cells || self->row >= self->grid_rows 
+       || self->col >= self->grid_cols) return;
+  GfxConCell *cells = self->cells + self->row * self->grid_cols;
+  int width = self->grid_cols - self->col;
+  int count = n > 0 ? n : -n;
+  if (count > width) count = width;
+  int keep = width - count;
+  if (n > 0)
+    {
+    memmove (cells + self->col + count, cells + self->col, 
+      (size_t)keep * sizeof (GfxConCell));
+    gfxcondev_grid_erase (self, self->row, self->col, self->col + count - 1);
+    }
+  else
+    {
+    memmove (cells + self->col, cells + self->col + count, 
+      (size_t)keep * sizeof (GfxConCell));
+    gfxcondev_grid_erase (self, self->row, self->col + keep, 
+      self->grid_cols - 1);
+    }
+  gfxcondev_grid_mark (self, self->row, self->col, self->grid_cols - 1);
   }
 
 /*============================================================================
- * gfxcon_fill_glyph_buffer
+ * gfxcondev_swap_rows
 * ==========================================================================*/
-#if PICO_ON_DEVICE
-static void gfxcon_fill_glyph_buffer (FileDesc *f, uint8_t c)
+static void gfxcondev_swap_rows (GfxConCell *grid, int cols, int r1, int r2)
   {
-  GfxConDev *self = f->self;
-  const uint32_t white = 0xFFFFFFFF; // TODO real colour
-  int bytes_pp = self->bytes_pp;
+  GfxConCell *a = grid + r1 * cols;
+  GfxConCell *b = grid + r2 * cols;
+  for (int i = 0; i < cols; i++)
+    {
+    GfxConCell t = a[i]; a[i] = b[i]; b[i] = t;
+    }
+  }
 
-  int font_height = self->font_height;
-  int font_width = self->font_width;
+/*============================================================================
+ * gfxcondev_rotate_rows
+ * Rotate rows top to bottom of a grid, so that row top + n moves to row
+ *   top. This is done by three reversals, so needs no extra memory.
+* ==========================================================================*/
+static void gfxcondev_rotate_rows (GfxConCell *grid, int cols, int top, 
+              int bottom, int n)
+  {
+  int spans[3][2] = {{top, top + n - 1}, {top + n, bottom}, {top, bottom}};
+  for (int i = 0; i < 3; i++)
+    {
+    for (int r1 = spans[i][0], r2 = spans[i][1]; r1 < r2; r1++, r2--)
+      gfxcondev_swap_rows (grid, cols, r1, r2);
+    }
+  }
 
-  memset (self->glyph_buffer, 0, (size_t)(bytes_pp * 
-     self->font_width * self->font_height)); // TODO background colour
+// The ways that the pixels of a scrolled region can be brought into line
+//   with the text
+// SCROLL_REDRAW -- draw every cell that has changed
+#define SCROLL_REDRAW 0
+// SCROLL_HARDWARE -- scroll the whole screen with DC_GFX_SCROLL_UP, and then
+//   draw the cells that are still wrong, which include those outside 
+//   the region
+#define SCROLL_HARDWARE 1
+// SCROLL_COPY -- move the region's pixels with DC_GFX_OP_COPY_RECT
+#define SCROLL_COPY 2
 
-  const uint8_t *offset = gfxcon_font_get_offset (c, self->font); 
-  if (!offset)
-    offset = gfxcon_font_get_offset ('?', self->font); 
-  int font_width_bytes = self->font->Bytes;
+/*============================================================================
+ * gfxcondev_source_row
+ * Returns the row of 'shown' that would be on screen row r, after the 
+ *   region top to bottom was scrolled by n rows (up if n is positive) by 
+ *   the method 'how'.
+* ==========================================================================*/
+static int gfxcondev_source_row (const GfxConDev *self, int how, int top, 
+              int bottom, int n, int r)
+  {
+  switch (how)
+    {
+    case SCROLL_HARDWARE:
+      return (r + n + self->grid_rows) % self->grid_rows;
+    case SCROLL_COPY:
+      // Rows that are uncovered keep whatever pixels they had
+      if (r >= top && r <= bottom && r + n >= top && r + n <= bottom)
+        return r + n;
+      return r;
+    }
+  return r;
+  }
 
-  for (int i = 0; i < font_height; i++)
+/*============================================================================
+ * gfxcondev_scroll_cost
+ * Returns the number of cells that would have to be drawn, after 
+ *   scrolling by the method 'how'.
+* ==========================================================================*/
+static int gfxcondev_scroll_cost (const GfxConDev *self, int how, int top, 
+              int bottom, int n)
+  {
+  int cost = 0;
+  int cols = self->grid_cols;
+  for (int r = 0; r < self->grid_rows; r++)
     {
-    const uint8_t *cur_offset = offset + i * font_width_bytes; 
-    uint8_t cur_byte = *cur_offset;
-    
-    register int cur_bit_p = 0;
-    for (int j = 0; j < font_width; j++)
+    const GfxConCell *cells = self->cells + r * cols;
+    const GfxConCell *shown = self->shown 
+      + gfxcondev_source_row (self, how, top, bottom, n, r) * cols;
+    for (int c = 0; c < cols; c++)
       {
-      if (cur_byte & 0x80)
+      if (cells[c].c != shown[c].c || cells[c].attr != shown[c].attr) 
+        cost++;
+      }
+    }
+  return cost;
+  }
+
+/*============================================================================
+ * gfxcondev_scroll_region
+ * Scroll rows top to bottom by n rows; up if n is positive, and down if
+ *   it is negative. This is how LF at the bottom of the scrolling region,
+ *   reverse index, IL and DL are all carried out. 
+ * The text is moved in the grid, and then whichever of the SCROLL_XXX
+ *   methods leaves the fewest cells to draw is used to move the pixels.
+ *   For the whole screen, that is almost always a hardware scroll. An 
+ *   editor with a status line at the bottom scrolls by hardware as well,
+ *   and the status line is redrawn. A small region in the middle of the 
+ *   screen is cheaper to redraw, unless the device can copy pixels.
+* ==========================================================================*/
+static void gfxcondev_scroll_region (GfxConDev *self, int top, int bottom,
+              int n)
+  {
+  if (!self->cells || top < 0 || bottom >= self->grid_rows || top > bottom
+       || n == 0) return;
+  int height = bottom - top + 1;
+  int count = n > 0 ? n : -n;
+  if (count >= height)
+    {
+    for (int r = top; r <= bottom; r++)
+      gfxcondev_grid_erase (self, r, 0, self->grid_cols - 1);
+    return;
+    }
+  n = n > 0 ? count : -count;
+
+  // Move the text. Rotating the region leaves the rows that are scrolled
+  //   out where the new, blank, rows will be.
+  int cols = self->grid_cols;
+  gfxcondev_rotate_rows (self->cells, cols, top, bottom, 
+    n > 0 ? count : height - count);
+  int blank_top = n > 0 ? bottom - count + 1 : top;
+  for (int r = blank_top; r < blank_top + count; r++)
+    gfxcondev_grid_erase (self, r, 0, cols - 1);
+
+  int how = SCROLL_REDRAW;
+  int best = gfxcondev_scroll_cost (self, SCROLL_REDRAW, top, bottom, n);
+  int cost = gfxcondev_scroll_cost (self, SCROLL_HARDWARE, top, bottom, n);
+  if (cost < best) 
+    {
+    how = SCROLL_HARDWARE;
+    best = cost;
+    }
+  if (self->can_copy_rect)
+    {
+    // The device still has to move the pixels, so a copy is not free. 
+    //   Charging an eighth of the cost of drawing them means that a 
+    //   hardware scroll is still used for the whole screen.
+    cost = gfxcondev_scroll_cost (self, SCROLL_COPY, top, bottom, n)
+      + (height - count) * cols / 8;
+    if (cost < best) how = SCROLL_COPY;
+    }
+
+  // Move the pixels, and make 'shown' match them
+  int first = top, last = bottom;
+  if (how == SCROLL_HARDWARE)
+    {
+    int rows = n > 0 ? count : self->grid_rows - count;
+    self->gfx_file_desc->devctl (self->gfx_file_desc, DC_GFX_SCROLL_UP, 
+      rows * self->row_height);
+    gfxcondev_rotate_rows (self->shown, cols, 0, self->grid_rows - 1, rows);
+    first = 0;
+    last = self->grid_rows - 1;
+    }
+  else if (how == SCROLL_COPY)
+    {
+    DevCtlGfxDrawCmd cmd;
+    memset (&cmd, 0, sizeof (cmd));
+    cmd.op = DC_GFX_OP_COPY_RECT;
+    cmd.y = (n > 0 ? top : top + count) * self->row_height;
+    cmd.y2 = (n > 0 ? top + count : top) * self->row_height;
+    cmd.w = cols * self->font_width;
+    cmd.h = (height - count) * self->row_height;
+    DevCtlGfxDrawList list;
+    memset (&list, 0, sizeof (list));
+    list.cmds = &cmd;
+    list.count = 1;
+    self->gfx_file_desc->devctl (self->gfx_file_desc, DC_GFX_DRAW, 
+      (intptr_t)&list);
+    size_t row_bytes = (size_t)cols * sizeof (GfxConCell);
+    GfxConCell *region = self->shown + top * cols;
+    if (n > 0)
+      memmove (region, region + count * cols, 
+        (size_t)(height - count) * row_bytes);
+    else
+      memmove (region + count * cols, region, 
+        (size_t)(height - count) * row_bytes);
+    }
+
+  for (int r = first; r <= last; r++)
+    gfxcondev_grid_mark (self, r, 0, cols - 1);
+  }
+
+/*============================================================================
+ * gfxcondev_glyph
+ * Get the pixels of a cell's character, in the cell's colours. 
+* ==========================================================================*/
+static const uint8_t *gfxcondev_glyph (GfxConDev *self, 
+              const GfxConCell *cell)
+  {
+  bool reverse = (cell->attr & ATTR_REVERSE) != 0;
+  return glyphcache_get (self->glyph_cache, self->font, self->font_scale,
+      reverse ? self->bg : self->fg, reverse ? self->fg : self->bg, 
+      self->bytes_pp, cell->c);
+  }
+
+/*============================================================================
+ * gfxcondev_draw_span
+ * Draw n adjacent cells of a row, starting at col, as a single region.
+* ==========================================================================*/
+static void gfxcondev_draw_span (GfxConDev *self, int row, int col, int n)
+  {
+  const GfxConCell *cells = self->cells + row * self->grid_cols + col;
+  int glyph_row_bytes = self->font_width * self->bytes_pp;
+  int glyph_bytes = glyph_row_bytes * self->font_height;
+
+  DevCtlGfxRegion region;
+  region.x = col * self->font_width; 
+  region.y = row * self->row_height; 
+  region.cx = n * self->font_width; 
+  region.cy = self->font_height; 
+  self->gfx_file_desc->devctl (self->gfx_file_desc, DC_GFX_SET_REGION, 
+    (intptr_t)&region);
+
+  if (n == 1)
+    {
+    // The glyph is already in the right layout -- no need to copy it
+    const uint8_t *glyph = gfxcondev_glyph (self, &cells[0]);
+    if (glyph)
+      self->gfx_file_desc->write (self->gfx_file_desc, glyph, glyph_bytes); 
+    return;
+    }
+
+  // The region is filled a pixel row at a time, so each row of the span
+  //   is the same row of each glyph, end to end. A glyph from the cache
+  //   is only valid until the next call to the cache, so it has to be
+  //   copied out straight away.
+  int span_row_bytes = n * glyph_row_bytes;
+  for (int i = 0; i < n; i++)
+    {
+    const uint8_t *glyph = gfxcondev_glyph (self, &cells[i]);
+    uint8_t *dest = self->span_buff + i * glyph_row_bytes;
+    for (int y = 0; y < self->font_height; y++)
+      {
+      if (glyph)
+        memcpy (dest, glyph + y * glyph_row_bytes, (size_t)glyph_row_bytes);
+      else
+        memset (dest, 0, (size_t)glyph_row_bytes);
+      dest += span_row_bytes;
+      }
+    }
+  self->gfx_file_desc->write (self->gfx_file_desc, self->span_buff, 
+    span_row_bytes * self->font_height);
+  }
+
+/*============================================================================
+ * gfxcondev_flush_blank
+ * If columns lo to hi of a row are all plain spaces, and more than one of
+ *   them has changed, fill them with the background colour in one 
+ *   operation, rather than drawing spaces. This is the usual case for 
+ *   the row that a scroll uncovers. Returns true if the row was filled.
+* ==========================================================================*/
+static bool gfxcondev_flush_blank (GfxConDev *self, int row, int lo, int hi)
+  {
+  GfxConCell *cells = self->cells + row * self->grid_cols;
+  GfxConCell *shown = self->shown + row * self->grid_cols;
+  int changed = 0;
+  for (int c = lo; c <= hi; c++)
+    {
+    if (cells[c].c != ' ' || cells[c].attr != 0) return false;
+    if (shown[c].c != ' ' || shown[c].attr != 0) changed++;
+    }
+  if (changed < 2) return false;
+
+  DevCtlGfxRegion region;
+  region.x = lo * self->font_width; 
+  region.y = row * self->row_height; 
+  region.cx = (hi - lo + 1) * self->font_width; 
+  region.cy = self->font_height; 
+  self->gfx_file_desc->devctl (self->gfx_file_desc, DC_GFX_SET_REGION, 
+    (intptr_t)&region);
+  DevCtlGfxColour colour;
+  colour.rgb888 = self->bg;
+  self->gfx_file_desc->devctl (self->gfx_file_desc, DC_GFX_FILL, 
+    (intptr_t)&colour);
+  memcpy (&shown[lo], &cells[lo], (size_t)(hi - lo + 1) * sizeof (GfxConCell));
+  return true;
+  }
+
+/*============================================================================
+ * gfxcondev_flush
+ * Send the changed parts of the grid to the device. Within the dirty 
+ *   columns of each row, cells that are the same as those on the device
+ *   are skipped, and runs of changed cells are drawn together. 
+* ==========================================================================*/
+static void gfxcondev_flush (GfxConDev *self)
+  {
+  if (!self->cells) return;
+  for (int r = 0; r < self->grid_rows; r++)
+    {
+    int lo = self->dirty_lo[r];
+    int hi = self->dirty_hi[r];
+    if (lo > hi) continue;
+    if (gfxcondev_flush_blank (self, r, lo, hi)) lo = hi + 1;
+    GfxConCell *cells = self->cells + r * self->grid_cols;
+    GfxConCell *shown = self->shown + r * self->grid_cols;
+    int c = lo;
+    while (c <= hi)
+      {
+      if (memcmp (&cells[c], &shown[c], sizeof (GfxConCell)) == 0)
         {
-        memcpy (self->glyph_buffer + (i * font_width + j) 
-          * self->bytes_pp, &white, (size_t)bytes_pp); 
+        c++;
+        continue;
         }
-      cur_byte <<= 1;
-      cur_bit_p++;
-      if (cur_bit_p == 8)
-        {
-        cur_offset++;
-        cur_bit_p = 0; 
-        cur_byte = *cur_offset;
-        } 
-      } 
-    } 
+      int n = 1;
+      while (c + n <= hi && n < SPAN_CELLS
+         && memcmp (&cells[c + n], &shown[c + n], sizeof (GfxConCell)) != 0)
+        n++;
+      gfxcondev_draw_span (self, r, c, n);
+      memcpy (&shown[c], &cells[c], (size_t)n * sizeof (GfxConCell));
+      c += n;
+      }
+    self->dirty_lo[r] = (int16_t)self->grid_cols;
+    self->dirty_hi[r] = -1;
+    }
+  }
+
+/*============================================================================
+ * gfxcondev_get_text_size
+* ==========================================================================*/
+static void gfxcondev_get_text_size (GfxConDev *self, int *rows, int *cols,
+              int *pixel_width)
+  {
+  DevCtlGfxProps gfx_props;
+  self->gfx_file_desc->devctl 
+        (self->gfx_file_desc, DC_GFX_GET_PROPS, (intptr_t)&gfx_props);      
+
+  *pixel_width = gfx_props.width;
+  *rows = gfx_props.height / self->row_height;
+  *cols = gfx_props.width / self->font_width; 
+  }
+
+/*============================================================================
+ * gfxcondev_read
+* ==========================================================================*/
+int gfxcon_read (FileDesc *f, void *buffer, int len)
+  {
+  // TODO
+  return 0;
+  }
+
+/*============================================================================
+ * gfxcondev_read_timeout
+* ==========================================================================*/
+int gfxcon_read_timeout (FileDesc *f, int msec)
+  {
+  GfxConDev *self = f->self;
+  
+  return -1;
   }
-#endif
 
 /*============================================================================
  * gfxcon_write_cr
@@ -196,29 +604,30 @@ static void gfxcon_write_cr (FileDesc *f)
 
 /*============================================================================
  * gfxcon_write_lf
+ * A line feed on the bottom row of the scrolling region scrolls the 
+ *   region. Below the region, it does nothing on the bottom row of the 
+ *   screen.
 * ==========================================================================*/
 static void gfxcon_write_lf (FileDesc *f)
   {
   GfxConDev *self = f->self;
-  self->row++;
-  if (self->row == self->temp_rows) 
-    {
-    self->gfx_file_desc->devctl 
-        (self->gfx_file_desc, DC_GFX_SCROLL_UP, self->row_height); 
-    self->row = self->temp_rows - 1;
-
-    DevCtlGfxRegion region;
-    region.x = 0; 
-    region.y = self->row_height * (self->temp_rows - 1); 
-    region.cx = self->temp_pixel_width; 
-    region.cy = 480 - region.y; 
-    self->gfx_file_desc->devctl (self->gfx_file_desc, DC_GFX_SET_REGION, 
-      (intptr_t)&region);
-    int32_t black = 0x0; // TODO -- use real background colour
-    self->gfx_file_desc->devctl (self->gfx_file_desc, DC_GFX_FILL, 
-      (intptr_t)&black);
+  if (self->row == self->scroll_bottom)
+    gfxcondev_scroll_region (self, self->scroll_top, self->scroll_bottom, 1);
+  else if (self->row < self->temp_rows - 1)
+    self->row++;
+  }
 
-    }
+/*============================================================================
+ * gfxcon_write_ri
+ * Reverse index -- the opposite of a line feed.
+* ==========================================================================*/
+static void gfxcon_write_ri (FileDesc *f)
+  {
+  GfxConDev *self = f->self;
+  if (self->row == self->scroll_top)
+    gfxcondev_scroll_region (self, self->scroll_top, self->scroll_bottom, -1);
+  else if (self->row > 0)
+    self->row--;
   }
 
 /*============================================================================
@@ -287,25 +696,10 @@ static void gfxcon_write_tab (FileDesc *f)
 static void gfxcon_write_printing_char (FileDesc *f, uint8_t c)
   {
   GfxConDev *self = f->self;
-  int x, y;
   if (self->col < self->temp_cols)
     {
-#if PICO_ON_DEVICE
-    gfxcondev_get_glyph_offset (f->self, &x, &y);
-    DevCtlGfxRegion region;
-    region.x = x; 
-    region.y = y; 
-    region.cx = self->font_width; 
-    region.cy = self->font_height; 
-    self->gfx_file_desc->devctl (self->gfx_file_desc, DC_GFX_SET_REGION, 
-      (int32_t)&region);
-    gfxcon_fill_glyph_buffer (f, c); 
-    self->gfx_file_desc->write (self->gfx_file_desc, self->glyph_buffer, 
-      self->bytes_pp * self->font_width * self->font_height);
-#else
-    (void)x; (void)y;
-    putchar (c);
-#endif
+    // The character is drawn when the grid is flushed
+    gfxcondev_grid_put (self, c);
     }
   self->col++;
   if ((self->flags & DC_TERM_FLAG_WRAP) && (self->col >= self->temp_cols))
@@ -314,9 +708,74 @@ static void gfxcon_write_printing_char (FileDesc *f, uint8_t c)
     }
   }
 
+/*============================================================================
+ * gfxcon_csi_arg
+ * Returns argument i of a CSI sequence, or 'def' if it was not given. As
+ *   on the VT100, an argument of zero also means the default.
+* ==========================================================================*/
+static int gfxcon_csi_arg (const int *arg, int argc, int i, int def)
+  {
+  if (i >= argc || arg[i] == 0) return def;
+  return arg[i];
+  }
+
+/*============================================================================
+ * gfxcon_set_modes
+ * CSI ? ... h and l. Only DECTCEM (25), which shows and hides the
+ *   cursor, has any effect.
+* ==========================================================================*/
+static void gfxcon_set_modes (GfxConDev *self, const int *arg, int argc,
+              bool set)
+  {
+  for (int i = 0; i < argc; i++)
+    {
+    if (arg[i] == 25) self->cursor_visible = set;
+    }
+  }
+
+/*============================================================================
+ * gfxcon_sgr
+ * Select graphic rendition. The screen has only two colours, so only
+ *   reverse video is supported; bold, underline, etc., are ignored.
+* ==========================================================================*/
+static void gfxcon_sgr (GfxConDev *self, const int *arg, int argc)
+  {
+  for (int i = 0; i < argc; i++)
+    {
+    switch (arg[i])
+      {
+      case 0: self->attr = 0; break;
+      case 7: self->attr |= ATTR_REVERSE; break;
+      case 27: self->attr &= (uint8_t)~ATTR_REVERSE; break;
+      }
+    }
+  }
+
+/*============================================================================
+ * gfxcon_erase_line
+ * EL -- 0 = from cursor, 1 = to cursor, 2 = all.
+* ==========================================================================*/
+static void gfxcon_erase_line (GfxConDev *self, int what)
+  {
+  switch (what)
+    {
+    case 0:
+      gfxcondev_grid_erase (self, self->row, self->col, self->temp_cols - 1);
+      break;
+    case 1:
+      gfxcondev_grid_erase (self, self->row, 0, self->col);
+      break;
+    case 2:
+      gfxcondev_grid_erase (self, self->row, 0, self->temp_cols - 1);
+      break;
+    }
+  }
+
 /*============================================================================
  * gfxcon_csi
- * // Note -- this function will modify the string passed to it
+ * Carry out a CSI sequence. csi is the text after esc-[, including the
+ *   final character.
+ * Note -- this function will modify the string passed to it
 * ==========================================================================*/
 static void gfxcon_csi (FileDesc *f, char *csi)
   {
@@ -326,108 +785,114 @@ static void gfxcon_csi (FileDesc *f, char *csi)
   if (l == 0) return;
   char terminator = csi[l - 1];
   csi[l - 1] = 0;
- 
-  // At present, no CSI sequence we handle has more than three arguments,
-  //   and all are numbers.
-  int arg[3];
-  int argc = 0; 
 
-  // The way we split the CSI sequence on semicolons might need work
-  char numbuff[5];
-  int numind = 0; 
-  while (*csi)
+  // Sequences that start with '?' are DEC private modes
+  bool private = false;
+  if (*csi == '?') 
+    {
+    private = true;
+    csi++;
+    }
+ 
+  // Arguments are numbers separated by semicolons; an empty argument is 
+  //   zero. Arguments after the first MAX_CSI_ARGS are dropped.
+  int arg[MAX_CSI_ARGS];
+  memset (arg, 0, sizeof (arg));
+  int argc = 1; 
+  for (; *csi; csi++)
     {
     char c = *csi;
     if (c == ';')
       {
-      numbuff[numind] = 0;
-      if (argc < 3)
-        {
-        arg[argc] = atoi (numbuff);
-        argc++;
-        numind = 0;
-        numbuff[0] = 0;
-        }
+      if (argc == MAX_CSI_ARGS) break;
+      argc++;
       }
-    else
+    else if (isdigit ((uint8_t)c))
       {
-      if (numind < (int)sizeof (numbuff) - 1)
-        numbuff[numind++] = c;
-      }   
-    csi++;
-    }
-
-  if (numind && (argc < 3))
-    {
-    arg[argc] = atoi (numbuff);
-    argc++;
+      int *a = &arg[argc - 1];
+      if (*a < 10000) *a = *a * 10 + (c - '0');
+      }
     }
 
-  /*
-  printf ("terminator=%c\n", terminator); // TODO
-  for (int i = 0; i < argc; i++) // TODO
+  if (private)
     {
-    printf ("%d: %d\n", i, arg[i]);
+    if (terminator == 'h' || terminator == 'l')
+      gfxcon_set_modes (self, arg, argc, terminator == 'h');
+    return;
     }
-  */
-
-  //printf ("arg0=%d arg1=%d\n", arg[0], arg[1]);
 
+  int n = gfxcon_csi_arg (arg, argc, 0, 1);
   switch (terminator)
     {
-    case 'A':
-      if (argc == 0)
-        gfxcondev_cursor_up (self, 1); 
-      else if (argc == 2)
-        {
-        if (arg[0] == 0) arg[0] = 1;
-        gfxcondev_cursor_up (self, arg[0]); 
-        }
+    case 'A': // CUU
+      gfxcondev_cursor_up (self, n); 
       break;
-    case 'B':
-      if (argc == 0)
-        gfxcondev_cursor_down (self, 1); 
-      else if (argc == 2)
-        {
-        if (arg[0] == 0) arg[0] = 1;
-        gfxcondev_cursor_down (self, arg[0]); 
-        }
+    case 'B': // CUD
+      gfxcondev_cursor_down (self, n); 
       break;
-    case 'C':
-      if (argc == 0)
-        gfxcondev_cursor_forward (self, 1); 
-      else if (argc == 2)
-        {
-        if (arg[0] == 0) arg[0] = 1;
-        gfxcondev_cursor_forward (self, arg[0]); 
-        }
+    case 'C': // CUF
+      gfxcondev_cursor_forward (self, n); 
       break;
-    case 'D':
-      if (argc == 0)
-        gfxcondev_cursor_back (self, 1); 
-      else if (argc == 2)
-        {
-        if (arg[0] == 0) arg[0] = 1;
-        gfxcondev_cursor_back (self, arg[0]); 
-        }
+    case 'D': // CUB
+      gfxcondev_cursor_back (self, n); 
       break;
-    case 'H':
-      if (argc == 0)
-        gfxcondev_set_cursor (self, 0, 0); 
-      else if (argc == 2)
-        {
-        if (arg[0] == 0) arg[0] = 1;
-        if (arg[1] == 0) arg[1] = 1;
-        gfxcondev_set_cursor (self, arg[0] - 1, arg[1] - 1); 
-        }
+    case 'G': // CHA
+      gfxcondev_set_cursor (self, self->row, n - 1); 
+      break;
+    case 'd': // VPA
+      gfxcondev_set_cursor (self, n - 1, self->col); 
+      break;
+    case 'H': // CUP
+    case 'f': // HVP
+      gfxcondev_set_cursor (self, n - 1, gfxcon_csi_arg (arg, argc, 1, 1) - 1);
+      break;
+    case 'J': // ED
+      gfxcondev_clear_screen (self, arg[0]); 
+      break;
+    case 'K': // EL
+      gfxcon_erase_line (self, arg[0]);
+      break;
+    case 'L': // IL
+      if (self->row >= self->scroll_top && self->row <= self->scroll_bottom)
+        gfxcondev_scroll_region (self, self->row, self->scroll_bottom, -n);
+      self->col = 0;
+      break;
+    case 'M': // DL
+      if (self->row >= self->scroll_top && self->row <= self->scroll_bottom)
+        gfxcondev_scroll_region (self, self->row, self->scroll_bottom, n);
+      self->col = 0;
       break;
-    case 'J':
-      if (argc == 0)
-        gfxcondev_clear_screen (self, 2); 
-      else if (argc == 1)
+    case '@': // ICH
+      gfxcondev_grid_shift_chars (self, n);
+      break;
+    case 'P': // DCH
+      gfxcondev_grid_shift_chars (self, -n);
+      break;
+    case 'X': // ECH
+      gfxcondev_grid_erase (self, self->row, self->col, self->col + n - 1);
+      break;
+    case 'r': // DECSTBM
+      {
+      int top = gfxcon_csi_arg (arg, argc, 0, 1) - 1;
+      int bottom = gfxcon_csi_arg (arg, argc, 1, self->grid_rows) - 1;
+      if (bottom >= self->grid_rows) bottom = self->grid_rows - 1;
+      // The region must be at least two rows
+      if (top < bottom)
         {
-        gfxcondev_clear_screen (self, arg[0]); 
+        self->scroll_top = top;
+        self->scroll_bottom = bottom;
+        gfxcondev_set_cursor (self, 0, 0);
         }
+      }
+      break;
+    case 's': // SCOSC
+      gfxcondev_save_cursor (self);
+      break;
+    case 'u': // SCORC
+      gfxcondev_restore_cursor (self);
+      break;
+    case 'm': // SGR
+      gfxcon_sgr (self, arg, argc);
       break;
     }
   }
@@ -440,23 +905,31 @@ static void gfxcon_write_char (FileDesc *f, uint8_t c)
   GfxConDev *self = f->self;
   if (self->mode == MODE_CSI)
     {
+    if (c == 24 || c == 26) // CAN and SUB abandon the sequence
+      {
+      self->mode = MODE_NORMAL;
+      return;
+      }
+    if (c == 27)
+      {
+      self->mode = MODE_ESC;
+      return;
+      }
     if (self->csilen < MAX_CSI)
       {
       self->csibuf[self->csilen] = (char)c;
       self->csilen++;
       }
-    if (isdigit (c) || c == ';')
-      {
-      }
     else
+      self->csi_overflow = true;
+    if (c >= 0x40 && c <= 0x7E)
       {
-      if (self->csilen > 0)
-        {
-        self->csibuf [self->csilen] = 0;
+      // The final character. A sequence that was too long to store is 
+      //   ignored
+      self->csibuf [self->csilen] = 0;
+      if (!self->csi_overflow)
         gfxcon_csi (f, self->csibuf); 
-        self->csilen = 0;
-        self->mode = MODE_NORMAL;
-        }
+      self->mode = MODE_NORMAL;
       }
     }
   else if (self->mode == MODE_ESC)
@@ -469,6 +942,28 @@ static void gfxcon_write_char (FileDesc *f, uint8_t c)
         break;
       case '[': // enter CSI mode 
         self->mode = MODE_CSI;
+        self->csilen = 0;
+        self->csi_overflow = false;
+        break;
+      case '7': // DECSC
+        gfxcondev_save_cursor (self);
+        self->mode = MODE_NORMAL;
+        break;
+      case '8': // DECRC
+        gfxcondev_restore_cursor (self);
+        self->mode = MODE_NORMAL;
+        break;
+      case 'D': // IND
+        gfxcon_write_lf (f);
+        self->mode = MODE_NORMAL;
+        break;
+      case 'E': // NEL
+        gfxcon_write_newline (f);
+        self->mode = MODE_NORMAL;
+        break;
+      case 'M': // RI
+        gfxcon_write_ri (f);
+        self->mode = MODE_NORMAL;
         break;
       default:
         self->mode = MODE_NORMAL; // Generally, just ignore the char
@@ -521,7 +1016,9 @@ int gfxcon_write (FileDesc *f, const void *buffer, int len)
     {
     gfxcon_write_char (f, ((uint8_t *)buffer)[i]);
     }
-  gfxcondev_cursor_show (self, true); // TODO -- cursor may be hidden
+  gfxcondev_flush (self);
+  if (self->cursor_visible)
+    gfxcondev_cursor_show (self, true);
   return len;
   }
 
@@ -540,20 +1037,39 @@ Error gfxcon_close (FileDesc *f)
 * ==========================================================================*/
 void gfxcondev_alloc_buffers (GfxConDev *self)
   {
-  if (self->glyph_buffer) free (self->glyph_buffer);
+  // Glyphs are cached by pixel size, but there's no point keeping
+  //   glyphs for a pixel format that the hardware no longer uses
+  if (self->glyph_cache) 
+    glyphcache_clear (self->glyph_cache);
+  else
+    self->glyph_cache = glyphcache_create (GLYPH_CACHE_BUDGET);
 
-#if PICO_ON_DEVICE
   DevCtlGfxProps gfx_props;
   self->gfx_file_desc->devctl 
-        (self->gfx_file_desc, DC_GFX_GET_PROPS, (int32_t)&gfx_props);      
+        (self->gfx_file_desc, DC_GFX_GET_PROPS, (intptr_t)&gfx_props);      
   self->bytes_pp = gfx_util_get_bytes_pp (gfx_props.colmode);
-#else
-  self->bytes_pp = 2;
-#endif
 
-  size_t glyph_buffer_size = (size_t)(self->font_width * 
-          self->font_height * self->bytes_pp);
-  self->glyph_buffer = malloc (glyph_buffer_size);
+  // The text size might have changed, so the grid is reallocated, and
+  //   set to match the screen, which the caller will clear
+  free (self->cells);
+  free (self->shown);
+  free (self->dirty_lo);
+  free (self->dirty_hi);
+  free (self->span_buff);
+  self->cells = NULL;
+  self->grid_rows = self->temp_rows;
+  self->grid_cols = self->temp_cols;
+  self->scroll_top = 0;
+  self->scroll_bottom = self->grid_rows - 1;
+  if (self->grid_rows <= 0 || self->grid_cols <= 0) return;
+  size_t ncells = (size_t)(self->grid_rows * self->grid_cols);
+  self->cells = malloc (ncells * sizeof (GfxConCell));
+  self->shown = malloc (ncells * sizeof (GfxConCell));
+  self->dirty_lo = malloc ((size_t)self->grid_rows * sizeof (int16_t));
+  self->dirty_hi = malloc ((size_t)self->grid_rows * sizeof (int16_t));
+  self->span_buff = malloc ((size_t)(SPAN_CELLS * self->font_width 
+    * self->font_height * self->bytes_pp));
+  gfxcondev_grid_clear (self);
   }
 
 /*============================================================================
@@ -599,13 +1115,28 @@ void gfxcondev_set_cursor (GfxConDev *self, int row, int col)
   if (col >= self->temp_cols) col = self->temp_cols - 1;
   self->row = row;
   self->col = col;
-#if PICO_ON_DEVICE
-#else
-  printf ("gfxcondev set cursor r=%d c=%d\n", row, col);
-#endif
   // TODO show cursor
   }
 
+/*============================================================================
+ * gfxcondev_save_cursor
+* ==========================================================================*/
+void gfxcondev_save_cursor (GfxConDev *self)
+  {
+  self->saved_row = self->row;
+  self->saved_col = self->col;
+  self->saved_attr = self->attr;
+  }
+
+/*============================================================================
+ * gfxcondev_restore_cursor
+* ==========================================================================*/
+void gfxcondev_restore_cursor (GfxConDev *self)
+  {
+  gfxcondev_set_cursor (self, self->saved_row, self->saved_col);
+  self->attr = self->saved_attr;
+  }
+
 /*============================================================================
  * gfxcondev_cursor_up
 * ==========================================================================*/
@@ -693,38 +1224,42 @@ void gfxcondev_cursor_show (const GfxConDev *self, bool visible)
   else
     colour = 0;
 
-#if PICO_ON_DEVICE
-    DevCtlGfxRegion region;
-    region.x = self->col * self->font_width; 
-    region.y = self->row * self->row_height + self->font_height; 
-    region.cx = self->font_width; 
-    region.cy = CURSOR_HEIGHT; 
-    self->gfx_file_desc->devctl (self->gfx_file_desc, DC_GFX_SET_REGION, 
-      (int32_t)&region);
-    self->gfx_file_desc->devctl (self->gfx_file_desc, DC_GFX_FILL, 
-      (int32_t)&colour);
-#else
-  (void)colour; (void)self;
-#endif
+  DevCtlGfxRegion region;
+  region.x = self->col * self->font_width; 
+  region.y = self->row * self->row_height + self->font_height; 
+  region.cx = self->font_width; 
+  region.cy = CURSOR_HEIGHT; 
+  self->gfx_file_desc->devctl (self->gfx_file_desc, DC_GFX_SET_REGION, 
+    (intptr_t)&region);
+  self->gfx_file_desc->devctl (self->gfx_file_desc, DC_GFX_FILL, 
+    (intptr_t)&colour);
   }
 
 /*============================================================================
  * gfxcondev_clear_screen
- * TODO: 'what' is not yet implemented
+ * Clearing the whole screen is done by the device, which also resets the
+ *   hardware scroll. Partial clears go through the grid.
 * ==========================================================================*/
 void gfxcondev_clear_screen (GfxConDev *self, int what)
   {
-#if PICO_ON_DEVICE
-  if (what == 2)
+  switch (what)
     {
-    self->gfx_file_desc->devctl 
+    case 0:
+      gfxcondev_grid_erase (self, self->row, self->col, self->temp_cols - 1);
+      for (int r = self->row + 1; r < self->temp_rows; r++)
+        gfxcondev_grid_erase (self, r, 0, self->temp_cols - 1);
+      break;
+    case 1:
+      for (int r = 0; r < self->row; r++)
+        gfxcondev_grid_erase (self, r, 0, self->temp_cols - 1);
+      gfxcondev_grid_erase (self, self->row, 0, self->col);
+      break;
+    case 2:
+      self->gfx_file_desc->devctl 
         (self->gfx_file_desc, DC_GFX_RESET_AND_CLEAR, 0);      
+      gfxcondev_grid_clear (self);
+      break;
     }
-#else
-  printf ("gfxcondev clear screen\n");
-#endif
-
-  gfxcondev_cursor_show (self, true);
   }
 
 /*============================================================================
@@ -737,12 +1272,20 @@ void gfxcondev_full_reset (GfxConDev *self)
   self->tab_size = 8;
   self->mode = 0;
   self->csilen = 0;
+  self->attr = 0;
+  self->cursor_visible = true;
+  self->scroll_top = 0;
+  self->scroll_bottom = self->grid_rows - 1;
+  self->saved_row = 0;
+  self->saved_col = 0;
+  self->saved_attr = 0;
   gfxcondev_clear_screen (self, 2);
   //set_cursor could fail here, because it constrains the cursor pos to
   //  (temp_rows, temp_cols), which may not have been set at this point
   //gfxcondev_set_cursor (self, 0, 0);
   self->row = 0;
   self->col = 0;
+  gfxcondev_cursor_show (self, true);
   }
 
 /*============================================================================
@@ -772,13 +1315,14 @@ void gfxcondev_adjust_to_hardware (GfxConDev *self)
 
   DevCtlGfxProps gfx_props;
   self->gfx_file_desc->devctl 
-        (self->gfx_file_desc, DC_GFX_GET_PROPS, (int32_t)&gfx_props);      
+        (self->gfx_file_desc, DC_GFX_GET_PROPS, (intptr_t)&gfx_props);      
   self->bytes_pp = gfx_util_get_bytes_pp (gfx_props.colmode);
 
   // TODO -- we need a way to change font at runtime
-  self->font = &Font16;
-  self->font_width = self->font->Width;
-  self->font_height = self->font->Height;
+  self->font = &GFXCON_FONT;
+  self->font_scale = GFXCON_FONT_SCALE;
+  self->font_width = self->font->width * self->font_scale;
+  self->font_height = self->font->height * self->font_scale;
   self->row_height = self->font_height + CURSOR_HEIGHT;
 
   gfxcondev_get_text_size (self, &(self->temp_rows), &(self->temp_cols),
@@ -791,11 +1335,21 @@ void gfxcondev_adjust_to_hardware (GfxConDev *self)
   gfx_props.width = actual_width;
   gfx_props.height = actual_height;
   self->gfx_file_desc->devctl 
-        (self->gfx_file_desc, DC_GFX_SET_USED_AREA, (int32_t)&gfx_props);      
-  self->glyph_buffer = NULL;
+        (self->gfx_file_desc, DC_GFX_SET_USED_AREA, (intptr_t)&gfx_props);      
   self->row = 0;
   self->col = 0;
   gfxcondev_alloc_buffers (self); 
+
+  // A copy of nothing fails if the device can't copy at all
+  DevCtlGfxDrawCmd cmd;
+  memset (&cmd, 0, sizeof (cmd));
+  cmd.op = DC_GFX_OP_COPY_RECT;
+  DevCtlGfxDrawList list;
+  memset (&list, 0, sizeof (list));
+  list.cmds = &cmd;
+  list.count = 1;
+  self->can_copy_rect = self->gfx_file_desc->devctl (self->gfx_file_desc, 
+    DC_GFX_DRAW, (intptr_t)&list) == 0;
   }
 
 /*============================================================================
@@ -817,6 +1371,9 @@ GfxConDev *gfxcondev_new (const char *name, DevDescriptor *gfxdevdesc)
   self->tab_size = 8;
   self->mode = 0;
   self->csilen = 0;
+  self->fg = 0xFFFFFFFF; // TODO user back/fore colours
+  self->bg = 0;
+  self->cursor_visible = true;
   return self;
   }
 
@@ -826,7 +1383,12 @@ GfxConDev *gfxcondev_new (const char *name, DevDescriptor *gfxdevdesc)
 void gfxcondev_destroy (GfxConDev *self)
   {
   self->gfx_file_desc->close (self->gfx_file_desc);
-  if (self->glyph_buffer) free (self->glyph_buffer);
+  if (self->glyph_cache) glyphcache_destroy (self->glyph_cache);
+  free (self->cells);
+  free (self->shown);
+  free (self->dirty_lo);
+  free (self->dirty_hi);
+  free (self->span_buff);
   free (self->desc);
   free (self);
   }
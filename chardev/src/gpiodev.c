@@ -20,6 +20,7 @@
 #include <errno.h>
 #include <fatfs_loopback/fatloopback.h>
 #include <chardev/gpiodev.h>
+#include <chardev/picoconsoledev.h>
 
 struct _GPIODev
   {
@@ -52,6 +53,12 @@ int gpiodev_write (FileDesc *f, const void *buffer, int len)
   if (len < 4)
     return -EINVAL;
    
+#if !PICO_ON_DEVICE
+  // The host build reports GPIO operations on stdout, after any console
+  //   output that is waiting
+  picoconsoledev_flush ();
+#endif
+
   char s_pin[3];
   s_pin[0] = ((char *)buffer)[2]; 
   s_pin[1] = ((char *)buffer)[3]; 
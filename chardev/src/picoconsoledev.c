@@ -16,10 +16,14 @@
 #include <bearos/devctl.h>
 #include <bearos/terminal.h>
 #if PICO_ON_DEVICE
+#include <pico/sync.h>
+// The stdio driver's output function, from the Pico SDK
+extern int _write (int handle, char *buffer, int length);
 #else
 #include <termios.h>
 #include <unistd.h>
 #include <fcntl.h>
+#include <poll.h>
 #include <errno.h>
 static struct termios orig_termios;
 #endif
@@ -30,12 +34,58 @@ static struct termios orig_termios;
 #include <fatfs_loopback/fatloopback.h>
 #include <chardev/picoconsoledev.h>
 
+// Size of the receive buffer. It must be a power of two. It only has to 
+//   hold what arrives while nothing is reading the console, but that
+//   might be a whole pasted file.
+#define PICOCONSOLE_RX_SIZE 1024
+#define PICOCONSOLE_RX_MASK (PICOCONSOLE_RX_SIZE - 1)
+
+// Size of the transmit buffer. Small writes are collected here, and 
+//   passed to the stdio driver in one call when a line is complete,
+//   when the buffer is full, before waiting for input, when the console
+//   is polled for an interrupt, and at the first write or system call
+//   after PICOCONSOLE_TX_DELAY_MS. All of these are in thread context: 
+//   the stdio driver takes a mutex, which can't be waited for in an IRQ.
+//   So, on the device, the timer that marks the delay only sets a flag.
+#define PICOCONSOLE_TX_SIZE 256
+#define PICOCONSOLE_TX_DELAY_MS 20
+
+#if PICO_ON_DEVICE
+// The longest we wait without looking at stdio ourselves. It should never
+//   matter, because the chars-available callback wakes the reader. But
+//   it protects against a driver that does not call it
+#define PICOCONSOLE_WAIT_SLICE_MS 50
+#endif
+
 // Nasty end-of-input flag, which is global because I've been tool lazy
 //   to define a specific object for each file which is based on this
 //   driver. Still, there is only one console, so we might get away 
 //   with it.
 static bool eoi = false;
 
+// The receive ring buffer. It is filled at rx_head, by the stdio 
+//   callback on the device, and emptied at rx_tail by the reader. The 
+//   indices run freely, and are masked when used.
+static uint8_t rx_buff[PICOCONSOLE_RX_SIZE];
+static volatile uint32_t rx_head = 0;
+static volatile uint32_t rx_tail = 0;
+
+#if PICO_ON_DEVICE
+// Released whenever data arrives in the ring
+static semaphore_t rx_sem;
+#endif
+
+// The transmit buffer, and the time the oldest data in it was written
+static char tx_buff[PICOCONSOLE_TX_SIZE];
+static int tx_len = 0;
+static uint64_t tx_since = 0;
+
+#if PICO_ON_DEVICE
+// Set by the timer every PICOCONSOLE_TX_DELAY_MS, and cleared by a flush
+static repeating_timer_t tx_timer;
+static volatile bool tx_due = false;
+#endif
+
 struct _PicoConsoleDev
   {
   char *name;
@@ -44,68 +94,251 @@ struct _PicoConsoleDev
   };
 
 /*============================================================================
- * picoconsolede_read
-* ==========================================================================*/
-int picoconsole_read (FileDesc *f, void *buffer, int len)
+ * picoconsole_rx_count
+ * ==========================================================================*/
+static inline uint32_t picoconsole_rx_count (void)
   {
-  PicoConsoleDev *self = f->self;
-  if (eoi) return 0;
-  for (int i = 0; i < len; i++)
+  return rx_head - rx_tail;
+  }
+
+/*============================================================================
+ * picoconsole_rx_get
+ * Take one byte from the ring, which must not be empty
+ * ==========================================================================*/
+static inline int picoconsole_rx_get (void)
+  {
+  int c = rx_buff[rx_tail & PICOCONSOLE_RX_MASK];
+  rx_tail = rx_tail + 1;
+  return c;
+  }
+
+#if PICO_ON_DEVICE
+/*============================================================================
+ * picoconsole_rx_fill
+ * Move whatever the stdio driver has received into the ring. This is 
+ * called from the chars-available callback, in interrupt context, and
+ * by the reader with interrupts disabled, so there is never more than
+ * one writer.
+ * ==========================================================================*/
+static void picoconsole_rx_fill (void)
+  {
+  while (picoconsole_rx_count () < PICOCONSOLE_RX_SIZE)
+    {
+    int c = getchar_timeout_us (0);
+    if (c < 0) break;
+    rx_buff[rx_head & PICOCONSOLE_RX_MASK] = (uint8_t)c;
+    rx_head = rx_head + 1;
+    }
+  }
+
+/*============================================================================
+ * picoconsole_chars_available
+ * The stdio chars-available callback. If the ring is full, the 
+ * remaining data stays in the driver until a reader makes room.
+ * ==========================================================================*/
+static void picoconsole_chars_available (void *param)
+  {
+  (void)param;
+  picoconsole_rx_fill ();
+  if (picoconsole_rx_count () > 0) sem_release (&rx_sem);
+  }
+
+/*============================================================================
+ * picoconsole_rx_wait
+ * Wait up to msec milliseconds (forever, if msec is negative) for the ring
+ * to contain data. Returns false on timeout.
+ * ==========================================================================*/
+static bool picoconsole_rx_wait (int msec)
+  {
+  absolute_time_t until = msec < 0 ? at_the_end_of_time 
+    : make_timeout_time_ms ((uint32_t)msec);
+  for (;;)
+    {
+    uint32_t save = save_and_disable_interrupts ();
+    picoconsole_rx_fill ();
+    restore_interrupts (save);
+    if (picoconsole_rx_count () > 0) return true;
+    if (time_reached (until)) return false;
+
+    absolute_time_t slice = make_timeout_time_ms (PICOCONSOLE_WAIT_SLICE_MS);
+    if (absolute_time_diff_us (slice, until) < 0) slice = until; 
+    sem_acquire_block_until (&rx_sem, slice);
+    }
+  }
+#else
+/*============================================================================
+ * picoconsole_rx_wait
+ * Wait up to msec milliseconds (forever, if msec is negative) for the ring
+ * to contain data, and read everything that is available from stdin
+ * into it. Returns false on timeout, or at the end of stdin.
+ * ==========================================================================*/
+static bool picoconsole_rx_wait (int msec)
+  {
+  if (picoconsole_rx_count () > 0) return true;
+
+  struct pollfd pfd;
+  pfd.fd = STDIN_FILENO;
+  pfd.events = POLLIN;
+  pfd.revents = 0;
+  int r;
+  while ((r = poll (&pfd, 1, msec)) < 0 && errno == EINTR) {}
+  if (r <= 0) return false;
+
+  // The ring is empty, so the whole of it can be filled in one read
+  rx_head = rx_tail = 0;
+  ssize_t n = read (STDIN_FILENO, rx_buff, PICOCONSOLE_RX_SIZE);
+  if (n <= 0) 
+    {
+    // stdin is readable but empty -- it has been closed
+    eoi = true;
+    return false;
+    }
+  rx_head = (uint32_t)n;
+  return true;
+  }
+#endif
+
+/*============================================================================
+ * picoconsole_tx_raw
+ * Pass data to the stdio driver. On the device, this bypasses the C
+ * library's FILE buffering, which would only buffer it again.
+ * ==========================================================================*/
+static void picoconsole_tx_raw (const char *data, int len)
+  {
+#if PICO_ON_DEVICE
+  _write (1, (char *)data, len);
+#else
+  fwrite (data, 1, (size_t)len, stdout);
+  fflush (stdout);
+#endif
+  }
+
+/*============================================================================
+ * picoconsole_tx_flush_buff
+ * Pass the transmit buffer to the stdio driver in one call
+ * ==========================================================================*/
+static void picoconsole_tx_flush_buff (void)
+  {
+#if PICO_ON_DEVICE
+  tx_due = false;
+#endif
+  if (tx_len > 0)
     {
-    int c;
+    picoconsole_tx_raw (tx_buff, tx_len);
+    tx_len = 0;
+    }
+  }
+
 #if PICO_ON_DEVICE
-    while ((c = getchar_timeout_us (0)) < 0)
-      {
-      // gpio_put (LED_PIN, 1);
-      // sleep_ms (50);
-      // gpio_put (LED_PIN, 0);
-      sleep_ms (1);
-      }
-    if (c == I_EOI) { eoi = true; return i; }
-    ((char *)buffer)[i] = (char)c;
-    if (c == I_EOL) { return i + 1; } // TODO
+/*============================================================================
+ * picoconsole_tx_timer
+ * The repeating timer callback. It runs in an IRQ, so it must not flush.
+ * ==========================================================================*/
+static bool picoconsole_tx_timer (repeating_timer_t *rt)
+  {
+  (void)rt;
+  tx_due = true;
+  return true;
+  }
+#endif
+
+/*============================================================================
+ * picoconsole_tx_is_due
+ * Returns true if the buffered output has waited long enough
+ * ==========================================================================*/
+static inline bool picoconsole_tx_is_due (void)
+  {
+#if PICO_ON_DEVICE
+  return tx_due;
 #else
-    while ((c = getchar()) < 0)
-      {
-      if (c == 0) return 0;
-      sleep_ms (10);
-      }
-    if (c == I_EOI) { eoi = true; return i; }
-    ((char *)buffer)[i] = (char)c;
+  return time_us_64 () - tx_since > PICOCONSOLE_TX_DELAY_MS * 1000;
 #endif
-    if (!(self->flags & DC_TERM_FLAG_NOECHO)) putchar (c);
+  }
+
+/*============================================================================
+ * picoconsoledev_poll
+ * ==========================================================================*/
+void picoconsoledev_poll (void)
+  {
+  if (tx_len > 0 && picoconsole_tx_is_due ()) 
+    picoconsole_tx_flush_buff ();
+  }
+
+/*============================================================================
+ * picoconsoledev_flush
+ * ==========================================================================*/
+void picoconsoledev_flush (void)
+  {
+  picoconsole_tx_flush_buff ();
+  }
+
+/*============================================================================
+ * picoconsole_tx_put
+ * ==========================================================================*/
+static void picoconsole_tx_put (const char *data, int len)
+  {
+  // Output that has been waiting too long is flushed when more arrives.
+  //   Output that nothing follows is flushed when the program next
+  //   makes a system call, or reads the console.
+  picoconsoledev_poll ();
+  if (tx_len + len > PICOCONSOLE_TX_SIZE)
+    picoconsole_tx_flush_buff ();
+  if (len >= PICOCONSOLE_TX_SIZE)
+    {
+    // Too big to be worth copying
+    picoconsole_tx_raw (data, len);
+    }
+  else
+    {
+    if (tx_len == 0) tx_since = time_us_64 ();
+    memcpy (tx_buff + tx_len, data, (size_t)len);
+    tx_len += len;
+    if (memchr (data, '\n', (size_t)len)) 
+      picoconsole_tx_flush_buff ();
     }
-  return len;
   }
 
 /*============================================================================
- * picoconsolede_read_timeout
+ * picoconsolede_read
+ * Wait for some input, then return all that has been received, up to
+ * len bytes, or up to the end of a line.
 * ==========================================================================*/
-int picoconsole_read_timeout (FileDesc *f, int msec)
+int picoconsole_read (FileDesc *f, void *buffer, int len)
   {
   PicoConsoleDev *self = f->self;
-  
-  int c;
-#if PICO_ON_DEVICE
-  int loops = 0;
-  while ((c = getchar_timeout_us (0)) < 0 && loops < msec)
+  if (eoi) return 0;
+  picoconsoledev_flush ();
+  if (len <= 0 || !picoconsole_rx_wait (-1)) return 0;
+
+  char *b = buffer;
+  int i = 0;
+  while (i < len && picoconsole_rx_count () > 0)
     {
-    sleep_us (1000);
-    loops++;
+    int c = picoconsole_rx_get ();
+    if (c == I_EOI) { eoi = true; break; }
+    b[i++] = (char)c;
+    if (c == I_EOL) break; 
     }
-  return c;
-#else
-  (void)msec; (void)self;
-  int loops = 0;
-  while ((c = getchar ()) < 0 && loops < msec)
+  if (i > 0 && !(self->flags & DC_TERM_FLAG_NOECHO))
     {
-    usleep (1000);
-    loops++;
+    picoconsole_tx_put (b, i);
+    picoconsoledev_flush ();
     }
-#endif
+  return i;
+  }
+
+/*============================================================================
+ * picoconsolede_read_timeout
+ * Returns one character, or -1 if none arrives within msec milliseconds
+* ==========================================================================*/
+int picoconsole_read_timeout (FileDesc *f, int msec)
+  {
+  (void)f;
+  picoconsoledev_flush ();
+  if (!picoconsole_rx_wait (msec)) return -1;
   // NOT SURE ABOUT THIS...
   //if (!(self->flags & DC_TERM_FLAG_NOECHO)) putchar (c);
-  return c;
+  return picoconsole_rx_get ();
   }
 
 /*============================================================================
@@ -114,8 +347,7 @@ int picoconsole_read_timeout (FileDesc *f, int msec)
 int picoconsole_write (FileDesc *f, const void *buffer, int len)
   {
   (void)f;
-  for (int i = 0; i < len; i++)
-    putchar (((char *)buffer)[i]);
+  if (len > 0) picoconsole_tx_put (buffer, len);
   return len;
   }
 
@@ -124,6 +356,7 @@ int picoconsole_write (FileDesc *f, const void *buffer, int len)
 * ==========================================================================*/
 Error picoconsole_close (FileDesc *f)
   {
+  picoconsoledev_flush ();
   eoi = false;
   free (f);
   return 0;
@@ -189,6 +422,10 @@ PicoConsoleDev *picoconsoledev_new (const char *name)
   self->flags = DC_TERM_FLAG_ECHO;
 
 #if PICO_ON_DEVICE
+  sem_init (&rx_sem, 0, 1);
+  stdio_set_chars_available_callback (picoconsole_chars_available, NULL);
+  add_repeating_timer_ms (PICOCONSOLE_TX_DELAY_MS, picoconsole_tx_timer, 
+    NULL, &tx_timer);
 #else
   tcgetattr (STDIN_FILENO, &orig_termios);
   struct termios raw = orig_termios;
@@ -208,6 +445,11 @@ PicoConsoleDev *picoconsoledev_new (const char *name)
 void picoconsoledev_destroy (PicoConsoleDev *self)
   {
 #if PICO_ON_DEVICE
+  cancel_repeating_timer (&tx_timer);
+#endif
+  picoconsoledev_flush ();
+#if PICO_ON_DEVICE
+  stdio_set_chars_available_callback (NULL, NULL);
 #else
   tcsetattr (STDIN_FILENO, TCSAFLUSH, &orig_termios);
 #endif
@@ -20,6 +20,7 @@
 #include <errno.h>
 #include <chardev/wslcddev.h>
 #include <waveshare_lcd/waveshare_lcd.h>
+#include <gfx/gfxdraw.h>
 
 struct _WSLCDDev
   {
@@ -86,35 +87,38 @@ Error wslcddev_devctl (FileDesc *f, intptr_t arg1, intptr_t arg2)
 
     case DC_GFX_SET_REGION:
       DevCtlGfxRegion *region = (DevCtlGfxRegion *)arg2;
-#if PICO_ON_DEVICE
       wslcd_set_window (self->wslcd, (uint16_t) region->x, 
         (uint16_t) region->y, 
         (uint16_t)(region->x + region->cx), 
         (uint16_t) (region->y + region->cy));
-#endif
       self->expected_bytes = region->cx * region->cy;
       return 0;
 
     case DC_GFX_FILL:
-#if PICO_ON_DEVICE
+      // The fill carries on in the background; the next operation on the
+      //   panel will wait for it
       DevCtlGfxColour *colour = (DevCtlGfxColour *)arg2;
       uint16_t rgb = colour->rgb565; // This device only supports RGB565
       wslcd_send_repeated_word (self->wslcd, rgb, self->expected_bytes);
-#endif
       self->expected_bytes = 0; 
       return 0;
 
     case DC_GFX_SCROLL_UP:
-#if PICO_ON_DEVICE
       wslcd_scroll_up (self->wslcd, (uint16_t)arg2);
-#endif
       return 0;
 
     case DC_GFX_WRITE:
       DevCtlGfxWrite *wr = (DevCtlGfxWrite *)arg2;
-      Error ret = wslcddev_write (f, wr->buffer, wr->length);
+      wslcddev_write (f, wr->buffer, wr->length);
       self->expected_bytes = 0; 
-      return ret;
+      return 0;
+
+    case DC_GFX_DRAW:
+      // The panel's memory can be read, but only slowly, so there is no
+      //   copy-rect
+      return gfxdraw_run (f, wslcd_get_width (self->wslcd), 
+        wslcd_get_height (self->wslcd), (DevCtlGfxDrawList *)arg2, 
+        NULL, NULL);
 
     case DC_GET_GEN_FLAGS:
       *((int32_t *)arg2) = DC_FLAG_ISGFX;
@@ -145,6 +149,7 @@ FileDesc *wslcddev_get_file_desc (DevDescriptor *dev_desc)
 WSLCDDev *wslcddev_new (const char *name)
   {
   WSLCDDev *self = malloc (sizeof (WSLCDDev));
+  memset (self, 0, sizeof (WSLCDDev));
   DevDescriptor *desc = malloc (sizeof (DevDescriptor));
   memset (desc, 0, sizeof (DevDescriptor));
   self->desc = desc;
@@ -173,6 +178,15 @@ DevDescriptor *wslcddev_get_desc (WSLCDDev *self)
   return self->desc;
   }
 
+/*============================================================================
+ * wslcddev_bus_fence
+ * ==========================================================================*/
+void wslcddev_bus_fence (void *self)
+  {
+  WSLCDDev *dev = self;
+  if (dev->wslcd) wslcd_wait (dev->wslcd);
+  }
+
 /*============================================================================
  * wslcddev_init
  * ==========================================================================*/
@@ -1,63 +1,35 @@
-/*
+/*============================================================================
+ *  compat/re.h
  *
- * Mini regex-module inspired by Rob Pike's regex code described in:
+ *  The interface of the old tiny-regex module, kept for code that uses
+ *  it. It is now a thin layer over klib/regex.h, so it accepts the full
+ *  syntax documented there, and matches in linear time. As before, there
+ *  is only one compiled pattern at a time: each call to re_compile()
+ *  replaces the last one.
  *
- * http://www.cs.princeton.edu/courses/archive/spr09/cos333/beautiful.html
- *
- *
- *
- * Supports:
- * ---------
- *   '.'        Dot, matches any character
- *   '^'        Start anchor, matches beginning of string
- *   '$'        End anchor, matches end of string
- *   '*'        Asterisk, match zero or more (greedy)
- *   '+'        Plus, match one or more (greedy)
- *   '?'        Question, match zero or one (non-greedy)
- *   '[abc]'    Character class, match if one of {'a', 'b', 'c'}
- *   '[^abc]'   Inverted class, match if NOT one of {'a', 'b', 'c'} -- NOTE: feature is currently broken!
- *   '[a-zA-Z]' Character ranges, the character set of the ranges { a-z | A-Z }
- *   '\s'       Whitespace, \t \f \r \n \v and spaces
- *   '\S'       Non-whitespace
- *   '\w'       Alphanumeric, [a-zA-Z0-9_]
- *   '\W'       Non-alphanumeric
- *   '\d'       Digits, [0-9]
- *   '\D'       Non-digits
- *
- *
- */
+ * Copyright (c)2023 Kevin Boone, GPL v3.0
+ * ==========================================================================*/
 
 #ifndef _TINY_REGEX_C
 #define _TINY_REGEX_C
 
-
-#ifndef RE_DOT_MATCHES_NEWLINE
-/* Define to 0 if you DON'T want '.' to match '\r' + '\n' */
-#define RE_DOT_MATCHES_NEWLINE 1
-#endif
-
 #ifdef __cplusplus
 extern "C"{
 #endif
 
-
-
 /* Typedef'd pointer to get abstract datatype. */
 typedef struct regex_t* re_t;
 
-
-/* Compile regex string pattern to a regex_t-array. */
+/* Compile regex string pattern. Returns NULL if the pattern is invalid. */
 re_t re_compile(const char* pattern);
 
-
-/* Find matches of the compiled pattern inside text. */
+/* Find matches of the compiled pattern inside text. Returns the position
+   of the leftmost match, or -1, and sets *matchlength. */
 int re_matchp(re_t pattern, const char* text, int* matchlength);
 
-
 /* Find matches of the txt pattern inside text (will compile automatically first). */
 int re_match(const char* pattern, const char* text, int* matchlength);
 
-
 #ifdef __cplusplus
 }
 #endif
@@ -18,6 +18,52 @@
 #include <sys/syscalls.h>
 #include <compat/compat.h>
 
+// Size of the buffer that compat_printf() formats into. Longer output
+//   is formatted into a temporary heap buffer instead
+#define COMPAT_PRINTF_BUFF_SIZE 256
+
+static char printf_buff[COMPAT_PRINTF_BUFF_SIZE];
+// Set while printf_buff is in use, in case compat_printf() is somehow
+//   re-entered while writing
+static bool printf_busy = false;
+
+/*=========================================================================
+  compat_vprintf_fd
+=========================================================================*/
+static void compat_vprintf_fd (int fd, const char *fmt, va_list ap)
+  {
+  if (printf_busy)
+    {
+    char *s;
+    int n = vasprintf (&s, fmt, ap);
+    if (n >= 0)
+      {
+      sys_write (fd, s, n); 
+      free (s);
+      }
+    return;
+    }
+
+  printf_busy = true;
+  va_list ap2;
+  va_copy (ap2, ap);
+  int n = vsnprintf (printf_buff, sizeof (printf_buff), fmt, ap);
+  if (n >= (int)sizeof (printf_buff))
+    {
+    char *s = malloc ((size_t)n + 1);
+    if (s)
+      {
+      vsnprintf (s, (size_t)n + 1, fmt, ap2);
+      sys_write (fd, s, n); 
+      free (s);
+      }
+    }
+  else if (n > 0)
+    sys_write (fd, printf_buff, n); 
+  va_end (ap2);
+  printf_busy = false;
+  }
+
 /*=========================================================================
   compat_printf
 =========================================================================*/
@@ -25,10 +71,7 @@ void compat_printf (const char *fmt, ...)
   {
   va_list ap;
   va_start (ap, fmt);
-  char *s;
-  int n = vasprintf (&s, fmt, ap);
-  sys_write (1, s, n); 
-  free (s);
+  compat_vprintf_fd (1, fmt, ap);
   va_end (ap);
   }
 
@@ -39,12 +82,7 @@ void compat_printf_stderr (const char *fmt, ...)
   {
   va_list ap;
   va_start (ap, fmt);
-  char *s;
-  int n = vasprintf (&s, fmt, ap);
-  sys_write (2, s, n); 
-  free (s);
+  compat_vprintf_fd (2, fmt, ap);
   va_end (ap);
   }
 
-
-
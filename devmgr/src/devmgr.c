@@ -12,18 +12,26 @@
 #include <string.h>
 #include <pico/stdlib.h>
 #include <stdio.h>
+#include <klib/hashmap.h>
 #include <devmgr/devmgr.h>
 
 static int numdevs = 0;
 
 static DevDescriptor *devs[DEVMGR_MAX_DEVS];
 
+// Device names are case-insensitive. The map's keys are the names in
+//   the device descriptors themselves.
+static HashMap *devs_by_name = NULL;
+
 /*============================================================================
  * devmgr_init 
  * ==========================================================================*/
 void devmgr_init (void)
   {
   memset (devs, 0, sizeof (devs));
+  numdevs = 0;
+  if (devs_by_name) hashmap_destroy (devs_by_name);
+  devs_by_name = hashmap_create_strings (TRUE, NULL);
   }
 
 /*============================================================================
@@ -31,16 +39,19 @@ void devmgr_init (void)
  * ==========================================================================*/
 void devmgr_deinit (void)
   {
+  if (devs_by_name) hashmap_destroy (devs_by_name);
+  devs_by_name = NULL;
   }
 
 /*============================================================================
- * devmgr_deinit 
+ * devmgr_register
  * ==========================================================================*/
 void devmgr_register (DevDescriptor *desc)
   {
-  // TODO check bounds
+  if (numdevs >= DEVMGR_MAX_DEVS) return; 
   devs[numdevs] = desc;
   numdevs++;
+  hashmap_put (devs_by_name, desc->name, desc);
   }
 
 /*============================================================================
@@ -48,14 +59,8 @@ void devmgr_register (DevDescriptor *desc)
  * ==========================================================================*/
 DevDescriptor *devmgr_find_descriptor (const char *name)
   {
-  for (int i = 0; i < DEVMGR_MAX_DEVS; i++)
-    {
-    if (devs[i])
-      {
-      if (strcasecmp (devs[i]->name, name) == 0) return devs[i];
-      }
-    }
-  return 0;
+  if (!devs_by_name) return 0;
+  return hashmap_get (devs_by_name, name);
   }
 
 /*============================================================================
@@ -11,9 +11,11 @@
 
 #pragma once
 
-#include <pico/stdlib.h>
+#include <stdint.h>
+#include <stdbool.h>
 
 #if PICO_ON_DEVICE
+#include <pico/stdlib.h>
 #include <hardware/i2c.h>
 #endif
 
@@ -47,12 +49,49 @@
 //   common choice, but not universal.
 #define I2C_LCD_BACKLIGHT 0x08
 
-// Length of time in microseconds to pulse the enable line. In reality the
-//   time will be a bit longer, because of the I2C protocol overhead
-#define I2C_LCD_DELAY 600
+// Length of time in microseconds to wait after a clear or home command,
+//   which take the panel 1.52ms. Other commands take 37us, which is less
+//   than the time it takes to send the next one on the I2C bus.
+#define I2C_LCD_CLEAR_DELAY 2000
+
+// Length of time in microseconds to wait after each of the commands that
+//   put the panel into 4-bit mode
+#define I2C_LCD_INIT_DELAY 5000
 
 typedef struct _I2C_LCD I2C_LCD;
 
+#if PICO_ON_DEVICE
+#else
+/*============================================================================
+ * I2C_LCDMockBus
+ * In the host build, the bytes that would be written to the I2C bus go
+ * to a mock bus, if one has been set with i2c_lcd_set_mock_bus(). It
+ * counts writes, bytes, and the time they would take at baud_rate, and
+ * passes the bytes to an emulated HD44780, whose display memory is in
+ * ddram. 'instructions' counts the commands and characters the emulated
+ * panel receives, and 'errors' the ones that arrived while it was still
+ * busy, or with the data lines changing as the enable line fell.
+ * ==========================================================================*/
+typedef struct _I2C_LCDMockBus
+  {
+  uint32_t baud_rate;
+  uint32_t transactions;
+  uint32_t bytes;
+  uint32_t instructions;
+  uint32_t errors;
+  uint64_t bus_ns;
+  // Time spent waiting for slow commands
+  uint64_t wait_ns;
+  // The emulated panel
+  uint8_t ddram[128];
+  uint8_t address;
+  uint8_t pins;
+  uint8_t nibble;
+  bool half;
+  uint64_t busy_until_ns;
+  } I2C_LCDMockBus;
+#endif
+
 #ifdef __cplusplus
 extern "C" {
 #endif
@@ -63,6 +102,8 @@ extern I2C_LCD *i2c_lcd_new (int width, int height,
                int scrollback_pages);
 #else
 extern I2C_LCD *i2c_lcd_new (int width, int height);
+/** Start (or, with NULL, stop) sending to a mock bus. */
+extern void     i2c_lcd_set_mock_bus (I2C_LCD *self, I2C_LCDMockBus *bus);
 #endif 
 
 extern void     i2c_lcd_destroy (I2C_LCD* self);
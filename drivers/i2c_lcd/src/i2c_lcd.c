@@ -4,15 +4,23 @@
  *  For a description of the protocol, please see
  *  https://kevinboone.me/pi-lcd.html
  *
+ *  Nothing is sent to the panel as it is printed. Text goes into the
+ *  scrollback buffer, and then i2c_lcd_sync() compares the part of the
+ *  buffer that should be visible with a copy of what the panel's display
+ *  memory (DDRAM) holds, and sends only the characters that differ. The
+ *  bytes for the PCF8574 port expander are collected into a buffer, and
+ *  go out as a single I2C write.
+ *
  * Copyright (c)2022 Kevin Boone, GPL v3.0
  * ==========================================================================*/
 
 #include <stdio.h>
 #include <stdlib.h>
-#include <pico/stdlib.h>
+#include <stdint.h>
 #include <string.h>
 
 #if PICO_ON_DEVICE
+#include <pico/stdlib.h>
 #include <hardware/i2c.h>
 #include <hardware/gpio.h>
 #endif
@@ -59,14 +67,28 @@
 #define I2C_LCD_SET_CGRAM_ADDR 0x40
 #define I2C_LCD_SET_DDRAM_ADDR 0x80
 
+// The most bytes sent in one I2C write. Each character takes six, so
+//   this is a full row of a 40-column display, with its address.
+#define I2C_LCD_TX_SIZE 252
+
+// A clear command, with the wait after it, takes about as long to send as
+//   this many characters, at 100kHz. sync() uses it if the screen is
+//   mostly changing to blanks.
+#define I2C_LCD_CLEAR_COST 5
+
+// The host build has no scrollback setting
+#define I2C_LCD_HOST_SCROLLBACK_PAGES 4
 
-struct _I2C_LCD 
+struct _I2C_LCD
   {
   int width;
   int height;
 #if PICO_ON_DEVICE
   int addr;
-  i2c_inst_t *i2c;  
+  i2c_inst_t *i2c;
+#else
+  I2C_LCDMockBus *bus;
+#endif
   int curr_row;
   int curr_col;
   int scrollback_max_lines;
@@ -78,59 +100,203 @@ struct _I2C_LCD
   unsigned char offsets[I2C_LCD_MAX_ROWS];
   bool wrap;
   bool destructive_backspace;
-  bool implicit_lf; 
+  bool implicit_lf;
   unsigned char *scrollback_buffer;
-#endif
+  // The panel's DDRAM, as far as we know, one row after another
+  unsigned char *shown;
+  // The panel's DDRAM address counter, or -1 if we don't know it
+  int address;
+  // Bytes for the port expander, not yet sent
+  uint8_t tx[I2C_LCD_TX_SIZE];
+  int tx_len;
   };
 
-//#define MIN(x,y) (x < y ? x : y)
-
+#ifndef MIN
+#define MIN(x,y) (x < y ? x : y)
+#endif
 
 #if PICO_ON_DEVICE
 
 /*============================================================================
- * i2c_write_byte 
+ * i2c_bus_write
+ * ==========================================================================*/
+static void i2c_bus_write (const I2C_LCD *self, const uint8_t *data, int len)
+  {
+  i2c_write_blocking (self->i2c, (uint8_t)self->addr, data, (size_t)len,
+    false);
+  }
+
+/*============================================================================
+ * i2c_bus_wait
+ * ==========================================================================*/
+static void i2c_bus_wait (const I2C_LCD *self, int usec)
+  {
+  (void)self;
+  sleep_us ((uint64_t)usec);
+  }
+
+#else
+
+/*============================================================================
+ * mock_latch
+ * The emulated HD44780 has seen the enable line fall, with data lines d.
+ * ==========================================================================*/
+static void mock_latch (I2C_LCDMockBus *bus, uint8_t d, uint64_t now)
+  {
+  if (!bus->half)
+    {
+    bus->nibble = d & 0xF0;
+    bus->half = true;
+    return;
+    }
+  bus->half = false;
+  uint8_t b = (uint8_t)(bus->nibble | (d >> 4));
+  bus->instructions++;
+  if (now < bus->busy_until_ns) bus->errors++;
+  uint64_t busy = 37000;
+
+  if (d & I2C_LCD_RS)
+    {
+    bus->ddram[bus->address & 0x7F] = b;
+    if (bus->address == 0x27) bus->address = 0x40;
+    else if (bus->address == 0x67) bus->address = 0x00;
+    else bus->address++;
+    }
+  else if (b & I2C_LCD_SET_DDRAM_ADDR)
+    bus->address = b & 0x7F;
+  else if (b & (I2C_LCD_SET_CGRAM_ADDR | I2C_LCD_FUNCTION_SET
+      | I2C_LCD_CURSOR_SHIFT | I2C_LCD_DISPLAY_CONTROL
+      | I2C_LCD_ENTRY_MODE_SET))
+    {
+    // Nothing that the mock keeps track of
+    }
+  else if (b & I2C_LCD_HOME)
+    {
+    bus->address = 0;
+    busy = 1520000;
+    }
+  else if (b & I2C_LCD_CLEAR_DISPLAY)
+    {
+    memset (bus->ddram, ' ', sizeof (bus->ddram));
+    bus->address = 0;
+    busy = 1520000;
+    }
+  bus->busy_until_ns = now + busy;
+  }
+
+/*============================================================================
+ * i2c_bus_write
+ * The mock bus counts the transaction, and passes each byte to an
+ *   emulated port expander and HD44780. Every byte on the bus is nine
+ *   bits (eight, and the acknowledge), and there is an address byte, and
+ *   a start and a stop bit.
+ * ==========================================================================*/
+static void i2c_bus_write (const I2C_LCD *self, const uint8_t *data, int len)
+  {
+  I2C_LCDMockBus *bus = self->bus;
+  if (!bus) return;
+  uint32_t baud = bus->baud_rate ? bus->baud_rate : 100000;
+  uint64_t bit_ns = 1000000000ULL / baud;
+  bus->transactions++;
+  bus->bytes += (uint32_t)len;
+  bus->bus_ns += 10 * bit_ns;
+  for (int i = 0; i < len; i++)
+    {
+    bus->bus_ns += 9 * bit_ns;
+    uint8_t b = data[i];
+    if ((bus->pins & I2C_LCD_ENABLE) && !(b & I2C_LCD_ENABLE))
+      {
+      if ((b & (0xF0 | I2C_LCD_RS)) != (bus->pins & (0xF0 | I2C_LCD_RS)))
+        bus->errors++;
+      mock_latch (bus, bus->pins, bus->bus_ns + bus->wait_ns);
+      }
+    bus->pins = b;
+    }
+  bus->bus_ns += bit_ns;
+  }
+
+/*============================================================================
+ * i2c_bus_wait
+ * ==========================================================================*/
+static void i2c_bus_wait (const I2C_LCD *self, int usec)
+  {
+  if (self->bus) self->bus->wait_ns += (uint64_t)usec * 1000;
+  }
+
+/*============================================================================
+ * i2c_lcd_set_mock_bus
+ * ==========================================================================*/
+void i2c_lcd_set_mock_bus (I2C_LCD *self, I2C_LCDMockBus *bus)
+  {
+  self->bus = bus;
+  }
+
+#endif //PICO_ON_DEVICE
+
+/*============================================================================
+ * flush
+ * Send everything that has been queued, in one I2C write.
+ * ==========================================================================*/
+static void flush (I2C_LCD *self)
+  {
+  if (self->tx_len == 0) return;
+  i2c_bus_write (self, self->tx, self->tx_len);
+  self->tx_len = 0;
+  }
+
+/*============================================================================
+ * wait
+ * Wait for the panel to finish a slow command. Anything queued has to be
+ *   sent first, or we would be waiting for nothing.
  * ==========================================================================*/
-static void i2c_write_byte (const I2C_LCD *self, unsigned char b)
+static void wait (I2C_LCD *self, int usec)
   {
-  unsigned char data = b | (uint8_t)self->backlight;
-  i2c_write_blocking (self->i2c, (uint8_t)self->addr, &data, 1, false);
+  flush (self);
+  i2c_bus_wait (self, usec);
   }
 
 /*============================================================================
- * pulse_enable_line 
+ * queue_byte
  * ==========================================================================*/
-static void pulse_enable_line (const I2C_LCD *self, unsigned char b)
+static void queue_byte (I2C_LCD *self, unsigned char b)
   {
-  sleep_us (I2C_LCD_DELAY);
-  i2c_write_byte (self, b | I2C_LCD_ENABLE);
-  sleep_us (I2C_LCD_DELAY);
-  i2c_write_byte (self, (uint8_t)(b & ~I2C_LCD_ENABLE));
-  sleep_us (I2C_LCD_DELAY);
+  if (self->tx_len == I2C_LCD_TX_SIZE) flush (self);
+  self->tx[self->tx_len++] = b | (uint8_t)self->backlight;
   }
 
 /*============================================================================
  * send_4bits
+ * Set up the data lines, raise the enable line, and drop it again; the
+ *   panel takes the data as the enable line falls. These are three
+ *   separate bytes for the port expander, because the data must be
+ *   steady on either side of the enable pulse. Each byte takes 90us on
+ *   a 100kHz bus, which is far longer than the pulse and setup times
+ *   the panel needs, so there is no need to sleep between them.
  * ==========================================================================*/
-static void send_4bits (const I2C_LCD *self, unsigned char b)
+static void send_4bits (I2C_LCD *self, unsigned char b)
   {
-  i2c_write_byte (self, b);
-  pulse_enable_line (self, b);
+  queue_byte (self, b);
+  queue_byte (self, b | I2C_LCD_ENABLE);
+  queue_byte (self, (uint8_t)(b & ~I2C_LCD_ENABLE));
   }
 
 /*============================================================================
  * send_byte
+ * Most commands take the panel 37us, and the next byte's first nibble is
+ *   three bus bytes later, which is at least 67us at up to 400kHz. So
+ *   bytes can follow one another in the same write. The slow commands are
+ *   followed by a wait().
  * ==========================================================================*/
-static void send_byte (const I2C_LCD *self, unsigned char b, unsigned char mode)
+static void send_byte (I2C_LCD *self, unsigned char b, unsigned char mode)
   {
-  send_4bits (self, (b & 0xF0) | mode);
-  send_4bits (self, ((b << 4) & 0xF0) | mode);
+  send_4bits (self, (uint8_t)((b & 0xF0) | mode));
+  send_4bits (self, (uint8_t)(((b << 4) & 0xF0) | mode));
   }
 
 /*============================================================================
- * send_command 
+ * send_command
  * ==========================================================================*/
-static void send_command (const I2C_LCD *self, unsigned char c)
+static void send_command (I2C_LCD *self, unsigned char c)
   {
   send_byte (self, c, I2C_LCD_COMMAND);
   }
@@ -138,161 +304,350 @@ static void send_command (const I2C_LCD *self, unsigned char c)
 /*============================================================================
  * send_char
  * ==========================================================================*/
-static void send_char (const I2C_LCD *self, char c)
+static void send_char (I2C_LCD *self, unsigned char c)
   {
   send_byte (self, c, I2C_LCD_RS);
   }
 
 /*============================================================================
- * reset_scrollback 
+ * send_address
+ * Move the panel's address counter, unless it is already there.
  * ==========================================================================*/
-static void reset_scrollback (I2C_LCD *self)
+static void send_address (I2C_LCD *self, int address)
   {
-  memset (self->scrollback_buffer, ' ', 
-    (size_t)(self->scrollback_max_lines * self->width));
-  self->scrollback = 0;
+  if (self->address == address) return;
+  send_command (self, (uint8_t)(I2C_LCD_SET_DDRAM_ADDR | address));
+  self->address = address;
   }
 
 /*============================================================================
- * dump_scrollback 
- * Dump the scrollback buffer to the display, starting at the position of
- * self->scrollback. 
+ * send_clear
  * ==========================================================================*/
-static void dump_scrollback (I2C_LCD *self)
+static void send_clear (I2C_LCD *self)
   {
-  int old_curr_row = self->curr_row;
-  int old_curr_col = self->curr_col;
+  send_command (self, I2C_LCD_CLEAR_DISPLAY);
+  wait (self, I2C_LCD_CLEAR_DELAY);
+  memset (self->shown, ' ', (size_t)(self->width * self->height));
+  self->address = 0;
+  }
 
-  int scrollback_start_line = self->scrollback_max_lines - self->height 
+/*============================================================================
+ * visible
+ * Returns the part of the scrollback buffer that should be on the panel.
+ * ==========================================================================*/
+static unsigned char *visible (const I2C_LCD *self)
+  {
+  int start_line = self->scrollback_max_lines - self->height
     - self->scrollback;
+  return self->scrollback_buffer + start_line * self->width;
+  }
+
+/*============================================================================
+ * i2c_lcd_sync
+ * Bring the panel up to date with the visible part of the scrollback
+ *   buffer, and put the cursor in place. Characters that differ from
+ *   'shown' are sent in runs, and the address is only sent when a run
+ *   starts somewhere other than where the last one ended. A gap of one
+ *   unchanged character is cheaper to send again than to skip. If most
+ *   of the panel is to be blanked, it is cleared first.
+ * ==========================================================================*/
+static void i2c_lcd_sync (I2C_LCD *self)
+  {
+  const unsigned char *want = visible (self);
+  int cells = self->width * self->height;
+  int changed = 0, text = 0;
+  for (int i = 0; i < cells; i++)
+    {
+    if (want[i] != self->shown[i]) changed++;
+    if (want[i] != ' ') text++;
+    }
+  // After a clear, only the characters that are not blank need sending
+  if (I2C_LCD_CLEAR_COST + text < changed)
+    send_clear (self);
 
-  for (int i = 0; i < self->height; i++)
+  for (int row = 0; row < self->height; row++)
     {
-    int offset = (scrollback_start_line + i) * self->width;
-    i2c_lcd_set_cursor (self, i, 0);
-    for (int j = 0; j < self->width; j++)
+    const unsigned char *w = want + row * self->width;
+    unsigned char *s = self->shown + row * self->width;
+    for (int col = 0; col < self->width; col++)
       {
-      send_char (self, self->scrollback_buffer[offset + j]);
+      if (w[col] == s[col]) continue;
+      int address = self->offsets[row] + col;
+      if (col > 0 && self->address == address - 1)
+        {
+        // The panel moves on past the character, so no address is needed
+        send_char (self, s[col - 1]);
+        self->address = address;
+        }
+      send_address (self, address);
+      send_char (self, w[col]);
+      s[col] = w[col];
+      self->address = address + 1;
       }
     }
-  
-  self->curr_row = old_curr_row;
-  self->curr_col = old_curr_col;
+
+  int col = self->curr_col < self->width ? self->curr_col : self->width - 1;
+  send_address (self, self->offsets[self->curr_row] + col);
+  flush (self);
   }
 
 /*============================================================================
- *  cancel_scrollback
- *  Reset the display to the bottom of the scrollback buffer, that is, to
- *    the display that would have been visible before scrolling back. Only
- *    do this if, in fact, a scrollback is in force -- it causes an ugly
- *    flicker otherwise.
+ * reset_scrollback
  * ==========================================================================*/
-static void cancel_scrollback (I2C_LCD *self)
+static void reset_scrollback (I2C_LCD *self)
   {
-  if (self->scrollback > 0)
-    {
-    self->scrollback = 0;
-    dump_scrollback (self);
-    i2c_lcd_set_cursor (self, self->curr_row, self->curr_col);
-    }
+  memset (self->scrollback_buffer, ' ',
+    (size_t)(self->scrollback_max_lines * self->width));
+  self->scrollback = 0;
   }
 
-
 /*============================================================================
- * scroll_up 
+ * scroll_up
+ * Shift the scrollback buffer up one line. The panel catches up at the
+ *   next sync, when only the characters that differ from the line above
+ *   are sent.
  * ==========================================================================*/
 static void scroll_up (I2C_LCD *self)
   {
-  int orig_col = self->curr_col;
-
-  // Shift scrollback buffer up one line
-
   memmove (self->scrollback_buffer, self->scrollback_buffer + self->width,
              (size_t)(self->width * (self->scrollback_max_lines - 1)));
-  memset (self->scrollback_buffer + (self->scrollback_max_lines - 1) 
+  memset (self->scrollback_buffer + (self->scrollback_max_lines - 1)
             * self->width, ' ', (size_t)self->width);
-  
-  // clear display
+  }
 
-  i2c_lcd_clear (self, false);
+/*============================================================================
+ * move_cursor
+ * ==========================================================================*/
+static void move_cursor (I2C_LCD *self, int row, int col)
+  {
+  // TODO -- should we constrain the column as well?
+  self->curr_row = MIN (row, self->height - 1);
+  self->curr_col = col;
+  }
 
-  // Dump bottom (height - 1) lines from the scrollback buffer to the display
-  
-  for (int i = 0; i < self->height - 1; i++)
+/*============================================================================
+ * line_feed
+ * ==========================================================================*/
+static void line_feed (I2C_LCD *self)
+  {
+  self->curr_row++;
+  if (self->curr_row >= self->height)
     {
-    int offset = (self->scrollback_max_lines - self->height + i + 0) 
-      * self->width;
-    i2c_lcd_set_cursor (self, i, 0);
-    for (int j = 0; j < self->width; j++)
-      {
-      send_char (self, self->scrollback_buffer[offset + j]);
-      }
+    scroll_up (self);
+    self->curr_row = self->height - 1;
     }
+  }
 
-  // Set to original_column 
-  i2c_lcd_set_cursor (self, self->height - 1, orig_col); 
+/*============================================================================
+ * new_line
+ * ==========================================================================*/
+static void new_line (I2C_LCD *self)
+  {
+  if (self->curr_row >= self->height - 1)
+    scroll_up (self);
+  else
+    self->curr_row++;
+  self->curr_col = 0;
   }
 
 /*============================================================================
- *  i2c_lcd_new 
+ * backspace
  * ==========================================================================*/
-I2C_LCD *i2c_lcd_new (int width, int height, int addr, i2c_inst_t *i2c, 
-                       int sda, int scl, int i2c_baud, int scrollback_pages)
+static void backspace (I2C_LCD *self)
   {
-  I2C_LCD *self = malloc (sizeof (I2C_LCD));
-  self->width = width;
-  self->height = height;
-  self->addr = addr;
-  self->i2c = i2c;
-  self->wrap = true; 
-  self->implicit_lf = true;
-  self->destructive_backspace = true; 
-  self->scrollback_max_lines = scrollback_pages * self->height; 
-  // printf ("%ld\n", (size_t)(self->width * self->height)); // XXX
-  self->scrollback_buffer = malloc 
-    ((size_t)(self->width * self->scrollback_max_lines));
-  reset_scrollback (self);
-  //return self; // XXX
+  if (self->curr_col > 0)
+    {
+    self->curr_col--;
+    }
+  else
+    {
+    // If the cursor is not on the top line, backspace on the previous
+    //   line, and set the cursor to the end of the line. I'm not sure
+    //   whether this is the appropriate action to take -- what do
+    //   real terminals do?
+    if (self->curr_row > 0)
+      move_cursor (self, self->curr_row - 1, self->width - 1);
+    }
+  }
 
-  i2c_init (i2c, (uint)i2c_baud);
-  gpio_set_function ((uint8_t)sda, GPIO_FUNC_I2C);
-  gpio_set_function ((uint8_t)scl, GPIO_FUNC_I2C);
-  gpio_pull_up ((uint8_t)sda);
-  gpio_pull_up ((uint8_t)scl);
+static void put_char (I2C_LCD *self, const char c);
+
+/*============================================================================
+ * del
+ * ==========================================================================*/
+static void del (I2C_LCD *self)
+  {
+  backspace (self);
+  put_char (self, ' ');
+  backspace (self);
+  }
+
+/*============================================================================
+ * clear
+ * ==========================================================================*/
+static void clear (I2C_LCD *self, bool clear_scrollback)
+  {
+  if (clear_scrollback)
+    reset_scrollback (self);
+  else
+    {
+    self->scrollback = 0;
+    memset (visible (self), ' ', (size_t)(self->width * self->height));
+    }
+  self->curr_row = 0; self->curr_col = 0;
+  }
+
+/*============================================================================
+ * put_char
+ * Update the scrollback buffer and cursor position for one character,
+ *   without sending anything. Printing anything ends a scrollback.
+ * ==========================================================================*/
+static void put_char (I2C_LCD *self, const char c)
+  {
+  self->scrollback = 0;
+  switch (c)
+    {
+    case 8: // BS
+      if (self->destructive_backspace)
+        del (self);
+      else
+        backspace (self);
+      break;
+    case 10: // LF
+      line_feed (self);
+      break;
+    case 12: // FF (clear screen)
+      clear (self, true);
+      break;
+    case 13: // CR
+      self->curr_col = 0;
+      if (self->implicit_lf)
+        line_feed (self);
+      break;
+    case 127: // DEL
+      del (self);
+      break;
+    default:
+      // With wrapping off, characters past the end of the line are lost
+      if (self->curr_col < self->width)
+        {
+        int scrollback_row = self->scrollback_max_lines - self->height
+          + self->curr_row;
+        self->scrollback_buffer
+          [scrollback_row * self->width + self->curr_col] = (uint8_t)c;
+        }
+      self->curr_col++;
+      if (self->wrap)
+        {
+        if (self->curr_col >= (int)self->width)
+          {
+          new_line (self);
+          }
+        }
+    }
+  }
+
+/*============================================================================
+ *  i2c_lcd_init
+ *  Set up the panel, which can be in any state, and clear it.
+ * ==========================================================================*/
+static void i2c_lcd_init (I2C_LCD *self)
+  {
   self->backlight = 0;
   self->display_mode = I2C_LCD_ENTRY_LEFT | I2C_LCD_ENTRY_SHIFT_DECREMENT;
-  self->display_function 
+  self->display_function
                     = I2C_LCD_MODE_4_BIT | I2C_LCD_LINE_2 | I2C_LCD_DOTS_5X8;
-  self->display_control 
+  self->display_control
                     = I2C_LCD_DISPLAY_ON | I2C_LCD_CURSOR_ON | I2C_LCD_BLINK_OFF;
 
   self->offsets[0] = 0;
   self->offsets[1] = 0x40;
-  self->offsets[2] = (uint8_t)width;
-  self->offsets[3] = (uint8_t)(0x40 + width);
-  
+  self->offsets[2] = (uint8_t)self->width;
+  self->offsets[3] = (uint8_t)(0x40 + self->width);
+
   self->curr_row = 0;
   self->curr_col = 0;
-  
+  self->address = -1;
+  self->tx_len = 0;
+
   // Basic init sequence. It's an ugly workaround for the fact that we
-  //   don't know whether the unit starts up in 4-bit or 8-bit mode.
+  //   don't know whether the unit starts up in 4-bit or 8-bit mode. Until
+  //   it is in a known mode, each command needs a long wait.
   send_command (self, 0x03);
+  wait (self, I2C_LCD_INIT_DELAY);
   send_command (self, 0x03);
+  wait (self, I2C_LCD_INIT_DELAY);
   send_command (self, 0x03);
+  wait (self, I2C_LCD_INIT_DELAY);
   send_command (self, 0x02);
+  wait (self, I2C_LCD_INIT_DELAY);
 
   send_command (self, I2C_LCD_ENTRY_MODE_SET | self->display_mode);
   send_command (self, I2C_LCD_FUNCTION_SET | self->display_function);
+  send_clear (self);
 
   i2c_lcd_display_on (self);
 
   // We might as well start with the backlight on -- this is the usual
-  //   power-on state of these I2C LCD devices. The application call 
+  //   power-on state of these I2C LCD devices. The application call
   //   always turn it off with i2c_lcd_backlight_off() later if necessary.
   i2c_lcd_backlight_on (self);
+  }
+
+/*============================================================================
+ *  i2c_lcd_create
+ * ==========================================================================*/
+static I2C_LCD *i2c_lcd_create (int width, int height, int scrollback_pages)
+  {
+  I2C_LCD *self = malloc (sizeof (I2C_LCD));
+  memset (self, 0, sizeof (I2C_LCD));
+  self->width = width;
+  self->height = height;
+  self->wrap = true;
+  self->implicit_lf = true;
+  self->destructive_backspace = true;
+  self->scrollback_max_lines = scrollback_pages * self->height;
+  self->scrollback_buffer = malloc
+    ((size_t)(self->width * self->scrollback_max_lines));
+  reset_scrollback (self);
+  self->shown = malloc ((size_t)(self->width * self->height));
+  return self;
+  }
 
+#if PICO_ON_DEVICE
+/*============================================================================
+ *  i2c_lcd_new
+ * ==========================================================================*/
+I2C_LCD *i2c_lcd_new (int width, int height, int addr, i2c_inst_t *i2c,
+                       int sda, int scl, int i2c_baud, int scrollback_pages)
+  {
+  I2C_LCD *self = i2c_lcd_create (width, height, scrollback_pages);
+  self->addr = addr;
+  self->i2c = i2c;
+
+  i2c_init (i2c, (uint)i2c_baud);
+  gpio_set_function ((uint8_t)sda, GPIO_FUNC_I2C);
+  gpio_set_function ((uint8_t)scl, GPIO_FUNC_I2C);
+  gpio_pull_up ((uint8_t)sda);
+  gpio_pull_up ((uint8_t)scl);
+  i2c_lcd_init (self);
+  return self;
+  }
+#else
+/*============================================================================
+ *  i2c_lcd_new
+ *  In the host build, nothing is sent anywhere until a mock bus is set
+ *    with i2c_lcd_set_mock_bus(). The panel is cleared when it is
+ *    set up, so a mock bus set after that starts from a blank panel.
+ * ==========================================================================*/
+I2C_LCD *i2c_lcd_new (int width, int height)
+  {
+  I2C_LCD *self = i2c_lcd_create (width, height,
+    I2C_LCD_HOST_SCROLLBACK_PAGES);
+  i2c_lcd_init (self);
   return self;
   }
+#endif
 
 /*============================================================================
  *  i2c_lcd_display_on
@@ -301,6 +656,7 @@ void i2c_lcd_display_on (I2C_LCD* self)
   {
   self->display_control |= I2C_LCD_DISPLAY_ON;
   send_command (self, I2C_LCD_DISPLAY_CONTROL | self->display_control);
+  flush (self);
   }
 
 /*============================================================================
@@ -310,6 +666,7 @@ void i2c_lcd_display_off (I2C_LCD* self)
   {
   self->display_control &= (uint8_t) ~I2C_LCD_DISPLAY_ON;
   send_command (self, I2C_LCD_DISPLAY_CONTROL | self->display_control);
+  flush (self);
   }
 
 /*============================================================================
@@ -318,7 +675,8 @@ void i2c_lcd_display_off (I2C_LCD* self)
 void i2c_lcd_backlight_on (I2C_LCD* self)
   {
   self->backlight = I2C_LCD_BACKLIGHT;
-  i2c_write_byte (self, (uint8_t)self->backlight); 
+  queue_byte (self, 0);
+  flush (self);
   }
 
 /*============================================================================
@@ -327,7 +685,8 @@ void i2c_lcd_backlight_on (I2C_LCD* self)
 void i2c_lcd_backlight_off (I2C_LCD* self)
   {
   self->backlight = 0;
-  i2c_write_byte (self, (uint8_t)self->backlight); 
+  queue_byte (self, 0);
+  flush (self);
   }
 
 /*============================================================================
@@ -335,145 +694,84 @@ void i2c_lcd_backlight_off (I2C_LCD* self)
  * ==========================================================================*/
 void i2c_lcd_set_cursor (I2C_LCD *self, int row, int col)
   {
-//printf ("SET CUR\n"); //XXX
-//return;
-  // TODO -- should we constrain the column as well?
-  row = MIN (row, self->height - 1);
-  self->curr_row = row;
-  self->curr_col = col;
-  send_command (self, (uint8_t)(I2C_LCD_SET_DDRAM_ADDR | (self->offsets[row] + col)));
+  move_cursor (self, row, col);
+  i2c_lcd_sync (self);
   }
 
 /*============================================================================
  *  i2c_lcd_line_feed
  * ==========================================================================*/
-void i2c_lcd_line_feed (I2C_LCD *self) 
+void i2c_lcd_line_feed (I2C_LCD *self)
   {
-  self->curr_row++;
-  if (self->curr_row >= self->height)
-    scroll_up (self);
-  i2c_lcd_set_cursor (self, self->curr_row, self->curr_col);
+  self->scrollback = 0;
+  line_feed (self);
+  i2c_lcd_sync (self);
   }
 
 /*============================================================================
  *  i2c_lcd_cr
  * ==========================================================================*/
-void i2c_lcd_cr (I2C_LCD *self) 
+void i2c_lcd_cr (I2C_LCD *self)
   {
-  i2c_lcd_set_cursor (self, self->curr_row, 0);
   self->curr_col = 0;
+  i2c_lcd_sync (self);
   }
 
 /*============================================================================
  *  i2c_cursor_on
  * ==========================================================================*/
-void i2c_lcd_cursor_on (I2C_LCD *self) 
+void i2c_lcd_cursor_on (I2C_LCD *self)
   {
   self->display_control |= I2C_LCD_CURSOR_ON;
   send_command (self, I2C_LCD_DISPLAY_CONTROL | self->display_control);
+  flush (self);
   }
 
 /*============================================================================
  *  i2c_cursor_off
  * ==========================================================================*/
-void i2c_lcd_cursor_off (I2C_LCD *self) 
+void i2c_lcd_cursor_off (I2C_LCD *self)
   {
   self->display_control &= (uint8_t)~I2C_LCD_CURSOR_ON;
   send_command (self, I2C_LCD_DISPLAY_CONTROL | self->display_control);
+  flush (self);
   }
 
 /*============================================================================
  *  i2c_lcd_backspace
  * ==========================================================================*/
-void i2c_lcd_backspace (I2C_LCD *self) 
+void i2c_lcd_backspace (I2C_LCD *self)
   {
-  if (self->curr_col > 0)
-    {
-    self->curr_col--;
-    i2c_lcd_set_cursor (self, self->curr_row, self->curr_col);
-    }
-  else
-    {
-    // If the cursor is not on the top line, backspace on the previous
-    //   line, and set the cursor to the end of the line. I'm not sure
-    //   whether this is the appropriate action to take -- what do
-    //   real terminals do?
-    if (self->curr_row > 0)
-      {
-      i2c_lcd_set_cursor (self, self->curr_row - 1, self->width - 1);
-      }
-    }
+  backspace (self);
+  i2c_lcd_sync (self);
   }
 
 /*============================================================================
  *  i2c_lcd_del
  * ==========================================================================*/
-void i2c_lcd_del (I2C_LCD *self) 
+void i2c_lcd_del (I2C_LCD *self)
   {
-  i2c_lcd_backspace (self);
-  i2c_lcd_print_char (self, ' ');
-  i2c_lcd_backspace (self);
+  del (self);
+  i2c_lcd_sync (self);
   }
 
 /*============================================================================
  *  i2c_lcd_new_line
  * ==========================================================================*/
-void i2c_lcd_new_line (I2C_LCD *self) 
+void i2c_lcd_new_line (I2C_LCD *self)
   {
-  if (self->curr_row >= self->height - 1)
-    {
-    scroll_up (self);
-    }
-  else
-    {
-    self->curr_row++;
-    }
-  i2c_lcd_set_cursor (self, self->curr_row, 0);
+  self->scrollback = 0;
+  new_line (self);
+  i2c_lcd_sync (self);
   }
 
 /*============================================================================
  *  i2c_lcd_print_char
  * ==========================================================================*/
-void i2c_lcd_print_char (I2C_LCD *self, const char c) 
+void i2c_lcd_print_char (I2C_LCD *self, const char c)
   {
-  cancel_scrollback (self);
-  switch (c)
-    {
-    case 8: // BS 
-      if (self->destructive_backspace)
-        i2c_lcd_del (self); 
-      else
-        i2c_lcd_backspace (self); 
-      break;
-    case 10: // LF
-      i2c_lcd_line_feed (self); 
-      break;
-    case 12: // FF (clear screen)
-      i2c_lcd_clear (self, true);
-      break;
-    case 13: // CR
-      i2c_lcd_cr (self);
-      if (self->implicit_lf)
-        i2c_lcd_line_feed (self);
-      break;
-    case 127: // DEL
-      i2c_lcd_del (self); 
-      break;
-    default:
-      send_char (self, c);
-      int scrollback_row = self->scrollback_max_lines - self->height 
-        + self->curr_row;
-      self->scrollback_buffer 
-        [scrollback_row * self->width + self->curr_col] = c;
-      self->curr_col++;
-      if (self->wrap)
-        {
-        if (self->curr_col >= (int)self->width)
-          {
-          i2c_lcd_new_line (self);
-          }
-        }
-    }
+  put_char (self, c);
+  i2c_lcd_sync (self);
   }
 
 /*============================================================================
@@ -481,14 +779,8 @@ void i2c_lcd_print_char (I2C_LCD *self, const char c)
  * ==========================================================================*/
 void  i2c_lcd_clear (I2C_LCD *self, bool clear_scrollback)
   {
-  send_command (self, I2C_LCD_CLEAR_DISPLAY); 
-  self->curr_row = 0; self->curr_col = 0;
-
-  if (clear_scrollback)
-    {
-    if (self->scrollback > 0) cancel_scrollback (self);
-    reset_scrollback (self);
-    }
+  clear (self, clear_scrollback);
+  i2c_lcd_sync (self);
   }
 
 /*============================================================================
@@ -544,13 +836,13 @@ void i2c_lcd_destructive_backspace_off (I2C_LCD *self)
  * ==========================================================================*/
 void i2c_lcd_scrollback_line_up (I2C_LCD *self)
   {
-  int scrollback_start_line = self->scrollback_max_lines - self->height 
+  int scrollback_start_line = self->scrollback_max_lines - self->height
     - self->scrollback - 1;
 
   if (scrollback_start_line > 0)
     {
     self->scrollback++;
-    dump_scrollback (self);
+    i2c_lcd_sync (self);
     }
   }
 
@@ -562,79 +854,43 @@ void i2c_lcd_scrollback_line_down (I2C_LCD *self)
   if (self->scrollback > 0)
     {
     self->scrollback--;
-    dump_scrollback (self);
-    // If we reduce scrollback from 1 to 0, we are effectively at
-    //   the working position. So restore the original cursor.
-    if (self->scrollback == 0)
-      i2c_lcd_set_cursor (self, self->curr_row, self->curr_col);
+    i2c_lcd_sync (self);
     }
   }
 
-#else //PICO_ON_DEVICE
-
-/*============================================================================
- *  i2c_lcd_new 
- * ==========================================================================*/
-I2C_LCD *i2c_lcd_new (int width, int height)
-  {
-  I2C_LCD *self = malloc (sizeof (I2C_LCD));
-  self->width = width;
-  self->height = height;
-  return self;
-  }
-
-/*============================================================================
- *  i2c_lcd_print_char
- * ==========================================================================*/
-void i2c_lcd_print_char (I2C_LCD *self, const char c) 
-  {
-  (void)self;
-  putchar (c);
-  }
-
-/*============================================================================
- *  i2c_lcd_set_cursor
- * ==========================================================================*/
-void i2c_lcd_set_cursor (I2C_LCD *self, int row, int col)
-  {
-  (void)self;
-  printf ("%c[%d;%dm", 27, row, col);
-  }
-
-#endif //PICO_ON_DEVICE
-
 /*============================================================================
  *  i2c_lcd_print_string
  * ==========================================================================*/
-void i2c_lcd_print_string (I2C_LCD *self, const char *s) 
+void i2c_lcd_print_string (I2C_LCD *self, const char *s)
   {
   while (*s)
     {
-    i2c_lcd_print_char (self, *s);
+    put_char (self, *s);
     s++;
     }
+  i2c_lcd_sync (self);
   }
 
 /*============================================================================
  *  i2c_lcd_write
+ *  The whole buffer goes into the scrollback buffer before anything is
+ *    sent, so text that scrolls off before the end is never sent at all.
  * ==========================================================================*/
-int i2c_lcd_write (I2C_LCD *self, const char *buffer, int c) 
+int i2c_lcd_write (I2C_LCD *self, const char *buffer, int c)
   {
   for (int i = 0; i < c; i++)
-    i2c_lcd_print_char (self, buffer[i]);
+    put_char (self, buffer[i]);
+  i2c_lcd_sync (self);
   return c;
   }
 
-
 /*============================================================================
  *  i2c_lcd_destroy
  * ==========================================================================*/
 void i2c_lcd_destroy (I2C_LCD* self)
   {
-#if PICO_ON_DEVICE
   free (self->scrollback_buffer);
-#endif
+  free (self->shown);
   free (self);
   }
 
-
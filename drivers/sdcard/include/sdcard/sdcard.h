@@ -54,6 +54,10 @@ typedef enum
 
 typedef struct _SDCard SDCard;
 
+/** A function that is called before the driver uses the SPI bus, so that
+    another device on the same bus can finish what it is doing. */
+typedef void (*SDBusFenceFn) (void *data);
+
 #ifdef __cplusplus
 extern "C" {
 #endif
@@ -114,6 +118,12 @@ extern const char *sdcard_type_to_string (SDCardType type);
      specified error code (one of the SD_ERR_XXX values) */
 extern const char *sdcard_perror (SDError error);
 
+/** Set a function to be called before each use of the SPI bus. This is
+    needed if another device on the bus can leave a transfer running 
+    in the background. */
+extern void sdcard_set_bus_fence (SDCard *self, SDBusFenceFn fn, 
+          void *data);
+
 /** Get the SDCard instance that represents a particular drive. Note that,
     at present, only one drive is supported, and the drive_num argument
     is ignore. */
@@ -172,6 +172,8 @@ struct _SDCard
   uint64_t sectors; // Number of 512-byte sectors on the card
   bool driver_initialized; // Set when the driver is initialized 
   bool card_initialized; // Set when card is initialized 
+  SDBusFenceFn bus_fence; // Called before using the bus, if not NULL
+  void *bus_fence_data; // Passed to bus_fence
   };
 
 // Because we're using interrupts to signal the end of data transfers, 
@@ -374,6 +376,7 @@ static void sdcard_send_initializing_sequence (SDCard *self)
   TRACE ("start");
 #endif
 
+  if (self->bus_fence) self->bus_fence (self->bus_fence_data);
   bool old_ss = gpio_get (self->gpio_cs);
   // Set DI and CS high and apply "74 or more" clock pulses to SCLK.
   // In practice, we will do this by sending ten 0xFF bytes (= 80 bits).
@@ -739,6 +742,7 @@ static int sdcard_cmd (SDCard *self, const SDCmd cmd, uint32_t arg,
 static void sdcard_acquire (SDCard *self)
   {
   sdcard_lock (self);
+  if (self->bus_fence) self->bus_fence (self->bus_fence_data);
   gpio_put (self->gpio_cs, 0);
   // A fill byte seems sometimes to be necessary. Not sure why.
   uint8_t fill = SPI_FILL_CHAR;
@@ -1705,6 +1709,15 @@ SDCard *sdcard_get_instance (int drive_num)
   return global_sdcard;
   }
 
+/*============================================================================
+ * sdcard_set_bus_fence
+ * ==========================================================================*/
+void sdcard_set_bus_fence (SDCard *self, SDBusFenceFn fn, void *data)
+  {
+  self->bus_fence = fn;
+  self->bus_fence_data = data;
+  }
+
 /*============================================================================
  * sdcard_is_driver_initialized
  * ==========================================================================*/
@@ -5,6 +5,9 @@
  * ==========================================================================*/
 #pragma once
 
+#include <stdint.h>
+#include <stddef.h>
+#include <stdbool.h>
 #if PICO_ON_DEVICE
 #include <hardware/spi.h>
 #endif 
@@ -24,12 +27,36 @@ typedef enum _WSLCDScanDir
 
 typedef struct _WSLCD WSLCD;
 
+#if PICO_ON_DEVICE
+#else
+/*============================================================================
+ * WSLCDCapture 
+ * In the host build, the bytes that would be sent to the panel are
+ * recorded here, if a capture has been set with wslcd_set_capture(). 
+ * Command bytes and data bytes are recorded in the order they would be
+ * sent. If buff is NULL, or fills up, bytes are only counted. bus_ns is
+ * the time the bytes would take on the SPI bus at baud_rate.
+ * ==========================================================================*/
+typedef struct _WSLCDCapture 
+  {
+  uint8_t *buff;
+  size_t size;
+  size_t bytes;
+  uint32_t commands;
+  uint32_t transfers;
+  uint32_t baud_rate;
+  uint64_t bus_ns;
+  } WSLCDCapture;
+#endif
+
 #if PICO_ON_DEVICE
 extern WSLCD *wslcd_new (spi_inst_t *spi, uint gpio_cs, uint gpio_miso, 
     uint gpio_mosi, uint gpio_sck, uint gpio_rst, uint gpio_dc, 
     uint gpio_bl, int baud_rate, WSLCDScanDir scan_dir);
 #else
 extern WSLCD *wslcd_new (void);
+/** Start (or, with NULL, stop) recording the bytes sent to the panel. */
+extern void wslcd_set_capture (WSLCD *self, WSLCDCapture *capture);
 #endif
 
 extern void wslcd_destroy (WSLCD *self);
@@ -52,8 +79,25 @@ extern void wslcd_set_pixel (const WSLCD *self, uint16_t x, uint16_t y,
 
 extern void wslcd_clear (WSLCD *self, uint16_t colour);
 
+/** Send len pixels to the window most recently set. Pixels are sent by
+    DMA, in 16-bit SPI frames; this function waits for the transfer to 
+    finish. */
 extern void wslcd_transfer (const WSLCD *self, const uint16_t *buff, int len);
 
+/** Like wslcd_transfer(), but returns as soon as the transfer has started.
+    The caller must not change the contents of buff until wslcd_wait()
+    has been called. Any other call to this driver also waits for the
+    transfer to finish. */
+extern void wslcd_transfer_async (const WSLCD *self, const uint16_t *buff, 
+         int len);
+
+/** Wait for any transfer or fill to finish, and release the SPI bus. 
+    Anything else that uses the same SPI bus must call this first. */
+extern void wslcd_wait (const WSLCD *self);
+
+/** Returns true if a transfer or fill is still in progress. */
+extern bool wslcd_is_busy (const WSLCD *self);
+
 extern void wslcd_transfer_window 
         (const WSLCD *self, const uint16_t *buff, uint16_t w, 
         uint16_t h, uint16_t x, uint16_t y);
@@ -61,6 +105,8 @@ extern void wslcd_transfer_window
 extern void wslcd_set_window (const WSLCD *self, uint16_t xstart, 
          uint16_t ystart, uint16_t xend, uint16_t yend);
 
+/** Send len copies of word. This does not wait for the fill to finish,
+    so a large area can be cleared while the CPU does something else. */
 extern void wslcd_send_repeated_word (const WSLCD *self, uint16_t word, 
          int len);
 
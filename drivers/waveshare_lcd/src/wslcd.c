@@ -2,10 +2,12 @@
 #include <string.h> 
 #include <malloc.h> 
 #include <stdio.h> 
+#include <sys/types.h> 
 #if PICO_ON_DEVICE
 #include <hardware/spi.h> 
-#endif
+#include <hardware/dma.h> 
 #include <hardware/gpio.h> 
+#endif
 #include <waveshare_lcd/waveshare_lcd.h> 
 
 // ID codes for the 2.8" and 3.5" displays, from the Waveshare docs
@@ -26,12 +28,30 @@
 #define LCD_2_8_WIDTH  	240  //LCD width
 #define LCD_2_8_HEIGHT  320
 
+#if PICO_ON_DEVICE
+// The state of the pixel DMA channel. This is kept apart from the WSLCD
+//   itself, because it changes in operations that take a const WSLCD.
+//   While busy is set, a transfer might be in progress, chip select is
+//   still asserted, and the SPI bus is in 16-bit mode. wslcd_wait() 
+//   puts all this right.
+typedef struct _WSLCDDma
+  {
+  int channel;
+  volatile bool busy;
+  // The source of a fill; it must stay put until the fill is finished
+  uint16_t fill_word;
+  } WSLCDDma;
+#endif
+
 // Opaque structure
 
 struct _WSLCD
   {
 #if PICO_ON_DEVICE
   spi_inst_t *spi;
+  WSLCDDma *dma;
+#else
+  WSLCDCapture *capture;
 #endif
   uint gpio_cs;
   uint gpio_miso;
@@ -92,49 +112,65 @@ static uint8_t wslcd_write_byte (const WSLCD *self, uint8_t value)
   }
 
 /*============================================================================
-  swap16 
-  Swaps the byte order of x, in place
+  wslcd_wait
+  Wait for any pixel transfer to finish, and then put the SPI bus back
+    into the state that other users expect: not busy, 8-bit frames,
+    no stale data in the receive FIFO, and chip select high.
  ===========================================================================*/
-static inline void swap16 (uint16_t *x)
+void wslcd_wait (const WSLCD *self)
   {
-  uint8_t *t = (uint8_t *)x;
-  uint8_t c = t[0];
-  t[0] = t[1];
-  t[1] = c;
-  } 
+  WSLCDDma *dma = self->dma;
+  if (!dma->busy) return;
+  dma_channel_wait_for_finish_blocking ((uint)dma->channel);
+  // The DMA is finished when the last word is in the FIFO, not when it 
+  //   has been sent
+  while (spi_get_hw (self->spi)->sr & SPI_SSPSR_BSY_BITS)
+    tight_loop_contents();
+  // Nothing reads the receive FIFO during the transfer, so it will have
+  //   overrun
+  while (spi_is_readable (self->spi))
+    (void)spi_get_hw (self->spi)->dr;
+  spi_get_hw (self->spi)->icr = SPI_SSPICR_RORIC_BITS;
+  spi_set_format (self->spi, 8, SPI_CPOL_0, SPI_CPHA_0, SPI_MSB_FIRST);
+  gpio_put (self->gpio_cs, 1);
+  dma->busy = false;
+  }
 
 /*============================================================================
-  spit_write_blocking2
+  wslcd_is_busy
  ===========================================================================*/
-static inline void spi_write_blocking2 (spi_inst_t *spi, const uint8_t *src) 
+bool wslcd_is_busy (const WSLCD *self)
   {
-  for (size_t i = 0; i < 2; ++i) 
-    {
-    while (!spi_is_writable(spi))
-      tight_loop_contents();
-    spi_get_hw(spi)->dr = (uint32_t)src[i];
-    }
-
-  while (spi_is_readable(spi))
-    (void)spi_get_hw(spi)->dr;
-  while (spi_get_hw(spi)->sr & SPI_SSPSR_BSY_BITS)
-    tight_loop_contents();
-  while (spi_is_readable(spi))
-    (void)spi_get_hw(spi)->dr;
-
-  spi_get_hw(spi)->icr = SPI_SSPICR_RORIC_BITS;
+  return self->dma->busy && dma_channel_is_busy ((uint)self->dma->channel);
   }
 
 /*============================================================================
-  wslcd_write_word_be
-  Writes w in big-endian order to the SPI bus
+  wslcd_pixels_start
+  Start sending count 16-bit pixels, from src, or count copies of *src if
+    increment is false. This does not wait for the transfer to finish:
+    the data at src must not change until wslcd_wait() has been called. 
+  With 16-bit SPI frames, the SPI peripheral sends the most significant 
+    byte first, which is the order the panel expects, so no byte swapping
+    is needed.
  ===========================================================================*/
-static inline void wslcd_write_word_be (const WSLCD *self, uint16_t w)
+static void wslcd_pixels_start (const WSLCD *self, const uint16_t *src, 
+         uint32_t count, bool increment)
   {
-  swap16 (&w);
-  //uint8_t rx[2];
-  //spi_write_read_blocking (self->spi, (uint8_t *)&w, rx, 2);
-  spi_write_blocking2 (self->spi, (uint8_t *)&w);
+  WSLCDDma *dma = self->dma;
+  wslcd_wait (self);
+  if (count == 0) return;
+  gpio_put (self->gpio_dc, 1);
+  gpio_put (self->gpio_cs, 0);
+  spi_set_format (self->spi, 16, SPI_CPOL_0, SPI_CPHA_0, SPI_MSB_FIRST);
+
+  dma_channel_config c = dma_channel_get_default_config ((uint)dma->channel);
+  channel_config_set_transfer_data_size (&c, DMA_SIZE_16);
+  channel_config_set_read_increment (&c, increment);
+  channel_config_set_write_increment (&c, false);
+  channel_config_set_dreq (&c, spi_get_dreq (self->spi, true));
+  dma->busy = true;
+  dma_channel_configure ((uint)dma->channel, &c, 
+      &spi_get_hw (self->spi)->dr, src, count, true);  
   }
 
 /*============================================================================
@@ -158,6 +194,7 @@ static void wslcd_reset (const WSLCD *self)
  *===========================================================================*/
 static void wslcd_write_reg (const WSLCD *self, uint8_t reg)
   {
+  wslcd_wait (self);
   gpio_put (self->gpio_dc, 0);
   gpio_put (self->gpio_cs, 0);
   wslcd_write_byte (self, reg);
@@ -167,8 +204,9 @@ static void wslcd_write_reg (const WSLCD *self, uint8_t reg)
 /*============================================================================
   wslcd_write_data
  *===========================================================================*/
-void wslcd_write_data (const WSLCD *self, uint16_t data)
+static void wslcd_write_data (const WSLCD *self, uint16_t data)
   {
+  wslcd_wait (self);
   if (self->id == LCD_2_8)
     {
     // Not tested!
@@ -198,6 +236,7 @@ uint8_t LCD_Read_Id (WSLCD *self)
   uint8_t reg = 0xDC;
   uint8_t tx_val = 0x00;
   uint8_t rx_val;
+  wslcd_wait (self);
   gpio_put (self->gpio_cs, 0);
   gpio_put (self->gpio_dc, 0);
   wslcd_write_byte (self, reg);
@@ -384,6 +423,84 @@ static void wslcd_set_scan (WSLCD *self, WSLCDScanDir Scan_dir)
     }
   }
 
+#else
+
+/*============================================================================
+  Host SPI capture. In the host build there is no panel, so the bytes that
+    would be sent on the SPI bus are recorded in the WSLCDCapture, if
+    one has been set, along with the time they would take to send.
+ ===========================================================================*/
+static void wslcd_capture_byte (const WSLCD *self, uint8_t b)
+  {
+  WSLCDCapture *c = self->capture;
+  if (!c) return;
+  if (c->buff && c->bytes < c->size) c->buff[c->bytes] = b;
+  c->bytes++;
+  if (c->baud_rate) c->bus_ns += 8000000000ULL / c->baud_rate;
+  }
+
+/*============================================================================
+  wslcd_wait
+ ===========================================================================*/
+void wslcd_wait (const WSLCD *self)
+  {
+  (void)self;
+  }
+
+/*============================================================================
+  wslcd_is_busy
+ ===========================================================================*/
+bool wslcd_is_busy (const WSLCD *self)
+  {
+  (void)self;
+  return false;
+  }
+
+/*============================================================================
+  wslcd_write_reg
+ ===========================================================================*/
+static void wslcd_write_reg (const WSLCD *self, uint8_t reg)
+  {
+  if (self->capture) self->capture->commands++;
+  wslcd_capture_byte (self, reg);
+  }
+
+/*============================================================================
+  wslcd_write_data
+  Only the 3.5" panel is emulated
+ ===========================================================================*/
+static void wslcd_write_data (const WSLCD *self, uint16_t data)
+  {
+  wslcd_capture_byte (self, 0);
+  wslcd_capture_byte (self, (uint8_t) (data & 0xFF));
+  }
+
+/*============================================================================
+  wslcd_pixels_start
+ ===========================================================================*/
+static void wslcd_pixels_start (const WSLCD *self, const uint16_t *src, 
+         uint32_t count, bool increment)
+  {
+  if (!self->capture || count == 0) return;
+  self->capture->transfers++;
+  for (uint32_t i = 0; i < count; i++)
+    {
+    uint16_t w = increment ? src[i] : *src;
+    wslcd_capture_byte (self, (uint8_t)(w >> 8));
+    wslcd_capture_byte (self, (uint8_t)(w & 0xFF));
+    }
+  }
+
+/*============================================================================
+  wslcd_set_capture
+ ===========================================================================*/
+void wslcd_set_capture (WSLCD *self, WSLCDCapture *capture)
+  {
+  self->capture = capture;
+  }
+
+#endif // PICO_ON_DEVICE
+
 /*============================================================================
   wslcd_set_window
   Sends the X and Y range of the data transfer to follow. This function
@@ -397,10 +514,8 @@ void wslcd_set_window (const WSLCD *self, uint16_t Xstart, uint16_t Ystart,
   uint16_t ye = Yend + self->scroll_pos; 
 
   if (ys >= self->used_height) ys = (uint16_t)(ys - self->used_height);
-  if (ye >= self->used_height) ye = (uint16_t)(ye - self->used_height);
-
-  //if (ys > ye)
-  //  printf ("ys=%d ye=%d\n", ys, ye); // XXX
+  // ye is exclusive, so a window that ends on the last row must not wrap
+  if (ye > self->used_height) ye = (uint16_t)(ye - self->used_height);
 
   //set the X coordinates
   wslcd_write_reg (self, 0x2A); // Column address set
@@ -434,20 +549,22 @@ static void wslcd_set_cursor (const WSLCD *self, uint16_t xpoint,
 
 /*============================================================================
   wslcd_send_repeated_word
+  The fill is sent from a single word, with a DMA channel that does not
+    increment its read address, so this returns without waiting for it
+    to finish.
  ===========================================================================*/
 void wslcd_send_repeated_word (const WSLCD *self, uint16_t word, int len)
   {
-  gpio_put (self->gpio_dc, 1);
-  gpio_put (self->gpio_cs, 0);
-  for (int i = 0; i < len; i++) 
-    {
-    wslcd_write_word_be (self, word);
-    }
-  gpio_put (self->gpio_cs, 1);
+  if (len <= 0) return;
+#if PICO_ON_DEVICE
+  wslcd_wait (self);
+  self->dma->fill_word = word;
+  wslcd_pixels_start (self, &self->dma->fill_word, (uint32_t)len, false);
+#else
+  wslcd_pixels_start (self, &word, (uint32_t)len, false);
+#endif
   }
 
-#endif // PICO_ON_DEVICE
-
 /*============================================================================
   wslcd_fill_area
  ===========================================================================*/
@@ -455,17 +572,12 @@ void wslcd_fill_area (const WSLCD *self, uint16_t xstart,
          uint16_t ystart, uint16_t xend, uint16_t yend,        
          uint16_t color)
   {
-#if PICO_ON_DEVICE
   if ((xend > xstart) && (yend > ystart)) 
     {
     wslcd_set_window (self, xstart , ystart , xend , yend);
     //LCD_SetColor (self, color, xend - xstart, yend - ystart);
     wslcd_send_repeated_word (self, color, (xend - xstart) * (yend - ystart));
     }
-#else
-  (void)self; (void)color;
-  printf ("wslcd_fill_area %d %d %d %d\n", xstart, ystart, xend, yend);
-#endif
   }
 
 /*============================================================================
@@ -473,7 +585,6 @@ void wslcd_fill_area (const WSLCD *self, uint16_t xstart,
  ===========================================================================*/
 void wslcd_clear (WSLCD *self, uint16_t colour)
   {
-#if PICO_ON_DEVICE
   //int baud = spi_get_baudrate (self->spi); 
   //printf ("baud=%d\n", baud);
 
@@ -489,9 +600,8 @@ void wslcd_clear (WSLCD *self, uint16_t colour)
   _wslcd_set_scroll_area (self, 0, (uint16_t)self->height, 0);
   wslcd_fill_area (self, 0, 0, 
 //       (uint16_t)self->width, (uint16_t)self->height, colour);
-       (uint16_t)self->width, (uint16_t)self->actual_height, colour);
+       (uint16_t)self->width, (uint16_t)self->used_height, colour);
   wslcd_set_scroll_area (self);
-#endif
   }
 
 /*============================================================================
@@ -499,22 +609,17 @@ void wslcd_clear (WSLCD *self, uint16_t colour)
  ===========================================================================*/
 void wslcd_transfer (const WSLCD *self, const uint16_t *buff, int len)
   {
-#if PICO_ON_DEVICE
-  gpio_put (self->gpio_dc, 1);
-  gpio_put (self->gpio_cs, 0);
-  // Ugh. We have to do this word-by-word, because we need to reverse the
-  //   byte order. The WSLCD device expects big-endian 16-bit values, while
-  //   the ARM uses little-endian. Since most (all?) operations on the 
-  //   display are 16-bit, we have to swap bytes on every word :/
-  for (int i = 0; i < len; i++) 
-    {
-    wslcd_write_word_be (self, *buff++);
-    }
-  gpio_put (self->gpio_cs, 1);
-#else
-  (void)self; (void)buff;
-  printf ("wslcd_transfer %d\n", len);
-#endif
+  wslcd_transfer_async (self, buff, len);
+  wslcd_wait (self);
+  }
+
+/*============================================================================
+  wslcd_transfer_async
+ ===========================================================================*/
+void wslcd_transfer_async (const WSLCD *self, const uint16_t *buff, int len)
+  {
+  if (len <= 0) return;
+  wslcd_pixels_start (self, buff, (uint32_t)len, true);
   }
 
 /*============================================================================
@@ -523,20 +628,8 @@ void wslcd_transfer (const WSLCD *self, const uint16_t *buff, int len)
 void wslcd_transfer_window (const WSLCD *self, const uint16_t *buff, uint16_t w, 
         uint16_t h, uint16_t x, uint16_t y)
   {
-#if PICO_ON_DEVICE
-  wslcd_set_window (self, x, y, x + w, y + h); 
-  int len = w * h;
-  gpio_put (self->gpio_dc, 1);
-  gpio_put (self->gpio_cs, 0);
-  for (int i = 0; i < len; i++) 
-    {
-    wslcd_write_word_be (self, buff[i]);
-    }
-  gpio_put (self->gpio_cs, 1);
-#else
-  (void)self; (void)buff;
-  printf ("wslcd_transfer %d %d %d %d\n", w, h, x, y);
-#endif
+  wslcd_set_window (self, x, y, (uint16_t)(x + w), (uint16_t)(y + h)); 
+  wslcd_transfer (self, buff, w * h);
   }
 
 /*============================================================================
@@ -561,19 +654,11 @@ int wslcd_get_height (const WSLCD *self)
 void wslcd_set_pixel (const WSLCD *self, uint16_t x, uint16_t y, 
       uint16_t colour)
   {
-#if PICO_ON_DEVICE
   if ((x < self->width) && (y <= self->height)) 
     {
     wslcd_set_cursor (self, x, y);
-    gpio_put (self->gpio_dc, 1);
-    gpio_put (self->gpio_cs, 0);
-
-    wslcd_write_word_be (self, colour);
-    gpio_put (self->gpio_cs, 1);
+    wslcd_transfer (self, &colour, 1);
     }
-#else
-  (void)self; (void)x; (void)y; (void)colour;
-#endif
   }
 
 /*============================================================================
@@ -581,7 +666,6 @@ void wslcd_set_pixel (const WSLCD *self, uint16_t x, uint16_t y,
  ===========================================================================*/
 void wslcd_scroll_up (WSLCD *self, uint16_t pixels)
   {
-#if PICO_ON_DEVICE
   wslcd_write_reg (self, 0x37);
 
   self->scroll_pos = 
@@ -591,7 +675,6 @@ void wslcd_scroll_up (WSLCD *self, uint16_t pixels)
   wslcd_write_data (self, self->scroll_pos & 0xFF);
 
   //gpio_put (self->gpio_cs, 1);
-#endif
   }
 
 /*============================================================================
@@ -641,6 +724,10 @@ void wslcd_init (WSLCD *self)
 #if PICO_ON_DEVICE
   wslcd_gpio_init (self);
 
+  self->dma = malloc (sizeof (WSLCDDma));
+  memset (self->dma, 0, sizeof (WSLCDDma));
+  self->dma->channel = dma_claim_unused_channel (true);
+
   wslcd_reset (self); //Hardware reset
 
   spi_set_baudrate (self->spi, (uint)self->baud_rate);
@@ -656,8 +743,11 @@ void wslcd_init (WSLCD *self)
 
   sleep_ms (200);
 #else
-  (void)self;
-  printf ("wslcd_init\n");
+  // The host stand-in behaves as a 3.5" panel in normal scan direction
+  self->width = LCD_3_5_WIDTH;
+  self->height = LCD_3_5_HEIGHT;
+  self->used_width = self->width;
+  self->used_height = self->height;
 #endif
   }
 
@@ -699,6 +789,14 @@ WSLCD *wslcd_new (void)
  ===========================================================================*/
 void wslcd_destroy (WSLCD *self)
   {
+#if PICO_ON_DEVICE
+  if (self->dma)
+    {
+    wslcd_wait (self);
+    dma_channel_unclaim ((uint)self->dma->channel);
+    free (self->dma);
+    }
+#endif
   free (self);
   }
 
@@ -21,6 +21,7 @@
 #include <syslog/syslog.h>
 #include <sys/process.h>
 #include <sdcard/sdcard.h>
+#include <chardev/picoconsoledev.h>
 #include <fat/fat.h>
 #include <fat/fatfile.h>
 #include <fat/fatdir.h>
@@ -82,6 +83,7 @@ Error fatsd_mount (FSysDescriptor *descriptor)
       {
       SDCardType ct = sdcard_get_type (self->sdcard); 
       const char *ctstring = sdcard_type_to_string (ct);
+      picoconsoledev_flush ();
       printf ("Card type: %s\n", ctstring); 
       uint64_t sectors = sdcard_get_sectors (self->sdcard);
       printf ("Card capacity: %llu sectors, %u Mb \n", sectors, 
@@ -96,6 +98,7 @@ Error fatsd_mount (FSysDescriptor *descriptor)
     FRESULT fr = f_mount (&(self->fatfs), "0:", 1); // TODO
     if (fr)
       {
+      picoconsoledev_flush ();
       printf ("Mount error %d\n", fr);
       ret = fat_fresult_to_error (fr);
       }
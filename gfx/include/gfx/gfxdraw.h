@@ -0,0 +1,37 @@
+/*============================================================================
+ *  gfx/gfxdraw.h
+ *
+ * Copyright (c)2023 Kevin Boone, GPL v3.0
+ * ==========================================================================*/
+#pragma once
+
+#include <stdint.h>
+#include <sys/error.h>
+#include <sys/filedesc.h>
+#include <bearos/devctl.h>
+
+// The largest coordinate or size a drawing command may use
+#define GFXDRAW_MAX_COORD 32767
+
+/** Read n pixels from row y of the screen, starting at x. */
+typedef void (*GfxDrawReadFn) (void *ctx, int x, int y, int n,
+          uint16_t *out);
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/** Carry out the commands in a DC_GFX_DRAW list, on a graphics device of
+    width x height pixels. Everything is clipped, and then drawn using the
+    device's own DC_GFX_SET_REGION, DC_GFX_FILL and DC_GFX_WRITE devctls,
+    so a device only has to pass the list on. Lines are drawn as runs of
+    pixels, not pixel by pixel. If read is NULL, the device cannot
+    read back pixels, and DC_GFX_OP_COPY_RECT fails with ENOTSUP.
+    Commands are carried out in order, until one is invalid. */
+extern Error gfxdraw_run (FileDesc *f, int width, int height,
+          const DevCtlGfxDrawList *list, GfxDrawReadFn read, void *ctx);
+
+#ifdef __cplusplus
+}
+#endif
+
@@ -0,0 +1,52 @@
+/*============================================================================
+ *  gfx/glyphcache.h
+ *
+ * A cache of glyphs that have been expanded into pixel data, ready to be
+ * written to a graphics device in one transfer. Each glyph is stored for a
+ * particular font, scale, foreground and background colour, and pixel 
+ * size. The
+ * cache is filled as characters are drawn, and when it reaches its
+ * memory budget, the least-recently used glyphs are discarded.
+ *
+ * Copyright (c)2023 Kevin Boone, GPL v3.0
+ * ==========================================================================*/
+#pragma once
+
+#include <stdint.h>
+#include <stddef.h>
+#include <gfx/packedfont.h>
+
+struct _GlyphCache;
+typedef struct _GlyphCache GlyphCache;
+
+typedef struct _GlyphCacheStats
+  {
+  uint32_t hits;
+  uint32_t misses;
+  uint32_t evictions;
+  uint32_t bytes; // Pixel data currently held
+  } GlyphCacheStats;
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/** Create a cache that will hold at most budget bytes of pixel data. */
+GlyphCache *glyphcache_create (size_t budget);
+
+void glyphcache_destroy (GlyphCache *self);
+
+/** Get the pixel data for character c, as drawn by packedfont_render(),
+    which is (width * scale) * (height * scale) * bytes_pp bytes long. The
+    data is valid until the next call to any glyphcache_ function. */
+const uint8_t *glyphcache_get (GlyphCache *self, const PackedFont *font, 
+         int scale, uint32_t fg, uint32_t bg, int bytes_pp, int c);
+
+/** Discard all glyphs. */
+void glyphcache_clear (GlyphCache *self);
+
+void glyphcache_get_stats (const GlyphCache *self, GlyphCacheStats *stats);
+
+#ifdef __cplusplus
+}
+#endif
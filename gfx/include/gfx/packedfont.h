@@ -0,0 +1,94 @@
+/*============================================================================
+ *  gfx/packedfont.h
+ *
+ * The compact font format that is built into the firmware. Each glyph is
+ * stored as the bounding box of its set pixels, and each row of the box is
+ * run-length encoded. The fonts are made from the bitmap tables in
+ * gfx/fonts by tools/fontpack.c, and only those selected by the build
+ * (GFX_FONTS in CMakeLists.txt) are compiled in.
+ *
+ * Row encoding: each byte is a run of background pixels in the top four
+ * bits, followed by a run of foreground pixels in the bottom four, and the
+ * row ends when the runs add up to the width of the box. A zero byte at
+ * the start of a row means that the row is the same as the one above.
+ * Small glyphs can be smaller as a plain bitmap of the box, w bits per row
+ * with no padding between rows; these are marked by PACKEDFONT_BITMAP.
+ *
+ * A font with small cells can be smaller with no glyph table at all. Then
+ * 'glyphs' is NULL, and each glyph is a plain bitmap of the whole cell,
+ * starting on a byte boundary.
+ *
+ * Copyright (c)2023 Kevin Boone, GPL v3.0
+ * ==========================================================================*/
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+#include <stdbool.h>
+
+// The largest scale factor packedfont_render accepts
+#define PACKEDFONT_MAX_SCALE 4
+
+// Set in PackedGlyph.offset if the glyph is a bitmap, rather than runs
+#define PACKEDFONT_BITMAP 0x8000
+
+typedef struct _PackedGlyph
+  {
+  // Offset of the glyph's rows in PackedFont.data, perhaps with 
+  //   PACKEDFONT_BITMAP set
+  uint16_t offset;
+  // The bounding box, relative to the top-left of the character cell. A
+  //   glyph with no pixels set, like the space, has w and h of zero.
+  uint8_t x;
+  uint8_t y;
+  uint8_t w;
+  uint8_t h;
+  } PackedGlyph;
+
+typedef struct _PackedFont
+  {
+  // Size of the character cell, in pixels
+  uint16_t width;
+  uint16_t height;
+  // The characters that the font contains. If 'last' is 255, the font
+  //   has the Latin-1 characters as well as ASCII.
+  uint8_t first;
+  uint8_t last;
+  // NULL if every glyph is a bitmap of the whole cell
+  const PackedGlyph *glyphs;
+  const uint8_t *data;
+  // Length of 'data', in bytes
+  uint16_t data_size;
+  } PackedFont;
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// The fonts that have been built in. Declaring all of them is harmless;
+//   using one that was not selected is a link error.
+extern const PackedFont PackedFont8;
+extern const PackedFont PackedFont12;
+extern const PackedFont PackedFont16;
+extern const PackedFont PackedFont20;
+extern const PackedFont PackedFont24;
+
+/** Returns the character that will be drawn for c. Latin-1 letters that
+    the font does not contain are drawn without their accents, and
+    anything else that is missing is drawn as '?'. */
+extern int packedfont_map_char (const PackedFont *font, int c);
+
+/** Expand character c into a buffer of (width * scale) x (height * scale)
+    pixels, each of bytes_pp bytes. Colours are in the device's pixel
+    format, and the first bytes_pp bytes of fg and bg, in memory order,
+    are used. */
+extern void packedfont_render (const PackedFont *font, int scale,
+         uint32_t fg, uint32_t bg, int bytes_pp, int c, uint8_t *buffer);
+
+/** Returns the number of bytes of flash that the font occupies. */
+extern uint32_t packedfont_get_size (const PackedFont *font);
+
+#ifdef __cplusplus
+}
+#endif
+
@@ -0,0 +1,282 @@
+/*============================================================================
+ *  gfx/gfxdraw.c
+ *
+ *  The batch drawing operations of DC_GFX_DRAW, in terms of the basic
+ *  region, fill, and write operations that every graphics device has.
+ *
+ * Copyright (c)2023 Kevin Boone, GPL v3.0
+ * ==========================================================================*/
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdbool.h>
+#include <errno.h>
+#include <gfx/gfxdraw.h>
+
+typedef struct _GfxDraw
+  {
+  FileDesc *f;
+  // The clipping rectangle; x1 and y1 are exclusive
+  int x0;
+  int y0;
+  int x1;
+  int y1;
+  GfxDrawReadFn read;
+  void *ctx;
+  } GfxDraw;
+
+/*============================================================================
+ * gfxdraw_region
+ * ==========================================================================*/
+static void gfxdraw_region (const GfxDraw *d, int x, int y, int w, int h)
+  {
+  DevCtlGfxRegion region;
+  region.x = x;
+  region.y = y;
+  region.cx = w;
+  region.cy = h;
+  d->f->devctl (d->f, DC_GFX_SET_REGION, (intptr_t)&region);
+  }
+
+/*============================================================================
+ * gfxdraw_fill
+ * Fill a rectangle, after clipping it.
+ * ==========================================================================*/
+static void gfxdraw_fill (const GfxDraw *d, int x, int y, int w, int h,
+          uint16_t colour)
+  {
+  int xe = x + w;
+  int ye = y + h;
+  if (x < d->x0) x = d->x0;
+  if (y < d->y0) y = d->y0;
+  if (xe > d->x1) xe = d->x1;
+  if (ye > d->y1) ye = d->y1;
+  if (x >= xe || y >= ye) return;
+  gfxdraw_region (d, x, y, xe - x, ye - y);
+  DevCtlGfxColour c;
+  memset (&c, 0, sizeof (c));
+  c.rgb565 = colour;
+  d->f->devctl (d->f, DC_GFX_FILL, (intptr_t)&c);
+  }
+
+/*============================================================================
+ * gfxdraw_write
+ * Write w x h pixels, which must already be clipped.
+ * ==========================================================================*/
+static void gfxdraw_write (const GfxDraw *d, int x, int y, int w, int h,
+          const uint16_t *pixels)
+  {
+  gfxdraw_region (d, x, y, w, h);
+  DevCtlGfxWrite wr;
+  wr.buffer = (void *)pixels;
+  wr.length = w * h * (int)sizeof (uint16_t);
+  d->f->devctl (d->f, DC_GFX_WRITE, (intptr_t)&wr);
+  }
+
+/*============================================================================
+ * gfxdraw_line
+ * Bresenham's algorithm. Consecutive pixels along the major axis are
+ *   collected into runs, and each run is drawn as a single fill, so a
+ *   nearly-horizontal line costs a few fills, rather than one per pixel.
+ * ==========================================================================*/
+static void gfxdraw_line (const GfxDraw *d, int x, int y, int xe, int ye,
+          uint16_t colour)
+  {
+  int dx = abs (xe - x);
+  int dy = -abs (ye - y);
+  int sx = x < xe ? 1 : -1;
+  int sy = y < ye ? 1 : -1;
+  int err = dx + dy;
+  bool steep = -dy > dx;
+  // The start of the current run, and its length
+  int rx = x, ry = y, len = 1;
+
+  for (;;)
+    {
+    bool last = (x == xe && y == ye);
+    int nx = x, ny = y;
+    if (!last)
+      {
+      int e2 = 2 * err;
+      if (e2 >= dy) { err += dy; nx += sx; }
+      if (e2 <= dx) { err += dx; ny += sy; }
+      if (steep ? (nx == x) : (ny == y))
+        {
+        len++;
+        x = nx; y = ny;
+        continue;
+        }
+      }
+
+    // The run has ended
+    if (steep)
+      gfxdraw_fill (d, rx, sy > 0 ? ry : ry - len + 1, 1, len, colour);
+    else
+      gfxdraw_fill (d, sx > 0 ? rx : rx - len + 1, ry, len, 1, colour);
+    if (last) break;
+    x = nx; y = ny;
+    rx = x; ry = y; len = 1;
+    }
+  }
+
+/*============================================================================
+ * gfxdraw_blit
+ * Without a key, a blit that is not clipped at the sides is a single
+ *   write. With a key, each row is written as runs of pixels that are
+ *   not the key colour.
+ * ==========================================================================*/
+static void gfxdraw_blit (const GfxDraw *d, const DevCtlGfxDrawCmd *c)
+  {
+  int x0 = c->x > d->x0 ? c->x : d->x0;
+  int y0 = c->y > d->y0 ? c->y : d->y0;
+  int x1 = c->x + c->w < d->x1 ? c->x + c->w : d->x1;
+  int y1 = c->y + c->h < d->y1 ? c->y + c->h : d->y1;
+  if (x0 >= x1 || y0 >= y1) return;
+
+  const uint16_t *row = c->pixels + (y0 - c->y) * c->w + (x0 - c->x);
+  if (!(c->flags & DC_GFX_DRAW_KEY))
+    {
+    if (x1 - x0 == c->w)
+      {
+      gfxdraw_write (d, x0, y0, x1 - x0, y1 - y0, row);
+      return;
+      }
+    for (int y = y0; y < y1; y++, row += c->w)
+      gfxdraw_write (d, x0, y, x1 - x0, 1, row);
+    return;
+    }
+
+  for (int y = y0; y < y1; y++, row += c->w)
+    {
+    int i = 0, n = x1 - x0;
+    while (i < n)
+      {
+      while (i < n && row[i] == c->key) i++;
+      int start = i;
+      while (i < n && row[i] != c->key) i++;
+      if (i > start)
+        gfxdraw_write (d, x0 + start, y, i - start, 1, row + start);
+      }
+    }
+  }
+
+/*============================================================================
+ * gfxdraw_copy_rect
+ * Rows are copied one at a time, through a buffer, in an order that
+ *   works if the source and destination overlap.
+ * ==========================================================================*/
+static Error gfxdraw_copy_rect (const GfxDraw *d, int width, int height,
+          const DevCtlGfxDrawCmd *c)
+  {
+  if (!d->read) return ENOTSUP;
+  int x = c->x, y = c->y, sx = c->x2, sy = c->y2, w = c->w, h = c->h;
+
+  // Clip the destination, and then the source, to the screen; moving the
+  //   corner of one moves the corner of the other.
+  int cut;
+  if ((cut = d->x0 - x) > 0) { x += cut; sx += cut; w -= cut; }
+  if ((cut = d->y0 - y) > 0) { y += cut; sy += cut; h -= cut; }
+  if ((cut = -sx) > 0) { x += cut; sx += cut; w -= cut; }
+  if ((cut = -sy) > 0) { y += cut; sy += cut; h -= cut; }
+  if (x + w > d->x1) w = d->x1 - x;
+  if (y + h > d->y1) h = d->y1 - y;
+  if (sx + w > width) w = width - sx;
+  if (sy + h > height) h = height - sy;
+  if (w <= 0 || h <= 0) return 0;
+
+  uint16_t *buff = malloc ((size_t)w * sizeof (uint16_t));
+  if (!buff) return ENOMEM;
+  bool up = y <= sy;
+  for (int i = 0; i < h; i++)
+    {
+    int r = up ? i : h - 1 - i;
+    d->read (d->ctx, sx, sy + r, w, buff);
+    gfxdraw_write (d, x, y + r, w, 1, buff);
+    }
+  free (buff);
+  return 0;
+  }
+
+/*============================================================================
+ * gfxdraw_check
+ * Reject anything that could overflow, or take for ever to clip.
+ * ==========================================================================*/
+static bool gfxdraw_check (const DevCtlGfxDrawCmd *c)
+  {
+  const int m = GFXDRAW_MAX_COORD;
+  if (c->x < -m || c->x > m || c->y < -m || c->y > m) return false;
+  if (c->x2 < -m || c->x2 > m || c->y2 < -m || c->y2 > m) return false;
+  if (c->w < 0 || c->w > m || c->h < 0 || c->h > m) return false;
+  if (c->op == DC_GFX_OP_BLIT && !c->pixels) return false;
+  return true;
+  }
+
+/*============================================================================
+ * gfxdraw_run
+ * ==========================================================================*/
+Error gfxdraw_run (FileDesc *f, int width, int height,
+          const DevCtlGfxDrawList *list, GfxDrawReadFn read, void *ctx)
+  {
+  GfxDraw d;
+  d.f = f;
+  d.read = read;
+  d.ctx = ctx;
+  d.x0 = 0;
+  d.y0 = 0;
+  d.x1 = width;
+  d.y1 = height;
+  const DevCtlGfxRegion *clip = &list->clip;
+  if (clip->cx > 0 && clip->cy > 0)
+    {
+    if (clip->x > d.x0) d.x0 = clip->x;
+    if (clip->y > d.y0) d.y0 = clip->y;
+    if (clip->x + clip->cx < d.x1) d.x1 = clip->x + clip->cx;
+    if (clip->y + clip->cy < d.y1) d.y1 = clip->y + clip->cy;
+    }
+
+  for (int i = 0; i < list->count; i++)
+    {
+    const DevCtlGfxDrawCmd *c = &list->cmds[i];
+    if (!gfxdraw_check (c)) return EINVAL;
+    switch (c->op)
+      {
+      case DC_GFX_OP_HLINE:
+        gfxdraw_fill (&d, c->x, c->y, c->w, 1, c->colour);
+        break;
+      case DC_GFX_OP_VLINE:
+        gfxdraw_fill (&d, c->x, c->y, 1, c->h, c->colour);
+        break;
+      case DC_GFX_OP_RECT:
+        if (c->w <= 2 || c->h <= 2)
+          gfxdraw_fill (&d, c->x, c->y, c->w, c->h, c->colour);
+        else
+          {
+          gfxdraw_fill (&d, c->x, c->y, c->w, 1, c->colour);
+          gfxdraw_fill (&d, c->x, c->y + c->h - 1, c->w, 1, c->colour);
+          gfxdraw_fill (&d, c->x, c->y + 1, 1, c->h - 2, c->colour);
+          gfxdraw_fill (&d, c->x + c->w - 1, c->y + 1, 1, c->h - 2,
+            c->colour);
+          }
+        break;
+      case DC_GFX_OP_FILL_RECT:
+        gfxdraw_fill (&d, c->x, c->y, c->w, c->h, c->colour);
+        break;
+      case DC_GFX_OP_LINE:
+        gfxdraw_line (&d, c->x, c->y, c->x2, c->y2, c->colour);
+        break;
+      case DC_GFX_OP_BLIT:
+        gfxdraw_blit (&d, c);
+        break;
+      case DC_GFX_OP_COPY_RECT:
+        {
+        Error ret = gfxdraw_copy_rect (&d, width, height, c);
+        if (ret) return ret;
+        }
+        break;
+      default:
+        return EINVAL;
+      }
+    }
+  return 0;
+  }
+
@@ -0,0 +1,182 @@
+/*============================================================================
+ *  gfx/glyphcache.c
+ *
+ * Copyright (c)2023 Kevin Boone, GPL v3.0
+ * ==========================================================================*/
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include <klib/hashmap.h>
+#include <gfx/glyphcache.h>
+
+typedef struct _GlyphKey
+  {
+  const PackedFont *font;
+  int scale;
+  uint32_t fg;
+  uint32_t bg;
+  int bytes_pp;
+  int c;
+  } GlyphKey;
+
+// An entry is the key, the list links, and the pixel data, in a single
+//   allocation. The least-recently used entry is at the tail of the list.
+typedef struct _GlyphEntry
+  {
+  GlyphKey key;
+  struct _GlyphEntry *prev;
+  struct _GlyphEntry *next;
+  size_t size;
+  uint8_t data[];
+  } GlyphEntry;
+
+struct _GlyphCache
+  {
+  HashMap *map;
+  GlyphEntry *head;
+  GlyphEntry *tail;
+  size_t budget;
+  GlyphCacheStats stats;
+  };
+
+/*============================================================================
+ * glyphcache_hash
+ * ==========================================================================*/
+static uint32_t glyphcache_hash (const void *key)
+  {
+  const GlyphKey *k = key;
+  uint32_t h = (uint32_t)(uintptr_t)k->font;
+  h = h * 31 + (uint32_t)k->scale;
+  h = h * 31 + k->fg;
+  h = h * 31 + k->bg;
+  h = h * 31 + (uint32_t)k->bytes_pp;
+  h = h * 31 + (uint32_t)k->c;
+  return hashmap_hash_int ((const void *)(uintptr_t)h);
+  }
+
+/*============================================================================
+ * glyphcache_equal
+ * ==========================================================================*/
+static BOOL glyphcache_equal (const void *key1, const void *key2)
+  {
+  const GlyphKey *k1 = key1;
+  const GlyphKey *k2 = key2;
+  return k1->font == k2->font && k1->scale == k2->scale
+    && k1->fg == k2->fg && k1->bg == k2->bg
+    && k1->bytes_pp == k2->bytes_pp && k1->c == k2->c;
+  }
+
+/*============================================================================
+ * glyphcache_create
+ * ==========================================================================*/
+GlyphCache *glyphcache_create (size_t budget)
+  {
+  GlyphCache *self = malloc (sizeof (GlyphCache));
+  memset (self, 0, sizeof (GlyphCache));
+  // The map owns the entries
+  self->map = hashmap_create (glyphcache_hash, glyphcache_equal, free);
+  self->budget = budget;
+  return self;
+  }
+
+/*============================================================================
+ * glyphcache_destroy
+ * ==========================================================================*/
+void glyphcache_destroy (GlyphCache *self)
+  {
+  hashmap_destroy (self->map);
+  free (self);
+  }
+
+/*============================================================================
+ * glyphcache_clear
+ * ==========================================================================*/
+void glyphcache_clear (GlyphCache *self)
+  {
+  hashmap_clear (self->map);
+  self->head = self->tail = NULL;
+  self->stats.bytes = 0;
+  }
+
+/*============================================================================
+ * glyphcache_get_stats
+ * ==========================================================================*/
+void glyphcache_get_stats (const GlyphCache *self, GlyphCacheStats *stats)
+  {
+  *stats = self->stats;
+  }
+
+/*============================================================================
+ * glyphcache_unlink
+ * ==========================================================================*/
+static void glyphcache_unlink (GlyphCache *self, GlyphEntry *e)
+  {
+  if (e->prev) e->prev->next = e->next; else self->head = e->next;
+  if (e->next) e->next->prev = e->prev; else self->tail = e->prev;
+  e->prev = e->next = NULL;
+  }
+
+/*============================================================================
+ * glyphcache_push_front
+ * ==========================================================================*/
+static void glyphcache_push_front (GlyphCache *self, GlyphEntry *e)
+  {
+  e->prev = NULL;
+  e->next = self->head;
+  if (self->head) self->head->prev = e;
+  self->head = e;
+  if (!self->tail) self->tail = e;
+  }
+
+/*============================================================================
+ * glyphcache_get
+ * ==========================================================================*/
+const uint8_t *glyphcache_get (GlyphCache *self, const PackedFont *font, 
+         int scale, uint32_t fg, uint32_t bg, int bytes_pp, int c)
+  {
+  c = packedfont_map_char (font, c);
+  GlyphKey key;
+  memset (&key, 0, sizeof (key));
+  key.font = font;
+  key.scale = scale;
+  key.fg = fg;
+  key.bg = bg;
+  key.bytes_pp = bytes_pp;
+  key.c = c;
+
+  GlyphEntry *e = hashmap_get (self->map, &key);
+  if (e)
+    {
+    self->stats.hits++;
+    if (e != self->head)
+      {
+      glyphcache_unlink (self, e);
+      glyphcache_push_front (self, e);
+      }
+    return e->data;
+    }
+
+  self->stats.misses++;
+  size_t size = (size_t)(font->width * scale * font->height * scale 
+    * bytes_pp);
+  // Make room. The glyph is always added, even if it is bigger than 
+  //   the whole budget, because the caller needs somewhere to draw it
+  while (self->tail && self->stats.bytes + size > self->budget)
+    {
+    GlyphEntry *old = self->tail;
+    glyphcache_unlink (self, old);
+    self->stats.bytes -= (uint32_t)old->size;
+    self->stats.evictions++;
+    hashmap_remove (self->map, &old->key);
+    }
+
+  e = malloc (sizeof (GlyphEntry) + size);
+  if (!e) return NULL;
+  e->key = key;
+  e->size = size;
+  packedfont_render (font, scale, fg, bg, bytes_pp, c, e->data);
+  hashmap_put (self->map, &e->key, e);
+  glyphcache_push_front (self, e);
+  self->stats.bytes += (uint32_t)size;
+  return e->data;
+  }
@@ -0,0 +1,153 @@
+/*============================================================================
+ *  gfx/packedfont.c
+ *
+ *  The decoder for packed fonts. See packedfont.h for the format.
+ *
+ * Copyright (c)2023 Kevin Boone, GPL v3.0
+ * ==========================================================================*/
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdbool.h>
+#include <gfx/packedfont.h>
+
+// What to draw for Latin-1 characters 0xA0-0xFF, when the font only has
+//   ASCII: the nearest ASCII character, usually the letter without
+//   its accent.
+static const char latin1_fold[] =
+  " !cL?Y|S\"ca<--r-o+23'uP.,1o>????"
+  "AAAAAAACEEEEIIIIDNOOOOOxOUUUUYPs"
+  "aaaaaaaceeeeiiiidnooooo/ouuuuypy";
+
+/*============================================================================
+ * packedfont_map_char
+ * ==========================================================================*/
+int packedfont_map_char (const PackedFont *font, int c)
+  {
+  if (c >= font->first && c <= font->last) return c;
+  if (c >= 0xA0 && c <= 0xFF)
+    {
+    c = (uint8_t)latin1_fold[c - 0xA0];
+    if (c >= font->first && c <= font->last) return c;
+    }
+  return '?';
+  }
+
+/*============================================================================
+ * packedfont_fill
+ * Set n pixels to the colour col, and return the next pixel.
+ * ==========================================================================*/
+static inline uint8_t *packedfont_fill (uint8_t *p, const uint8_t *col,
+         int bytes_pp, int n)
+  {
+  switch (bytes_pp)
+    {
+    case 2:
+      for (int i = 0; i < n; i++, p += 2)
+        {
+        p[0] = col[0]; p[1] = col[1];
+        }
+      return p;
+    case 3:
+      for (int i = 0; i < n; i++, p += 3)
+        {
+        p[0] = col[0]; p[1] = col[1]; p[2] = col[2];
+        }
+      return p;
+    default:
+      for (int i = 0; i < n; i++, p += bytes_pp)
+        memcpy (p, col, (size_t)bytes_pp);
+      return p;
+    }
+  }
+
+/*============================================================================
+ * packedfont_render
+ * The cell is filled with the background, and then only the bounding
+ *   box is decoded. Each decoded row is drawn once, at full scale, and
+ *   then copied for the remaining scale - 1 rows, as are rows that the
+ *   font marks as repeats.
+ * ==========================================================================*/
+void packedfont_render (const PackedFont *font, int scale, uint32_t fg,
+         uint32_t bg, int bytes_pp, int c, uint8_t *buffer)
+  {
+  if (scale < 1) scale = 1;
+  if (scale > PACKEDFONT_MAX_SCALE) scale = PACKEDFONT_MAX_SCALE;
+  const uint8_t *fgp = (const uint8_t *)&fg;
+  const uint8_t *bgp = (const uint8_t *)&bg;
+  size_t line = (size_t)(font->width * scale * bytes_pp);
+  int lines = font->height * scale;
+
+  packedfont_fill (buffer, bgp, bytes_pp, font->width * scale);
+  for (int i = 1; i < lines; i++)
+    memcpy (buffer + (size_t)i * line, buffer, line);
+
+  c = packedfont_map_char (font, c);
+  const PackedGlyph *g;
+  const uint8_t *p;
+  bool bitmap;
+  PackedGlyph cell;
+  if (font->glyphs)
+    {
+    g = &font->glyphs[c - font->first];
+    p = font->data + (g->offset & ~PACKEDFONT_BITMAP);
+    bitmap = (g->offset & PACKEDFONT_BITMAP) != 0;
+    }
+  else
+    {
+    cell.x = 0;
+    cell.y = 0;
+    cell.w = (uint8_t)font->width;
+    cell.h = (uint8_t)font->height;
+    g = &cell;
+    p = font->data + (c - font->first) * ((font->width * font->height + 7) / 8);
+    bitmap = true;
+    }
+  int bit = 0;
+  for (int r = 0; r < g->h; r++)
+    {
+    uint8_t *dest = buffer + (size_t)((g->y + r) * scale) * line;
+    if (bitmap)
+      {
+      for (int x = g->x; x < g->x + g->w; x++, bit++)
+        {
+        if (p[bit >> 3] & (0x80 >> (bit & 7)))
+          packedfont_fill (dest + (size_t)(x * scale * bytes_pp), fgp,
+            bytes_pp, scale);
+        }
+      }
+    else if (*p == 0)
+      {
+      p++;
+      if (r > 0) memcpy (dest, dest - (size_t)scale * line, line);
+      }
+    else
+      {
+      int x = g->x;
+      int end = g->x + g->w;
+      while (x < end)
+        {
+        uint8_t run = *p++;
+        x += run >> 4;
+        int n = run & 0x0F;
+        packedfont_fill (dest + (size_t)(x * scale * bytes_pp), fgp,
+          bytes_pp, n * scale);
+        x += n;
+        }
+      }
+    for (int s = 1; s < scale; s++)
+      memcpy (dest + (size_t)s * line, dest, line);
+    }
+  }
+
+/*============================================================================
+ * packedfont_get_size
+ * ==========================================================================*/
+uint32_t packedfont_get_size (const PackedFont *font)
+  {
+  uint32_t glyphs = font->glyphs ? (uint32_t)(font->last - font->first + 1)
+    : 0;
+  return (uint32_t)sizeof (PackedFont)
+    + glyphs * (uint32_t)sizeof (PackedGlyph) + font->data_size;
+  }
+
@@ -0,0 +1,159 @@
+/*============================================================================
+ *  gfx/pfont12.c
+ *
+ *  Font12, packed by tools/fontpack.c from gfx/fonts/font12.c, which
+ *  carries the font's licence. Do not edit.
+ * ==========================================================================*/
+#ifdef GFX_FONT_12
+
+#include <gfx/packedfont.h>
+
+static const uint8_t pfont12_data[462] =
+  {
+  0xF9, 0xDC, 0xA4, 0x29, 0x55, 0xF5, 0x7D, 0x54, 0xA0, 0x27, 0x88, 0x79,
+  0xE2, 0x20, 0x45, 0x10, 0x3E, 0x08, 0xA2, 0x32, 0x11, 0x59, 0x34, 0xF0,
+  0x5A, 0xAA, 0x50, 0xA5, 0x55, 0xA0, 0x27, 0xC8, 0xA5, 0x00, 0x10, 0x20,
+  0x47, 0xF1, 0x02, 0x04, 0x00, 0x6B, 0x40, 0x05, 0xF0, 0x08, 0x44, 0x22,
+  0x11, 0x08, 0x80, 0x74, 0x63, 0x18, 0xC6, 0x2E, 0x61, 0x08, 0x42, 0x10,
+  0x9F, 0x74, 0x42, 0x22, 0x22, 0x3F, 0x74, 0x42, 0x60, 0x86, 0x2E, 0x18,
+  0xA2, 0x92, 0x8B, 0xF0, 0x87, 0x7A, 0x10, 0xE0, 0x86, 0x2E, 0x3A, 0x21,
+  0xE8, 0xC6, 0x2E, 0xFC, 0x42, 0x21, 0x08, 0x84, 0x74, 0x62, 0xE8, 0xC6,
+  0x2E, 0x74, 0x63, 0x17, 0x84, 0x5C, 0xF0, 0xF0, 0x6C, 0x07, 0xA0, 0x0C,
+  0x46, 0x20, 0x60, 0x40, 0xC0, 0xF8, 0x3E, 0xC0, 0x81, 0x81, 0x18, 0x8C,
+  0x00, 0x69, 0x12, 0x40, 0xC0, 0x74, 0x63, 0x3A, 0xD6, 0x70, 0x8B, 0x80,
+  0x30, 0x20, 0xA1, 0x42, 0x8F, 0x91, 0x77, 0xF9, 0x14, 0x5E, 0x45, 0x14,
+  0x7E, 0x7C, 0x61, 0x08, 0x42, 0x2E, 0xF1, 0x24, 0x51, 0x45, 0x14, 0xBC,
+  0xFD, 0x15, 0x1C, 0x51, 0x04, 0x7F, 0xFD, 0x15, 0x1C, 0x51, 0x04, 0x38,
+  0x7A, 0x28, 0x20, 0x9E, 0x28, 0x9C, 0xEE, 0x89, 0x13, 0xE4, 0x48, 0x91,
+  0x77, 0xF9, 0x08, 0x42, 0x10, 0x9F, 0x78, 0x84, 0x29, 0x4A, 0x4C, 0xEE,
+  0x89, 0x22, 0x87, 0x09, 0x11, 0x73, 0xE2, 0x10, 0x84, 0x25, 0x3F, 0xEE,
+  0xD9, 0xB2, 0xA5, 0x48, 0x91, 0x77, 0xEE, 0xC9, 0x92, 0xA5, 0x4A, 0x93,
+  0x76, 0x74, 0x63, 0x18, 0xC6, 0x2E, 0xF2, 0x52, 0x97, 0x21, 0x1C, 0x74,
+  0x63, 0x18, 0xC6, 0x2E, 0x38, 0xF8, 0x89, 0x12, 0x27, 0x89, 0x11, 0x71,
+  0x6C, 0xE0, 0xE0, 0x87, 0x36, 0xFF, 0x24, 0x40, 0x81, 0x02, 0x04, 0x1C,
+  0xEE, 0x89, 0x12, 0x24, 0x48, 0x91, 0x1C, 0xEE, 0x89, 0x11, 0x42, 0x85,
+  0x04, 0x08, 0xEE, 0x89, 0x12, 0xA5, 0x4A, 0x95, 0x14, 0xC6, 0x88, 0xA0,
+  0x81, 0x05, 0x11, 0x63, 0xEE, 0x88, 0xA1, 0x41, 0x02, 0x04, 0x1C, 0xFC,
+  0x44, 0x42, 0x22, 0x3F, 0xF2, 0x49, 0x24, 0x9C, 0x84, 0x44, 0x22, 0x11,
+  0x10, 0xE4, 0x92, 0x49, 0x3C, 0x21, 0x15, 0x10, 0x07, 0x90, 0x72, 0x27,
+  0xA2, 0x89, 0xF0, 0xC1, 0x05, 0x99, 0x45, 0x14, 0x7E, 0x7C, 0x61, 0x08,
+  0xB8, 0x18, 0x26, 0xA6, 0x8A, 0x28, 0x9F, 0x74, 0x7F, 0x08, 0x3C, 0x3A,
+  0x3E, 0x84, 0x21, 0x1F, 0x6E, 0x68, 0xA2, 0x89, 0xE0, 0x9C, 0xC0, 0x81,
+  0x63, 0x24, 0x48, 0x91, 0x77, 0x20, 0x38, 0x42, 0x10, 0x9F, 0x20, 0xF1,
+  0x11, 0x11, 0x1E, 0xC1, 0x05, 0xD2, 0x71, 0x44, 0xB7, 0x61, 0x08, 0x42,
+  0x10, 0x9F, 0xE8, 0xA9, 0x52, 0xA5, 0x5F, 0xC0, 0xD8, 0xC9, 0x12, 0x24,
+  0x5D, 0xC0, 0x74, 0x63, 0x18, 0xB8, 0xD9, 0x94, 0x51, 0x45, 0xE4, 0x38,
+  0x6E, 0x68, 0xA2, 0x89, 0xE0, 0x87, 0xDB, 0x10, 0x84, 0x7C, 0x7C, 0x5C,
+  0x18, 0xF8, 0x43, 0xE4, 0x10, 0x41, 0x13, 0x80, 0xCC, 0x89, 0x12, 0x24,
+  0xC6, 0xC0, 0xEE, 0x89, 0x11, 0x42, 0x82, 0x00, 0xEE, 0x89, 0x52, 0xA5,
+  0x45, 0x00, 0xCD, 0x23, 0x0C, 0x4B, 0x30, 0xEE, 0x88, 0x91, 0x41, 0x82,
+  0x04, 0x3C, 0xFC, 0x88, 0x88, 0xFC, 0x29, 0x25, 0x12, 0x44, 0xFF, 0x80,
+  0x89, 0x24, 0x52, 0x50, 0x4D, 0x80,
+  };
+
+static const PackedGlyph pfont12_glyphs[95] =
+  {
+  {0x0000,  0,  0,  0,  0}, // ' '
+  {0x8000,  3,  1,  1,  8}, // '!'
+  {0x8001,  1,  1,  5,  3}, // '"'
+  {0x8003,  1,  1,  5,  9}, // '#'
+  {0x8009,  1,  1,  4,  9}, // '$'
+  {0x800E,  1,  1,  5,  8}, // '%'
+  {0x8013,  1,  3,  5,  6}, // '&'
+  {0x8017,  3,  1,  1,  4}, // '''
+  {0x8018,  3,  1,  2, 10}, // '('
+  {0x801B,  2,  1,  2, 10}, // ')'
+  {0x801E,  1,  1,  5,  5}, // '*'
+  {0x8022,  0,  2,  7,  7}, // '+'
+  {0x8029,  2,  7,  3,  4}, // ','
+  {0x002B,  1,  5,  5,  1}, // '-'
+  {0x802C,  2,  7,  2,  2}, // '.'
+  {0x802D,  1,  1,  5,  9}, // '/'
+  {0x8033,  1,  1,  5,  8}, // '0'
+  {0x8038,  1,  1,  5,  8}, // '1'
+  {0x803D,  1,  1,  5,  8}, // '2'
+  {0x8042,  1,  1,  5,  8}, // '3'
+  {0x8047,  1,  1,  6,  8}, // '4'
+  {0x804D,  1,  1,  5,  8}, // '5'
+  {0x8052,  1,  1,  5,  8}, // '6'
+  {0x8057,  1,  1,  5,  8}, // '7'
+  {0x805C,  1,  1,  5,  8}, // '8'
+  {0x8061,  1,  1,  5,  8}, // '9'
+  {0x8066,  2,  3,  2,  6}, // ':'
+  {0x8068,  2,  3,  3,  7}, // ';'
+  {0x806B,  0,  2,  6,  7}, // '<'
+  {0x8071,  1,  4,  5,  3}, // '='
+  {0x8073,  0,  2,  6,  7}, // '>'
+  {0x8079,  2,  2,  4,  7}, // '?'
+  {0x807D,  1,  0,  5, 10}, // '@'
+  {0x8084,  0,  1,  7,  8}, // 'A'
+  {0x808B,  0,  1,  6,  8}, // 'B'
+  {0x8091,  1,  1,  5,  8}, // 'C'
+  {0x8096,  0,  1,  6,  8}, // 'D'
+  {0x809C,  0,  1,  6,  8}, // 'E'
+  {0x80A2,  1,  1,  6,  8}, // 'F'
+  {0x80A8,  1,  1,  6,  8}, // 'G'
+  {0x80AE,  0,  1,  7,  8}, // 'H'
+  {0x80B5,  1,  1,  5,  8}, // 'I'
+  {0x80BA,  1,  1,  5,  8}, // 'J'
+  {0x80BF,  0,  1,  7,  8}, // 'K'
+  {0x80C6,  1,  1,  5,  8}, // 'L'
+  {0x80CB,  0,  1,  7,  8}, // 'M'
+  {0x80D2,  0,  1,  7,  8}, // 'N'
+  {0x80D9,  1,  1,  5,  8}, // 'O'
+  {0x80DE,  1,  1,  5,  8}, // 'P'
+  {0x80E3,  1,  1,  5,  9}, // 'Q'
+  {0x80E9,  0,  1,  7,  8}, // 'R'
+  {0x80F0,  1,  1,  5,  8}, // 'S'
+  {0x80F5,  0,  1,  7,  8}, // 'T'
+  {0x80FC,  0,  1,  7,  8}, // 'U'
+  {0x8103,  0,  1,  7,  8}, // 'V'
+  {0x810A,  0,  1,  7,  8}, // 'W'
+  {0x8111,  0,  1,  7,  8}, // 'X'
+  {0x8118,  0,  1,  7,  8}, // 'Y'
+  {0x811F,  1,  1,  5,  8}, // 'Z'
+  {0x8124,  2,  1,  3, 10}, // '['
+  {0x8128,  1,  1,  4,  9}, // backslash
+  {0x812D,  2,  1,  3, 10}, // ']'
+  {0x8131,  1,  1,  5,  4}, // '^'
+  {0x0134,  0, 11,  7,  1}, // '_'
+  {0x8135,  3,  1,  2,  2}, // '`'
+  {0x8136,  1,  3,  6,  6}, // 'a'
+  {0x813B,  0,  1,  6,  8}, // 'b'
+  {0x8141,  1,  3,  5,  6}, // 'c'
+  {0x8145,  1,  1,  6,  8}, // 'd'
+  {0x814B,  1,  3,  5,  6}, // 'e'
+  {0x814F,  1,  1,  5,  8}, // 'f'
+  {0x8154,  1,  3,  6,  8}, // 'g'
+  {0x815A,  0,  1,  7,  8}, // 'h'
+  {0x8161,  1,  1,  5,  8}, // 'i'
+  {0x8166,  1,  1,  4, 10}, // 'j'
+  {0x816B,  0,  1,  6,  8}, // 'k'
+  {0x8171,  1,  1,  5,  8}, // 'l'
+  {0x8176,  0,  3,  7,  6}, // 'm'
+  {0x817C,  0,  3,  7,  6}, // 'n'
+  {0x8182,  1,  3,  5,  6}, // 'o'
+  {0x8186,  0,  3,  6,  8}, // 'p'
+  {0x818C,  1,  3,  6,  8}, // 'q'
+  {0x8192,  1,  3,  5,  6}, // 'r'
+  {0x8196,  1,  3,  5,  6}, // 's'
+  {0x819A,  1,  2,  6,  7}, // 't'
+  {0x81A0,  0,  3,  7,  6}, // 'u'
+  {0x81A6,  0,  3,  7,  6}, // 'v'
+  {0x81AC,  0,  3,  7,  6}, // 'w'
+  {0x81B2,  0,  3,  6,  6}, // 'x'
+  {0x81B7,  0,  3,  7,  8}, // 'y'
+  {0x81BE,  1,  3,  5,  6}, // 'z'
+  {0x81C2,  2,  1,  3, 10}, // '{'
+  {0x81C6,  3,  1,  1,  9}, // '|'
+  {0x81C8,  2,  1,  3, 10}, // '}'
+  {0x81CC,  1,  5,  5,  2}, // '~'
+  };
+
+const PackedFont PackedFont12 =
+  {
+  7, 12, 32, 126, pfont12_glyphs, pfont12_data, 462
+  };
+
+#endif
+
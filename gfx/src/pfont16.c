@@ -0,0 +1,189 @@
+/*============================================================================
+ *  gfx/pfont16.c
+ *
+ *  Font16, packed by tools/fontpack.c from gfx/fonts/font16.c, which
+ *  carries the font's licence. Do not edit.
+ * ==========================================================================*/
+#ifdef GFX_FONT_16
+
+#include <gfx/packedfont.h>
+
+static const uint8_t pfont16_data[818] =
+  {
+  0xFF, 0xFF, 0x30, 0xEF, 0xDD, 0x12, 0x24, 0x40, 0x36, 0x36, 0x36, 0x36,
+  0xFF, 0x6C, 0xFF, 0x6C, 0x6C, 0x6C, 0x6C, 0x10, 0xFF, 0x1E, 0x3E, 0x0F,
+  0x0F, 0x07, 0xC7, 0x8F, 0xF0, 0x81, 0x00, 0x60, 0x90, 0x90, 0x63, 0x1E,
+  0x78, 0xC6, 0x09, 0x09, 0x06, 0x3C, 0xC1, 0x83, 0x03, 0x0E, 0xF7, 0x66,
+  0x76, 0xFD, 0x24, 0x33, 0x6E, 0xCC, 0xCC, 0xE6, 0x33, 0xCC, 0x63, 0x33,
+  0x33, 0x36, 0xEC, 0x18, 0x18, 0xFF, 0xFF, 0x3C, 0x7E, 0x66, 0x10, 0x20,
+  0x47, 0xF1, 0x02, 0x04, 0x00, 0x6B, 0x48, 0x07, 0xF0, 0x03, 0x03, 0x06,
+  0x06, 0x0C, 0x0C, 0x18, 0x30, 0x30, 0x60, 0x60, 0xC0, 0xC0, 0x38, 0xDB,
+  0x1E, 0x3C, 0x78, 0xF1, 0xE3, 0x6C, 0x70, 0x18, 0xF8, 0x18, 0x18, 0x18,
+  0x18, 0x18, 0x18, 0x18, 0xFF, 0x3C, 0xCF, 0x1E, 0x30, 0xC3, 0x0C, 0x30,
+  0xC1, 0xFC, 0x7E, 0xC3, 0x03, 0x06, 0x3E, 0x07, 0x03, 0x03, 0xC3, 0x7E,
+  0x1C, 0x38, 0xF1, 0x66, 0xC9, 0xB3, 0x7F, 0x0C, 0x7C, 0x7E, 0xC1, 0x83,
+  0x07, 0xC8, 0xC1, 0x83, 0x86, 0xF8, 0x1E, 0xE1, 0x86, 0x0D, 0xDC, 0xF1,
+  0xE3, 0x66, 0x78, 0xFF, 0x0C, 0x18, 0x60, 0xC1, 0x83, 0x0C, 0x18, 0x30,
+  0x7D, 0x8F, 0x1E, 0x37, 0xD8, 0xF1, 0xE3, 0xC6, 0xF8, 0x79, 0x9B, 0x1E,
+  0x3C, 0xEE, 0xC1, 0x86, 0x1D, 0xE0, 0xF0, 0x3C, 0x33, 0x00, 0x06, 0x48,
+  0x80, 0x01, 0x83, 0x02, 0x06, 0x0C, 0x01, 0x80, 0x20, 0x0C, 0x01, 0x80,
+  0x09, 0x90, 0x09, 0xC0, 0x18, 0x02, 0x00, 0xC0, 0x18, 0x30, 0x20, 0x60,
+  0xC0, 0x00, 0x7D, 0x8F, 0x18, 0x31, 0xC6, 0x0C, 0x00, 0x30, 0x39, 0x18,
+  0x61, 0x9E, 0x9A, 0x67, 0x81, 0x13, 0x80, 0x7E, 0x07, 0x81, 0x20, 0xCC,
+  0x33, 0x0F, 0xC6, 0x19, 0x86, 0xF3, 0xC0, 0xFE, 0x63, 0x63, 0x63, 0x7E,
+  0x63, 0x63, 0x63, 0xFE, 0x3E, 0xB0, 0xF0, 0x38, 0x0C, 0x06, 0x03, 0x02,
+  0xC2, 0x3E, 0x00, 0xFE, 0x31, 0x98, 0x6C, 0x36, 0x1B, 0x0D, 0x86, 0xC6,
+  0xFE, 0x00, 0xFF, 0x61, 0x61, 0x64, 0x7C, 0x64, 0x61, 0x61, 0xFF, 0xFF,
+  0xB0, 0x58, 0x2C, 0x87, 0xC3, 0x21, 0x80, 0xC0, 0xF8, 0x00, 0x3D, 0x31,
+  0xB0, 0x58, 0x0C, 0x06, 0x7F, 0x0C, 0xC6, 0x3E, 0x00, 0xF7, 0xB1, 0x98,
+  0xCC, 0x67, 0xF3, 0x19, 0x8C, 0xC6, 0xF7, 0x80, 0xFF, 0x18, 0x18, 0x18,
+  0x18, 0x18, 0x18, 0x18, 0xFF, 0x3F, 0x83, 0x01, 0x80, 0xC0, 0x66, 0x33,
+  0x19, 0x8C, 0x7C, 0x00, 0xF7, 0xB1, 0x99, 0x8D, 0x87, 0x83, 0xE1, 0x98,
+  0xC6, 0xF3, 0x80, 0xFC, 0x18, 0x0C, 0x06, 0x03, 0x01, 0x84, 0xC2, 0x61,
+  0xFF, 0x80, 0xE0, 0xEC, 0x19, 0xC7, 0x3D, 0xE6, 0xAC, 0xDD, 0x99, 0x33,
+  0x06, 0xFB, 0xE0, 0xE7, 0xB1, 0x9C, 0xCF, 0x66, 0xB3, 0x79, 0x9C, 0xC6,
+  0xF3, 0x00, 0x3E, 0x31, 0xB0, 0x78, 0x3C, 0x1E, 0x0F, 0x06, 0xC6, 0x3E,
+  0x00, 0xFE, 0x63, 0x63, 0x63, 0x63, 0x7E, 0x60, 0x60, 0xFC, 0x3E, 0x31,
+  0xB0, 0x78, 0x3C, 0x1E, 0x0F, 0x06, 0xC6, 0x3E, 0x0C, 0xCF, 0xC0, 0xFE,
+  0x18, 0xC6, 0x31, 0x8C, 0x7C, 0x19, 0x86, 0x31, 0x8C, 0xF9, 0xC0, 0x7F,
+  0x8F, 0x1F, 0x07, 0xC1, 0xF1, 0xE3, 0xFC, 0xFF, 0x99, 0x99, 0x99, 0x18,
+  0x18, 0x18, 0x18, 0x7E, 0xF7, 0xB1, 0x98, 0xCC, 0x66, 0x33, 0x19, 0x8C,
+  0xC6, 0x3E, 0x00, 0xF7, 0xB1, 0x98, 0xC6, 0xC3, 0x61, 0xB0, 0x50, 0x38,
+  0x1C, 0x00, 0xFB, 0xEC, 0x19, 0x93, 0x37, 0x66, 0xEC, 0x55, 0x0E, 0xE1,
+  0xDC, 0x31, 0x80, 0xF7, 0xB1, 0x8D, 0x83, 0x81, 0xC0, 0xE0, 0xD8, 0xC6,
+  0xF7, 0x80, 0xF3, 0xD8, 0x63, 0x30, 0x78, 0x0C, 0x03, 0x00, 0xC0, 0x30,
+  0x3F, 0x00, 0xFF, 0x0E, 0x30, 0xC1, 0x06, 0x18, 0xE1, 0xFE, 0xFC, 0xCC,
+  0xCC, 0xCC, 0xCC, 0xCF, 0xC0, 0xC0, 0x60, 0x60, 0x30, 0x30, 0x18, 0x0C,
+  0x0C, 0x06, 0x06, 0x03, 0x03, 0xF3, 0x33, 0x33, 0x33, 0x33, 0x3F, 0x10,
+  0x50, 0xA2, 0x28, 0x30, 0x40, 0x0B, 0x88, 0x80, 0x7C, 0x06, 0x06, 0x7E,
+  0xC6, 0xCE, 0x77, 0xE0, 0x30, 0x18, 0x0D, 0xC7, 0x33, 0x0D, 0x86, 0xC3,
+  0x73, 0x77, 0x00, 0x3D, 0x63, 0xC1, 0xC0, 0xC1, 0x63, 0x3E, 0x07, 0x01,
+  0x80, 0xC7, 0x66, 0x76, 0x1B, 0x0D, 0x86, 0x67, 0x1D, 0xC0, 0x3E, 0x31,
+  0xB0, 0x7F, 0xFC, 0x03, 0x0C, 0xFC, 0x1F, 0x98, 0x0C, 0x1F, 0xC3, 0x01,
+  0x80, 0xC0, 0x60, 0x30, 0x7F, 0x00, 0x3B, 0xB3, 0xB0, 0xD8, 0x6C, 0x33,
+  0x38, 0xEC, 0x06, 0x03, 0x1F, 0x00, 0xE0, 0x30, 0x18, 0x0D, 0xC7, 0x33,
+  0x19, 0x8C, 0xC6, 0x63, 0x7B, 0xC0, 0x18, 0x18, 0x00, 0x78, 0x18, 0x18,
+  0x18, 0x18, 0x18, 0xFF, 0x18, 0x60, 0x3F, 0x0C, 0x30, 0xC3, 0x0C, 0x30,
+  0xC3, 0xF8, 0xE0, 0x30, 0x18, 0x0D, 0xE6, 0xC3, 0xC1, 0xE0, 0xD8, 0x66,
+  0x77, 0xC0, 0x78, 0x18, 0x18, 0x18, 0x18, 0x18, 0x18, 0x18, 0x18, 0xFF,
+  0xFF, 0x1B, 0x66, 0xD9, 0xB6, 0x6D, 0x9B, 0x6E, 0xDC, 0xEE, 0x39, 0x98,
+  0xCC, 0x66, 0x33, 0x1B, 0xDE, 0x3E, 0x31, 0xB0, 0x78, 0x3C, 0x1B, 0x18,
+  0xF8, 0xEE, 0x39, 0x98, 0x6C, 0x36, 0x1B, 0x99, 0xB8, 0xC0, 0x60, 0x7C,
+  0x00, 0x3B, 0xB3, 0xB0, 0xD8, 0x6C, 0x33, 0x38, 0xEC, 0x06, 0x03, 0x07,
+  0xC0, 0xF7, 0x1C, 0xCC, 0x06, 0x03, 0x01, 0x83, 0xF8, 0x7F, 0x8F, 0xC3,
+  0xE0, 0xF8, 0xFF, 0x00, 0x30, 0x30, 0x30, 0xFE, 0x30, 0x30, 0x30, 0x30,
+  0x31, 0x1E, 0xE7, 0x31, 0x98, 0xCC, 0x66, 0x33, 0x38, 0xEE, 0xF7, 0xB1,
+  0x98, 0xC6, 0xC3, 0x60, 0xE0, 0x70, 0xF1, 0xEC, 0x19, 0x93, 0x37, 0x63,
+  0xB8, 0x77, 0x0C, 0x60, 0xF7, 0x9B, 0x07, 0x03, 0x81, 0xC1, 0xB3, 0xDE,
+  0xF3, 0xD8, 0x63, 0x30, 0xCC, 0x16, 0x07, 0x80, 0xC0, 0x30, 0x18, 0x1F,
+  0x00, 0xFF, 0x0C, 0x31, 0xC6, 0x18, 0x7F, 0x80, 0x36, 0x66, 0x66, 0xC6,
+  0x66, 0x63, 0xFF, 0xFF, 0xFF, 0xC6, 0x66, 0x66, 0x36, 0x66, 0x6C, 0x61,
+  0x24, 0x30,
+  };
+
+static const PackedGlyph pfont16_glyphs[95] =
+  {
+  {0x0000,  0,  0,  0,  0}, // ' '
+  {0x8000,  4,  1,  2, 10}, // '!'
+  {0x8003,  3,  2,  7,  5}, // '"'
+  {0x8008,  2,  1,  8, 11}, // '#'
+  {0x8013,  2,  0,  7, 13}, // '$'
+  {0x801F,  2,  1,  8, 10}, // '%'
+  {0x8029,  2,  2,  7,  9}, // '&'
+  {0x8031,  5,  2,  3,  5}, // '''
+  {0x8033,  4,  1,  4, 12}, // '('
+  {0x8039,  3,  1,  4, 12}, // ')'
+  {0x803F,  2,  1,  8,  7}, // '*'
+  {0x8046,  2,  3,  7,  7}, // '+'
+  {0x804D,  4,  9,  3,  5}, // ','
+  {0x004F,  2,  6,  7,  1}, // '-'
+  {0x8050,  4,  9,  2,  2}, // '.'
+  {0x8051,  2,  0,  8, 13}, // '/'
+  {0x805E,  2,  1,  7, 10}, // '0'
+  {0x8067,  2,  1,  8, 10}, // '1'
+  {0x8071,  2,  1,  7, 10}, // '2'
+  {0x807A,  1,  1,  8, 10}, // '3'
+  {0x8084,  2,  1,  7, 10}, // '4'
+  {0x808D,  2,  1,  7, 10}, // '5'
+  {0x8096,  2,  1,  7, 10}, // '6'
+  {0x809F,  1,  1,  7, 10}, // '7'
+  {0x80A8,  2,  1,  7, 10}, // '8'
+  {0x80B1,  2,  1,  7, 10}, // '9'
+  {0x80BA,  4,  4,  2,  7}, // ':'
+  {0x80BC,  4,  4,  4,  9}, // ';'
+  {0x80C1,  1,  2,  9,  9}, // '<'
+  {0x00CC,  1,  5,  9,  3}, // '='
+  {0x80CF,  1,  2,  9,  9}, // '>'
+  {0x80DA,  2,  2,  7,  9}, // '?'
+  {0x80E2,  2,  1,  6, 11}, // '@'
+  {0x80EB,  1,  2, 10,  9}, // 'A'
+  {0x80F7,  1,  2,  8,  9}, // 'B'
+  {0x8100,  1,  2,  9,  9}, // 'C'
+  {0x810B,  1,  2,  9,  9}, // 'D'
+  {0x8116,  1,  2,  8,  9}, // 'E'
+  {0x811F,  1,  2,  9,  9}, // 'F'
+  {0x812A,  1,  2,  9,  9}, // 'G'
+  {0x8135,  1,  2,  9,  9}, // 'H'
+  {0x8140,  2,  2,  8,  9}, // 'I'
+  {0x8149,  1,  2,  9,  9}, // 'J'
+  {0x8154,  1,  2,  9,  9}, // 'K'
+  {0x815F,  1,  2,  9,  9}, // 'L'
+  {0x816A,  0,  2, 11,  9}, // 'M'
+  {0x8177,  1,  2,  9,  9}, // 'N'
+  {0x8182,  1,  2,  9,  9}, // 'O'
+  {0x818D,  1,  2,  8,  9}, // 'P'
+  {0x8196,  1,  2,  9, 11}, // 'Q'
+  {0x81A3,  1,  2, 10,  9}, // 'R'
+  {0x81AF,  2,  2,  7,  9}, // 'S'
+  {0x81B7,  1,  2,  8,  9}, // 'T'
+  {0x81C0,  1,  2,  9,  9}, // 'U'
+  {0x81CB,  1,  2,  9,  9}, // 'V'
+  {0x81D6,  0,  2, 11,  9}, // 'W'
+  {0x81E3,  1,  2,  9,  9}, // 'X'
+  {0x81EE,  1,  2, 10,  9}, // 'Y'
+  {0x81FA,  2,  2,  7,  9}, // 'Z'
+  {0x8202,  5,  1,  4, 12}, // '['
+  {0x8208,  2,  0,  8, 13}, // backslash
+  {0x8215,  3,  1,  4, 12}, // ']'
+  {0x821B,  2,  0,  7,  6}, // '^'
+  {0x0221,  0, 15, 11,  1}, // '_'
+  {0x8222,  4,  0,  3,  3}, // '`'
+  {0x8224,  2,  4,  8,  7}, // 'a'
+  {0x822B,  1,  1,  9, 10}, // 'b'
+  {0x8237,  1,  4,  8,  7}, // 'c'
+  {0x823E,  1,  1,  9, 10}, // 'd'
+  {0x824A,  1,  4,  9,  7}, // 'e'
+  {0x8252,  2,  1,  9, 10}, // 'f'
+  {0x825E,  1,  4,  9, 10}, // 'g'
+  {0x826A,  1,  1,  9, 10}, // 'h'
+  {0x8276,  2,  1,  8, 10}, // 'i'
+  {0x8280,  2,  1,  6, 13}, // 'j'
+  {0x828A,  1,  1,  9, 10}, // 'k'
+  {0x8296,  2,  1,  8, 10}, // 'l'
+  {0x82A0,  1,  4, 10,  7}, // 'm'
+  {0x82A9,  1,  4,  9,  7}, // 'n'
+  {0x82B1,  1,  4,  9,  7}, // 'o'
+  {0x82B9,  1,  4,  9, 10}, // 'p'
+  {0x82C5,  1,  4,  9, 10}, // 'q'
+  {0x82D1,  1,  4,  9,  7}, // 'r'
+  {0x82D9,  2,  4,  7,  7}, // 's'
+  {0x82E0,  1,  1,  8, 10}, // 't'
+  {0x82EA,  1,  4,  9,  7}, // 'u'
+  {0x82F2,  1,  4,  9,  7}, // 'v'
+  {0x82FA,  0,  4, 11,  7}, // 'w'
+  {0x8304,  1,  4,  9,  7}, // 'x'
+  {0x830C,  1,  4, 10, 10}, // 'y'
+  {0x8319,  2,  4,  7,  7}, // 'z'
+  {0x8320,  3,  1,  4, 12}, // '{'
+  {0x8326,  5,  1,  2, 12}, // '|'
+  {0x8329,  4,  1,  4, 12}, // '}'
+  {0x832F,  2,  5,  7,  3}, // '~'
+  };
+
+const PackedFont PackedFont16 =
+  {
+  11, 16, 32, 126, pfont16_glyphs, pfont16_data, 818
+  };
+
+#endif
+
@@ -0,0 +1,222 @@
+/*============================================================================
+ *  gfx/pfont20.c
+ *
+ *  Font20, packed by tools/fontpack.c from gfx/fonts/font20.c, which
+ *  carries the font's licence. Do not edit.
+ * ==========================================================================*/
+#ifdef GFX_FONT_20
+
+#include <gfx/packedfont.h>
+
+static const uint8_t pfont20_data[1220] =
+  {
+  0xFF, 0xFF, 0xFA, 0x40, 0x7E, 0xE7, 0xE7, 0xE7, 0x42, 0x42, 0x42, 0x33,
+  0x0C, 0xC3, 0x30, 0xCC, 0x33, 0x3F, 0xFF, 0xFC, 0xCC, 0x33, 0x3F, 0xFF,
+  0xFC, 0xCC, 0x33, 0x0C, 0xC3, 0x30, 0xCC, 0x18, 0x18, 0x3F, 0x7F, 0xC3,
+  0xC0, 0xF8, 0x7E, 0x07, 0xC3, 0xC3, 0xFE, 0xFC, 0x18, 0x18, 0x18, 0x70,
+  0x44, 0x22, 0x11, 0x07, 0x18, 0x3C, 0xF9, 0xE0, 0xC7, 0x04, 0x42, 0x21,
+  0x10, 0x70, 0x1F, 0x3F, 0x98, 0x0C, 0x03, 0x03, 0xCF, 0xFF, 0x9E, 0xC6,
+  0x7F, 0xCF, 0x60, 0xFF, 0xA4, 0x80, 0x33, 0x66, 0x6C, 0xCC, 0xCC, 0xC6,
+  0x66, 0x33, 0xCC, 0x66, 0x63, 0x33, 0x33, 0x36, 0x66, 0xCC, 0x18, 0x18,
+  0x18, 0xDB, 0xFF, 0x3C, 0x3C, 0x7E, 0x66, 0x42, 0x40, 0x00, 0x00, 0x00,
+  0x0A, 0x00, 0x42, 0x40, 0x00, 0x00, 0x00, 0x76, 0x6C, 0xC8, 0x09, 0x00,
+  0xFF, 0x80, 0x03, 0x03, 0x06, 0x06, 0x06, 0x0C, 0x0C, 0x18, 0x18, 0x30,
+  0x30, 0x60, 0x60, 0x60, 0xC0, 0xC0, 0x3E, 0x3F, 0x98, 0xD8, 0x3C, 0x1E,
+  0x0F, 0x07, 0x83, 0xC1, 0xE0, 0xD8, 0xCF, 0xE3, 0xE0, 0x18, 0xF8, 0xF8,
+  0x18, 0x18, 0x18, 0x18, 0x18, 0x18, 0x18, 0x18, 0xFF, 0xFF, 0x3E, 0x3F,
+  0xB8, 0xF8, 0x30, 0x18, 0x18, 0x18, 0x18, 0x18, 0x18, 0x18, 0x1F, 0xFF,
+  0xF8, 0x1F, 0x1F, 0xE6, 0x1C, 0x03, 0x01, 0xC3, 0xE0, 0xF8, 0x07, 0x00,
+  0xC0, 0x3C, 0x1F, 0xFE, 0x7F, 0x00, 0x07, 0x07, 0x83, 0xC3, 0x63, 0x31,
+  0x99, 0x8D, 0x86, 0xFF, 0xFF, 0xC0, 0xC1, 0xF0, 0xF8, 0x7F, 0x3F, 0x98,
+  0x0C, 0x07, 0xE3, 0xF9, 0x8E, 0x03, 0x01, 0x80, 0xF0, 0xFF, 0xE7, 0xE0,
+  0x0F, 0x9F, 0xDE, 0x0C, 0x0E, 0x06, 0xF3, 0xFD, 0xC7, 0xC1, 0xE0, 0xD8,
+  0xEF, 0xE1, 0xE0, 0xFF, 0xFF, 0xF0, 0x60, 0x30, 0x30, 0x18, 0x0C, 0x0C,
+  0x06, 0x03, 0x03, 0x01, 0x80, 0xC0, 0x3E, 0x3F, 0xB8, 0xF8, 0x3E, 0x3B,
+  0xF9, 0xFD, 0xC7, 0xC1, 0xE0, 0xF8, 0xEF, 0xE3, 0xE0, 0x3C, 0x3F, 0xB8,
+  0xD8, 0x3C, 0x1F, 0x1D, 0xFE, 0x7B, 0x03, 0x81, 0x83, 0xDF, 0xCF, 0x80,
+  0xFF, 0x80, 0x3F, 0xE0, 0x39, 0xCE, 0x00, 0x01, 0xCC, 0xC6, 0x20, 0x00,
+  0x60, 0x3C, 0x1E, 0x07, 0x03, 0x81, 0xE0, 0x0E, 0x00, 0x70, 0x07, 0x80,
+  0x3C, 0x01, 0x80, 0x0B, 0x00, 0xB0, 0x00, 0x0B, 0x00, 0xC0, 0x1E, 0x00,
+  0xF0, 0x07, 0x00, 0x38, 0x03, 0xC0, 0xE0, 0x70, 0x3C, 0x1E, 0x03, 0x00,
+  0x00, 0x7C, 0xFE, 0xC3, 0xC3, 0x03, 0x0E, 0x1C, 0x18, 0x00, 0x00, 0x38,
+  0x38, 0x1C, 0xC9, 0x0C, 0x18, 0x31, 0xE4, 0xC9, 0x93, 0x1E, 0x02, 0x04,
+  0x27, 0x80, 0x3F, 0x03, 0xF0, 0x07, 0x00, 0xD8, 0x0D, 0x81, 0x98, 0x18,
+  0xC3, 0xFC, 0x3F, 0xC6, 0x06, 0xF0, 0xFF, 0x0F, 0xFE, 0x3F, 0xC6, 0x19,
+  0x86, 0x63, 0x9F, 0xC7, 0xF9, 0x87, 0x60, 0xD8, 0x3F, 0xFF, 0xFE, 0x1E,
+  0xCF, 0xF7, 0x1F, 0x83, 0xC0, 0x30, 0x0C, 0x03, 0x00, 0xE0, 0xDC, 0x73,
+  0xF8, 0x7C, 0xFF, 0x1F, 0xF1, 0x87, 0x30, 0x76, 0x06, 0xC0, 0xD8, 0x1B,
+  0x03, 0x60, 0xEC, 0x3B, 0xFE, 0x7F, 0x80, 0xFF, 0xFF, 0xF6, 0x0D, 0x83,
+  0x66, 0x1F, 0x87, 0xE1, 0x98, 0x60, 0xD8, 0x3F, 0xFF, 0xFF, 0xFF, 0xFF,
+  0xF6, 0x0D, 0x83, 0x66, 0x1F, 0x87, 0xE1, 0x98, 0x60, 0x18, 0x0F, 0xC3,
+  0xF0, 0x1E, 0xCF, 0xF9, 0x87, 0x60, 0x6C, 0x01, 0x80, 0x31, 0xFE, 0x3F,
+  0xC0, 0xCC, 0x19, 0xFF, 0x0F, 0x80, 0xF3, 0xFC, 0xF6, 0x19, 0x86, 0x61,
+  0x9F, 0xE7, 0xF9, 0x86, 0x61, 0x98, 0x6F, 0x3F, 0xCF, 0xFF, 0xFF, 0x18,
+  0x18, 0x18, 0x18, 0x18, 0x18, 0x18, 0x18, 0xFF, 0xFF, 0x0F, 0xE1, 0xFC,
+  0x06, 0x00, 0xC0, 0x18, 0x03, 0x30, 0x66, 0x0C, 0xC1, 0x98, 0x73, 0xFC,
+  0x1F, 0x00, 0xFB, 0xFF, 0x7D, 0x8E, 0x33, 0x06, 0xC0, 0xF8, 0x1D, 0x83,
+  0x18, 0x63, 0x0C, 0x33, 0xE7, 0xFC, 0x70, 0x06, 0x40, 0x00, 0x22, 0x60,
+  0x00, 0x00, 0x00, 0x00, 0x22, 0x42, 0x00, 0x00, 0x0A, 0x00, 0xF0, 0xFF,
+  0x0F, 0x70, 0xE7, 0x9E, 0x69, 0x66, 0xF6, 0x6F, 0x66, 0x66, 0x66, 0x66,
+  0x06, 0xF9, 0xFF, 0x9F, 0xE7, 0xFD, 0xF7, 0x19, 0xE6, 0x79, 0x9B, 0x66,
+  0xD9, 0x9E, 0x67, 0x98, 0xEF, 0xBB, 0xE6, 0x1E, 0x0F, 0xC7, 0x3B, 0x87,
+  0xC0, 0xF0, 0x3C, 0x0F, 0x03, 0xE1, 0xDC, 0xE3, 0xF0, 0x78, 0xFF, 0x3F,
+  0xE6, 0x1D, 0x83, 0x60, 0xD8, 0x77, 0xF9, 0xFC, 0x60, 0x18, 0x0F, 0xC3,
+  0xF0, 0x1E, 0x0F, 0xC7, 0x3B, 0x87, 0xC0, 0xF0, 0x3C, 0x0F, 0x03, 0xE1,
+  0xDC, 0xE3, 0xF0, 0x78, 0x1E, 0xCF, 0xF3, 0x38, 0xFF, 0x1F, 0xF1, 0x87,
+  0x30, 0x66, 0x1C, 0xFF, 0x1F, 0xC3, 0x1C, 0x61, 0x8C, 0x3B, 0xE3, 0xFC,
+  0x30, 0x3E, 0xDF, 0xFE, 0x1F, 0x03, 0xE0, 0x1F, 0x81, 0xF8, 0x07, 0xC0,
+  0xF8, 0x7F, 0xFB, 0x7C, 0xFF, 0xFF, 0xFC, 0xCF, 0x33, 0xCC, 0xC3, 0x00,
+  0xC0, 0x30, 0x0C, 0x03, 0x03, 0xF0, 0xFC, 0xF3, 0xFC, 0xF6, 0x19, 0x86,
+  0x61, 0x98, 0x66, 0x19, 0x86, 0x61, 0x9C, 0xE3, 0xF0, 0x78, 0xF1, 0xFE,
+  0x3D, 0x83, 0x30, 0x63, 0x18, 0x63, 0x06, 0xC0, 0xD8, 0x1B, 0x01, 0xC0,
+  0x38, 0x07, 0x00, 0xF8, 0xFF, 0xC7, 0xD8, 0x0C, 0xCE, 0x66, 0x73, 0x33,
+  0x99, 0xB6, 0xC5, 0xB4, 0x38, 0xE1, 0xC7, 0x0E, 0x38, 0x60, 0xC0, 0xF1,
+  0xFE, 0x3D, 0x83, 0x18, 0xC1, 0xB0, 0x1C, 0x03, 0x80, 0xD8, 0x31, 0x8C,
+  0x1B, 0xC7, 0xF8, 0xF0, 0xF3, 0xFC, 0xF6, 0x18, 0xCC, 0x1E, 0x07, 0x80,
+  0xC0, 0x30, 0x0C, 0x03, 0x03, 0xF0, 0xFC, 0xFF, 0xFF, 0xC3, 0xC6, 0x0C,
+  0x18, 0x18, 0x30, 0x63, 0xC3, 0xFF, 0xFF, 0xFF, 0xCC, 0xCC, 0xCC, 0xCC,
+  0xCC, 0xCC, 0xFF, 0xC0, 0xC0, 0x60, 0x60, 0x60, 0x30, 0x30, 0x18, 0x18,
+  0x0C, 0x0C, 0x06, 0x06, 0x06, 0x03, 0x03, 0xFF, 0x33, 0x33, 0x33, 0x33,
+  0x33, 0x33, 0xFF, 0x08, 0x0E, 0x0D, 0x8C, 0x6C, 0x1C, 0x04, 0x0E, 0x00,
+  0x86, 0x10, 0x3F, 0x1F, 0xE0, 0x18, 0xFE, 0x7F, 0xB8, 0x6C, 0x3B, 0xFF,
+  0x7D, 0xC0, 0xE0, 0x1C, 0x01, 0x80, 0x30, 0x06, 0xF0, 0xFF, 0x9C, 0x33,
+  0x03, 0x60, 0x6C, 0x0D, 0xC3, 0x7F, 0xEE, 0xF0, 0x1E, 0xDF, 0xF6, 0x0F,
+  0x03, 0xC0, 0x30, 0x0E, 0x0D, 0xFF, 0x3F, 0x00, 0x01, 0xC0, 0x38, 0x03,
+  0x00, 0x61, 0xEC, 0xFF, 0x98, 0x76, 0x06, 0xC0, 0xD8, 0x1B, 0x87, 0x3F,
+  0xF1, 0xEE, 0x1E, 0x1F, 0xE6, 0x1B, 0xFF, 0xFF, 0xF0, 0x06, 0x0D, 0xFF,
+  0x1F, 0x00, 0x1F, 0x9F, 0xCC, 0x06, 0x0F, 0xF7, 0xF8, 0xC0, 0x60, 0x30,
+  0x18, 0x0C, 0x1F, 0xEF, 0xF0, 0x1E, 0xEF, 0xFD, 0x87, 0x60, 0x6C, 0x0D,
+  0x81, 0x98, 0x73, 0xFE, 0x1E, 0xC0, 0x18, 0x07, 0x1F, 0xC3, 0xF0, 0xE0,
+  0x38, 0x06, 0x01, 0x80, 0x6F, 0x1F, 0xE7, 0x19, 0x86, 0x61, 0x98, 0x66,
+  0x1B, 0xCF, 0xF3, 0xC0, 0x18, 0x18, 0x00, 0x00, 0xF8, 0xF8, 0x18, 0x18,
+  0x18, 0x18, 0x18, 0xFF, 0xFF, 0x0C, 0x0C, 0x00, 0x00, 0x7F, 0x7F, 0x03,
+  0x03, 0x03, 0x03, 0x03, 0x03, 0x03, 0x03, 0x07, 0xFE, 0xFC, 0xE0, 0x38,
+  0x06, 0x01, 0x80, 0x6F, 0x9B, 0xE6, 0xC1, 0xE0, 0x78, 0x1B, 0x06, 0x63,
+  0x9F, 0xE7, 0xC0, 0xF8, 0xF8, 0x18, 0x18, 0x18, 0x18, 0x18, 0x18, 0x18,
+  0x18, 0x18, 0xFF, 0xFF, 0xFD, 0xCF, 0xFE, 0x66, 0x66, 0x66, 0x66, 0x66,
+  0x66, 0x66, 0x6F, 0x77, 0xF7, 0x70, 0xEF, 0x3F, 0xE7, 0x19, 0x86, 0x61,
+  0x98, 0x66, 0x1B, 0xCF, 0xF3, 0xC0, 0x1E, 0x1F, 0xE6, 0x1B, 0x03, 0xC0,
+  0xF0, 0x36, 0x19, 0xFE, 0x1E, 0x00, 0xEF, 0x1F, 0xF9, 0xC3, 0x30, 0x36,
+  0x06, 0xC0, 0xDC, 0x33, 0xFE, 0x6F, 0x0C, 0x01, 0x80, 0x7C, 0x0F, 0x80,
+  0x1E, 0xEF, 0xFD, 0x87, 0x60, 0x6C, 0x0D, 0x81, 0x98, 0x73, 0xFE, 0x1E,
+  0xC0, 0x18, 0x03, 0x01, 0xF0, 0x3E, 0xF3, 0xBD, 0xF3, 0xCC, 0xE0, 0x30,
+  0x0C, 0x03, 0x03, 0xFC, 0xFF, 0x00, 0x3F, 0xFF, 0xC3, 0xF0, 0x7E, 0x0F,
+  0xC3, 0xFF, 0xFC, 0x30, 0x0C, 0x03, 0x03, 0xFE, 0xFF, 0x8C, 0x03, 0x00,
+  0xC0, 0x30, 0x0C, 0x33, 0xFC, 0x7C, 0xE3, 0xB8, 0xE6, 0x19, 0x86, 0x61,
+  0x98, 0x66, 0x39, 0xFF, 0x3D, 0xC0, 0xF1, 0xFE, 0x3D, 0x83, 0x18, 0xC3,
+  0x18, 0x36, 0x06, 0xC0, 0x70, 0x0E, 0x00, 0xF1, 0xFE, 0x3D, 0x93, 0x32,
+  0x66, 0xFC, 0x77, 0x0E, 0xE1, 0x8C, 0x31, 0x80, 0xF3, 0xFC, 0xF3, 0x30,
+  0x78, 0x0C, 0x07, 0x83, 0x33, 0xCF, 0xF3, 0xC0, 0xF1, 0xFE, 0x3D, 0x83,
+  0x18, 0xC3, 0x18, 0x36, 0x07, 0xC0, 0x70, 0x0C, 0x01, 0x80, 0x60, 0x7F,
+  0x0F, 0xE0, 0xFF, 0xFF, 0xC6, 0x0C, 0x18, 0x30, 0x63, 0xFF, 0xFF, 0x1C,
+  0xF3, 0x0C, 0x30, 0xC3, 0x1C, 0xE1, 0xC3, 0x0C, 0x30, 0xC3, 0xC7, 0xFF,
+  0xFF, 0xFF, 0xFF, 0xE3, 0xC3, 0x0C, 0x30, 0xC3, 0x0E, 0x1C, 0xE3, 0x0C,
+  0x30, 0xCF, 0x38, 0x38, 0x3F, 0x3C, 0xFC, 0x1E,
+  };
+
+static const PackedGlyph pfont20_glyphs[95] =
+  {
+  {0x0000,  0,  0,  0,  0}, // ' '
+  {0x8000,  5,  1,  3, 13}, // '!'
+  {0x8005,  3,  2,  8,  6}, // '"'
+  {0x800B,  2,  0, 10, 16}, // '#'
+  {0x801F,  3,  0,  8, 16}, // '$'
+  {0x802F,  2,  1,  9, 13}, // '%'
+  {0x803E,  3,  3,  9, 11}, // '&'
+  {0x804B,  6,  2,  3,  6}, // '''
+  {0x804E,  6,  1,  4, 16}, // '('
+  {0x8056,  4,  1,  4, 16}, // ')'
+  {0x805E,  3,  1,  8,  9}, // '*'
+  {0x0067,  2,  3, 10, 10}, // '+'
+  {0x8073,  5, 11,  4,  6}, // ','
+  {0x0076,  2,  7,  9,  2}, // '-'
+  {0x8078,  6, 11,  3,  3}, // '.'
+  {0x807A,  3,  0,  8, 16}, // '/'
+  {0x808A,  2,  1,  9, 13}, // '0'
+  {0x8099,  3,  1,  8, 13}, // '1'
+  {0x80A6,  2,  1,  9, 13}, // '2'
+  {0x80B5,  1,  1, 10, 13}, // '3'
+  {0x80C6,  2,  1,  9, 13}, // '4'
+  {0x80D5,  2,  1,  9, 13}, // '5'
+  {0x80E4,  2,  1,  9, 13}, // '6'
+  {0x80F3,  2,  1,  9, 13}, // '7'
+  {0x8102,  2,  1,  9, 13}, // '8'
+  {0x8111,  2,  1,  9, 13}, // '9'
+  {0x8120,  6,  5,  3,  9}, // ':'
+  {0x8124,  5,  5,  5, 11}, // ';'
+  {0x812B,  1,  3, 11, 11}, // '<'
+  {0x013B,  1,  5, 11,  6}, // '='
+  {0x8141,  2,  3, 11, 11}, // '>'
+  {0x8151,  3,  2,  8, 12}, // '?'
+  {0x815D,  3,  1,  7, 14}, // '@'
+  {0x816A,  1,  2, 12, 12}, // 'A'
+  {0x817C,  2,  2, 10, 12}, // 'B'
+  {0x818B,  2,  2, 10, 12}, // 'C'
+  {0x819A,  1,  2, 11, 12}, // 'D'
+  {0x81AB,  2,  2, 10, 12}, // 'E'
+  {0x81BA,  2,  2, 10, 12}, // 'F'
+  {0x81C9,  2,  2, 11, 12}, // 'G'
+  {0x81DA,  2,  2, 10, 12}, // 'H'
+  {0x81E9,  3,  2,  8, 12}, // 'I'
+  {0x81F5,  2,  2, 11, 12}, // 'J'
+  {0x8206,  2,  2, 11, 12}, // 'K'
+  {0x0217,  2,  2, 10, 12}, // 'L'
+  {0x8226,  1,  2, 12, 12}, // 'M'
+  {0x8238,  2,  2, 10, 12}, // 'N'
+  {0x8247,  2,  2, 10, 12}, // 'O'
+  {0x8256,  2,  2, 10, 12}, // 'P'
+  {0x8265,  2,  2, 10, 15}, // 'Q'
+  {0x8278,  2,  2, 11, 12}, // 'R'
+  {0x8289,  2,  2, 10, 12}, // 'S'
+  {0x8298,  2,  2, 10, 12}, // 'T'
+  {0x82A7,  2,  2, 10, 12}, // 'U'
+  {0x82B6,  1,  2, 11, 12}, // 'V'
+  {0x82C7,  1,  2, 13, 12}, // 'W'
+  {0x82DB,  1,  2, 11, 12}, // 'X'
+  {0x82EC,  2,  2, 10, 12}, // 'Y'
+  {0x82FB,  3,  2,  8, 12}, // 'Z'
+  {0x8307,  6,  1,  4, 16}, // '['
+  {0x830F,  3,  0,  8, 16}, // backslash
+  {0x831F,  4,  1,  4, 16}, // ']'
+  {0x8327,  2,  1,  9,  6}, // '^'
+  {0x032E,  0, 18, 14,  2}, // '_'
+  {0x8330,  5,  1,  4,  3}, // '`'
+  {0x8332,  2,  5, 10,  9}, // 'a'
+  {0x833E,  1,  1, 11, 13}, // 'b'
+  {0x8350,  2,  5, 10,  9}, // 'c'
+  {0x835C,  2,  1, 11, 13}, // 'd'
+  {0x836E,  2,  5, 10,  9}, // 'e'
+  {0x837A,  3,  1,  9, 13}, // 'f'
+  {0x8389,  2,  5, 11, 13}, // 'g'
+  {0x839B,  2,  1, 10, 13}, // 'h'
+  {0x83AC,  3,  1,  8, 13}, // 'i'
+  {0x83B9,  2,  1,  8, 17}, // 'j'
+  {0x83CA,  2,  1, 10, 13}, // 'k'
+  {0x83DB,  3,  1,  8, 13}, // 'l'
+  {0x83E8,  1,  5, 12,  9}, // 'm'
+  {0x83F6,  2,  5, 10,  9}, // 'n'
+  {0x8402,  2,  5, 10,  9}, // 'o'
+  {0x840E,  1,  5, 11, 13}, // 'p'
+  {0x8420,  2,  5, 11, 13}, // 'q'
+  {0x8432,  2,  5, 10,  9}, // 'r'
+  {0x843E,  3,  5,  8,  9}, // 's'
+  {0x8447,  2,  2, 10, 12}, // 't'
+  {0x8456,  2,  5, 10,  9}, // 'u'
+  {0x8462,  1,  5, 11,  9}, // 'v'
+  {0x846F,  1,  5, 11,  9}, // 'w'
+  {0x847C,  2,  5, 10,  9}, // 'x'
+  {0x8488,  1,  5, 11, 13}, // 'y'
+  {0x849A,  3,  5,  8,  9}, // 'z'
+  {0x84A3,  4,  1,  6, 16}, // '{'
+  {0x84AF,  6,  1,  2, 16}, // '|'
+  {0x84B3,  3,  1,  6, 16}, // '}'
+  {0x84BF,  2,  6, 10,  4}, // '~'
+  };
+
+const PackedFont PackedFont20 =
+  {
+  14, 20, 32, 126, pfont20_glyphs, pfont20_data, 1220
+  };
+
+#endif
+
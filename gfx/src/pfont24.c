@@ -0,0 +1,263 @@
+/*============================================================================
+ *  gfx/pfont24.c
+ *
+ *  Font24, packed by tools/fontpack.c from gfx/fonts/font24.c, which
+ *  carries the font's licence. Do not edit.
+ * ==========================================================================*/
+#ifdef GFX_FONT_24
+
+#include <gfx/packedfont.h>
+
+static const uint8_t pfont24_data[1711] =
+  {
+  0xFF, 0xFF, 0xFF, 0xE9, 0x01, 0xF8, 0xE7, 0xE7, 0xE7, 0x42, 0x42, 0x42,
+  0x42, 0x19, 0x83, 0x30, 0x66, 0x0C, 0xC1, 0x99, 0xFF, 0xFF, 0xF8, 0xCC,
+  0x33, 0x1F, 0xFF, 0xFF, 0x99, 0x83, 0x30, 0x66, 0x0C, 0xC1, 0x98, 0x0C,
+  0x06, 0x0F, 0x6F, 0xFC, 0x3E, 0x1F, 0x80, 0xF8, 0x3F, 0x03, 0xF0, 0x7C,
+  0x3E, 0x3F, 0xFB, 0x78, 0x18, 0x0C, 0x06, 0x03, 0x00, 0x3C, 0x1F, 0x8E,
+  0x73, 0x0C, 0xC3, 0x39, 0xC7, 0xFC, 0xFC, 0xFF, 0x8E, 0x73, 0x0C, 0xC3,
+  0x39, 0xC7, 0xE0, 0xF0, 0x1F, 0x87, 0xF1, 0x8C, 0x30, 0x06, 0x00, 0x60,
+  0x0E, 0x03, 0xE7, 0xEF, 0xF8, 0xF3, 0x0E, 0x3F, 0xF3, 0xEE, 0xFF, 0xA4,
+  0x90, 0x0C, 0x73, 0x9E, 0x71, 0xCE, 0x38, 0xE3, 0x8E, 0x38, 0x71, 0xC3,
+  0x8E, 0x1C, 0x30, 0xC3, 0x87, 0x1C, 0x38, 0xE1, 0xC7, 0x1C, 0x71, 0xC7,
+  0x38, 0xE7, 0x9C, 0xE3, 0x00, 0x0C, 0x03, 0x00, 0xC3, 0xB7, 0xFF, 0xCF,
+  0xC1, 0xE0, 0x78, 0x33, 0x0C, 0xC0, 0x52, 0x50, 0x00, 0x00, 0x00, 0x00,
+  0x0C, 0x00, 0x52, 0x50, 0x00, 0x00, 0x00, 0x00, 0x39, 0x9C, 0xC6, 0x63,
+  0x00, 0x0A, 0x00, 0xFF, 0xF0, 0x00, 0xC0, 0x30, 0x1C, 0x06, 0x03, 0x80,
+  0xC0, 0x30, 0x18, 0x06, 0x03, 0x00, 0xC0, 0x60, 0x18, 0x0C, 0x03, 0x01,
+  0xC0, 0x60, 0x38, 0x0C, 0x03, 0x00, 0x1E, 0x0F, 0xC6, 0x19, 0x86, 0xC0,
+  0xF0, 0x3C, 0x0F, 0x03, 0xC0, 0xF0, 0x3C, 0x0D, 0x86, 0x61, 0x8F, 0xC1,
+  0xE0, 0x04, 0x0F, 0x0F, 0xC3, 0xB0, 0x0C, 0x03, 0x00, 0xC0, 0x30, 0x0C,
+  0x03, 0x00, 0xC0, 0x30, 0x0C, 0x3F, 0xFF, 0xFC, 0x1F, 0x0F, 0xFB, 0x83,
+  0x60, 0x3C, 0x06, 0x00, 0xC0, 0x30, 0x0C, 0x07, 0x01, 0xC0, 0x60, 0x18,
+  0x06, 0x01, 0xFF, 0xFF, 0xF8, 0x1E, 0x1F, 0xC6, 0x38, 0x06, 0x01, 0x80,
+  0xC1, 0xE0, 0x7C, 0x03, 0x80, 0x30, 0x0C, 0x03, 0xC1, 0xFF, 0xE7, 0xE0,
+  0x03, 0x80, 0xF0, 0x1E, 0x06, 0xC1, 0x98, 0x33, 0x0C, 0x61, 0x8C, 0x61,
+  0x98, 0x33, 0xFF, 0xFF, 0xF0, 0x18, 0x1F, 0xC3, 0xF8, 0x7F, 0xCF, 0xF9,
+  0x80, 0x30, 0x06, 0x00, 0xDE, 0x1F, 0xF3, 0x86, 0x00, 0x60, 0x0C, 0x01,
+  0x80, 0x3C, 0x0D, 0xFF, 0x8F, 0xC0, 0x07, 0xC7, 0xF3, 0x81, 0xC0, 0x60,
+  0x30, 0x0D, 0xE3, 0xFE, 0xE1, 0xB0, 0x3C, 0x0F, 0x03, 0x61, 0xDF, 0xE1,
+  0xF0, 0xFF, 0xFF, 0xFC, 0x0F, 0x07, 0x01, 0x80, 0x60, 0x38, 0x0C, 0x03,
+  0x01, 0xC0, 0x60, 0x18, 0x0E, 0x03, 0x00, 0xC0, 0x3F, 0x1F, 0xEE, 0x1F,
+  0x03, 0xC0, 0xD8, 0x63, 0xF0, 0xFC, 0x61, 0xB0, 0x3C, 0x0F, 0x03, 0xE1,
+  0xDF, 0xE3, 0xF0, 0x3E, 0x1F, 0xEE, 0x1B, 0x03, 0xC0, 0xF0, 0x36, 0x1D,
+  0xFF, 0x1E, 0xC0, 0x30, 0x18, 0x0E, 0x07, 0x3F, 0x8F, 0x80, 0xFF, 0xF0,
+  0x00, 0x00, 0xFF, 0xF0, 0x3C, 0xF3, 0xC0, 0x00, 0x00, 0x0E, 0x71, 0x86,
+  0x30, 0x80, 0xB3, 0xA4, 0x84, 0x20, 0x64, 0x40, 0x44, 0x60, 0x24, 0x80,
+  0x04, 0xA0, 0x24, 0x80, 0x44, 0x60, 0x64, 0x40, 0x84, 0x20, 0xA4, 0xB3,
+  0x0D, 0x00, 0xD0, 0x00, 0x0D, 0x00, 0xE0, 0x03, 0xC0, 0x03, 0xC0, 0x03,
+  0xC0, 0x03, 0xC0, 0x03, 0xC0, 0x03, 0xC0, 0x3C, 0x03, 0xC0, 0x3C, 0x03,
+  0xC0, 0x3C, 0x00, 0xE0, 0x00, 0x3E, 0x3F, 0xB0, 0xF8, 0x3C, 0x18, 0x1C,
+  0x1C, 0x3C, 0x1C, 0x0C, 0x00, 0x00, 0x03, 0x81, 0xC0, 0x1F, 0x0F, 0xE7,
+  0x1D, 0x83, 0xC3, 0xF1, 0xFC, 0xEF, 0x33, 0xCC, 0xF3, 0x3C, 0x7F, 0x0F,
+  0xC0, 0x18, 0x07, 0x0C, 0xFF, 0x1F, 0x00, 0x1F, 0x80, 0x1F, 0xC0, 0x01,
+  0xC0, 0x03, 0x60, 0x03, 0x60, 0x06, 0x30, 0x06, 0x30, 0x0C, 0x30, 0x0F,
+  0xF8, 0x1F, 0xF8, 0x18, 0x0C, 0x30, 0x0C, 0xFC, 0x7F, 0xFC, 0x7F, 0xFF,
+  0xC7, 0xFF, 0x0C, 0x1C, 0x60, 0x63, 0x03, 0x18, 0x38, 0xFF, 0x87, 0xFE,
+  0x30, 0x39, 0x80, 0xCC, 0x06, 0x60, 0x3F, 0xFF, 0x7F, 0xF0, 0x0F, 0xB3,
+  0xFF, 0x70, 0x76, 0x03, 0xC0, 0x3C, 0x00, 0xC0, 0x0C, 0x00, 0xC0, 0x0C,
+  0x00, 0x60, 0x37, 0x07, 0x3F, 0xE0, 0xFC, 0xFF, 0x87, 0xFF, 0x0C, 0x1C,
+  0x60, 0x63, 0x01, 0x98, 0x0C, 0xC0, 0x66, 0x03, 0x30, 0x19, 0x80, 0xCC,
+  0x0C, 0x60, 0xEF, 0xFE, 0x7F, 0xE0, 0xFF, 0xFF, 0xFF, 0x30, 0x33, 0x03,
+  0x33, 0x33, 0x30, 0x3F, 0x03, 0xF0, 0x33, 0x03, 0x33, 0x30, 0x33, 0x03,
+  0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0x30, 0x33, 0x03, 0x33, 0x33, 0x30,
+  0x3F, 0x03, 0xF0, 0x33, 0x03, 0x30, 0x30, 0x03, 0x00, 0xFF, 0x0F, 0xF0,
+  0x0F, 0xB1, 0xFF, 0x9C, 0x1C, 0xC0, 0x6C, 0x03, 0x60, 0x03, 0x00, 0x18,
+  0x7F, 0xC3, 0xFE, 0x01, 0xB8, 0x0C, 0xE0, 0xE3, 0xFF, 0x07, 0xE0, 0x06,
+  0x26, 0x00, 0x22, 0x62, 0x20, 0x00, 0x00, 0x00, 0x2A, 0x20, 0x00, 0x22,
+  0x62, 0x20, 0x00, 0x00, 0x00, 0x06, 0x26, 0x00, 0x0A, 0x00, 0x42, 0x40,
+  0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x0A, 0x00, 0x3A,
+  0x00, 0x82, 0x30, 0x00, 0x00, 0x00, 0x00, 0x02, 0x62, 0x30, 0x00, 0x00,
+  0x00, 0x02, 0x52, 0x40, 0x09, 0x40, 0x25, 0x60, 0xFE, 0x7D, 0xFC, 0xF8,
+  0xC1, 0x81, 0x86, 0x03, 0x18, 0x06, 0x60, 0x0D, 0xC0, 0x1F, 0xC0, 0x39,
+  0xC0, 0x61, 0xC0, 0xC1, 0x81, 0x83, 0x8F, 0xE3, 0xFF, 0xC7, 0xC0, 0x08,
+  0x50, 0x00, 0x32, 0x80, 0x00, 0x00, 0x00, 0x00, 0x00, 0x32, 0x62, 0x00,
+  0x00, 0x00, 0x0D, 0x00, 0xF0, 0x0F, 0xF8, 0x1F, 0x38, 0x1C, 0x3C, 0x3C,
+  0x3C, 0x3C, 0x36, 0x6C, 0x36, 0x6C, 0x33, 0xCC, 0x33, 0xCC, 0x31, 0x8C,
+  0x30, 0x0C, 0x30, 0x0C, 0xFE, 0x7F, 0xFE, 0x7F, 0xF1, 0xFF, 0xC7, 0xF3,
+  0x83, 0x0F, 0x0C, 0x3E, 0x30, 0xD8, 0xC3, 0x73, 0x0C, 0xEC, 0x31, 0xB0,
+  0xC7, 0xC3, 0x0F, 0x0C, 0x1C, 0xFE, 0x33, 0xF8, 0xC0, 0x0F, 0x03, 0xFC,
+  0x70, 0xE6, 0x06, 0xE0, 0x7C, 0x03, 0xC0, 0x3C, 0x03, 0xC0, 0x3E, 0x07,
+  0x60, 0x67, 0x0E, 0x3F, 0xC0, 0xF0, 0xFF, 0xCF, 0xFE, 0x30, 0x73, 0x03,
+  0x30, 0x33, 0x03, 0x30, 0x63, 0xFE, 0x3F, 0x83, 0x00, 0x30, 0x03, 0x00,
+  0xFF, 0x0F, 0xF0, 0x0F, 0x03, 0xFC, 0x70, 0xE6, 0x06, 0xE0, 0x7C, 0x03,
+  0xC0, 0x3C, 0x03, 0xC0, 0x3E, 0x07, 0x60, 0x67, 0x0E, 0x3F, 0xC1, 0xF0,
+  0x1F, 0x33, 0xFF, 0x30, 0xE0, 0xFF, 0xC3, 0xFF, 0x83, 0x07, 0x0C, 0x0C,
+  0x30, 0x30, 0xC1, 0xC3, 0xFE, 0x0F, 0xE0, 0x31, 0xC0, 0xC3, 0x83, 0x06,
+  0x0C, 0x1C, 0xFE, 0x3F, 0xF8, 0x70, 0x3E, 0xDF, 0xFE, 0x1F, 0x03, 0xC0,
+  0xFC, 0x07, 0xE0, 0x7E, 0x03, 0xF0, 0x3C, 0x0F, 0x87, 0xFF, 0xB7, 0xC0,
+  0x0C, 0x00, 0x02, 0x32, 0x32, 0x00, 0x00, 0x00, 0x52, 0x50, 0x00, 0x00,
+  0x00, 0x00, 0x00, 0x28, 0x20, 0x00, 0x06, 0x26, 0x00, 0x22, 0x62, 0x20,
+  0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x32, 0x42, 0x30, 0x38,
+  0x30, 0x54, 0x50, 0x07, 0x17, 0x00, 0x22, 0x72, 0x20, 0x32, 0x52, 0x30,
+  0x00, 0x00, 0x42, 0x32, 0x40, 0x00, 0x52, 0x12, 0x50, 0x00, 0x00, 0x63,
+  0x60, 0x00, 0x71, 0x70, 0xFE, 0x3F, 0xFF, 0x1F, 0xCC, 0x01, 0x86, 0x00,
+  0xC3, 0x08, 0x60, 0xCE, 0x60, 0x67, 0x30, 0x36, 0xD8, 0x1B, 0x6C, 0x0F,
+  0x3E, 0x03, 0x8E, 0x01, 0xC7, 0x00, 0xC1, 0x80, 0x60, 0xC0, 0xFC, 0xFF,
+  0xF3, 0xF3, 0x03, 0x06, 0x18, 0x0C, 0xC0, 0x1E, 0x00, 0x30, 0x00, 0xC0,
+  0x07, 0x80, 0x33, 0x01, 0x86, 0x0C, 0x0C, 0xFC, 0xFF, 0xF3, 0xF0, 0x05,
+  0x36, 0x00, 0x22, 0x62, 0x20, 0x32, 0x42, 0x30, 0x42, 0x22, 0x40, 0x00,
+  0x54, 0x50, 0x62, 0x60, 0x00, 0x00, 0x00, 0x00, 0x38, 0x30, 0x00, 0x7F,
+  0xEF, 0xFD, 0x81, 0xB0, 0x66, 0x18, 0xC6, 0x01, 0x80, 0x60, 0x18, 0x66,
+  0x0D, 0x81, 0xE0, 0x3F, 0xFF, 0xFF, 0xC0, 0xFF, 0xF1, 0x8C, 0x63, 0x18,
+  0xC6, 0x31, 0x8C, 0x63, 0x18, 0xFF, 0xC0, 0xC0, 0x30, 0x0E, 0x01, 0x80,
+  0x70, 0x0C, 0x03, 0x00, 0x60, 0x18, 0x03, 0x00, 0xC0, 0x18, 0x06, 0x00,
+  0xC0, 0x30, 0x0E, 0x01, 0x80, 0x70, 0x0C, 0x03, 0xFF, 0xC6, 0x31, 0x8C,
+  0x63, 0x18, 0xC6, 0x31, 0x8C, 0x63, 0xFF, 0xC0, 0x04, 0x01, 0xC0, 0x7C,
+  0x1D, 0xC3, 0x18, 0xC1, 0xB0, 0x1C, 0x01, 0x0F, 0x01, 0x00, 0xC7, 0x0E,
+  0x30, 0x3F, 0x07, 0xF8, 0x00, 0xC0, 0x0C, 0x1F, 0xC7, 0xFC, 0xE0, 0xCC,
+  0x0C, 0xC1, 0xC7, 0xFF, 0x3E, 0xF0, 0xF0, 0x07, 0x80, 0x0C, 0x00, 0x60,
+  0x03, 0x7C, 0x1F, 0xF8, 0xE0, 0xC6, 0x03, 0x30, 0x19, 0x80, 0xCC, 0x06,
+  0x60, 0x33, 0x83, 0x7F, 0xFB, 0xDF, 0x00, 0x0F, 0xB3, 0xFF, 0x70, 0x7E,
+  0x03, 0xC0, 0x3C, 0x00, 0xC0, 0x0E, 0x03, 0x70, 0x73, 0xFE, 0x0F, 0xC0,
+  0x01, 0xE0, 0x0F, 0x00, 0x18, 0x00, 0xC1, 0xF6, 0x3F, 0xF1, 0x83, 0x98,
+  0x0C, 0xC0, 0x66, 0x03, 0x30, 0x19, 0x80, 0xC6, 0x0E, 0x3F, 0xFC, 0x7D,
+  0xE0, 0x1F, 0x87, 0xFE, 0x60, 0x6C, 0x03, 0xFF, 0xFF, 0xFF, 0xC0, 0x0C,
+  0x00, 0x60, 0x37, 0xFF, 0x1F, 0xC0, 0x57, 0x48, 0x32, 0x70, 0x00, 0x0B,
+  0x10, 0x00, 0x32, 0x70, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x0A, 0x20,
+  0x00, 0x1F, 0x7B, 0xFF, 0xD8, 0x39, 0x80, 0xCC, 0x06, 0x60, 0x33, 0x01,
+  0x98, 0x0C, 0x60, 0xE3, 0xFF, 0x07, 0xD8, 0x00, 0xC0, 0x06, 0x00, 0x70,
+  0xFF, 0x07, 0xE0, 0x04, 0xA0, 0x00, 0x22, 0xA0, 0x00, 0x22, 0x15, 0x40,
+  0x29, 0x30, 0x23, 0x43, 0x20, 0x22, 0x62, 0x20, 0x00, 0x00, 0x00, 0x00,
+  0x00, 0x06, 0x26, 0x00, 0x52, 0x50, 0x00, 0xC0, 0x00, 0x16, 0x50, 0x00,
+  0x52, 0x50, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x0C, 0x00, 0x52, 0x20,
+  0x00, 0x90, 0x00, 0x09, 0x00, 0x72, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+  0x00, 0x00, 0x00, 0x00, 0x63, 0x08, 0x10, 0x06, 0x30, 0xF0, 0x0F, 0x00,
+  0x30, 0x03, 0x00, 0x33, 0xE3, 0x3E, 0x33, 0x03, 0x60, 0x3E, 0x03, 0xC0,
+  0x3E, 0x03, 0x70, 0x33, 0x8F, 0x1F, 0xF1, 0xF0, 0x16, 0x50, 0x00, 0x52,
+  0x50, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x0C,
+  0x00, 0xF7, 0x78, 0xFF, 0xFC, 0x39, 0xCC, 0x31, 0x8C, 0x31, 0x8C, 0x31,
+  0x8C, 0x31, 0x8C, 0x31, 0x8C, 0x31, 0x8C, 0xFD, 0xEF, 0xFD, 0xEF, 0x04,
+  0x15, 0x40, 0x0B, 0x30, 0x23, 0x43, 0x20, 0x22, 0x62, 0x20, 0x00, 0x00,
+  0x00, 0x00, 0x00, 0x06, 0x26, 0x00, 0x0F, 0x03, 0xFC, 0x70, 0xEE, 0x07,
+  0xC0, 0x3C, 0x03, 0xC0, 0x3E, 0x07, 0x70, 0xE3, 0xFC, 0x0F, 0x00, 0xF7,
+  0xC7, 0xFF, 0x8E, 0x0C, 0x60, 0x33, 0x01, 0x98, 0x0C, 0xC0, 0x66, 0x03,
+  0x38, 0x31, 0xFF, 0x8D, 0xF0, 0x60, 0x03, 0x00, 0x18, 0x03, 0xF8, 0x1F,
+  0xC0, 0x1F, 0x7B, 0xFF, 0xD8, 0x39, 0x80, 0xCC, 0x06, 0x60, 0x33, 0x01,
+  0x98, 0x0C, 0x60, 0xE3, 0xFF, 0x07, 0xD8, 0x00, 0xC0, 0x06, 0x00, 0x30,
+  0x0F, 0xE0, 0x7F, 0xF9, 0xEF, 0xBF, 0x1F, 0x31, 0xC0, 0x18, 0x01, 0x80,
+  0x18, 0x01, 0x80, 0x18, 0x0F, 0xFC, 0xFF, 0xC0, 0x3F, 0xDF, 0xFC, 0x0F,
+  0x03, 0xFC, 0x1F, 0xE0, 0x7F, 0x03, 0xC1, 0xFF, 0xEF, 0xF0, 0x22, 0x80,
+  0x00, 0x00, 0x00, 0x0A, 0x20, 0x00, 0x22, 0x80, 0x00, 0x00, 0x00, 0x00,
+  0x00, 0x22, 0x53, 0x39, 0x46, 0x20, 0x04, 0x44, 0x20, 0x00, 0x22, 0x62,
+  0x20, 0x00, 0x00, 0x00, 0x00, 0x00, 0x22, 0x53, 0x20, 0x3B, 0x45, 0x14,
+  0x05, 0x45, 0x00, 0x22, 0x62, 0x20, 0x00, 0x32, 0x42, 0x30, 0x00, 0x42,
+  0x22, 0x40, 0x00, 0x46, 0x40, 0x54, 0x50, 0x00, 0xF0, 0x7F, 0x83, 0xD8,
+  0x8C, 0xCE, 0x66, 0x73, 0x1A, 0xB0, 0xF7, 0x87, 0xBC, 0x38, 0xC0, 0xC6,
+  0x06, 0x30, 0xF9, 0xFF, 0x9F, 0x30, 0xC1, 0x98, 0x0F, 0x00, 0x60, 0x0F,
+  0x01, 0x98, 0x30, 0xCF, 0x9F, 0xF9, 0xF0, 0xFC, 0x3F, 0xF8, 0x7C, 0xC0,
+  0x60, 0xC1, 0x81, 0x83, 0x01, 0x8C, 0x03, 0x18, 0x03, 0x60, 0x07, 0xC0,
+  0x07, 0x00, 0x06, 0x00, 0x18, 0x00, 0x30, 0x00, 0xC0, 0x1F, 0xE0, 0x3F,
+  0xC0, 0xFF, 0xFF, 0xFC, 0x1B, 0x0C, 0x06, 0x03, 0x01, 0x80, 0xC3, 0x60,
+  0xFF, 0xFF, 0xFC, 0x1C, 0xF3, 0x0C, 0x30, 0xC3, 0x0C, 0x73, 0x87, 0x0C,
+  0x30, 0xC3, 0x0C, 0x3C, 0x70, 0xFF, 0xFF, 0xFF, 0xFF, 0xF0, 0xE3, 0xC3,
+  0x0C, 0x30, 0xC3, 0x0C, 0x38, 0x73, 0x8C, 0x30, 0xC3, 0x0C, 0xF3, 0x80,
+  0x38, 0x0F, 0x8F, 0xBB, 0xE3, 0xE0, 0x38,
+  };
+
+static const PackedGlyph pfont24_glyphs[95] =
+  {
+  {0x0000,  0,  0,  0,  0}, // ' '
+  {0x8000,  6,  2,  3, 15}, // '!'
+  {0x8006,  4,  3,  8,  7}, // '"'
+  {0x800D,  2,  2, 11, 16}, // '#'
+  {0x8023,  3,  1,  9, 19}, // '$'
+  {0x8039,  3,  2, 10, 15}, // '%'
+  {0x804C,  3,  4, 11, 13}, // '&'
+  {0x805E,  6,  3,  3,  7}, // '''
+  {0x8061,  7,  2,  6, 18}, // '('
+  {0x806F,  3,  2,  6, 18}, // ')'
+  {0x807D,  3,  2, 10, 10}, // '*'
+  {0x008A,  2,  4, 12, 12}, // '+'
+  {0x8098,  6, 14,  5,  7}, // ','
+  {0x009D,  3,  9, 10,  2}, // '-'
+  {0x809F,  6, 14,  4,  3}, // '.'
+  {0x80A1,  3,  0, 10, 20}, // '/'
+  {0x80BA,  3,  2, 10, 15}, // '0'
+  {0x80CD,  3,  2, 10, 15}, // '1'
+  {0x80E0,  2,  2, 11, 15}, // '2'
+  {0x80F5,  3,  2, 10, 15}, // '3'
+  {0x8108,  2,  2, 11, 15}, // '4'
+  {0x811D,  2,  2, 11, 15}, // '5'
+  {0x8132,  3,  2, 10, 15}, // '6'
+  {0x8145,  3,  2, 10, 15}, // '7'
+  {0x8158,  3,  2, 10, 15}, // '8'
+  {0x816B,  3,  2, 10, 15}, // '9'
+  {0x817E,  6,  6,  4, 11}, // ':'
+  {0x8184,  6,  6,  6, 13}, // ';'
+  {0x018E,  0,  4, 14, 13}, // '<'
+  {0x01A4,  1,  7, 13,  6}, // '='
+  {0x81AA,  1,  4, 14, 13}, // '>'
+  {0x81C1,  3,  3,  9, 14}, // '?'
+  {0x81D1,  3,  2, 10, 17}, // '@'
+  {0x81E7,  0,  3, 16, 14}, // 'A'
+  {0x8203,  1,  3, 13, 14}, // 'B'
+  {0x821A,  2,  3, 12, 14}, // 'C'
+  {0x822F,  1,  3, 13, 14}, // 'D'
+  {0x8246,  1,  3, 12, 14}, // 'E'
+  {0x825B,  2,  3, 12, 14}, // 'F'
+  {0x8270,  2,  3, 13, 14}, // 'G'
+  {0x0287,  1,  3, 14, 14}, // 'H'
+  {0x029C,  3,  3, 10, 14}, // 'I'
+  {0x02AB,  2,  3, 13, 14}, // 'J'
+  {0x82C0,  1,  3, 15, 14}, // 'K'
+  {0x02DB,  1,  3, 13, 14}, // 'L'
+  {0x82EC,  0,  3, 16, 14}, // 'M'
+  {0x8308,  1,  3, 14, 14}, // 'N'
+  {0x8321,  2,  3, 12, 14}, // 'O'
+  {0x8336,  2,  3, 12, 14}, // 'P'
+  {0x834B,  2,  3, 12, 17}, // 'Q'
+  {0x8365,  1,  3, 14, 14}, // 'R'
+  {0x837E,  3,  3, 10, 14}, // 'S'
+  {0x0390,  2,  3, 12, 14}, // 'T'
+  {0x03A2,  1,  3, 14, 14}, // 'U'
+  {0x03B7,  1,  3, 15, 14}, // 'V'
+  {0x83D0,  0,  3, 17, 14}, // 'W'
+  {0x83EE,  1,  3, 14, 14}, // 'X'
+  {0x0407,  1,  3, 14, 14}, // 'Y'
+  {0x841F,  2,  3, 11, 14}, // 'Z'
+  {0x8433,  7,  2,  5, 18}, // '['
+  {0x843F,  3,  0, 10, 20}, // backslash
+  {0x8458,  4,  2,  5, 18}, // ']'
+  {0x8464,  3,  1, 11,  8}, // '^'
+  {0x046F,  0, 22, 16,  2}, // '_'
+  {0x8472,  6,  1,  5,  4}, // '`'
+  {0x8475,  2,  6, 12, 11}, // 'a'
+  {0x8486,  1,  2, 13, 15}, // 'b'
+  {0x849F,  2,  6, 12, 11}, // 'c'
+  {0x84B0,  2,  2, 13, 15}, // 'd'
+  {0x84C9,  2,  6, 12, 11}, // 'e'
+  {0x04DA,  2,  2, 12, 15}, // 'f'
+  {0x84ED,  2,  6, 13, 16}, // 'g'
+  {0x0507,  1,  2, 14, 15}, // 'h'
+  {0x0520,  2,  2, 12, 15}, // 'i'
+  {0x0532,  3,  2,  9, 20}, // 'j'
+  {0x8549,  2,  2, 12, 15}, // 'k'
+  {0x0560,  2,  2, 12, 15}, // 'l'
+  {0x8571,  0,  6, 16, 11}, // 'm'
+  {0x0587,  1,  6, 14, 11}, // 'n'
+  {0x859A,  2,  6, 12, 11}, // 'o'
+  {0x85AB,  1,  6, 13, 16}, // 'p'
+  {0x85C5,  2,  6, 13, 16}, // 'q'
+  {0x85DF,  2,  6, 12, 11}, // 'r'
+  {0x85F0,  3,  6, 10, 11}, // 's'
+  {0x05FE,  2,  2, 12, 15}, // 't'
+  {0x0612,  1,  6, 14, 11}, // 'u'
+  {0x0624,  1,  6, 14, 11}, // 'v'
+  {0x8638,  1,  6, 13, 11}, // 'w'
+  {0x864A,  2,  6, 12, 11}, // 'x'
+  {0x865B,  1,  6, 15, 16}, // 'y'
+  {0x8679,  3,  6, 10, 11}, // 'z'
+  {0x8687,  5,  2,  6, 18}, // '{'
+  {0x8695,  7,  2,  2, 18}, // '|'
+  {0x869A,  5,  2,  6, 18}, // '}'
+  {0x86A8,  2,  8, 11,  5}, // '~'
+  };
+
+const PackedFont PackedFont24 =
+  {
+  17, 24, 32, 126, pfont24_glyphs, pfont24_data, 1711
+  };
+
+#endif
+
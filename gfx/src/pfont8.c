@@ -0,0 +1,61 @@
+/*============================================================================
+ *  gfx/pfont8.c
+ *
+ *  Font8, packed by tools/fontpack.c from gfx/fonts/font8.c, which
+ *  carries the font's licence. Do not edit.
+ * ==========================================================================*/
+#ifdef GFX_FONT_8
+
+#include <gfx/packedfont.h>
+
+static const uint8_t pfont8_data[475] =
+  {
+  0x00, 0x00, 0x00, 0x00, 0x00, 0x21, 0x08, 0x40, 0x10, 0x00, 0x52, 0x80,
+  0x00, 0x00, 0x00, 0x2A, 0xBE, 0xAF, 0xAA, 0x80, 0x21, 0x98, 0x61, 0x30,
+  0x80, 0x21, 0x06, 0xC1, 0x08, 0x00, 0x01, 0xC8, 0xC5, 0x3C, 0x00, 0x21,
+  0x08, 0x00, 0x00, 0x00, 0x11, 0x08, 0x42, 0x10, 0x40, 0x41, 0x08, 0x42,
+  0x11, 0x00, 0x23, 0x88, 0xA0, 0x00, 0x00, 0x01, 0x09, 0xF2, 0x10, 0x00,
+  0x00, 0x00, 0x01, 0x10, 0x80, 0x00, 0x00, 0xE0, 0x00, 0x00, 0x00, 0x00,
+  0x00, 0x10, 0x00, 0x11, 0x08, 0x44, 0x22, 0x00, 0x22, 0x94, 0xA5, 0x10,
+  0x00, 0x61, 0x08, 0x42, 0x7C, 0x00, 0x22, 0x88, 0x44, 0x38, 0x00, 0x22,
+  0x84, 0x41, 0x30, 0x00, 0x11, 0x94, 0xF1, 0x1C, 0x00, 0x72, 0x18, 0x25,
+  0x10, 0x00, 0x32, 0x18, 0xA5, 0x30, 0x00, 0x72, 0x84, 0x42, 0x10, 0x00,
+  0x22, 0x88, 0xA5, 0x10, 0x00, 0x32, 0x94, 0x61, 0x30, 0x00, 0x00, 0x08,
+  0x00, 0x10, 0x00, 0x00, 0x04, 0x01, 0x10, 0x00, 0x00, 0x89, 0x82, 0x08,
+  0x00, 0x03, 0x80, 0xE0, 0x00, 0x00, 0x02, 0x08, 0x32, 0x20, 0x00, 0x22,
+  0x84, 0x40, 0x10, 0x00, 0x32, 0x52, 0xB4, 0xA0, 0xE0, 0x61, 0x14, 0xE8,
+  0xEC, 0x00, 0xF2, 0x5C, 0x94, 0xF8, 0x00, 0x72, 0x90, 0x84, 0x18, 0x00,
+  0xF2, 0x52, 0x94, 0xF8, 0x00, 0xFA, 0x58, 0x84, 0xFC, 0x00, 0xFA, 0x58,
+  0x84, 0x70, 0x00, 0x72, 0x10, 0xB5, 0x18, 0x00, 0xEA, 0x5E, 0x94, 0xF4,
+  0x00, 0x71, 0x08, 0x42, 0x38, 0x00, 0x38, 0x84, 0xA5, 0x10, 0x00, 0xDA,
+  0x98, 0xE5, 0x6C, 0x00, 0xE2, 0x10, 0x84, 0xFC, 0x00, 0xDE, 0xF7, 0x58,
+  0xEC, 0x00, 0xDB, 0x5A, 0xB5, 0xF4, 0x00, 0x32, 0x52, 0x94, 0x98, 0x00,
+  0xF2, 0x52, 0xE4, 0x70, 0x00, 0x32, 0x52, 0x94, 0x98, 0x60, 0xF2, 0x52,
+  0xE4, 0xF4, 0x00, 0x72, 0x88, 0x25, 0x38, 0x00, 0xFD, 0x48, 0x42, 0x38,
+  0x00, 0xDA, 0x52, 0x94, 0x98, 0x00, 0xDC, 0x52, 0xA5, 0x18, 0x00, 0xDC,
+  0x6B, 0x5A, 0xA8, 0x00, 0xDA, 0x88, 0x45, 0x6C, 0x00, 0xDC, 0x54, 0x42,
+  0x38, 0x00, 0x7A, 0x44, 0x44, 0xBC, 0x00, 0x31, 0x08, 0x42, 0x10, 0xC0,
+  0x82, 0x10, 0x42, 0x10, 0x40, 0x61, 0x08, 0x42, 0x11, 0x80, 0x21, 0x14,
+  0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x1F, 0x20, 0x80, 0x00, 0x00,
+  0x00, 0x00, 0x0C, 0x27, 0x3C, 0x00, 0xC2, 0x1C, 0x94, 0xF8, 0x00, 0x00,
+  0x1C, 0x84, 0x38, 0x00, 0x18, 0x4E, 0x94, 0x9C, 0x00, 0x00, 0x1C, 0xE4,
+  0x18, 0x00, 0x11, 0x1C, 0x42, 0x38, 0x00, 0x00, 0x0E, 0x94, 0x9C, 0x26,
+  0xC2, 0x1C, 0x94, 0xF4, 0x00, 0x20, 0x18, 0x42, 0x38, 0x00, 0x20, 0x1C,
+  0x21, 0x08, 0x4E, 0xC2, 0x16, 0xE5, 0x6C, 0x00, 0x61, 0x08, 0x42, 0x38,
+  0x00, 0x00, 0x35, 0x5A, 0xD4, 0x00, 0x00, 0x3C, 0x94, 0xE4, 0x00, 0x00,
+  0x0C, 0x94, 0x98, 0x00, 0x00, 0x3C, 0x94, 0xB9, 0x1C, 0x00, 0x0E, 0x94,
+  0x9C, 0x23, 0x00, 0x1E, 0x42, 0x38, 0x00, 0x00, 0x0C, 0x41, 0x30, 0x00,
+  0x02, 0x3C, 0x84, 0x98, 0x00, 0x00, 0x36, 0x94, 0x9C, 0x00, 0x00, 0x32,
+  0x93, 0x18, 0x00, 0x00, 0x37, 0x5A, 0xA8, 0x00, 0x00, 0x12, 0x63, 0x24,
+  0x00, 0x00, 0x36, 0xA5, 0x10, 0x8C, 0x00, 0x1E, 0xA2, 0xBC, 0x00, 0x11,
+  0x08, 0xC2, 0x10, 0x40, 0x21, 0x08, 0x42, 0x10, 0x80, 0x41, 0x08, 0x62,
+  0x11, 0x00, 0x00, 0x00, 0x55, 0x00, 0x00,
+  };
+
+const PackedFont PackedFont8 =
+  {
+  5, 8, 32, 126, NULL, pfont8_data, 475
+  };
+
+#endif
+
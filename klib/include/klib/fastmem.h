@@ -0,0 +1,39 @@
+/*============================================================================
+
+  klib
+  fastmem.h
+  Copyright (c)2023 Kevin Boone, GPL v3.0
+
+  Byte-scanning functions that work a 32-bit word at a time, using the
+  usual tricks for finding particular bytes in a word with ordinary
+  arithmetic. On the Cortex-M0+, which has no SIMD instructions, they
+  are several times faster than byte loops over text of any length.
+  The parts of the input before the first word boundary and after the
+  last are done a byte at a time, so any alignment is safe.
+
+============================================================================*/
+
+#pragma once
+
+#include <stddef.h>
+#include "defs.h"
+
+BEGIN_DECLS
+
+/** Like memchr(): returns the first byte equal to c in the n bytes at
+    s, or NULL. */
+void       *fastmem_memchr (const void *s, int c, size_t n);
+
+/** Like strlen(). */
+size_t      fastmem_strlen (const char *s);
+
+/** Returns the number of bytes equal to c in the n bytes at s. */
+size_t      fastmem_count_byte (const void *s, int c, size_t n);
+
+/** Copy n bytes from src to dest, changing the ASCII letters A-Z to
+    lower case. Other bytes, including those above 127, are copied
+    unchanged. dest may be the same as src. */
+void        fastmem_tolower (char *dest, const char *src, size_t n);
+
+END_DECLS
+
@@ -0,0 +1,75 @@
+/*============================================================================
+
+  klib
+  hashmap.h
+  Copyright (c)2023 Kevin Boone, GPL v3.0
+
+  An open-addressing hash map. The map does not copy or free its keys --
+  the caller must make sure that a key stays valid for as long as it is
+  in the map. Often the key is part of the value, in which case this is
+  automatic. Values can be freed by the map, if a free function is
+  supplied.
+
+  Entries are kept in insertion order, so iterating a map with
+  hashmap_iterate() gives them back in the order they were added.
+
+============================================================================*/
+
+#pragma once
+
+#include <stdint.h>
+#include "defs.h"
+
+struct _HashMap;
+typedef struct _HashMap HashMap;
+
+typedef uint32_t (*HashMapHashFn) (const void *key);
+typedef BOOL (*HashMapEqualFn) (const void *key1, const void *key2);
+typedef void (*HashMapItemFreeFn) (void *);
+
+BEGIN_DECLS
+
+HashMap    *hashmap_create (HashMapHashFn hash_fn, HashMapEqualFn equal_fn,
+              HashMapItemFreeFn free_fn);
+
+/** Create a map whose keys are C strings. If nocase is TRUE, keys
+    are hashed and compared without regard to (ASCII) case. */
+HashMap    *hashmap_create_strings (BOOL nocase, HashMapItemFreeFn free_fn);
+
+/** Create a map whose keys are integers. Use HASHMAP_INT_KEY to
+    convert an integer to a key. */
+HashMap    *hashmap_create_ints (HashMapItemFreeFn free_fn);
+
+void        hashmap_destroy (HashMap *self);
+
+/** Add an item, replacing (and freeing) any existing value with the
+    same key. The key pointer is replaced as well. */
+void        hashmap_put (HashMap *self, const void *key, void *value);
+
+void       *hashmap_get (const HashMap *self, const void *key);
+BOOL        hashmap_contains (const HashMap *self, const void *key);
+
+/** Remove the item with the specified key, calling the free function
+    on its value. Returns TRUE if the key was present. */
+BOOL        hashmap_remove (HashMap *self, const void *key);
+
+/** Remove all items, freeing their values. */
+void        hashmap_clear (HashMap *self);
+
+int         hashmap_size (const HashMap *self);
+
+/** Iterate over the map in insertion order. Set *pos to zero before
+    the first call. Returns FALSE when there are no more entries. The
+    map must not be modified during iteration. Either of key and value
+    may be NULL, if the caller is not interested. */
+BOOL        hashmap_iterate (const HashMap *self, int *pos,
+              const void **key, void **value);
+
+uint32_t    hashmap_hash_string (const void *key);
+uint32_t    hashmap_hash_string_nocase (const void *key);
+uint32_t    hashmap_hash_int (const void *key);
+
+END_DECLS
+
+#define HASHMAP_INT_KEY(i) ((const void *)(intptr_t)(i))
+
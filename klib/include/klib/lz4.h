@@ -0,0 +1,38 @@
+/*============================================================================
+
+  klib
+  lz4.h
+  Copyright (c)2023 Kevin Boone, GPL v3.0
+
+  A decoder for the LZ4 block format. The compressed data is pulled from
+  a caller-supplied function, a buffer at a time, and decompressed straight
+  into its final location. Since LZ4 matches only refer back to data that
+  has already been decompressed, no other working memory is needed.
+
+============================================================================*/
+
+#pragma once
+
+#include <stdint.h>
+#include "defs.h"
+
+// Errors returned by lz4_decompress_stream
+#define LZ4_ERR_CORRUPT  -1 // Bad match offset, or input ended mid-sequence
+#define LZ4_ERR_OVERFLOW -2 // Output would not fit in the space supplied
+#define LZ4_ERR_READ     -3 // The read function reported an error
+
+/** Supplies compressed data. Returns the number of bytes stored in buff,
+    which must not exceed len; zero at the end of the data; or a negative
+    number on error. */
+typedef int (*LZ4ReadFn) (void *context, uint8_t *buff, int len);
+
+BEGIN_DECLS
+
+/** Decompress one LZ4 block, reading it with read_fn using buff (of
+    buff_size bytes) as the input buffer, and writing at most out_size
+    bytes to out. Returns the number of bytes decompressed, or one
+    of the LZ4_ERR_ values. */
+int32_t lz4_decompress_stream (LZ4ReadFn read_fn, void *context,
+          uint8_t *buff, int buff_size, uint8_t *out, uint32_t out_size);
+
+END_DECLS
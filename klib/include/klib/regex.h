@@ -0,0 +1,91 @@
+/*============================================================================
+
+  klib
+  regex.h
+  Copyright (c)2023 Kevin Boone, GPL v3.0
+
+  Regular expressions, in roughly the POSIX extended syntax. A pattern is
+  compiled once to a Thompson NFA, and text is matched by a lazily-built
+  DFA, whose states are made from sets of NFA states as they are first
+  needed. Matching time is linear in the length of the text, whatever
+  the pattern, and all the memory a compiled pattern will ever use is
+  allocated by regex_compile().
+
+  Supported:
+
+    c          Any character that is not special matches itself
+    \c         Any special character c, literally
+    .          Any character
+    ^ $        Start and end of the text
+    [abc]      Any of a, b, c; ranges like a-z; [^abc] for none of them;
+               POSIX classes like [:alpha:]
+    \d \w \s   Digit, word character, white space (and \D \W \S)
+    \t \n \r   Tab, newline, carriage return
+    x* x+ x?   Repetition of the previous item
+    x{m} x{m,} x{m,n}  Bounded repetition; a missing m is 0,
+                       so x{,n} is x{0,n}, as in glibc
+    x|y        Alternation
+    (x)        Grouping
+
+============================================================================*/
+
+#pragma once
+
+#include <stdint.h>
+#include "defs.h"
+
+// Flags for regex_compile
+#define REGEX_ICASE 0x0001 // Ignore (ASCII) case
+
+// Errors from regex_compile
+#define REGEX_ERR_SYNTAX  -1 // Unbalanced (), [], or a stray |
+#define REGEX_ERR_REPEAT  -2 // Bad {m,n}
+#define REGEX_ERR_TOO_BIG -3 // More than REGEX_MAX_STATES NFA states
+#define REGEX_ERR_NOMEM   -4
+#define REGEX_ERR_DEPTH   -5 // () nested more than REGEX_MAX_DEPTH deep
+
+// Most NFA states a pattern may compile to. Each one is a literal
+//   character or class, or a branch, and x{m,n} makes n copies of x.
+#define REGEX_MAX_STATES 512
+
+// Deepest nesting of () in a pattern. This limits the recursion when
+//   parsing, and when generating the NFA.
+#define REGEX_MAX_DEPTH 16
+
+// Bytes of memory for the DFA states of one pattern. When it is full,
+//   the cache is emptied and filled again, which costs time, but not
+//   more than constant time per character of text.
+#define REGEX_DFA_BUDGET 4096
+
+struct _Regex;
+typedef struct _Regex Regex;
+
+BEGIN_DECLS
+
+/** Compile a pattern. Returns NULL on failure, and sets *error to one
+    of the REGEX_ERR_ values, if error is not NULL. */
+Regex      *regex_compile (const char *pattern, int flags, int *error);
+
+void        regex_destroy (Regex *self);
+
+/** Returns TRUE if the pattern matches anywhere in the len bytes of
+    text. This is the fastest test, as it only needs the DFA. */
+BOOL        regex_match (Regex *self, const char *text, int len);
+
+/** Find the leftmost match in the len bytes of text, and the longest
+    match that starts there. Returns the position of the match, and
+    sets *match_len, or returns -1 if there is no match. */
+int         regex_search (Regex *self, const char *text, int len,
+              int *match_len);
+
+/** Returns a string that every match contains, and sets *len, or
+    returns NULL if there isn't one that is easy to find. Text that
+    does not contain it can be skipped without matching. With
+    REGEX_ICASE, the string is in lower case, and matches either. */
+const char *regex_literal (const Regex *self, int *len);
+
+/** Returns a description of a REGEX_ERR_ value. */
+const char *regex_error_string (int error);
+
+END_DECLS
+
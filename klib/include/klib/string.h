@@ -11,11 +11,12 @@
 #include <stdint.h>
 #include "defs.h"
 #include "list.h"
+#include "vector.h"
 
 struct _String;
 typedef struct _String String;
 
-typedef void (*StringTokGlobber) (String *token, List *list);
+typedef void (*StringTokGlobber) (String *token, Vector *list);
 typedef const char *(*StringTokVarLookup) (const char *var, void *context);
 
 extern StringTokGlobber string_tok_globber;
@@ -33,6 +34,8 @@ const char  *string_cstr (const String *self);
 const char  *string_cstr_safe (const String *self);
 void         string_append_printf (String *self, const char *fmt,...);
 void         string_append (String *self, const char *s);
+void         string_append_n (String *self, const char *s, int32_t n);
+void         string_reserve (String *self, int32_t len);
 void         string_append_c (String *self, const uint32_t c);
 void         string_prepend (String *self, const char *s);
 int32_t      string_length (const String *self);
@@ -53,7 +56,7 @@ List       *string_split (const String *self, const char *delim);
 void        string_delete_last (String *self);
 void        string_insert_c_at (String *self, int pos, char c);
 void        string_delete_c_at (String *self, int pos);
-List       *string_tokenize2 (const String *s, void *context);
+Vector     *string_tokenize2 (const String *s, void *context);
 
 END_DECLS
 
@@ -0,0 +1,43 @@
+/*============================================================================
+
+  klib
+  vector.h
+  Copyright (c)2023 Kevin Boone, GPL v3.0
+
+  A growable, contiguous array of pointers. Unlike List, appending,
+  indexing and finding the length are all constant-time operations
+  (appending is amortised), so a Vector should be preferred wherever
+  code iterates over a collection by index.
+
+============================================================================*/
+
+#pragma once
+
+#include "defs.h"
+
+struct _Vector;
+typedef struct _Vector Vector;
+
+// The comparison function for vector_sort. As with list_sort, the i1,i2
+//   arguments are the addresses of the pointers in the vector, not
+//   the pointers themselves, because that is what qsort_r passes.
+typedef int (*VectorSortFn) (const void *i1, const void *i2,
+          void *user_data);
+
+typedef void (*VectorItemFreeFn) (void *);
+
+BEGIN_DECLS
+
+Vector *vector_create (VectorItemFreeFn free_fn);
+Vector *vector_create_strings (void);
+void    vector_destroy (Vector *self);
+void    vector_append (Vector *self, void *item);
+void   *vector_get (const Vector *self, int index);
+int     vector_length (const Vector *self);
+void    vector_remove_at (Vector *self, int index);
+void    vector_remove_object (Vector *self, const void *item);
+void    vector_sort (Vector *self, VectorSortFn fn, void *user_data);
+void    vector_reserve (Vector *self, int capacity);
+
+END_DECLS
+
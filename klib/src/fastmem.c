@@ -0,0 +1,189 @@
+/*============================================================================
+
+  klib
+  fastmem.c
+  Copyright (c)2023 Kevin Boone, GPL v3.0
+
+  A word w has a zero byte if (w - 0x01010101) & ~w & 0x80808080 is not
+  zero. That can wrongly flag a 0x01 byte above a zero byte, which is
+  fine for finding the first one, but not for counting them, so
+  fastmem_count_byte() uses a version that doesn't borrow between bytes.
+  To look for byte c rather than zero, the word is XORed with c in every
+  byte first.
+
+  fastmem_strlen() reads the whole of the word that holds the terminating
+  zero, which may run past the end of the string, but never into another
+  word, so never into memory that can't be read. AddressSanitizer doesn't
+  know that, and so is turned off for it.
+
+============================================================================*/
+
+#define _GNU_SOURCE
+#include <stdint.h>
+#include <string.h>
+#include "../include/klib/fastmem.h"
+
+#define ONES  0x01010101u
+#define HIGHS 0x80808080u
+
+// A word with a 1 in the top bit of each byte of w that is zero. The
+//   result may have false positives above a real one.
+#define HAS_ZERO(w) (((w) - ONES) & ~(w) & HIGHS)
+
+// Words are read from buffers of bytes, so they may alias anything
+typedef uint32_t __attribute__((__may_alias__)) Word;
+
+#if defined(__SANITIZE_ADDRESS__)
+#define FASTMEM_NO_ASAN __attribute__((no_sanitize_address))
+#else
+#define FASTMEM_NO_ASAN
+#endif
+
+/*==========================================================================
+fastmem_aligned
+TRUE if p is on a word boundary
+*==========================================================================*/
+static inline BOOL fastmem_aligned (const void *p)
+  {
+  return ((uintptr_t)p & (sizeof (uint32_t) - 1)) == 0;
+  }
+
+/*==========================================================================
+fastmem_exact_zeros
+A word with a 1 in the top bit of each byte of w that is zero, and
+nowhere else
+*==========================================================================*/
+static inline uint32_t fastmem_exact_zeros (uint32_t w)
+  {
+  uint32_t t = ((w & ~HIGHS) + ~HIGHS) | w;
+  return ~t & HIGHS;
+  }
+
+/*==========================================================================
+fastmem_memchr
+*==========================================================================*/
+void *fastmem_memchr (const void *s, int c, size_t n)
+  {
+  const uint8_t *p = s;
+  uint8_t b = (uint8_t)c;
+  while (n && !fastmem_aligned (p))
+    {
+    if (*p == b) return (void *)p;
+    p++;
+    n--;
+    }
+  uint32_t pattern = b * ONES;
+  while (n >= sizeof (uint32_t))
+    {
+    uint32_t w = *(const Word *)p ^ pattern;
+    if (HAS_ZERO (w)) break;
+    p += sizeof (uint32_t);
+    n -= sizeof (uint32_t);
+    }
+  while (n)
+    {
+    if (*p == b) return (void *)p;
+    p++;
+    n--;
+    }
+  return NULL;
+  }
+
+/*==========================================================================
+fastmem_strlen
+*==========================================================================*/
+FASTMEM_NO_ASAN size_t fastmem_strlen (const char *s)
+  {
+  const char *p = s;
+  while (!fastmem_aligned (p))
+    {
+    if (!*p) return (size_t)(p - s);
+    p++;
+    }
+  const Word *w = (const Word *)p;
+  while (!HAS_ZERO (*w)) w++;
+  p = (const char *)w;
+  while (*p) p++;
+  return (size_t)(p - s);
+  }
+
+/*==========================================================================
+fastmem_count_byte
+Each byte of 'lanes' counts the matches in that byte position. They
+are added together before any of them can overflow, after 255 words.
+*==========================================================================*/
+size_t fastmem_count_byte (const void *s, int c, size_t n)
+  {
+  const uint8_t *p = s;
+  uint8_t b = (uint8_t)c;
+  size_t count = 0;
+  while (n && !fastmem_aligned (p))
+    {
+    count += (*p++ == b);
+    n--;
+    }
+  uint32_t pattern = b * ONES;
+  while (n >= sizeof (uint32_t))
+    {
+    uint32_t lanes = 0;
+    for (int i = 0; i < 255 && n >= sizeof (uint32_t); i++)
+      {
+      lanes += fastmem_exact_zeros (*(const Word *)p ^ pattern) >> 7;
+      p += sizeof (uint32_t);
+      n -= sizeof (uint32_t);
+      }
+    lanes = (lanes & 0x00FF00FFu) + ((lanes >> 8) & 0x00FF00FFu);
+    count += (lanes & 0xFFFFu) + (lanes >> 16);
+    }
+  while (n)
+    {
+    count += (*p++ == b);
+    n--;
+    }
+  return count;
+  }
+
+/*==========================================================================
+fastmem_lower_word
+Set bit 5 of each byte that is A-Z. Adding 0x3F to the low seven bits
+of a byte sets its top bit if it is at least 'A', and adding 0x25 does
+so if it is greater than 'Z'. Neither sum can carry into the next byte.
+*==========================================================================*/
+static inline uint32_t fastmem_lower_word (uint32_t w)
+  {
+  uint32_t low7 = w & ~HIGHS;
+  uint32_t ge_a = low7 + 0x3F3F3F3Fu;
+  uint32_t gt_z = low7 + 0x25252525u;
+  uint32_t upper = (ge_a ^ gt_z) & ~w & HIGHS;
+  return w | (upper >> 2);
+  }
+
+/*==========================================================================
+fastmem_tolower
+Words are only used when src and dest are aligned the same way.
+*==========================================================================*/
+void fastmem_tolower (char *dest, const char *src, size_t n)
+  {
+  BOOL words = (((uintptr_t)dest ^ (uintptr_t)src)
+    & (sizeof (uint32_t) - 1)) == 0;
+  while (n && !(words && fastmem_aligned (src)))
+    {
+    char ch = *src++;
+    *dest++ = (ch >= 'A' && ch <= 'Z') ? (char)(ch + 'a' - 'A') : ch;
+    n--;
+    }
+  while (n >= sizeof (uint32_t))
+    {
+    *(Word *)dest = fastmem_lower_word (*(const Word *)src);
+    src += sizeof (uint32_t);
+    dest += sizeof (uint32_t);
+    n -= sizeof (uint32_t);
+    }
+  while (n)
+    {
+    char ch = *src++;
+    *dest++ = (ch >= 'A' && ch <= 'Z') ? (char)(ch + 'a' - 'A') : ch;
+    n--;
+    }
+  }
+
@@ -0,0 +1,380 @@
+/*============================================================================
+
+  klib
+  hashmap.c
+  Copyright (c)2023 Kevin Boone, GPL v3.0
+
+  An open-addressing hash map with linear probing. The entries themselves
+  are stored in a flat array, in the order they were added; the hash
+  table proper is an array of indices into the entry array. This keeps
+  iteration in insertion order, and means that adding an item never
+  allocates anything except when one of the arrays has to grow (and
+  they grow geometrically).
+
+  Removing an item leaves a hole in the entry array and a 'deleted'
+  marker in the index. Both are cleaned up when the table is next
+  rebuilt.
+
+============================================================================*/
+
+#define _GNU_SOURCE
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <strings.h>
+#include <memory.h>
+#include "../include/klib/hashmap.h"
+
+#define LOG_IN
+#define LOG_OUT
+
+// Smallest size of the index table. Must be a power of two
+#define HASHMAP_MIN_INDEX 8
+
+// Markers in the index table. Anything else is a position in the
+//   entry array
+#define HASHMAP_EMPTY   -1
+#define HASHMAP_DELETED -2
+
+typedef struct _HashMapEntry
+  {
+  const void *key;
+  void *value;
+  uint32_t hash;
+  BOOL used;
+  } HashMapEntry;
+
+struct _HashMap
+  {
+  HashMapHashFn hash_fn;
+  HashMapEqualFn equal_fn;
+  HashMapItemFreeFn free_fn;
+  HashMapEntry *entries;
+  int n_entries; // Entries in use, including deleted ones
+  int entries_capacity;
+  int count; // Live entries
+  int32_t *index;
+  int index_size;
+  };
+
+/*==========================================================================
+  hashmap_hash_string
+  FNV-1a
+*==========================================================================*/
+uint32_t hashmap_hash_string (const void *key)
+  {
+  const unsigned char *s = key;
+  uint32_t h = 2166136261u;
+  while (*s)
+    {
+    h ^= *s++;
+    h *= 16777619u;
+    }
+  return h;
+  }
+
+/*==========================================================================
+  hashmap_hash_string_nocase
+  FNV-1a, with ASCII letters folded to lower case
+*==========================================================================*/
+uint32_t hashmap_hash_string_nocase (const void *key)
+  {
+  const unsigned char *s = key;
+  uint32_t h = 2166136261u;
+  while (*s)
+    {
+    unsigned char c = *s++;
+    if (c >= 'A' && c <= 'Z') c = (unsigned char)(c + 'a' - 'A');
+    h ^= c;
+    h *= 16777619u;
+    }
+  return h;
+  }
+
+/*==========================================================================
+  hashmap_hash_int
+  The finalizer from MurmurHash3, which spreads small consecutive
+  integers over the whole table
+*==========================================================================*/
+uint32_t hashmap_hash_int (const void *key)
+  {
+  uint32_t h = (uint32_t)(uintptr_t)key;
+  h ^= h >> 16;
+  h *= 0x85ebca6bu;
+  h ^= h >> 13;
+  h *= 0xc2b2ae35u;
+  h ^= h >> 16;
+  return h;
+  }
+
+/*==========================================================================
+  Equality functions for the standard key types
+*==========================================================================*/
+static BOOL hashmap_equal_string (const void *key1, const void *key2)
+  {
+  return strcmp (key1, key2) == 0;
+  }
+
+static BOOL hashmap_equal_string_nocase (const void *key1, const void *key2)
+  {
+  return strcasecmp (key1, key2) == 0;
+  }
+
+static BOOL hashmap_equal_int (const void *key1, const void *key2)
+  {
+  return key1 == key2;
+  }
+
+/*==========================================================================
+  hashmap_create
+*==========================================================================*/
+HashMap *hashmap_create (HashMapHashFn hash_fn, HashMapEqualFn equal_fn,
+          HashMapItemFreeFn free_fn)
+  {
+  LOG_IN
+  HashMap *self = malloc (sizeof (HashMap));
+  memset (self, 0, sizeof (HashMap));
+  self->hash_fn = hash_fn;
+  self->equal_fn = equal_fn;
+  self->free_fn = free_fn;
+  self->index_size = HASHMAP_MIN_INDEX;
+  self->index = malloc ((size_t)self->index_size * sizeof (int32_t));
+  memset (self->index, 0xFF, (size_t)self->index_size * sizeof (int32_t));
+  LOG_OUT
+  return self;
+  }
+
+/*==========================================================================
+  hashmap_create_strings
+*==========================================================================*/
+HashMap *hashmap_create_strings (BOOL nocase, HashMapItemFreeFn free_fn)
+  {
+  if (nocase)
+    return hashmap_create (hashmap_hash_string_nocase,
+      hashmap_equal_string_nocase, free_fn);
+  else
+    return hashmap_create (hashmap_hash_string, hashmap_equal_string,
+      free_fn);
+  }
+
+/*==========================================================================
+  hashmap_create_ints
+*==========================================================================*/
+HashMap *hashmap_create_ints (HashMapItemFreeFn free_fn)
+  {
+  return hashmap_create (hashmap_hash_int, hashmap_equal_int, free_fn);
+  }
+
+/*==========================================================================
+  hashmap_clear
+*==========================================================================*/
+void hashmap_clear (HashMap *self)
+  {
+  LOG_IN
+  for (int i = 0; i < self->n_entries; i++)
+    {
+    if (self->entries[i].used && self->free_fn)
+      self->free_fn (self->entries[i].value);
+    }
+  self->n_entries = 0;
+  self->count = 0;
+  memset (self->index, 0xFF, (size_t)self->index_size * sizeof (int32_t));
+  LOG_OUT
+  }
+
+/*==========================================================================
+  hashmap_destroy
+*==========================================================================*/
+void hashmap_destroy (HashMap *self)
+  {
+  LOG_IN
+  if (self)
+    {
+    hashmap_clear (self);
+    free (self->entries);
+    free (self->index);
+    free (self);
+    }
+  LOG_OUT
+  }
+
+/*==========================================================================
+  hashmap_find_slot
+  Returns the position in the index of the entry with the specified key,
+  or -1 if there is none.
+*==========================================================================*/
+static int hashmap_find_slot (const HashMap *self, const void *key,
+        uint32_t hash)
+  {
+  uint32_t mask = (uint32_t)self->index_size - 1;
+  uint32_t slot = hash & mask;
+  for (;;)
+    {
+    int32_t e = self->index[slot];
+    if (e == HASHMAP_EMPTY) return -1;
+    if (e >= 0)
+      {
+      const HashMapEntry *entry = &self->entries[e];
+      if (entry->hash == hash && self->equal_fn (entry->key, key))
+        return (int)slot;
+      }
+    slot = (slot + 1) & mask;
+    }
+  }
+
+/*==========================================================================
+  hashmap_rebuild
+  Squeeze deleted entries out of the entry array, and rebuild the index
+  with a size that leaves plenty of room for the live entries.
+*==========================================================================*/
+static void hashmap_rebuild (HashMap *self)
+  {
+  LOG_IN
+  int j = 0;
+  for (int i = 0; i < self->n_entries; i++)
+    {
+    if (self->entries[i].used)
+      {
+      if (i != j) self->entries[j] = self->entries[i];
+      j++;
+      }
+    }
+  self->n_entries = j;
+
+  int size = HASHMAP_MIN_INDEX;
+  while (size * 3 < (self->count + 1) * 4 * 2) size *= 2;
+  if (size != self->index_size)
+    {
+    free (self->index);
+    self->index = malloc ((size_t)size * sizeof (int32_t));
+    self->index_size = size;
+    }
+  memset (self->index, 0xFF, (size_t)size * sizeof (int32_t));
+
+  uint32_t mask = (uint32_t)size - 1;
+  for (int i = 0; i < self->n_entries; i++)
+    {
+    uint32_t slot = self->entries[i].hash & mask;
+    while (self->index[slot] != HASHMAP_EMPTY)
+      slot = (slot + 1) & mask;
+    self->index[slot] = i;
+    }
+  LOG_OUT
+  }
+
+/*==========================================================================
+  hashmap_put
+*==========================================================================*/
+void hashmap_put (HashMap *self, const void *key, void *value)
+  {
+  LOG_IN
+  uint32_t hash = self->hash_fn (key);
+  int slot = hashmap_find_slot (self, key, hash);
+  if (slot >= 0)
+    {
+    HashMapEntry *entry = &self->entries[self->index[slot]];
+    if (self->free_fn && entry->value != value)
+      self->free_fn (entry->value);
+    entry->key = key;
+    entry->value = value;
+    LOG_OUT
+    return;
+    }
+
+  // Deleted entries still occupy the index, so count them when
+  //   deciding whether the table is too full. Keep the load below 3/4.
+  if ((self->n_entries + 1) * 4 > self->index_size * 3)
+    hashmap_rebuild (self);
+
+  if (self->n_entries == self->entries_capacity)
+    {
+    self->entries_capacity = self->entries_capacity
+      ? self->entries_capacity * 2 : HASHMAP_MIN_INDEX / 2;
+    self->entries = realloc (self->entries,
+      (size_t)self->entries_capacity * sizeof (HashMapEntry));
+    }
+
+  int e = self->n_entries++;
+  self->entries[e].key = key;
+  self->entries[e].value = value;
+  self->entries[e].hash = hash;
+  self->entries[e].used = TRUE;
+  self->count++;
+
+  uint32_t mask = (uint32_t)self->index_size - 1;
+  uint32_t s = hash & mask;
+  while (self->index[s] >= 0)
+    s = (s + 1) & mask;
+  self->index[s] = e;
+  LOG_OUT
+  }
+
+/*==========================================================================
+  hashmap_get
+*==========================================================================*/
+void *hashmap_get (const HashMap *self, const void *key)
+  {
+  int slot = hashmap_find_slot (self, key, self->hash_fn (key));
+  if (slot < 0) return NULL;
+  return self->entries[self->index[slot]].value;
+  }
+
+/*==========================================================================
+  hashmap_contains
+*==========================================================================*/
+BOOL hashmap_contains (const HashMap *self, const void *key)
+  {
+  return hashmap_find_slot (self, key, self->hash_fn (key)) >= 0;
+  }
+
+/*==========================================================================
+  hashmap_remove
+*==========================================================================*/
+BOOL hashmap_remove (HashMap *self, const void *key)
+  {
+  LOG_IN
+  int slot = hashmap_find_slot (self, key, self->hash_fn (key));
+  if (slot < 0)
+    {
+    LOG_OUT
+    return FALSE;
+    }
+  HashMapEntry *entry = &self->entries[self->index[slot]];
+  if (self->free_fn) self->free_fn (entry->value);
+  entry->used = FALSE;
+  entry->key = NULL;
+  entry->value = NULL;
+  self->index[slot] = HASHMAP_DELETED;
+  self->count--;
+  LOG_OUT
+  return TRUE;
+  }
+
+/*==========================================================================
+  hashmap_size
+*==========================================================================*/
+int hashmap_size (const HashMap *self)
+  {
+  return self->count;
+  }
+
+/*==========================================================================
+  hashmap_iterate
+*==========================================================================*/
+BOOL hashmap_iterate (const HashMap *self, int *pos, const void **key,
+        void **value)
+  {
+  while (*pos < self->n_entries)
+    {
+    const HashMapEntry *entry = &self->entries[*pos];
+    (*pos)++;
+    if (entry->used)
+      {
+      if (key) *key = entry->key;
+      if (value) *value = entry->value;
+      return TRUE;
+      }
+    }
+  return FALSE;
+  }
+
@@ -0,0 +1,160 @@
+/*============================================================================
+
+  klib
+  lz4.c
+  Copyright (c)2023 Kevin Boone, GPL v3.0
+
+  LZ4 block decoder. A block is a sequence of sequences, each of which
+  is a token byte, some literals, and a back-reference:
+
+    token: high nibble = literal length, low nibble = match length - 4;
+           a nibble of 15 means that further length bytes follow, each
+           added to the length, until one is less than 255.
+    literals
+    offset: two bytes, little-endian, counting back from the output position
+    (extra match length bytes)
+
+  The last sequence has literals only, and ends at the end of the input.
+
+============================================================================*/
+
+#include <stdint.h>
+#include <string.h>
+#include "../include/klib/lz4.h"
+
+#define LOG_IN
+#define LOG_OUT
+
+// The minimum length of a match
+#define LZ4_MIN_MATCH 4
+
+typedef struct _LZ4Input
+  {
+  LZ4ReadFn read_fn;
+  void *context;
+  uint8_t *buff;
+  int size;
+  int pos;
+  int len;
+  int error;
+  } LZ4Input;
+
+/*==========================================================================
+  lz4_fill
+  Returns FALSE at the end of the input, or on a read error.
+*==========================================================================*/
+static BOOL lz4_fill (LZ4Input *in)
+  {
+  if (in->error) return FALSE;
+  int n = in->read_fn (in->context, in->buff, in->size);
+  if (n < 0) in->error = LZ4_ERR_READ;
+  if (n <= 0) return FALSE;
+  in->pos = 0;
+  in->len = n;
+  return TRUE;
+  }
+
+/*==========================================================================
+  lz4_getc
+  Returns the next input byte, or -1 at the end of the input
+*==========================================================================*/
+static inline int lz4_getc (LZ4Input *in)
+  {
+  if (in->pos == in->len && !lz4_fill (in)) return -1;
+  return in->buff[in->pos++];
+  }
+
+/*==========================================================================
+  lz4_get_length
+  Add the extra length bytes that follow a nibble of 15 
+*==========================================================================*/
+static int32_t lz4_get_length (LZ4Input *in, uint32_t len)
+  {
+  int c;
+  do
+    {
+    c = lz4_getc (in);
+    if (c < 0) return LZ4_ERR_CORRUPT;
+    len += (uint32_t)c;
+    if (len > INT32_MAX) return LZ4_ERR_OVERFLOW;
+    } while (c == 255);
+  return (int32_t)len;
+  }
+
+/*==========================================================================
+  lz4_decompress_stream
+*==========================================================================*/
+int32_t lz4_decompress_stream (LZ4ReadFn read_fn, void *context,
+          uint8_t *buff, int buff_size, uint8_t *out, uint32_t out_size)
+  {
+  LOG_IN
+  LZ4Input in;
+  in.read_fn = read_fn;
+  in.context = context;
+  in.buff = buff;
+  in.size = buff_size;
+  in.pos = 0;
+  in.len = 0;
+  in.error = 0;
+
+  uint32_t op = 0;
+  int32_t ret = 0;
+
+  for (;;)
+    {
+    int token = lz4_getc (&in);
+    if (token < 0) break; // Clean end of block
+
+    // Literals, copied from the input buffer a bufferful at a time
+    int32_t lit = token >> 4;
+    if (lit == 15) lit = lz4_get_length (&in, 15);
+    if (lit < 0) { ret = lit; break; }
+    if ((uint32_t)lit > out_size - op) { ret = LZ4_ERR_OVERFLOW; break; }
+    while (lit > 0)
+      {
+      if (in.pos == in.len && !lz4_fill (&in)) 
+        { 
+        ret = LZ4_ERR_CORRUPT; 
+        break; 
+        }
+      int n = in.len - in.pos;
+      if (n > lit) n = lit;
+      memcpy (out + op, in.buff + in.pos, (size_t)n);
+      in.pos += n;
+      op += (uint32_t)n;
+      lit -= n;
+      }
+    if (ret) break;
+
+    // The last sequence has no match part
+    int lo = lz4_getc (&in);
+    if (lo < 0) break; 
+    int hi = lz4_getc (&in);
+    if (hi < 0) { ret = LZ4_ERR_CORRUPT; break; }
+    uint32_t offset = (uint32_t)(lo | (hi << 8));
+    if (offset == 0 || offset > op) { ret = LZ4_ERR_CORRUPT; break; }
+
+    int32_t mlen = token & 0x0F;
+    if (mlen == 15) mlen = lz4_get_length (&in, 15);
+    if (mlen < 0) { ret = mlen; break; }
+    mlen += LZ4_MIN_MATCH;
+    if ((uint32_t)mlen > out_size - op) { ret = LZ4_ERR_OVERFLOW; break; }
+
+    uint8_t *dst = out + op;
+    const uint8_t *src = dst - offset;
+    if (offset >= (uint32_t)mlen)
+      memcpy (dst, src, (size_t)mlen);
+    else
+      {
+      // Overlapping match -- a run. Must be copied forwards, a byte 
+      //   at a time
+      for (int32_t i = 0; i < mlen; i++) dst[i] = src[i];
+      }
+    op += (uint32_t)mlen;
+    }
+
+  if (ret == 0 && in.error) ret = in.error;
+  if (ret == 0) ret = (int32_t)op;
+  LOG_OUT
+  return ret;
+  }
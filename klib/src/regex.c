@@ -0,0 +1,1168 @@
+/*============================================================================
+
+  klib
+  regex.c
+  Copyright (c)2023 Kevin Boone, GPL v3.0
+
+  The pattern is parsed into a tree, and the tree is turned into a
+  Thompson NFA, building backwards from the match state so that every
+  item is generated with its successor already known. Repetitions with
+  bounds are generated as copies of the repeated item.
+
+  The 256 byte values are divided into classes of bytes that no part of
+  the pattern can tell apart, so that a DFA state needs one transition
+  per class, rather than 256. DFA states are sets of NFA states, and are
+  made only when the text leads to them. They live in a fixed arena,
+  which is emptied if it fills up. Since a DFA state costs at most one
+  pass over the NFA to make, matching is linear in the text either way.
+
+  regex_match() runs only the DFA. regex_search() uses the DFA to check
+  that there is a match, and then simulates the NFA, carrying the start
+  position of each thread, to find where it is.
+
+============================================================================*/
+
+#define _GNU_SOURCE
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <ctype.h>
+#include "../include/klib/regex.h"
+
+#define LOG_IN
+#define LOG_OUT
+
+// Largest count allowed in {m,n}
+#define REGEX_MAX_REPEAT 255
+
+// Buckets in the hash table of DFA states. Must be a power of two.
+#define REGEX_DFA_BUCKETS 64
+
+// Most DFA states that the arena can hold, which is when each is
+//   as small as it can be
+#define REGEX_DFA_MAX_STATES (REGEX_DFA_BUDGET / 32)
+
+// NFA state operations
+#define RX_CHAR  0 // Match one byte
+#define RX_SET   1 // Match a byte in a set
+#define RX_SPLIT 2 // Go to both out and out1
+#define RX_BOL   3 // Only at the start of the text
+#define RX_EOL   4 // Only at the end of the text
+#define RX_MATCH 5
+
+// Parse tree node types
+#define RN_EMPTY  0
+#define RN_CHAR   1
+#define RN_SET    2
+#define RN_BOL    3
+#define RN_EOL    4
+#define RN_CAT    5
+#define RN_ALT    6
+#define RN_REPEAT 7
+
+// Contexts for following assertions in a closure
+#define RX_AT_BEGIN 0x01
+#define RX_AT_END   0x02
+
+// DFA state flags
+#define RX_D_MATCH     0x01 // A match has been found
+#define RX_D_EOL_MATCH 0x02 // There is a match if the text ends here
+#define RX_D_DEAD      0x04 // No match is possible from here
+
+// Round a size in the DFA arena up, to keep the states aligned
+#define RX_ALIGN(n) (int)(((size_t)(n) + sizeof (void *) - 1) \
+  & ~(sizeof (void *) - 1))
+
+typedef uint8_t RegexSet[32];
+
+typedef struct _RegexNode
+  {
+  uint8_t type;
+  uint8_t c;
+  int16_t set;
+  // For RN_CAT and RN_ALT the last child, and for RN_REPEAT the
+  //   item repeated. Children are chained through 'prev'.
+  int16_t last;
+  int16_t prev;
+  int16_t min;
+  int16_t max; // -1 for no limit
+  } RegexNode;
+
+typedef struct _RegexParser
+  {
+  const char *p;
+  int flags;
+  RegexNode *nodes;
+  int nnodes;
+  int max_nodes;
+  RegexSet *sets;
+  int nsets;
+  int max_sets;
+  int depth;
+  int error;
+  } RegexParser;
+
+typedef struct _RegexState
+  {
+  uint8_t op;
+  uint8_t c;
+  int16_t set;
+  int16_t out;
+  int16_t out1;
+  } RegexState;
+
+typedef struct _RegexDState
+  {
+  uint32_t hash;
+  int16_t chain; // Next state in the same hash bucket, or -1
+  uint8_t flags;
+  uint16_t n;
+  int16_t *next; // One per byte class; -1 if not yet known
+  uint16_t *list; // The NFA states, in order
+  } RegexDState;
+
+struct _Regex
+  {
+  RegexState *states;
+  int nstates;
+  int start;
+  RegexSet *sets;
+  int nsets;
+  uint8_t classes[256];
+  uint8_t class_rep[256];
+  int nclasses;
+
+  // A string that every match contains, for regex_literal()
+  char *literal;
+  int literal_len;
+
+  // Working space for closures, big enough for any of them
+  uint32_t *bits;
+  uint32_t *bits2;
+  uint16_t *stack;
+  uint16_t *scratch;
+
+  // The DFA cache
+  uint8_t *arena;
+  int arena_used;
+  RegexDState **dstates;
+  int ndstates;
+  int16_t buckets[REGEX_DFA_BUCKETS];
+  int dfa_start[2];
+  int flushes;
+
+  // Threads for the NFA simulation, each a state and a start position
+  uint16_t *tstates[2];
+  int32_t *tstarts[2];
+  uint32_t *marks;
+  uint32_t mark;
+  };
+
+/*==========================================================================
+regex_set_add
+*==========================================================================*/
+static inline void regex_set_add (uint8_t *set, int c)
+  {
+  set[c >> 3] |= (uint8_t)(1 << (c & 7));
+  }
+
+/*==========================================================================
+regex_set_has
+*==========================================================================*/
+static inline BOOL regex_set_has (const uint8_t *set, int c)
+  {
+  return (set[c >> 3] >> (c & 7)) & 1;
+  }
+
+/*==========================================================================
+regex_set_add_class
+Add the members of one of the \d, \w, \s classes, or their negations
+for upper-case letters. Returns FALSE if e is not one of them.
+*==========================================================================*/
+static BOOL regex_set_add_class (uint8_t *set, int e)
+  {
+  int (*fn)(int);
+  switch (tolower (e))
+    {
+    case 'd': fn = isdigit; break;
+    case 's': fn = isspace; break;
+    case 'w': fn = isalnum; break;
+    default: return FALSE;
+    }
+  BOOL negate = isupper (e) != 0;
+  for (int c = 0; c < 256; c++)
+    {
+    BOOL in = (c < 128 && fn (c)) || (tolower (e) == 'w' && c == '_');
+    if (in != negate) regex_set_add (set, c);
+    }
+  return TRUE;
+  }
+
+/*==========================================================================
+regex_set_add_posix
+Add the members of a class like [:alpha:]. p points after the "[:".
+Returns the length of the name and ":]", or 0 if the name is not
+one we know.
+*==========================================================================*/
+static int regex_set_add_posix (uint8_t *set, const char *p)
+  {
+  static const struct { const char *name; int (*fn)(int); } posix[] =
+    {
+    {"alpha", isalpha}, {"digit", isdigit}, {"alnum", isalnum},
+    {"space", isspace}, {"upper", isupper}, {"lower", islower},
+    {"punct", ispunct}, {"xdigit", isxdigit}, {"print", isprint},
+    {"cntrl", iscntrl}, {"graph", isgraph}, {"blank", isblank}
+    };
+  for (size_t i = 0; i < sizeof (posix) / sizeof (posix[0]); i++)
+    {
+    size_t l = strlen (posix[i].name);
+    if (strncmp (p, posix[i].name, l) == 0 && p[l] == ':' && p[l + 1] == ']')
+      {
+      for (int c = 0; c < 128; c++)
+        if (posix[i].fn (c)) regex_set_add (set, c);
+      return (int)l + 2;
+      }
+    }
+  return 0;
+  }
+
+/*==========================================================================
+regex_node
+Returns a new node, or -1 (with the parser's error set)
+*==========================================================================*/
+static int regex_node (RegexParser *P, uint8_t type)
+  {
+  if (P->nnodes == P->max_nodes)
+    {
+    P->error = REGEX_ERR_TOO_BIG;
+    return -1;
+    }
+  RegexNode *n = &P->nodes[P->nnodes];
+  memset (n, 0, sizeof (RegexNode));
+  n->type = type;
+  n->last = -1;
+  n->prev = -1;
+  return P->nnodes++;
+  }
+
+/*==========================================================================
+regex_add_child
+*==========================================================================*/
+static void regex_add_child (RegexParser *P, int parent, int child)
+  {
+  P->nodes[child].prev = P->nodes[parent].last;
+  P->nodes[parent].last = (int16_t)child;
+  }
+
+/*==========================================================================
+regex_set_node
+Make a node for a set, folding case if required. Sets that are the
+same are stored once.
+*==========================================================================*/
+static int regex_set_node (RegexParser *P, uint8_t *set)
+  {
+  if (P->flags & REGEX_ICASE)
+    {
+    for (int c = 'a'; c <= 'z'; c++)
+      {
+      int u = toupper (c);
+      if (regex_set_has (set, c) || regex_set_has (set, u))
+        {
+        regex_set_add (set, c);
+        regex_set_add (set, u);
+        }
+      }
+    }
+  int i;
+  for (i = 0; i < P->nsets; i++)
+    if (memcmp (P->sets[i], set, sizeof (RegexSet)) == 0) break;
+  if (i == P->nsets)
+    {
+    if (P->nsets == P->max_sets)
+      {
+      P->error = REGEX_ERR_TOO_BIG;
+      return -1;
+      }
+    memcpy (P->sets[P->nsets++], set, sizeof (RegexSet));
+    }
+  int n = regex_node (P, RN_SET);
+  if (n >= 0) P->nodes[n].set = (int16_t)i;
+  return n;
+  }
+
+/*==========================================================================
+regex_char_node
+*==========================================================================*/
+static int regex_char_node (RegexParser *P, int c)
+  {
+  if ((P->flags & REGEX_ICASE) && isalpha (c))
+    {
+    RegexSet set;
+    memset (set, 0, sizeof (set));
+    regex_set_add (set, c);
+    return regex_set_node (P, set);
+    }
+  int n = regex_node (P, RN_CHAR);
+  if (n >= 0) P->nodes[n].c = (uint8_t)c;
+  return n;
+  }
+
+/*==========================================================================
+regex_escape
+Returns the character for escapes like \t, or c itself
+*==========================================================================*/
+static int regex_escape (int c)
+  {
+  switch (c)
+    {
+    case 't': return '\t';
+    case 'n': return '\n';
+    case 'r': return '\r';
+    case 'f': return '\f';
+    case 'v': return '\v';
+    }
+  return c;
+  }
+
+/*==========================================================================
+regex_parse_class
+Parse a [...] class. P->p points after the '['.
+*==========================================================================*/
+static int regex_parse_class (RegexParser *P)
+  {
+  RegexSet set;
+  memset (set, 0, sizeof (set));
+  BOOL negate = FALSE;
+  if (*P->p == '^')
+    {
+    negate = TRUE;
+    P->p++;
+    }
+  BOOL first = TRUE;
+  while (*P->p && (*P->p != ']' || first))
+    {
+    first = FALSE;
+    int c = (unsigned char)*P->p++;
+    if (c == '[' && *P->p == ':')
+      {
+      int l = regex_set_add_posix (set, P->p + 1);
+      if (l)
+        {
+        P->p += l + 1;
+        continue;
+        }
+      }
+    if (c == '\\' && *P->p)
+      {
+      c = (unsigned char)*P->p++;
+      if (regex_set_add_class (set, c)) continue;
+      c = regex_escape (c);
+      }
+    int hi = c;
+    if (P->p[0] == '-' && P->p[1] && P->p[1] != ']')
+      {
+      hi = (unsigned char)P->p[1];
+      P->p += 2;
+      if (hi == '\\' && *P->p) hi = regex_escape ((unsigned char)*P->p++);
+      if (hi < c)
+        {
+        P->error = REGEX_ERR_SYNTAX;
+        return -1;
+        }
+      }
+    for (int i = c; i <= hi; i++)
+      regex_set_add (set, i);
+    }
+  if (*P->p != ']')
+    {
+    P->error = REGEX_ERR_SYNTAX;
+    return -1;
+    }
+  P->p++;
+
+  if (negate)
+    {
+    // Fold case before negating, so that [^a] excludes A as well
+    if (P->flags & REGEX_ICASE)
+      {
+      for (int c = 'a'; c <= 'z'; c++)
+        {
+        if (regex_set_has (set, c) || regex_set_has (set, toupper (c)))
+          {
+          regex_set_add (set, c);
+          regex_set_add (set, toupper (c));
+          }
+        }
+      }
+    for (int i = 0; i < 32; i++) set[i] = (uint8_t)~set[i];
+    }
+  return regex_set_node (P, set);
+  }
+
+static int regex_parse_alt (RegexParser *P);
+
+/*==========================================================================
+regex_parse_atom
+*==========================================================================*/
+static int regex_parse_atom (RegexParser *P)
+  {
+  int c = (unsigned char)*P->p++;
+  RegexSet set;
+  switch (c)
+    {
+    case '(':
+      {
+      if (++P->depth > REGEX_MAX_DEPTH)
+        {
+        P->error = REGEX_ERR_DEPTH;
+        return -1;
+        }
+      int n = regex_parse_alt (P);
+      if (n < 0) return -1;
+      if (*P->p != ')')
+        {
+        P->error = REGEX_ERR_SYNTAX;
+        return -1;
+        }
+      P->p++;
+      P->depth--;
+      return n;
+      }
+    case '[':
+      return regex_parse_class (P);
+    case '.':
+      memset (set, 0xFF, sizeof (set));
+      return regex_set_node (P, set);
+    case '^':
+      return regex_node (P, RN_BOL);
+    case '$':
+      return regex_node (P, RN_EOL);
+    case '\\':
+      c = (unsigned char)*P->p;
+      if (!c)
+        {
+        P->error = REGEX_ERR_SYNTAX;
+        return -1;
+        }
+      P->p++;
+      memset (set, 0, sizeof (set));
+      if (regex_set_add_class (set, c)) return regex_set_node (P, set);
+      return regex_char_node (P, regex_escape (c));
+    }
+  // Anything else, including a repetition with nothing to repeat, is
+  //   taken literally
+  return regex_char_node (P, c);
+  }
+
+/*==========================================================================
+regex_parse_bounds
+Parse {m}, {m,}, or {m,n}, with P->p pointing at the '{'. A missing m
+is 0, as in glibc. If what follows is not like that, the '{' is
+literal, and this returns FALSE without moving P->p.
+*==========================================================================*/
+static BOOL regex_parse_bounds (RegexParser *P, int *min, int *max)
+  {
+  const char *p = P->p + 1;
+  long m = 0;
+  if (isdigit ((unsigned char)*p))
+    m = strtol (p, (char **)&p, 10);
+  else if (*p != ',')
+    return FALSE;
+  long n = m;
+  if (*p == ',')
+    {
+    p++;
+    if (isdigit ((unsigned char)*p))
+      n = strtol (p, (char **)&p, 10);
+    else
+      n = -1;
+    }
+  if (*p != '}') return FALSE;
+  P->p = p + 1;
+  if (m > REGEX_MAX_REPEAT || n > REGEX_MAX_REPEAT || (n >= 0 && n < m))
+    P->error = REGEX_ERR_REPEAT;
+  *min = (int)m;
+  *max = (int)n;
+  return TRUE;
+  }
+
+/*==========================================================================
+regex_parse_repeat
+*==========================================================================*/
+static int regex_parse_repeat (RegexParser *P)
+  {
+  int n = regex_parse_atom (P);
+  while (n >= 0)
+    {
+    int min, max;
+    char c = *P->p;
+    if (c == '*') { min = 0; max = -1; }
+    else if (c == '+') { min = 1; max = -1; }
+    else if (c == '?') { min = 0; max = 1; }
+    else if (c == '{')
+      {
+      if (!regex_parse_bounds (P, &min, &max)) break;
+      if (P->error) return -1;
+      P->p--;
+      }
+    else
+      break;
+    P->p++;
+    int r = regex_node (P, RN_REPEAT);
+    if (r < 0) return -1;
+    P->nodes[r].last = (int16_t)n;
+    P->nodes[r].min = (int16_t)min;
+    P->nodes[r].max = (int16_t)max;
+    n = r;
+    }
+  return n;
+  }
+
+/*==========================================================================
+regex_parse_alt
+*==========================================================================*/
+static int regex_parse_alt (RegexParser *P)
+  {
+  int alt = regex_node (P, RN_ALT);
+  if (alt < 0) return -1;
+  int branches = 0;
+  for (;;)
+    {
+    int cat = regex_node (P, RN_CAT);
+    if (cat < 0) return -1;
+    while (*P->p && *P->p != '|' && *P->p != ')')
+      {
+      int n = regex_parse_repeat (P);
+      if (n < 0) return -1;
+      regex_add_child (P, cat, n);
+      }
+    regex_add_child (P, alt, cat);
+    branches++;
+    if (*P->p != '|') break;
+    P->p++;
+    }
+  if (branches == 1) return P->nodes[alt].last;
+  return alt;
+  }
+
+/*==========================================================================
+regex_emit
+Add an NFA state. Returns its index, or -1 if there are too many.
+*==========================================================================*/
+static int regex_emit (Regex *self, uint8_t op, int out, int out1)
+  {
+  if (self->nstates == REGEX_MAX_STATES) return -1;
+  RegexState *s = &self->states[self->nstates];
+  s->op = op;
+  s->c = 0;
+  s->set = 0;
+  s->out = (int16_t)out;
+  s->out1 = (int16_t)out1;
+  return self->nstates++;
+  }
+
+/*==========================================================================
+regex_gen
+Generate the NFA states for node n, which go on to state next when
+they have matched. Returns the first state, or -1 if there are too
+many states.
+*==========================================================================*/
+static int regex_gen (Regex *self, const RegexParser *P, int n, int next)
+  {
+  const RegexNode *node = &P->nodes[n];
+  int s;
+  switch (node->type)
+    {
+    case RN_CHAR:
+      s = regex_emit (self, RX_CHAR, next, -1);
+      if (s >= 0) self->states[s].c = node->c;
+      return s;
+    case RN_SET:
+      s = regex_emit (self, RX_SET, next, -1);
+      if (s >= 0) self->states[s].set = node->set;
+      return s;
+    case RN_BOL:
+      return regex_emit (self, RX_BOL, next, -1);
+    case RN_EOL:
+      return regex_emit (self, RX_EOL, next, -1);
+    case RN_CAT:
+      for (int c = node->last; c >= 0 && next >= 0; c = P->nodes[c].prev)
+        next = regex_gen (self, P, c, next);
+      return next;
+    case RN_ALT:
+      {
+      int acc = -1;
+      for (int c = node->last; c >= 0; c = P->nodes[c].prev)
+        {
+        s = regex_gen (self, P, c, next);
+        if (s < 0) return -1;
+        acc = acc < 0 ? s : regex_emit (self, RX_SPLIT, s, acc);
+        if (acc < 0) return -1;
+        }
+      return acc;
+      }
+    case RN_REPEAT:
+      {
+      int cont = next;
+      if (node->max < 0)
+        {
+        // A loop, with the mandatory copies in front of it
+        int loop = regex_emit (self, RX_SPLIT, -1, next);
+        if (loop < 0) return -1;
+        int body = regex_gen (self, P, node->last, loop);
+        if (body < 0) return -1;
+        self->states[loop].out = (int16_t)body;
+        cont = loop;
+        }
+      else
+        {
+        // Optional copies, each of which can go straight to next
+        for (int i = 0; i < node->max - node->min && cont >= 0; i++)
+          {
+          int body = regex_gen (self, P, node->last, cont);
+          if (body < 0) return -1;
+          cont = regex_emit (self, RX_SPLIT, body, next);
+          }
+        }
+      for (int i = 0; i < node->min && cont >= 0; i++)
+        cont = regex_gen (self, P, node->last, cont);
+      return cont;
+      }
+    }
+  return next; // RN_EMPTY
+  }
+
+/*==========================================================================
+regex_state_has
+Returns TRUE if consuming state s matches byte c
+*==========================================================================*/
+static inline BOOL regex_state_has (const Regex *self, const RegexState *s,
+          int c)
+  {
+  if (s->op == RX_CHAR) return s->c == c;
+  return regex_set_has (self->sets[s->set], c);
+  }
+
+/*==========================================================================
+regex_make_classes
+Divide the bytes into classes. Each consuming state splits every
+class into the bytes it matches and the bytes it doesn't.
+*==========================================================================*/
+static void regex_make_classes (Regex *self)
+  {
+  memset (self->classes, 0, sizeof (self->classes));
+  int n = 1;
+  for (int i = 0; i < self->nstates; i++)
+    {
+    const RegexState *s = &self->states[i];
+    if (s->op != RX_CHAR && s->op != RX_SET) continue;
+    int16_t map[256][2];
+    memset (map, 0xFF, sizeof (int16_t) * 2 * (size_t)n);
+    int m = 0;
+    for (int c = 0; c < 256; c++)
+      {
+      int16_t *slot = &map[self->classes[c]][regex_state_has (self, s, c)];
+      if (*slot < 0) *slot = (int16_t)m++;
+      self->classes[c] = (uint8_t)*slot;
+      }
+    n = m;
+    }
+  self->nclasses = n;
+  for (int c = 255; c >= 0; c--)
+    self->class_rep[self->classes[c]] = (uint8_t)c;
+  }
+
+/*==========================================================================
+regex_closure
+Add state s, and everything reachable from it without consuming a
+byte, to bits. Returns TRUE if the match state is reached.
+*==========================================================================*/
+static BOOL regex_closure (const Regex *self, uint32_t *bits, int s, int ctx)
+  {
+  BOOL match = FALSE;
+  int sp = 0;
+  self->stack[sp++] = (uint16_t)s;
+  while (sp > 0)
+    {
+    s = self->stack[--sp];
+    if (bits[s >> 5] & (1u << (s & 31))) continue;
+    bits[s >> 5] |= 1u << (s & 31);
+    const RegexState *st = &self->states[s];
+    switch (st->op)
+      {
+      case RX_SPLIT:
+        self->stack[sp++] = (uint16_t)st->out1;
+        self->stack[sp++] = (uint16_t)st->out;
+        break;
+      case RX_BOL:
+        if (ctx & RX_AT_BEGIN) self->stack[sp++] = (uint16_t)st->out;
+        break;
+      case RX_EOL:
+        if (ctx & RX_AT_END) self->stack[sp++] = (uint16_t)st->out;
+        break;
+      case RX_MATCH:
+        match = TRUE;
+        break;
+      }
+    }
+  return match;
+  }
+
+/*==========================================================================
+regex_dfa_flush
+Empty the DFA cache
+*==========================================================================*/
+static void regex_dfa_flush (Regex *self)
+  {
+  self->arena_used = 0;
+  self->ndstates = 0;
+  memset (self->buckets, 0xFF, sizeof (self->buckets));
+  self->dfa_start[0] = -1;
+  self->dfa_start[1] = -1;
+  self->flushes++;
+  }
+
+/*==========================================================================
+regex_dfa_state
+Find or make the DFA state for the NFA states in bits. 'ctx' is used
+to work out whether there would be a match if the text ended here.
+*==========================================================================*/
+static int regex_dfa_state (Regex *self, BOOL match, int ctx)
+  {
+  // The consuming states, and any $ that could not be followed yet,
+  //   are what the DFA state is made of
+  int n = 0;
+  int words = (self->nstates + 31) / 32;
+  for (int w = 0; w < words; w++)
+    {
+    uint32_t b = self->bits[w];
+    while (b)
+      {
+      int s = w * 32 + __builtin_ctz (b);
+      b &= b - 1;
+      uint8_t op = self->states[s].op;
+      if (op == RX_CHAR || op == RX_SET || op == RX_EOL)
+        self->scratch[n++] = (uint16_t)s;
+      }
+    }
+
+  uint8_t flags = 0;
+  if (match)
+    flags = RX_D_MATCH;
+  else if (n == 0)
+    flags = RX_D_DEAD;
+  else
+    {
+    memset (self->bits2, 0, sizeof (uint32_t) * (size_t)words);
+    for (int i = 0; i < n; i++)
+      {
+      const RegexState *st = &self->states[self->scratch[i]];
+      if (st->op == RX_EOL
+           && regex_closure (self, self->bits2, st->out, ctx | RX_AT_END))
+        {
+        flags = RX_D_EOL_MATCH;
+        break;
+        }
+      }
+    }
+
+  uint32_t h = 2166136261u ^ flags;
+  for (int i = 0; i < n; i++)
+    {
+    h ^= self->scratch[i];
+    h *= 16777619u;
+    }
+  int b = (int)(h & (REGEX_DFA_BUCKETS - 1));
+  for (int i = self->buckets[b]; i >= 0; i = self->dstates[i]->chain)
+    {
+    const RegexDState *d = self->dstates[i];
+    if (d->hash == h && d->flags == flags && d->n == n
+         && memcmp (d->list, self->scratch, sizeof (uint16_t) * (size_t)n) == 0)
+      return i;
+    }
+
+  int size = RX_ALIGN (sizeof (RegexDState))
+    + RX_ALIGN (self->nclasses * 2) + RX_ALIGN (n * 2);
+  if (self->ndstates == REGEX_DFA_MAX_STATES
+       || self->arena_used + size > REGEX_DFA_BUDGET)
+    {
+    regex_dfa_flush (self);
+    }
+  RegexDState *d = (RegexDState *)(self->arena + self->arena_used);
+  uint8_t *p = (uint8_t *)d + RX_ALIGN (sizeof (RegexDState));
+  d->next = (int16_t *)p;
+  d->list = (uint16_t *)(p + RX_ALIGN (self->nclasses * 2));
+  self->arena_used += size;
+  d->hash = h;
+  d->flags = flags;
+  d->n = (uint16_t)n;
+  memset (d->next, 0xFF, sizeof (int16_t) * (size_t)self->nclasses);
+  memcpy (d->list, self->scratch, sizeof (uint16_t) * (size_t)n);
+  d->chain = self->buckets[b];
+  self->buckets[b] = (int16_t)self->ndstates;
+  self->dstates[self->ndstates] = d;
+  return self->ndstates++;
+  }
+
+/*==========================================================================
+regex_dfa_start
+The DFA state at the start of the text, or somewhere after the start
+*==========================================================================*/
+static int regex_dfa_start (Regex *self, BOOL at_begin)
+  {
+  int *start = &self->dfa_start[at_begin ? 0 : 1];
+  if (*start >= 0) return *start;
+  int ctx = at_begin ? RX_AT_BEGIN : 0;
+  memset (self->bits, 0, sizeof (uint32_t) * (size_t)((self->nstates + 31) / 32));
+  BOOL match = regex_closure (self, self->bits, self->start, ctx);
+  int d = regex_dfa_state (self, match, ctx);
+  // Set after making the state, which might empty the cache
+  *start = d;
+  return d;
+  }
+
+/*==========================================================================
+regex_dfa_step
+Make the transition from DFA state d on byte class k. Because the
+search is not anchored, the start state is added to every new state.
+*==========================================================================*/
+static int regex_dfa_step (Regex *self, int d, int k)
+  {
+  const RegexDState *ds = self->dstates[d];
+  int c = self->class_rep[k];
+  memset (self->bits, 0, sizeof (uint32_t) * (size_t)((self->nstates + 31) / 32));
+  BOOL match = FALSE;
+  for (int i = 0; i < ds->n; i++)
+    {
+    const RegexState *st = &self->states[ds->list[i]];
+    if (st->op != RX_EOL && regex_state_has (self, st, c))
+      match |= regex_closure (self, self->bits, st->out, 0);
+    }
+  match |= regex_closure (self, self->bits, self->start, 0);
+
+  int flushes = self->flushes;
+  int nx = regex_dfa_state (self, match, 0);
+  if (self->flushes == flushes) self->dstates[d]->next[k] = (int16_t)nx;
+  return nx;
+  }
+
+/*==========================================================================
+regex_match
+*==========================================================================*/
+BOOL regex_match (Regex *self, const char *text, int len)
+  {
+  const uint8_t *t = (const uint8_t *)text;
+  int d = regex_dfa_start (self, TRUE);
+  for (int i = 0; ; i++)
+    {
+    const RegexDState *ds = self->dstates[d];
+    if (ds->flags & RX_D_MATCH) return TRUE;
+    if (ds->flags & RX_D_DEAD) return FALSE;
+    if (i == len) return (ds->flags & RX_D_EOL_MATCH) != 0;
+    int k = self->classes[t[i]];
+    int nx = ds->next[k];
+    if (nx < 0) nx = regex_dfa_step (self, d, k);
+    d = nx;
+    }
+  }
+
+/*==========================================================================
+regex_add_thread
+Add a thread at state s, and everything reachable from it without
+consuming a byte, to thread list l. Returns TRUE if it reaches the
+match state.
+*==========================================================================*/
+static BOOL regex_add_thread (Regex *self, int l, int *count, int s,
+          int32_t start, int ctx)
+  {
+  BOOL match = FALSE;
+  int sp = 0;
+  self->stack[sp++] = (uint16_t)s;
+  while (sp > 0)
+    {
+    s = self->stack[--sp];
+    if (self->marks[s] == self->mark) continue;
+    self->marks[s] = self->mark;
+    const RegexState *st = &self->states[s];
+    switch (st->op)
+      {
+      case RX_SPLIT:
+        self->stack[sp++] = (uint16_t)st->out1;
+        self->stack[sp++] = (uint16_t)st->out;
+        break;
+      case RX_BOL:
+        if (ctx & RX_AT_BEGIN) self->stack[sp++] = (uint16_t)st->out;
+        break;
+      case RX_EOL:
+        if (ctx & RX_AT_END) self->stack[sp++] = (uint16_t)st->out;
+        break;
+      case RX_MATCH:
+        match = TRUE;
+        break;
+      default:
+        self->tstates[l][*count] = (uint16_t)s;
+        self->tstarts[l][*count] = start;
+        (*count)++;
+      }
+    }
+  return match;
+  }
+
+/*==========================================================================
+regex_search
+Threads are kept in order of their start positions, so that when two
+reach the same state, the one that started first is kept. Once a
+match has been found, no new threads are started, and threads that
+started after it are dropped, but earlier ones carry on, in case they
+match later, and so do the ones that started with it, in case they
+make a longer match.
+*==========================================================================*/
+int regex_search (Regex *self, const char *text, int len, int *match_len)
+  {
+  *match_len = 0;
+  if (!regex_match (self, text, len)) return -1;
+
+  const uint8_t *t = (const uint8_t *)text;
+  int32_t best_start = -1, best_end = -1;
+  int cur = 0, ncur = 0;
+
+  self->mark++;
+  int ctx = RX_AT_BEGIN | (len == 0 ? RX_AT_END : 0);
+  if (regex_add_thread (self, cur, &ncur, self->start, 0, ctx))
+    best_start = best_end = 0;
+
+  for (int i = 0; i < len; i++)
+    {
+    if (ncur == 0 && best_start >= 0) break;
+    int nxt = 1 - cur, nnxt = 0;
+    ctx = (i + 1 == len) ? RX_AT_END : 0;
+    self->mark++;
+    for (int j = 0; j < ncur; j++)
+      {
+      int32_t start = self->tstarts[cur][j];
+      if (best_start >= 0 && start > best_start) continue;
+      const RegexState *st = &self->states[self->tstates[cur][j]];
+      if (!regex_state_has (self, st, t[i])) continue;
+      if (regex_add_thread (self, nxt, &nnxt, st->out, start, ctx))
+        {
+        if (best_start < 0 || start < best_start
+             || (start == best_start && i + 1 > best_end))
+          {
+          best_start = start;
+          best_end = i + 1;
+          }
+        }
+      }
+    if (best_start < 0
+         && regex_add_thread (self, nxt, &nnxt, self->start, i + 1, ctx))
+      {
+      best_start = best_end = i + 1;
+      }
+    cur = nxt;
+    ncur = nnxt;
+    }
+
+  if (best_start < 0) return -1;
+  *match_len = best_end - best_start;
+  return best_start;
+  }
+
+/*==========================================================================
+regex_node_char
+Returns the character that node n must match, or -1 if there isn't
+just one. With REGEX_ICASE, a letter's set counts as its lower case.
+*==========================================================================*/
+static int regex_node_char (const RegexParser *P, int n)
+  {
+  const RegexNode *node = &P->nodes[n];
+  if (node->type == RN_CHAR) return node->c;
+  if (node->type != RN_SET || !(P->flags & REGEX_ICASE)) return -1;
+  const uint8_t *set = P->sets[node->set];
+  int first = -1, count = 0;
+  for (int c = 0; c < 256 && count < 3; c++)
+    {
+    if (regex_set_has (set, c))
+      {
+      if (first < 0) first = c;
+      count++;
+      }
+    }
+  if (count == 2 && isupper (first) && regex_set_has (set, tolower (first)))
+    return tolower (first);
+  return -1;
+  }
+
+/*==========================================================================
+regex_find_literal
+Find the longest run of single characters at the top level of the
+pattern. Anything in a group might be skipped, or repeated, so it ends
+a run.
+*==========================================================================*/
+static void regex_find_literal (Regex *self, const RegexParser *P, int root)
+  {
+  // The characters of the top-level items, in order, or -1 for items
+  //   that are not single characters
+  int16_t *chars = malloc (sizeof (int16_t) * (size_t)P->nnodes);
+  if (!chars) return;
+  int n = 0;
+  if (P->nodes[root].type == RN_CAT)
+    {
+    for (int c = P->nodes[root].last; c >= 0; c = P->nodes[c].prev)
+      n++;
+    int i = n;
+    for (int c = P->nodes[root].last; c >= 0; c = P->nodes[c].prev)
+      chars[--i] = (int16_t)regex_node_char (P, c);
+    }
+  else
+    chars[n++] = (int16_t)regex_node_char (P, root);
+
+  int best = 0, best_start = 0, run = 0;
+  for (int i = 0; i < n; i++)
+    {
+    run = chars[i] >= 0 ? run + 1 : 0;
+    if (run > best)
+      {
+      best = run;
+      best_start = i - run + 1;
+      }
+    }
+  if (best > 0 && (self->literal = malloc ((size_t)best + 1)))
+    {
+    for (int i = 0; i < best; i++)
+      self->literal[i] = (char)chars[best_start + i];
+    self->literal[best] = 0;
+    self->literal_len = best;
+    }
+  free (chars);
+  }
+
+/*==========================================================================
+regex_literal
+*==========================================================================*/
+const char *regex_literal (const Regex *self, int *len)
+  {
+  *len = self->literal_len;
+  return self->literal;
+  }
+
+/*==========================================================================
+regex_compile
+*==========================================================================*/
+Regex *regex_compile (const char *pattern, int flags, int *error)
+  {
+  LOG_IN
+  int len = (int)strlen (pattern);
+  RegexParser P;
+  memset (&P, 0, sizeof (P));
+  P.p = pattern;
+  P.flags = flags;
+  P.max_nodes = 3 * len + 4;
+  P.nodes = malloc (sizeof (RegexNode) * (size_t)P.max_nodes);
+  P.max_sets = len + 1;
+  P.sets = malloc (sizeof (RegexSet) * (size_t)P.max_sets);
+  Regex *self = calloc (1, sizeof (Regex));
+  if (self) self->states = malloc (sizeof (RegexState) * REGEX_MAX_STATES);
+
+  int root = -1;
+  if (!P.nodes || !P.sets || !self || !self->states)
+    P.error = REGEX_ERR_NOMEM;
+  else
+    {
+    root = regex_parse_alt (&P);
+    if (!P.error && *P.p) P.error = REGEX_ERR_SYNTAX; // Stray ')'
+    }
+
+  if (!P.error)
+    {
+    int match = regex_emit (self, RX_MATCH, -1, -1);
+    self->start = regex_gen (self, &P, root, match);
+    if (self->start < 0) P.error = REGEX_ERR_TOO_BIG;
+    else regex_find_literal (self, &P, root);
+    }
+
+  if (!P.error)
+    {
+    int n = self->nstates;
+    self->states = realloc (self->states, sizeof (RegexState) * (size_t)n);
+    self->nsets = P.nsets;
+    self->sets = malloc (sizeof (RegexSet) * (size_t)(P.nsets + 1));
+    if (self->sets)
+      memcpy (self->sets, P.sets, sizeof (RegexSet) * (size_t)P.nsets);
+    regex_make_classes (self);
+
+    int words = (n + 31) / 32;
+    self->bits = malloc (sizeof (uint32_t) * (size_t)words);
+    self->bits2 = malloc (sizeof (uint32_t) * (size_t)words);
+    self->stack = malloc (sizeof (uint16_t) * (size_t)(2 * n + 2));
+    self->scratch = malloc (sizeof (uint16_t) * (size_t)n);
+    self->arena = malloc (REGEX_DFA_BUDGET);
+    self->dstates = malloc (sizeof (RegexDState *) * REGEX_DFA_MAX_STATES);
+    for (int i = 0; i < 2; i++)
+      {
+      self->tstates[i] = malloc (sizeof (uint16_t) * (size_t)n);
+      self->tstarts[i] = malloc (sizeof (int32_t) * (size_t)n);
+      }
+    self->marks = calloc ((size_t)n, sizeof (uint32_t));
+    if (!self->states || !self->sets || !self->bits || !self->bits2
+         || !self->stack || !self->scratch || !self->arena || !self->dstates
+         || !self->tstates[0] || !self->tstates[1] || !self->tstarts[0]
+         || !self->tstarts[1] || !self->marks)
+      P.error = REGEX_ERR_NOMEM;
+    else
+      regex_dfa_flush (self);
+    }
+
+  free (P.nodes);
+  free (P.sets);
+  if (P.error)
+    {
+    if (self) regex_destroy (self);
+    self = NULL;
+    }
+  if (error) *error = P.error;
+  LOG_OUT
+  return self;
+  }
+
+/*==========================================================================
+regex_destroy
+*==========================================================================*/
+void regex_destroy (Regex *self)
+  {
+  LOG_IN
+  free (self->states);
+  free (self->sets);
+  free (self->bits);
+  free (self->bits2);
+  free (self->stack);
+  free (self->scratch);
+  free (self->arena);
+  free (self->dstates);
+  for (int i = 0; i < 2; i++)
+    {
+    free (self->tstates[i]);
+    free (self->tstarts[i]);
+    }
+  free (self->marks);
+  free (self->literal);
+  free (self);
+  LOG_OUT
+  }
+
+/*==========================================================================
+regex_error_string
+*==========================================================================*/
+const char *regex_error_string (int error)
+  {
+  switch (error)
+    {
+    case 0: return "No error";
+    case REGEX_ERR_SYNTAX: return "Unbalanced ( or [";
+    case REGEX_ERR_REPEAT: return "Bad repetition count";
+    case REGEX_ERR_TOO_BIG: return "Expression too large";
+    case REGEX_ERR_NOMEM: return "Out of memory";
+    case REGEX_ERR_DEPTH: return "Parentheses nested too deeply";
+    }
+  return "Unknown error";
+  }
+
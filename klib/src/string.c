@@ -32,11 +32,21 @@
 #include "shell/shell_parser.h" 
 #include "../include/klib/defs.h"
 #include "../include/klib/list.h"
+#include "../include/klib/vector.h"
 #include "../include/klib/string.h"
+#include "../include/klib/fastmem.h"
+
+// Strings shorter than this (including the terminating zero) are stored
+//   in the String object itself, so creating and filling a short string
+//   needs only one allocation. Most shell tokens are this short.
+#define STRING_INLINE_SIZE 24 
 
 struct _String
   {
   char *str;
+  int32_t length;   // Bytes in str, not including the terminating zero
+  int32_t capacity; // Bytes allocated for str, including the zero
+  char inline_buff[STRING_INLINE_SIZE];
   }; 
 
 StringTokGlobber string_tok_globber = NULL;
@@ -47,7 +57,12 @@ string_create_empty
 *==========================================================================*/
 String *string_create_empty (void)
   {
-  return string_create ("");
+  String *self = malloc (sizeof (String));
+  self->str = self->inline_buff;
+  self->str[0] = 0;
+  self->length = 0;
+  self->capacity = STRING_INLINE_SIZE;
+  return self;
   }
 
 /*==========================================================================
@@ -55,8 +70,8 @@ string_create
 *==========================================================================*/
 String *string_create (const char *s)
   {
-  String *self = malloc (sizeof (String));
-  self->str = strdup (s);
+  String *self = string_create_empty ();
+  string_append_n (self, s, (int32_t)fastmem_strlen (s));
   return self;
   }
 
@@ -67,11 +82,33 @@ void string_destroy (String *self)
   {
   if (self)
     {
-    if (self->str) free (self->str);
+    if (self->str != self->inline_buff) free (self->str);
     free (self);
     }
   }
 
+/*==========================================================================
+string_reserve
+Make sure there is space for at least 'len' bytes, plus the terminating 
+zero, without further allocation. When the string has to grow, it grows
+to at least double its current capacity, so that a sequence of appends
+costs amortised constant time per byte.
+*==========================================================================*/
+void string_reserve (String *self, int32_t len)
+  {
+  if (len < self->capacity) return;
+  int32_t new_capacity = self->capacity * 2;
+  if (new_capacity < len + 1) new_capacity = len + 1;
+  if (self->str == self->inline_buff)
+    {
+    char *s = malloc ((size_t)new_capacity);
+    memcpy (s, self->str, (size_t)self->length + 1);
+    self->str = s;
+    }
+  else
+    self->str = realloc (self->str, (size_t)new_capacity);
+  self->capacity = new_capacity;
+  }
 
 /*==========================================================================
 string_cstr
@@ -88,27 +125,33 @@ string_cstr_safe
 const char *string_cstr_safe (const String *self)
   {
   if (self)
-    {
-    if (self->str) 
-      return self->str;
-    else
-      return "";
-    }
+    return self->str;
   else
     return "";
   }
 
 
+/*==========================================================================
+string_append_n
+Append exactly n bytes from s, which need not be zero-terminated.
+*==========================================================================*/
+void string_append_n (String *self, const char *s, int32_t n) 
+  {
+  if (!s || n <= 0) return;
+  string_reserve (self, self->length + n);
+  memcpy (self->str + self->length, s, (size_t)n);
+  self->length += n;
+  self->str[self->length] = 0;
+  }
+
+
 /*==========================================================================
 string_append
 *==========================================================================*/
 void string_append (String *self, const char *s) 
   {
   if (!s) return;
-  if (self->str == NULL) self->str = strdup ("");
-  int newlen = (int)strlen (self->str) + (int)strlen (s) + 2;
-  self->str = realloc (self->str, (size_t)newlen);
-  strcat (self->str, s);
+  string_append_n (self, s, (int32_t)fastmem_strlen (s));
   }
 
 
@@ -118,14 +161,7 @@ string_prepend
 void string_prepend (String *self, const char *s) 
   {
   if (!s) return;
-  if (self->str == NULL) self->str = strdup ("");
-  int newlen = (int)strlen (self->str) + (int)strlen (s) + 2;
-  char *temp = strdup (self->str); 
-  free (self->str);
-  self->str = malloc ((size_t)newlen);
-  strcpy (self->str, s);
-  strcat (self->str, temp);
-  free (temp);
+  string_insert (self, 0, s);
   }
 
 
@@ -134,13 +170,18 @@ string_append_printf
 *==========================================================================*/
 void string_append_printf (String *self, const char *fmt,...) 
   {
-  if (self->str == NULL) self->str = strdup ("");
   va_list ap;
   va_start (ap, fmt);
-  char *s;
-  vasprintf (&s, fmt, ap);
-  string_append (self, s);
-  free (s);
+  va_list ap2;
+  va_copy (ap2, ap);
+  int n = vsnprintf (NULL, 0, fmt, ap);
+  if (n > 0)
+    {
+    string_reserve (self, self->length + n);
+    vsnprintf (self->str + self->length, (size_t)n + 1, fmt, ap2);
+    self->length += n;
+    }
+  va_end (ap2);
   va_end (ap);
   }
 
@@ -151,8 +192,7 @@ string_length
 int32_t string_length (const String *self)
   {
   if (self == NULL) return 0;
-  if (self->str == NULL) return 0;
-  return (int32_t)strlen (self->str);
+  return self->length;
   }
 
 
@@ -161,8 +201,9 @@ string_clone
 *==========================================================================*/
 String *string_clone (const String *self)
   {
-  if (!self->str) return string_create_empty();
-  return string_create (string_cstr (self));
+  String *s = string_create_empty();
+  string_append_n (s, self->str, self->length);
+  return s;
   }
 
 
@@ -185,7 +226,7 @@ string_find_last
 int32_t string_find_last (const String *self, const char *search)
   {
   int lsearch = (int)strlen (search); 
-  int lself = (int)strlen (self->str);
+  int lself = self->length;
   if (lsearch > lself) return -1; // Can't find a long string in short one
   for (int i = lself - lsearch; i >= 0; i--)
     {
@@ -202,20 +243,17 @@ int32_t string_find_last (const String *self, const char *search)
 
 /*==========================================================================
 string_delete
+Delete len bytes starting at pos. If there are fewer than len bytes
+after pos, delete to the end of the string.
 *==========================================================================*/
 void string_delete (String *self, const int pos, const int32_t len)
   {
-  char *str = self->str;
-  if (pos + len > (int)strlen (str))
-    string_delete (self, pos, (int)strlen(str) - len);
-  else
-    {
-    char *buff = malloc (strlen (str) - (size_t)len + 2);
-    strncpy (buff, str, (size_t)pos); 
-    strcpy (buff + pos, str + pos + len);
-    free (self->str);
-    self->str = buff;
-    }
+  if (pos < 0 || pos >= self->length || len <= 0) return;
+  int32_t n = len;
+  if (pos + n > self->length) n = self->length - pos;
+  memmove (self->str + pos, self->str + pos + n, 
+    (size_t)(self->length - pos - n) + 1);
+  self->length -= n;
   }
 
 
@@ -225,14 +263,13 @@ string_insert
 void string_insert (String *self, const int pos, 
     const char *replace)
   {
-  char *buff = malloc (strlen (self->str) + strlen (replace) + 2);
-  char *str = self->str;
-  strncpy (buff, str, (size_t)pos);
-  buff[pos] = 0;
-  strcat (buff, replace);
-  strcat (buff, str + pos); 
-  free (self->str);
-  self->str = buff;
+  int32_t n = (int32_t)strlen (replace);
+  if (n == 0 || pos < 0 || pos > self->length) return;
+  string_reserve (self, self->length + n);
+  memmove (self->str + pos + n, self->str + pos, 
+    (size_t)(self->length - pos) + 1);
+  memcpy (self->str + pos, replace, (size_t)n);
+  self->length += n;
   }
 
 /*==========================================================================
@@ -309,10 +346,10 @@ String *string_encode_url (const char *str)
 *==========================================================================*/
 void string_append_byte (String *self, const BYTE byte)
   {
-  char buff[2];
-  buff[0] = (char)byte;
-  buff[1] = 0;
-  string_append (self, buff);
+  if (self->length + 1 >= self->capacity)
+    string_reserve (self, self->length + 1);
+  self->str[self->length++] = (char)byte;
+  self->str[self->length] = 0;
   }
 
 
@@ -352,24 +389,11 @@ void string_append_c (String *self, const uint32_t ch)
 void string_trim_left (String *self)
   {
   const char *s = self->str;
-  int l = (int)strlen (s);
-  int i = 0;
+  int l = self->length;
   int pos = 0;
-  BOOL stop = FALSE;
-  while (i < l && !stop)
-    {
-    char c = s[i];
-    if (c == ' ' || c == '\n' || c == '\t')
-      {
-      pos++;
-      }
-    else
-      stop = TRUE;
-    i++;
-    }
-  char *s_new = strdup (s + pos);
-  free (self->str);
-  self->str = s_new;
+  while (pos < l && (s[pos] == ' ' || s[pos] == '\n' || s[pos] == '\t'))
+    pos++;
+  string_delete (self, 0, pos);
   }
 
 
@@ -379,20 +403,13 @@ void string_trim_left (String *self)
 void string_trim_right (String *self)
   {
   char *s = self->str;
-  int l = (int)strlen (s);
-  int i = l - 1;
-  BOOL stop = FALSE;
-  while (i >= 0 && !stop)
+  int i = self->length - 1;
+  while (i >= 0 && (s[i] == ' ' || s[i] == '\n' || s[i] == '\t'))
     {
-    char c = s[i];
-    if (c == ' ' || c == '\n' || c == '\t')
-      {
-      s[i] = 0;
-      }
-    else
-      stop = TRUE;
+    s[i] = 0;
     i--;
     }
+  self->length = i + 1;
   }
 
 /*==========================================================================
@@ -522,14 +539,14 @@ static void string_append_var (String *self, const char *var, void *context)
     }
   }
 
-void string_tok_append2 (List *args, String *tok_string, BOOL quoted, 
+void string_tok_append2 (Vector *args, String *tok_string, BOOL quoted, 
         int line, int col)
   {
   if (quoted)
     {
     // If it's quoted, it's a TOK_ARG, whatever the content
     Token *t = token_create (TOK_ARG, string_cstr (tok_string), line, col);
-    list_append (args, t);
+    vector_append (args, t);
     }
   else
     {
@@ -538,17 +555,17 @@ void string_tok_append2 (List *args, String *tok_string, BOOL quoted,
           || strcmp (_tok, "<") == 0)
       {
       Token *t = token_create (TOK_REDIR, string_cstr (tok_string), line, col); 
-      list_append (args, t);
+      vector_append (args, t);
       }
     else if (strcmp (_tok, ";") == 0)
       {
       Token *t = token_create (TOK_SEMI, string_cstr (tok_string), line, col); 
-      list_append (args, t);
+      vector_append (args, t);
       }
     else if (strcmp (_tok, "|") == 0)
       {
       Token *t = token_create (TOK_PIPE, string_cstr (tok_string), line, col); 
-      list_append (args, t);
+      vector_append (args, t);
       }
     else
       {
@@ -557,18 +574,18 @@ void string_tok_append2 (List *args, String *tok_string, BOOL quoted,
       else
 	{
 	Token *t = token_create (TOK_ARG, string_cstr (tok_string), line, col);
-	list_append (args, t);
+	vector_append (args, t);
 	}
       }
     }
   string_destroy (tok_string);
   }
 
-List *string_tokenize2 (const String *s, void *context)
+Vector *string_tokenize2 (const String *s, void *context)
   {
-  List *argv = list_create ((ListItemFreeFn)token_destroy);
+  Vector *argv = vector_create ((VectorItemFreeFn)token_destroy);
 
-  int i, l = (int)strlen (string_cstr(s));
+  int i, l = string_length (s);
 
   String *buff = string_create_empty();
   String *var = string_create_empty();
@@ -699,8 +716,8 @@ List *string_tokenize2 (const String *s, void *context)
 
       case 1000 * STATE_GENERAL + CHAR_WHITE:
         //Hit ws while eating characters -- this is a token
-        if (strlen (buff->str))
-          //list_append (argv, buff);
+        if (buff->length)
+          //vector_append (argv, buff);
           string_tok_append2 (argv, buff, FALSE, line, col);
         buff = string_create_empty();
         state = STATE_WHITE;
@@ -718,8 +735,8 @@ List *string_tokenize2 (const String *s, void *context)
 
       case 1000 * STATE_GENERAL + CHAR_HASH:
         //Hit hash while eating characters -- this is a token
-        if (strlen (buff->str))
-          //list_append (argv, buff);
+        if (buff->length)
+          //vector_append (argv, buff);
           string_tok_append2 (argv, buff, FALSE, line, col);
         buff = string_create_empty();
         state = STATE_COMMENT;
@@ -751,7 +768,7 @@ List *string_tokenize2 (const String *s, void *context)
       case 1000 * STATE_DQUOTE + CHAR_DQUOTE:
         // Leave duote mode and store token (which might be empty) 
         string_tok_append2 (argv, buff, TRUE, line, col); 
-        //list_append (argv, buff);
+        //vector_append (argv, buff);
         buff = string_create_empty();
         state = STATE_DUNNO;
         break;
@@ -860,7 +877,7 @@ List *string_tokenize2 (const String *s, void *context)
 
       case 1000 * STATE_VAR + CHAR_WHITE:
         // Hit ws while eating characters -- this is a var name 
-        if (strlen (var->str))
+        if (var->length)
           {
           string_append_var (buff, var->str, context);
           string_tok_append2 (argv, buff, FALSE, line, col);
@@ -888,7 +905,7 @@ List *string_tokenize2 (const String *s, void *context)
         break;
 
       case 1000 * STATE_VAR + CHAR_HASH:
-        if (strlen (var->str))
+        if (var->length)
           {
           string_append_var (buff, var->str, context);
           string_tok_append2 (argv, buff, FALSE, line, col);
@@ -905,7 +922,7 @@ List *string_tokenize2 (const String *s, void *context)
         break;
 
       case 1000 * STATE_VAR + CHAR_VAR:
-        if (strlen (var->str))
+        if (var->length)
           {
           string_append_var (buff, var->str, context);
           string_destroy (var);
@@ -1027,7 +1044,7 @@ List *string_tokenize2 (const String *s, void *context)
 */
 
   Token *t = token_create (TOK_EOI, NULL, line, col); 
-  list_append (argv, t);
+  vector_append (argv, t);
 
   string_destroy (var);
 
@@ -1040,9 +1057,11 @@ List *string_tokenize2 (const String *s, void *context)
 *==========================================================================*/
 void string_delete_last (String *self)
   {
-  int l = (int)strlen (self->str);
-  if (l > 0)
-    self->str[l - 1] = 0;  
+  if (self->length > 0)
+    {
+    self->length--;
+    self->str[self->length] = 0;  
+    }
   }
 
 /*==========================================================================
@@ -1050,8 +1069,9 @@ void string_delete_last (String *self)
 *==========================================================================*/
 void string_insert_c_at (String *self, int pos, char c)
   {
-  static char s[2] = " ";
+  char s[2];
   s[0] = c;
+  s[1] = 0;
   string_insert (self, pos, s);
   }
 
@@ -0,0 +1,183 @@
+/*============================================================================
+
+  klib
+  vector.c
+  Copyright (c)2023 Kevin Boone, GPL v3.0
+
+  Methods for maintaining a growable array of pointers. The storage
+  doubles in size when it fills, so a sequence of appends costs
+  amortised constant time per item.
+
+============================================================================*/
+
+#define _GNU_SOURCE
+#include <stdio.h>
+#include <stdlib.h>
+#include <memory.h>
+#include "../include/klib/vector.h"
+
+#define LOG_IN
+#define LOG_OUT
+
+// Initial capacity of a vector, when the first item is added. Most of
+//   the vectors the shell creates -- tokens on a command line, arguments
+//   in a node -- are small.
+#define VECTOR_INITIAL_CAPACITY 8
+
+struct _Vector
+  {
+  VectorItemFreeFn free_fn;
+  void **items;
+  int length;
+  int capacity;
+  };
+
+/*==========================================================================
+  vector_create
+*==========================================================================*/
+Vector *vector_create (VectorItemFreeFn free_fn)
+  {
+  LOG_IN
+  Vector *self = malloc (sizeof (Vector));
+  memset (self, 0, sizeof (Vector));
+  self->free_fn = free_fn;
+  LOG_OUT
+  return self;
+  }
+
+/*==========================================================================
+  vector_create_strings
+
+  This is a helper function for creating a vector of C strings -- not
+  string objects
+*==========================================================================*/
+Vector *vector_create_strings (void)
+  {
+  return vector_create (free);
+  }
+
+/*==========================================================================
+  vector_destroy
+*==========================================================================*/
+void vector_destroy (Vector *self)
+  {
+  LOG_IN
+  if (self)
+    {
+    if (self->free_fn)
+      {
+      for (int i = 0; i < self->length; i++)
+        self->free_fn (self->items[i]);
+      }
+    free (self->items);
+    free (self);
+    }
+  LOG_OUT
+  }
+
+/*==========================================================================
+  vector_reserve
+
+  Ensure that the vector can hold at least 'capacity' items without
+  further reallocation. This is never necessary, but it saves a few
+  reallocations when the caller knows how many items are coming.
+*==========================================================================*/
+void vector_reserve (Vector *self, int capacity)
+  {
+  LOG_IN
+  if (capacity > self->capacity)
+    {
+    self->items = realloc (self->items, (size_t)capacity * sizeof (void *));
+    self->capacity = capacity;
+    }
+  LOG_OUT
+  }
+
+/*==========================================================================
+  vector_append
+  As with list_append, the caller must not free the item after adding it.
+  It will be freed by the vector, using the supplied free function.
+*==========================================================================*/
+void vector_append (Vector *self, void *item)
+  {
+  LOG_IN
+  if (self->length == self->capacity)
+    {
+    int new_capacity = self->capacity ? self->capacity * 2
+      : VECTOR_INITIAL_CAPACITY;
+    vector_reserve (self, new_capacity);
+    }
+  self->items[self->length] = item;
+  self->length++;
+  LOG_OUT
+  }
+
+/*==========================================================================
+  vector_get
+*==========================================================================*/
+void *vector_get (const Vector *self, int index)
+  {
+  if (index < 0 || index >= self->length) return NULL;
+  return self->items[index];
+  }
+
+/*==========================================================================
+  vector_length
+*==========================================================================*/
+int vector_length (const Vector *self)
+  {
+  return self->length;
+  }
+
+/*==========================================================================
+  vector_remove_at
+  Remove the item at the specified position, calling the free function
+  on it. Later items move down to fill the gap.
+*==========================================================================*/
+void vector_remove_at (Vector *self, int index)
+  {
+  LOG_IN
+  if (index >= 0 && index < self->length)
+    {
+    if (self->free_fn) self->free_fn (self->items[index]);
+    memmove (self->items + index, self->items + index + 1,
+      (size_t)(self->length - index - 1) * sizeof (void *));
+    self->length--;
+    }
+  LOG_OUT
+  }
+
+/*==========================================================================
+  vector_remove_object
+  Remove the specific item from the vector, if it is present. As with
+  list_remove_object, this compares pointers, not values.
+*==========================================================================*/
+void vector_remove_object (Vector *self, const void *item)
+  {
+  LOG_IN
+  for (int i = 0; i < self->length; i++)
+    {
+    if (self->items[i] == item)
+      {
+      vector_remove_at (self, i);
+      break;
+      }
+    }
+  LOG_OUT
+  }
+
+/*==========================================================================
+  vector_sort
+
+  Sort the vector in place, using the supplied sort function. As with
+  list_sort, the function receives pointers to the stored pointers.
+*==========================================================================*/
+void vector_sort (Vector *self, VectorSortFn fn, void *user_data)
+  {
+  LOG_IN
+  if (self->length > 1)
+    qsort_r (self->items, (size_t)self->length, sizeof (void *),
+      fn, user_data);
+  LOG_OUT
+  }
+
@@ -20,6 +20,7 @@ Copyright (c)2022 Kevin Boone, GPL3
 #if PICO_ON_DEVICE
 #include <hardware/rtc.h>
 #include <fatfs_sdcard/fatsd.h>
+#include <sdcard/sdcard.h>
 #else
 #include <fatfs_loopback/fatloopback.h>
 #endif
@@ -36,6 +37,7 @@ Copyright (c)2022 Kevin Boone, GPL3
 #include <chardev/gpiodev.h>
 #include <chardev/gfxcondev.h>
 #include <chardev/wslcddev.h>
+#include <chardev/fbgfxdev.h>
 #include <sys/error.h>
 #include <errno.h>
 #include <term/term.h>
@@ -75,9 +77,15 @@ int main()
 #ifdef I2C_LCD_CONNECTED
   I2CLCDDev *lcd = i2clcddev_new ("lcd");
 #endif
+#if PICO_ON_DEVICE
   WSLCDDev *wslcddev = wslcddev_new ("gfx");
-  GfxConDev *gfxcondev = gfxcondev_new ("gfxcon", 
-    wslcddev_get_desc (wslcddev)); 
+  DevDescriptor *gfxdesc = wslcddev_get_desc (wslcddev);
+#else
+  // The host build draws into a framebuffer the same size as the panel
+  FbGfxDev *fbgfxdev = fbgfxdev_new ("gfx", 320, 480);
+  DevDescriptor *gfxdesc = fbgfxdev_get_desc (fbgfxdev);
+#endif
+  GfxConDev *gfxcondev = gfxcondev_new ("gfxcon", gfxdesc); 
 
 #ifdef I2C_LCD_CONNECTED
 #if PICO_ON_DEVICE
@@ -110,7 +118,7 @@ int main()
   devmgr_register (i2clcddev_get_desc (lcd));
 #endif
   devmgr_register (gpiodev_get_desc (gpio));
-  devmgr_register (wslcddev_get_desc (wslcddev));
+  devmgr_register (gfxdesc);
   devmgr_register (gfxcondev_get_desc (gfxcondev)); // XXX
 
 #if PICO_ON_DEVICE
@@ -138,8 +146,10 @@ int main()
   wslcddev_init (wslcddev, WSLCD_SPI, WSLCD_CS, WSLCD_MISO, 
     WSLCD_MOSI, WSLCD_SCK, WSLCD_RST, WSLCD_DC, 
     WSLCD_BL, WSLCD_BAUD, WSLCD_SCAN_DIR);
-#else
-  wslcddev_init (wslcddev);
+  // The panel and the SD card share an SPI bus, and the panel driver
+  //   can leave a fill running when it returns
+  sdcard_set_bus_fence (sdcard_get_instance (0), wslcddev_bus_fence, 
+    wslcddev);
 #endif
 
   gfxcondev_adjust_to_hardware (gfxcondev);
@@ -172,7 +182,26 @@ int main()
   i2clcddev_destroy (lcd);
 #endif
   gpiodev_destroy (gpio);
+#if PICO_ON_DEVICE
   wslcddev_destroy (wslcddev);
+#else
+  // Set BEAROS_FBDUMP to keep the final screen, for checking the console
+  //   renderer against a known-good image
+  const char *fbdump = getenv ("BEAROS_FBDUMP");
+  if (fbdump)
+    {
+    DevCtlGfxStats stats;
+    fbgfxdev_get_stats (fbgfxdev, &stats);
+    fprintf (stderr, "gfx: %u regions, %u fills (%llu pixels), "
+      "%u writes (%llu pixels), %u scrolls, %u clears\n", 
+      stats.regions, stats.fills, (unsigned long long)stats.fill_pixels, 
+      stats.writes, (unsigned long long)stats.write_pixels, 
+      stats.scrolls, stats.clears);
+    if (fbgfxdev_dump_ppm (fbgfxdev, fbdump) != 0)
+      fprintf (stderr, "gfx: can't write %s\n", fbdump);
+    }
+  fbgfxdev_destroy (fbgfxdev);
+#endif
   gfxcondev_destroy (gfxcondev);
   ds3231_destroy (ds3231);
 
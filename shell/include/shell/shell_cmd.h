@@ -25,10 +25,13 @@ extern Error shell_cmd_ls (int argc, char **argv);
 extern Error shell_cmd_cd (int argc, char **argv);
 extern Error shell_cmd_cat (int argc, char **argv);
 extern Error shell_cmd_date (int argc, char **argv);
+extern Error shell_cmd_du (int argc, char **argv);
 extern Error shell_cmd_echo (int argc, char **argv);
 extern Error shell_cmd_env (int argc, char **argv);
 extern Error shell_cmd_gpio (int argc, char **argv);
 extern Error shell_cmd_grep (int argc, char **argv);
+extern Error shell_cmd_hash (int argc, char **argv);
+extern Error shell_cmd_head (int argc, char **argv);
 extern Error shell_cmd_mkdir (int argc, char **argv);
 extern Error shell_cmd_cp (int argc, char **argv);
 extern Error shell_cmd_clear (int argc, char **argv);
@@ -36,13 +39,19 @@ extern Error shell_cmd_mv (int argc, char **argv);
 extern Error shell_cmd_rm (int argc, char **argv);
 extern Error shell_cmd_rmdir (int argc, char **argv);
 extern Error shell_cmd_run_file (const char *path, int argc, char **argv);
+extern Error shell_cmd_sort (int argc, char **argv);
 extern Error shell_cmd_source (int argc, char **argv);
+extern Error shell_cmd_tail (int argc, char **argv);
 extern Error shell_cmd_uname (int argc, char **argv);
+extern Error shell_cmd_wc (int argc, char **argv);
 
 extern Error shell_cmd_cp_mv (int argc, char **argv, bool move);
 
 Error shell_cmd (int argc, char **argv);
 
+/** Returns the function that implements a built-in command, or NULL. */
+extern ShellCmdFn shell_cmd_find_builtin (const char *name);
+
 #ifdef __cplusplus
 }
 #endif
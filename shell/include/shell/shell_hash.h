@@ -0,0 +1,57 @@
+/*============================================================================
+ *  shell/shell_hash.h
+ *
+ * Copyright (c)2023 Kevin Boone, GPL v3.0
+ * ==========================================================================*/
+
+#pragma once
+
+/*============================================================================
+ * ==========================================================================*/
+
+#include <stdint.h>
+#include <sys/error.h>
+#include <shell/shell_cmd.h>
+
+typedef enum _ShellHashType
+  {
+  SHELL_HASH_MISSING = 0,
+  SHELL_HASH_BUILTIN,
+  SHELL_HASH_EXTERNAL
+  } ShellHashType;
+
+/** The result of resolving a command name. For SHELL_HASH_BUILTIN, fn
+    is set; for SHELL_HASH_EXTERNAL, path is the absolute path of the
+    executable. SHELL_HASH_MISSING entries are kept as well, so that
+    a mistyped command does not search PATH every time. */
+typedef struct _ShellHashEntry
+  {
+  char *name;
+  ShellHashType type;
+  ShellCmdFn fn;
+  char *path;
+  int hits;
+  } ShellHashEntry;
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/** Start watching the filesystem for changes in PATH directories. */
+extern void shell_hash_init (void);
+
+/** Resolve a command name that has no directory part, using the
+    cache if possible. The entry returned remains owned by the cache, and
+    is valid until the next call to any shell_hash_ function. */
+extern const ShellHashEntry *shell_hash_lookup (const char *name);
+
+/** Forget all resolved commands. */
+extern void shell_hash_clear (void);
+
+/** Print the cached commands, in the order they were first used. */
+extern void shell_hash_dump (void);
+
+#ifdef __cplusplus
+}
+#endif
+
@@ -11,7 +11,7 @@
 
 #include <stdint.h>
 #include <sys/error.h>
-#include <klib/list.h>
+#include <klib/vector.h>
 #include <sys/process.h>
 
 /*========================================================================
@@ -86,7 +86,7 @@ typedef struct _Node
   int type;
   char *val1;
   char *val2;
-  List *nodes;
+  Vector *nodes;
   } Node;
 
 struct ShellParser;
@@ -102,7 +102,7 @@ extern Token *token_create (TokenType type, const char *val,
           int line, int col);
 extern void token_destroy (Token *self);
 
-extern ShellParser *shellparser_new (const List *tokens);
+extern ShellParser *shellparser_new (const Vector *tokens);
 extern void shellparser_destroy (ShellParser *self);
 extern Node *shellparser_parse_and_report (ShellParser *self);
 
@@ -0,0 +1,72 @@
+/*============================================================================
+ *  shell/shell_reader.h
+ *
+ * Copyright (c)2023 Kevin Boone, GPL v3.0
+ * ==========================================================================*/
+
+#pragma once
+
+/*============================================================================
+ * ==========================================================================*/
+
+#include <stdint.h>
+#include <sys/error.h>
+
+// Size of a read. Reads of whole sectors go straight from the card to
+//   the buffer.
+#define SHELL_READER_BLOCK 512
+
+// Default size of the buffer
+#define SHELL_READER_SIZE (8 * SHELL_READER_BLOCK)
+
+// Number of lines head and tail show, without -n
+#define SHELL_READER_LINES 10
+
+/** A buffer for reading a file in large blocks, for the text commands.
+    The bytes from start to end have been read, but not yet used. The
+    caller uses them by moving start along. */
+typedef struct _ShellReader
+  {
+  int fd;
+  char *buff;
+  int size;
+  int start;
+  int end;
+  } ShellReader;
+
+/** Write the first or last 'lines' lines read from fd to stdout, for
+    shell_reader_lines_cmd(). Returns 0 or an error number. */
+typedef Error (*ShellReaderLinesFn) (int fd, long lines);
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/** Allocate a buffer of size bytes, which should be a multiple of
+    SHELL_READER_BLOCK, for reading fd. Returns ENOMEM on failure. */
+extern Error shell_reader_init (ShellReader *self, int fd, int size);
+
+/** Free the buffer. The file is not closed. */
+extern void shell_reader_free (ShellReader *self);
+
+/** Move the unused bytes to the front of the buffer, and read as many
+    whole blocks after them as will fit. If less than a block will fit,
+    the buffer is made bigger. Returns the number of bytes read, 0 at
+    the end of the file, or a negative error number. */
+extern int shell_reader_fill (ShellReader *self);
+
+/** Write the len bytes at s to stdout, all of them, unless there is an
+    error. Returns 0 or an error number. */
+extern Error shell_reader_write (const char *s, int len);
+
+/** The whole of a command like head or tail, apart from fn, which does
+    the work. Handles -n, and calls fn for stdin if no files are named,
+    or for each file in turn, with a header before each if there is more
+    than one. description is the second line of the usage message. */
+extern Error shell_reader_lines_cmd (int argc, char **argv,
+      const char *description, ShellReaderLinesFn fn);
+
+#ifdef __cplusplus
+}
+#endif
+
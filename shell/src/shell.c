@@ -21,14 +21,16 @@
 #include <term/term.h>
 #include <shell/shell.h>
 #include <shell/shell_cmd.h>
+#include <shell/shell_hash.h>
 #include <shell/shell_parser.h>
 #include <klib/string.h>
-#include <klib/list.h>
+#include <klib/vector.h>
 #include <sys/fsutil.h>
 #include <sys/direntry.h>
 #include <sys/syscalls.h>
 #include <compat/compat.h>
 #include <devmgr/devmgr.h>
+#include <chardev/picoconsoledev.h>
 #include <bearos/terminal.h>
 #include <bearos/intr.h>
 
@@ -74,10 +76,24 @@ BOOL shell_glob_match (const char *filename, const char *match)
   return !compat_fnmatch (match, filename, 0);
   }
 
+/*=========================================================================
+  shell_glob_sort_fn
+  Sort glob matches into alphabetical order, as a Linux shell would. The
+  arguments are pointers to Token pointers.
+=========================================================================*/
+static int shell_glob_sort_fn (const void *p1, const void *p2, 
+        void *user_data)
+  {
+  (void)user_data;
+  const Token *t1 = *(const Token **)p1;
+  const Token *t2 = *(const Token **)p2;
+  return strcmp (t1->val, t2->val);
+  }
+
 /*=========================================================================
   shell_globber2
 =========================================================================*/
-static void shell_globber2 (String *token, List *list)
+static void shell_globber2 (String *token, Vector *list)
   {
   bool match = false;
 
@@ -95,6 +111,9 @@ static void shell_globber2 (String *token, List *list)
       fd = sys_open (".", O_RDONLY);
     if (fd >= 0)
       {
+      // Collect the matches separately, so they can be sorted before
+      //   they are added to the token list.
+      Vector *matches = vector_create (NULL);
       DirEntry de;
       while (sys_getdent (fd, &de) == 1)
          {
@@ -104,11 +123,19 @@ static void shell_globber2 (String *token, List *list)
            char newpath[PATH_MAX];
            fsutil_join_path (dir, de.name, newpath, PATH_MAX);
            Token *t = token_create (TOK_ARG, newpath, 0, 0); // TODO
-           list_append (list, t);
+           vector_append (matches, t);
            match = true;
            }
          } 
       sys_close (fd);
+
+      vector_sort (matches, shell_glob_sort_fn, NULL);
+      int n = vector_length (matches);
+      vector_reserve (list, vector_length (list) + n);
+      for (int i = 0; i < n; i++)
+        vector_append (list, vector_get (matches, i));
+      // The tokens now belong to 'list', and matches has no free function
+      vector_destroy (matches);
       }
     }
 
@@ -118,7 +145,7 @@ static void shell_globber2 (String *token, List *list)
   else
     {
     Token *t = token_create (TOK_ARG, string_cstr (token), 0, 0); // TODO
-    list_append (list, t);
+    vector_append (list, t);
     }
   }
 
@@ -194,9 +221,9 @@ static Error shell_exec_exec  (const Node *exec, int _argc, char **_argv,
   Error ret = 0;
 
   const Node *redirs = NULL;
-  const Node *arglist = list_get (exec->nodes, 0);
-  if (list_length (exec->nodes) >= 2)
-    redirs = list_get (exec->nodes, 1);
+  const Node *arglist = vector_get (exec->nodes, 0);
+  if (vector_length (exec->nodes) >= 2)
+    redirs = vector_get (exec->nodes, 1);
   
   //printf ("ARGLIST\n");
   //node_dump (arglist, 0);
@@ -235,10 +262,10 @@ static Error shell_exec_exec  (const Node *exec, int _argc, char **_argv,
 
   if (redirs)
     {
-    int n_redirs = list_length (redirs->nodes);
+    int n_redirs = vector_length (redirs->nodes);
     for (int i = 0; i < n_redirs; i++)
       {
-      const Node *n = list_get (redirs->nodes, i);
+      const Node *n = vector_get (redirs->nodes, i);
       const char *redir = n->val1;
       const char *filename = n->val2;
       if (strcmp (redir, ">") == 0)
@@ -309,12 +336,12 @@ static Error shell_exec_exec  (const Node *exec, int _argc, char **_argv,
 
   if (redirs_ok)
     {
-    int argc = list_length (arglist->nodes);
+    int argc = vector_length (arglist->nodes);
     char **argv = malloc ((size_t)(argc + 1) * sizeof (char *));
 
     for (int i = 0; i < argc; i++)
       {
-      Node *n = list_get (arglist->nodes, i);
+      Node *n = vector_get (arglist->nodes, i);
       argv[i] = strdup (n->val1);
       }
     argv[argc] = NULL;
@@ -352,10 +379,10 @@ static Error shell_exec_exec  (const Node *exec, int _argc, char **_argv,
 =========================================================================*/
 static void shell_assignlist_to_env (const Node *assignlist, Environment *env)
   {
-  int n_assigns = list_length (assignlist->nodes);
+  int n_assigns = vector_length (assignlist->nodes);
   for (int i = 0; i < n_assigns; i++)
     {
-    const Node *n = list_get (assignlist->nodes, i);
+    const Node *n = vector_get (assignlist->nodes, i);
     const char *env_token = n->val1;
     shell_do_variable (env_token, env);
     } 
@@ -371,8 +398,8 @@ static Error shell_exec_assignlist_exec (const Node *assignlist_exec,
          const char *redir_in, const char *redir_out)
   {
   int ret;
-  const Node *assignlist = list_get (assignlist_exec->nodes, 0);
-  const Node *exec = list_get (assignlist_exec->nodes, 1);
+  const Node *assignlist = vector_get (assignlist_exec->nodes, 0);
+  const Node *exec = vector_get (assignlist_exec->nodes, 1);
 
   Process *p = process_get_current();
   Environment *old_env = p->environment;
@@ -397,7 +424,7 @@ static Error shell_exec_statement (const Node *n, int argc, char **argv,
   switch (n->type)
     {
     case NODE_STATEMENT:
-      Node *n_child = list_get (n->nodes, 0);
+      Node *n_child = vector_get (n->nodes, 0);
       switch (n_child->type)
         {
         case NODE_EXEC:
@@ -417,6 +444,7 @@ static Error shell_exec_statement (const Node *n, int argc, char **argv,
           shell_assignlist_to_env (n_child, p->environment);
           break;
         default:
+          picoconsoledev_flush ();
           printf ("Error\n");
         }
       break;
@@ -437,10 +465,10 @@ static Error shell_exec_pipedlist (const Node *n, int argc, char **argv)
     {
     case NODE_PIPEDLIST:
       //node_dump (n, 0);
-      int len = list_length (n->nodes);
+      int len = vector_length (n->nodes);
       if (len == 1)
         {
-        Node *statement = list_get (n->nodes, 0);
+        Node *statement = vector_get (n->nodes, 0);
         ret = shell_exec_statement (statement, argc, argv, 
                 NULL, NULL);
         }
@@ -492,7 +520,7 @@ static Error shell_exec_pipedlist (const Node *n, int argc, char **argv)
               }
             }
 
-          Node *statement = list_get (n->nodes, i);
+          Node *statement = vector_get (n->nodes, i);
           ret = shell_exec_statement (statement, argc, argv, 
                   redir_in, redir_out);
           // TODO -- handle ret
@@ -526,15 +554,15 @@ Error shell_do_buffer (const char *buff, const char *file,
   spc.argv = argv;
 
   int ret = 0;
-  List *args = string_tokenize2 (sbuff, &spc); 
-  int len = list_length (args);
+  Vector *args = string_tokenize2 (sbuff, &spc); 
+  int len = vector_length (args);
   if (len > 1) // The token list will always end with an EOI token.
     {
     /*
-    int l = list_length (args);
+    int l = vector_length (args);
     for (int i = 0; i < l; i++)
       {
-      Token *t = (Token *)list_get (args, i);
+      Token *t = (Token *)vector_get (args, i);
       printf ("i=%d type=%d val=%s line=%d col=%d\n", i, t->type, t->val, 
 	t->line, t->col);
       }
@@ -552,9 +580,10 @@ Error shell_do_buffer (const char *buff, const char *file,
       {
       // TODO -- find a way to report errors properly
       int p = shellparser_get_token_pos (sp);
-      Token *t = list_get (args, p);
+      Token *t = vector_get (args, p);
       int line = t->line;
       int col = t->col;
+      picoconsoledev_flush ();
       printf ("Syntax error, file '%s': line %d, col %d\n", 
         file ? file : "stdin",  line + 1, col + 1);
       ret = EINVAL;
@@ -563,7 +592,7 @@ Error shell_do_buffer (const char *buff, const char *file,
     shellparser_destroy (sp);
     }
 
-  list_destroy (args);
+  vector_destroy (args);
   string_destroy (sbuff);
   return ret;
   }
@@ -587,7 +616,7 @@ Error shell_do_line (const char *buff, int argc, char **argv)
 void shell_run (void)
   {
   char line [SHELL_MAX_LINE];
-  List *history = list_create (free);
+  Vector *history = vector_create (free);
 
   while (prompt (), term_get_line (0, /* TODO */ line, sizeof (line), 
         10, history) != TGL_EOI) 
@@ -597,7 +626,7 @@ void shell_run (void)
       shell_do_line (line, 0, NULL);
       }
     }
-  list_destroy (history);
+  vector_destroy (history);
   }
 
 /*============================================================================
@@ -609,6 +638,7 @@ Error shell_process (int argc, char **argv, char **envp)
   (void)argv;
   (void)envp;
   sys_mkdir ("A:/tmp"); // We should probably check the env var
+  shell_hash_init ();
   shell_run ();
   return 0;
   }
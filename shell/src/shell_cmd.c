@@ -20,8 +20,10 @@
 #include <term/term.h>
 #include <shell/shell.h>
 #include <shell/shell_cmd.h>
+#include <shell/shell_hash.h>
 #include <klib/string.h>
 #include <klib/list.h>
+#include <klib/hashmap.h>
 #include <sys/fsutil.h>
 #include <bearos/devctl.h>
 #include <sys/direntry.h>
@@ -59,58 +61,56 @@ static struct Cmd
   {"cp", shell_cmd_cp},
   {"date", shell_cmd_date},
   {"df", shell_cmd_df},
+  {"du", shell_cmd_du},
   {"env", shell_cmd_env},
   {"gpio", shell_cmd_gpio},
   {"grep", shell_cmd_grep},
+  {"hash", shell_cmd_hash},
+  {"head", shell_cmd_head},
   {"ls", shell_cmd_ls},
   {"echo", shell_cmd_echo},
   {"mkdir", shell_cmd_mkdir},
   {"mv", shell_cmd_mv},
   {"rm", shell_cmd_rm},
   {"rmdir", shell_cmd_rmdir},
+  {"sort", shell_cmd_sort},
   {"source", shell_cmd_source},
+  {"tail", shell_cmd_tail},
   {"uname", shell_cmd_uname},
+  {"wc", shell_cmd_wc},
   {"foo", shell_cmd_foo},
   {0, 0}
   };
 
+// Index of cmd_table by name, built on first use
+static HashMap *cmd_map = NULL;
+
 /*============================================================================
- * shell_try_path
+ * shell_cmd_find_builtin
  * ==========================================================================*/
-Error shell_try_path (const char *path, int argc, char **argv)
+ShellCmdFn shell_cmd_find_builtin (const char *name)
   {
-  Error ret = ENOENT;
-  if (sys_access (path, X_OK) == 0)
+  if (!cmd_map)
     {
-    if (fsutil_is_regular (path))
-      {
-      ret = shell_cmd_run_file (path, argc, argv);;
-      }
+    cmd_map = hashmap_create_strings (FALSE, NULL);
+    for (struct Cmd *p = cmd_table; p->name; p++)
+      hashmap_put (cmd_map, p->name, p);
     }
-  return ret;
+  const struct Cmd *cmd = hashmap_get (cmd_map, name);
+  return cmd ? cmd->fn : NULL;
   }
 
 /*============================================================================
- * shell_do_external
+ * shell_try_path
  * ==========================================================================*/
-Error shell_do_external (int argc, char **argv)
+Error shell_try_path (const char *path, int argc, char **argv)
   {
-  Error ret = shell_try_path (argv[0], argc, argv);
-  if (ret == ENOENT)
+  Error ret = ENOENT;
+  if (sys_access (path, X_OK) == 0)
     {
-    const char *path = process_getenv (process_get_current(), "PATH");
-    if (path)
+    if (fsutil_is_regular (path))
       {
-      char *path2 = strdup (path);
-      char *tok = strtok (path2, ";");
-      while (tok && ret == ENOENT)
-        {
-        char try[PATH_MAX];
-        fsutil_join_path (tok, argv[0], try, PATH_MAX); 
-        ret = shell_try_path (try, argc, argv);
-        tok = strtok (NULL, ";");
-        }
-      free (path2);
+      ret = shell_cmd_run_file (path, argc, argv);;
       }
     }
   return ret;
@@ -121,22 +121,31 @@ Error shell_do_external (int argc, char **argv)
  * ==========================================================================*/
 Error shell_cmd (int argc, char **argv)
   {
-  Error ret = shell_do_external (argc, argv);
-  if (ret != ENOENT) return ret;
- 
-  int i = 0;
-  struct Cmd *p = &(cmd_table[0]);
-  do
+  // A name with a directory or drive part is run as it stands, and
+  //   is never looked up in PATH or the built-ins.
+  if (strchr (argv[0], '/') || strchr (argv[0], ':'))
     {
-    if (strcmp (argv[0], p->name) == 0)
-      {
-      Error ret = p->fn (argc, argv);
-      return ret;
-      }
+    Error ret = shell_try_path (argv[0], argc, argv);
+    if (ret == ENOENT)
+      compat_printf ("%s: bad command\n", argv[0]);
+    return ret;
+    }
 
-    i++;
-    p = &(cmd_table[i]);
-    } while (p->name);
+  const ShellHashEntry *e = shell_hash_lookup (argv[0]);
+  // The command itself might change the cache, so don't use the entry
+  //   after the command starts 
+  if (e->type == SHELL_HASH_BUILTIN)
+    {
+    ShellCmdFn fn = e->fn;
+    return fn (argc, argv);
+    }
+  else if (e->type == SHELL_HASH_EXTERNAL)
+    {
+    char path[PATH_MAX];
+    strncpy (path, e->path, PATH_MAX - 1);
+    path[PATH_MAX - 1] = 0;
+    return shell_cmd_run_file (path, argc, argv);
+    }
 
   compat_printf ("%s: bad command\n", argv[0]);
   return ENOENT;
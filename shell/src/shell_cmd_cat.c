@@ -20,6 +20,7 @@
 #include <getopt.h>
 #include <term/term.h>
 #include <shell/shell.h>
+#include <shell/shell_reader.h>
 #include <klib/string.h>
 #include <sys/syscalls.h>
 #include <sys/fsutil.h>
@@ -30,13 +31,25 @@
 =========================================================================*/
 static Error do_cat (int fd, BOOL unbuffered)
   {
-  char buff[256];
-  int bufsize = unbuffered ? 1 : sizeof (buff);
-  int n;
-  while ((n = sys_read (fd, buff, bufsize)) > 0)
-    sys_write (1, buff, n);
+  if (unbuffered)
+    {
+    char c;
+    while (sys_read (fd, &c, 1) > 0)
+      sys_write (1, &c, 1);
+    return 0;
+    }
 
-  return 0;
+  ShellReader reader;
+  Error ret = shell_reader_init (&reader, fd, SHELL_READER_SIZE);
+  if (ret) return ret;
+  int n;
+  while (ret == 0 && (n = shell_reader_fill (&reader)) > 0)
+    {
+    ret = shell_reader_write (reader.buff + reader.start, n);
+    reader.start = reader.end;
+    }
+  shell_reader_free (&reader);
+  return ret;
   }
 
 /*=========================================================================
@@ -36,6 +36,7 @@ static void show_usage (const char *argv0)
      argv0);
   compat_printf ("    -v     verbose\n");
   compat_printf ("    -p     preserve attributes\n");
+  compat_printf ("    -r     copy directories and their contents\n");
   }
 
 /*=========================================================================
@@ -54,10 +55,12 @@ static void do_move_file (const char *argv0, const char *source,
 
 /*=========================================================================
   do_copy_file 
+  Reports its own errors, and returns the first
 =========================================================================*/
-static void do_copy_file (const char *argv0, const char *source, 
+static Error do_copy_file (const char *argv0, const char *source, 
          const char *target, bool verbose, bool attributes)
   {
+  Error ret = 0;
   char real_source[PATH_MAX];
   char real_target[PATH_MAX];
   fsutil_make_abs_path (source, real_source, PATH_MAX);
@@ -65,6 +68,7 @@ static void do_copy_file (const char *argv0, const char *source,
   if (fsutil_is_directory (real_source))
     {
     compat_printf ("Omitting directory '%s'\n", real_source);
+    ret = EISDIR;
     }
   else
     {
@@ -72,11 +76,12 @@ static void do_copy_file (const char *argv0, const char *source,
       {
       compat_printf_stderr ("%s: '%s' and '%s' are the same file\n", argv0, 
         source, target); 
+      ret = EINVAL;
       }
     else
       {
       if (verbose) compat_printf ("%s -> %s\n", real_source, real_target);
-      Error ret = fsutil_copy_file (real_source, real_target);
+      ret = fsutil_copy_file (real_source, real_target);
       if (ret == 0)
         {
         if (attributes)
@@ -102,6 +107,100 @@ static void do_copy_file (const char *argv0, const char *source,
         }
       }
     }
+  return ret;
+  }
+
+typedef struct _CopyTree
+  {
+  const char *argv0;
+  const char *target;
+  int source_len;
+  bool verbose;
+  bool attributes;
+  Error error;
+  } CopyTree;
+
+/*=========================================================================
+  copy_tree_fn
+  Directories are made in the target as they are found, so that the
+  files in them can be copied straight away
+=========================================================================*/
+static int copy_tree_fn (const FsutilWalkEntry *entry, int event,
+         Error error, void *data)
+  {
+  CopyTree *self = data;
+  if (event == FSUTIL_WALK_DIR_POST) return FSUTIL_WALK_CONTINUE;
+
+  char target[PATH_MAX];
+  const char *rest = entry->path + self->source_len;
+  while (*rest == '/') rest++;
+  if (*rest)
+    fsutil_join_path (self->target, rest, target, PATH_MAX);
+  else
+    strncpy (target, self->target, PATH_MAX);
+
+  if (event == FSUTIL_WALK_DIR_PRE)
+    {
+    if (self->verbose) compat_printf ("%s -> %s\n", entry->path, target);
+    if (!fsutil_is_directory (target))
+      error = sys_mkdir (target);
+    }
+  else if (event == FSUTIL_WALK_FILE)
+    {
+    // do_copy_file has reported the error already
+    Error err = do_copy_file (self->argv0, entry->path, target, 
+      self->verbose, self->attributes);
+    if (err) self->error = err;
+    }
+
+  if (error)
+    {
+    compat_printf_stderr ("%s: %s: %s\n", self->argv0, entry->path,
+      strerror (error));
+    self->error = error;
+    // Nothing can be copied into a directory that wasn't made
+    if (event == FSUTIL_WALK_DIR_PRE) return FSUTIL_WALK_PRUNE;
+    }
+  return FSUTIL_WALK_CONTINUE;
+  }
+
+/*=========================================================================
+  do_copy_tree
+=========================================================================*/
+static Error do_copy_tree (const char *argv0, const char *source,
+         const char *target, bool verbose, bool attributes)
+  {
+  char real_source[PATH_MAX];
+  char real_target[PATH_MAX];
+  fsutil_make_abs_path (source, real_source, PATH_MAX);
+  fsutil_make_abs_path (target, real_target, PATH_MAX);
+  size_t len = strlen (real_source);
+  if (strncasecmp (real_source, real_target, len) == 0
+      && (real_target[len] == 0 || real_target[len] == '/'
+        || real_source[len - 1] == '/'))
+    {
+    compat_printf_stderr ("%s: can't copy '%s' into itself\n", argv0,
+      source);
+    return EINVAL;
+    }
+
+  CopyTree copy;
+  copy.argv0 = argv0;
+  copy.target = real_target;
+  copy.source_len = (int)len;
+  copy.verbose = verbose;
+  copy.attributes = attributes;
+  copy.error = 0;
+  FsutilWalkStats stats;
+  Error ret = fsutil_walk (real_source, -1, copy_tree_fn, &copy, &stats);
+  if (ret)
+    compat_printf_stderr ("%s: %s: %s\n", argv0, source, strerror (ret));
+  else
+    ret = copy.error;
+  if (verbose)
+    compat_printf ("%s: %ld opens, %ld entries read, %d open at most\n",
+      source, stats.opens, stats.entries, stats.max_open);
+  return ret;
   }
 
 /*=========================================================================
@@ -115,10 +214,14 @@ Error shell_cmd_cp_mv (int argc, char **argv, bool move)
   BOOL usage = FALSE;
   BOOL verbose = FALSE;
   BOOL attributes = FALSE;
-  while ((opt = getopt (argc, argv, "hvp")) != -1)
+  BOOL recursive = FALSE;
+  while ((opt = getopt (argc, argv, "hvpr")) != -1)
     {
     switch (opt)
       {
+      case 'r':
+        recursive = TRUE;
+        break;
       case 'v':
         verbose = TRUE;
         break;
@@ -182,8 +285,19 @@ Error shell_cmd_cp_mv (int argc, char **argv, bool move)
             }
           if (move)
             do_move_file (argv[0], source, real_target, verbose);
+          else if (recursive && fsutil_is_directory (source))
+            {
+            Error err = do_copy_tree (argv[0], source, real_target,
+              verbose, attributes);
+            if (err == EINTR) interrupted = true;
+            else if (err) ret = err;
+            }
           else
-            do_copy_file (argv[0], source, real_target, verbose, attributes);
+            {
+            Error err = do_copy_file (argv[0], source, real_target, 
+              verbose, attributes);
+            if (err) ret = err;
+            }
           }
         if (interrupted)
           {
@@ -0,0 +1,175 @@
+/*============================================================================
+ *  shell/shell_cmd_du.c
+ *
+ *  The sizes come from the directory entries, as fsutil_walk() reads
+ *  them, so no file is opened. Each directory's total is kept on a stack
+ *  indexed by depth, and added to its parent's when the walk leaves it.
+ *
+ * Copyright (c)2023 Kevin Boone, GPL v3.0
+ * ==========================================================================*/
+
+/*============================================================================
+ * ==========================================================================*/
+
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include <ctype.h>
+#include <pico/stdlib.h>
+#include <stdio.h>
+#include <getopt.h>
+#include <sys/types.h>
+#include <sys/stat.h>
+#include <sys/error.h>
+#include <errno.h>
+#include <sys/fsutil.h>
+#include <shell/shell.h>
+#include <sys/syscalls.h>
+#include <compat/compat.h>
+
+typedef struct _Du
+  {
+  const char *argv0;
+  BOOL all;
+  BOOL kilo;
+  int max_depth; // Deepest level to show, or -1 for all
+  Error error;
+  int64_t totals[FSUTIL_WALK_MAX_DEPTH + 1];
+  } Du;
+
+/*=========================================================================
+  show_usage
+=========================================================================*/
+static void show_usage (const char *argv0)
+  {
+  compat_printf ("Usage: %s [options] [paths...]\n", argv0);
+  compat_printf ("Shows the space used by directories.\n", argv0);
+  compat_printf ("    -a     show files as well as directories\n");
+  compat_printf ("    -d N   show only N levels below each path\n");
+  compat_printf ("    -k     show sizes in kilobytes\n");
+  compat_printf ("    -s     show only the total for each path\n");
+  compat_printf ("    -v     show the directory reads\n");
+  }
+
+/*=========================================================================
+  du_show
+=========================================================================*/
+static void du_show (const Du *self, int64_t size, const char *path)
+  {
+  if (self->kilo)
+    compat_printf ("%ldk %s\n", (long)((size + 1023) / 1024), path);
+  else
+    compat_printf ("%ld %s\n", (long)size, path);
+  }
+
+/*=========================================================================
+  du_walk_fn
+=========================================================================*/
+static int du_walk_fn (const FsutilWalkEntry *entry, int event, Error error,
+        void *data)
+  {
+  Du *self = data;
+  BOOL show = self->max_depth < 0 || entry->depth <= self->max_depth;
+  switch (event)
+    {
+    case FSUTIL_WALK_DIR_PRE:
+      self->totals[entry->depth] = 0;
+      break;
+    case FSUTIL_WALK_FILE:
+      if (entry->depth > 0)
+        self->totals[entry->depth - 1] += entry->size;
+      if ((self->all && show) || entry->depth == 0)
+        du_show (self, entry->size, entry->path);
+      break;
+    case FSUTIL_WALK_DIR_POST:
+      if (entry->depth > 0)
+        self->totals[entry->depth - 1] += self->totals[entry->depth];
+      if (show) du_show (self, self->totals[entry->depth], entry->path);
+      break;
+    default:
+      compat_printf_stderr ("%s: %s: %s\n", self->argv0, entry->path,
+        strerror (error));
+      self->error = error;
+    }
+  return FSUTIL_WALK_CONTINUE;
+  }
+
+/*=========================================================================
+  du_path
+=========================================================================*/
+static Error du_path (Du *self, const char *path, BOOL verbose)
+  {
+  self->error = 0;
+  FsutilWalkStats stats;
+  Error ret = fsutil_walk (path, -1, du_walk_fn, self, &stats);
+  if (ret)
+    compat_printf_stderr ("%s: %s: %s\n", self->argv0, path, strerror (ret));
+  else
+    ret = self->error;
+  if (verbose)
+    compat_printf ("%s: %ld opens, %ld entries read, %d open at most\n",
+      path, stats.opens, stats.entries, stats.max_open);
+  return ret;
+  }
+
+/*=========================================================================
+  shell_cmd_du
+=========================================================================*/
+Error shell_cmd_du (int argc, char **argv)
+  {
+  int opt;
+  Error ret = 0;
+  optind = 0;
+  BOOL usage = FALSE;
+  BOOL verbose = FALSE;
+  Du du;
+  memset (&du, 0, sizeof (du));
+  du.argv0 = argv[0];
+  du.max_depth = -1;
+
+  while ((opt = getopt (argc, argv, "ad:hksv")) != -1)
+    {
+    switch (opt)
+      {
+      case 'a':
+        du.all = TRUE;
+        break;
+      case 'd':
+        du.max_depth = atoi (optarg);
+        break;
+      case 'k':
+        du.kilo = TRUE;
+        break;
+      case 's':
+        du.max_depth = 0;
+        break;
+      case 'v':
+        verbose = TRUE;
+        break;
+      case 'h':
+        usage = TRUE;
+        // Fall through
+      default:
+        show_usage (argv[0]);
+        ret = EINVAL;
+      }
+    }
+
+  if (ret == 0)
+    {
+    if (argc == optind)
+      {
+      Process *p = process_get_current();
+      ret = du_path (&du, process_get_cwd (p), verbose);
+      }
+    else
+      {
+      for (int i = optind; i < argc && ret != EINTR; i++)
+        ret = du_path (&du, argv[i], verbose);
+      }
+    }
+
+  if (usage) ret = 0;
+  return ret;
+  }
+
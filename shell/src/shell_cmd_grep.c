@@ -1,6 +1,13 @@
 /*============================================================================
  *  shell/shell_cmd_grep.c
  *
+ *  Files are read in blocks of whole sectors into one buffer, and lines
+ *  are found in place, without copying them, with klib/fastmem. If the
+ *  pattern contains a literal string that every match must contain, the
+ *  buffer is searched for that first, with Boyer-Moore-Horspool, and only
+ *  the lines that contain it are given to the regex engine. Lines in
+ *  between are skipped, apart from counting them for -n.
+ *
  * Copyright (c)2022 Kevin Boone, GPL v3.0
  * ==========================================================================*/
 
@@ -13,8 +20,6 @@
 #include <ctype.h>
 #include <pico/stdlib.h>
 #include <stdio.h>
-//#include <regex.h>
-#include <compat/re.h>
 #include <sys/types.h>
 #include <sys/stat.h>
 #include <fcntl.h>
@@ -22,29 +27,44 @@
 #include <sys/error.h>
 #include <errno.h>
 #include <sys/fsutil.h>
+#include <sys/limits.h>
 #include <term/term.h>
 #include <shell/shell.h>
-#include <klib/string.h>
+#include <klib/regex.h>
+#include <klib/fastmem.h>
 #include <sys/syscalls.h>
 #include <sys/direntry.h>
 #include <compat/compat.h>
 
-/*=========================================================================
-  strlwr
-=========================================================================*/
-char *strlwr (char *s)
+// Size of a read. Reads of whole sectors go straight from the card to
+//   the buffer.
+#define GREP_BLOCK 512
+
+// Initial size of the buffer, which grows if a line won't fit in it
+#define GREP_BUFF_SIZE (4 * GREP_BLOCK)
+
+typedef struct _Grep
   {
-  char *ss = s;
-  while (*ss)
-    {
-    *ss = (char)tolower (*ss);
-    ss++;
-    }
-  return s;
-  }
+  const char *argv0;
+  Regex *regex;
+  BOOL invert;
+  BOOL show_count;
+  BOOL show_filename;
+  BOOL list_files;
+  BOOL line_numbers;
+  BOOL recursive;
+  // The literal for the prefilter, and its Boyer-Moore-Horspool shift
+  //   table, if there is one
+  const char *literal;
+  int literal_len;
+  BOOL nocase;
+  uint8_t shift[256];
+  char *buff;
+  int buff_size;
+  } Grep;
 
 /*=========================================================================
-  show_usage 
+  show_usage
 =========================================================================*/
 static void show_usage (const char *argv0)
   {
@@ -52,105 +72,186 @@ static void show_usage (const char *argv0)
   compat_printf ("Searches for patterns in files.\n", argv0);
   compat_printf ("  -c: show match count\n", argv0);
   compat_printf ("  -i: case-insensitive\n", argv0);
-  compat_printf ("  -n: don't show filenames with multiple files\n", argv0);
+  compat_printf ("  -l: show only the names of files that match\n", argv0);
+  compat_printf ("  -n: show line numbers\n", argv0);
+  compat_printf ("  -N: don't show filenames with multiple files\n", argv0);
+  compat_printf ("  -r: search directories recursively\n", argv0);
   compat_printf ("  -v: show non-matches\n", argv0);
   compat_printf ("If no files are listed, searches stdin.\n", argv0);
   }
 
 /*=========================================================================
-  do_grep_line
-  Returns true if a line matches
+  grep_init_literal
+  Set up the shift table for the literal. The shift for a byte is how
+  far the literal can move along, when that byte is under its last
+  character and there is no match.
 =========================================================================*/
-static BOOL do_grep_line (const char *filename, struct regex_t *preg, 
-        const char *line, BOOL invert, BOOL show_filename, 
-        BOOL suppress, BOOL nocase)
+static void grep_init_literal (Grep *self)
   {
-  BOOL show = invert ? TRUE : FALSE; 
-  BOOL match = FALSE;
-  int len = 0;
-  if (nocase)
+  self->literal = regex_literal (self->regex, &self->literal_len);
+  if (!self->literal) return;
+  int len = self->literal_len;
+  int max = len > 255 ? 255 : len;
+  memset (self->shift, max, sizeof (self->shift));
+  for (int i = len > 255 ? len - 255 : 0; i < len - 1; i++)
     {
-    char *testline = strdup (line);
-    strlwr (testline);
-    if (re_matchp (preg, testline, &len) != -1)
-      show = invert ? FALSE : TRUE; 
-    free (testline);
+    uint8_t c = (uint8_t)self->literal[i];
+    self->shift[c] = (uint8_t)(len - 1 - i);
+    if (self->nocase) self->shift[toupper (c)] = (uint8_t)(len - 1 - i);
     }
-  else
+  }
+
+/*=========================================================================
+  grep_find_literal
+  Returns the first occurence of the literal in the len bytes at s, or
+  NULL.
+=========================================================================*/
+static const char *grep_find_literal (const Grep *self, const char *s,
+        int len)
+  {
+  const char *lit = self->literal;
+  int m = self->literal_len;
+  if (m == 1 && !self->nocase)
+    return fastmem_memchr (s, lit[0], (size_t)len);
+  const uint8_t *t = (const uint8_t *)s;
+  uint8_t last = (uint8_t)lit[m - 1];
+  for (int i = m - 1; i < len; )
     {
-    if (re_matchp (preg, line, &len) != -1)
-      show = invert ? FALSE : TRUE; 
+    uint8_t c = t[i];
+    if ((self->nocase ? (uint8_t)tolower (c) : c) == last)
+      {
+      int j = m - 2;
+      if (self->nocase)
+        while (j >= 0 && tolower (t[i - m + 1 + j]) == (uint8_t)lit[j]) j--;
+      else
+        while (j >= 0 && t[i - m + 1 + j] == (uint8_t)lit[j]) j--;
+      if (j < 0) return s + i - m + 1;
+      }
+    i += self->shift[c];
     }
+  return NULL;
+  }
 
-  if (show)
+/*=========================================================================
+  grep_line
+  Match one line, and show it if required. Returns TRUE if there is no
+  need to look at the rest of the file.
+=========================================================================*/
+static BOOL grep_line (const Grep *self, const char *filename, long lineno,
+        const char *line, int len, int *count)
+  {
+  if (regex_match (self->regex, line, len) == self->invert) return FALSE;
+  (*count)++;
+  if (self->list_files)
     {
-    match = TRUE;
-    if (!suppress)
+    compat_printf ("%s\n", filename);
+    return TRUE;
+    }
+  if (self->show_count) return FALSE;
+  if (self->show_filename && self->line_numbers)
+    compat_printf ("%s: %ld: %.*s\n", filename, lineno, len, line);
+  else if (self->show_filename)
+    compat_printf ("%s: %.*s\n", filename, len, line);
+  else if (self->line_numbers)
+    compat_printf ("%ld: %.*s\n", lineno, len, line);
+  else
+    compat_printf ("%.*s\n", len, line);
+  return FALSE;
+  }
+
+/*=========================================================================
+  grep_lines
+  Search the complete lines in the buffer from start to end. Returns
+  the offset of the line that is not complete, or -1 if there is no
+  need to read any more of the file.
+=========================================================================*/
+static int grep_lines (const Grep *self, const char *filename, int start,
+        int end, long *lineno, int *count)
+  {
+  const char *p = self->buff + start;
+  const char *limit = self->buff + end;
+  // Lines without the literal can't match, so with -v they have to
+  //   be shown, and can't be skipped
+  BOOL prefilter = self->literal && !self->invert;
+  while (p < limit)
+    {
+    if (prefilter)
       {
-      if (show_filename)
-	compat_printf ("%s: %s\n", filename, line);
+      const char *hit = grep_find_literal (self, p, (int)(limit - p));
+      const char *skip_to;
+      if (hit)
+        {
+        skip_to = hit;
+        while (skip_to > p && skip_to[-1] != '\n') skip_to--;
+        }
       else
-	compat_printf ("%s\n", line);
+        {
+        // Nothing to match here, but an incomplete line at the end
+        //   might yet turn out to contain the literal
+        skip_to = limit;
+        while (skip_to > p && skip_to[-1] != '\n') skip_to--;
+        }
+      if (self->line_numbers)
+        *lineno += (long)fastmem_count_byte (p, '\n',
+          (size_t)(skip_to - p));
+      p = skip_to;
+      if (!hit) break;
       }
+    const char *nl = fastmem_memchr (p, '\n', (size_t)(limit - p));
+    if (!nl) break;
+    if (grep_line (self, filename, *lineno, p, (int)(nl - p), count))
+      return -1;
+    (*lineno)++;
+    p = nl + 1;
     }
-  return match;
+  return (int)(p - self->buff);
   }
 
 /*=========================================================================
-  do_grep_fd
-  Returns the number of matching lines. There is no error return -- we 
+  grep_fd
+  Returns the number of matching lines. There is no error return -- we
     assume that if the fd has been opened, it can likely be read.
 =========================================================================*/
-static int do_grep_fd (const char *filename, struct regex_t *preg, int fd, 
-        BOOL invert, BOOL show_filename, BOOL show_count, BOOL nocase)
+static int grep_fd (Grep *self, const char *filename, int fd)
   {
-  int curr_len = 0;
-  int max_len = 80;
-  int expand = 80;
   int count = 0;
-
-  char *line = malloc ((size_t)max_len);
-  char buff[40];
-  line[0] = 0;
-  curr_len = 0;
-  int n = sys_read (fd, buff, sizeof (buff));
-  while (n > 0)
+  long lineno = 1;
+  int start = 0;
+  int end = 0;
+  for (;;)
     {
-    if (n + curr_len > max_len)
+    // Move the incomplete line to the front, and make sure there is
+    //   room to read at least a block after it
+    if (start > 0)
       {
-      max_len += expand;
-      line = realloc (line, (size_t)max_len); 
+      memmove (self->buff, self->buff + start, (size_t)(end - start));
+      end -= start;
+      start = 0;
       }
-    strncat (line, buff, (size_t)n);       
-    curr_len += n;
-    line[curr_len] = 0; 
-
-    char *nlpos;
-    while ((nlpos = strchr (line, '\n')))
+    if (self->buff_size - end < GREP_BLOCK)
       {
-      int this_len = (int)(nlpos - line);
-      line[this_len] = 0;
-      if (do_grep_line (filename, preg, line, invert, 
-          show_filename, show_count, nocase)) count++;
-      memmove (line, line + this_len + 1, (size_t)(curr_len - this_len)); 
-      curr_len -= this_len;
+      char *buff = realloc (self->buff, (size_t)self->buff_size * 2);
+      if (!buff) break;
+      self->buff = buff;
+      self->buff_size *= 2;
       }
-
-    n = sys_read (fd, buff, sizeof (buff));
-    }
-  
-  if (curr_len > 0 && line[0] && line[0] != '\n')
-    {
-    if (do_grep_line (filename, preg, line, invert, show_filename, 
-      show_count, nocase))
-       count++;
+    int room = (self->buff_size - end) / GREP_BLOCK * GREP_BLOCK;
+    int n = sys_read (fd, self->buff + end, room);
+    if (n <= 0)
+      {
+      if (end > start)
+        grep_line (self, filename, lineno, self->buff + start,
+          end - start, &count);
+      break;
+      }
+    end += n;
+    start = grep_lines (self, filename, start, end, &lineno, &count);
+    if (start < 0) break;
     }
 
-  free (line);
-
-  if (show_count)
+  if (self->show_count && !self->list_files)
     {
-    if (show_filename)
+    if (self->show_filename)
       compat_printf ("%s: %d\n", filename, count);
     else
       compat_printf ("%d\n", count);
@@ -160,24 +261,48 @@ static int do_grep_fd (const char *filename, struct regex_t *preg, int fd,
   }
 
 /*=========================================================================
-  do_grep_file 
+  grep_path
+  Search a file or, with -r, a directory and everything below it
 =========================================================================*/
-static Error do_grep_file (struct regex_t *preg, 
-               const char *filename, const char *argv0, BOOL invert, 
-               BOOL show_filename, BOOL show_count, BOOL nocase)
+static Error grep_path (Grep *self, const char *path)
   {
   Error ret = 0;
-  int fd = sys_open (filename, O_RDONLY); // TODO DIR
+  int fd = sys_open (path, O_RDONLY);
   if (fd >= 0)
     {
-    do_grep_fd (filename, preg, fd, invert, 
-         show_filename, show_count, nocase); 
+    struct stat sb;
+    sys_fstat (fd, &sb);
+    if ((sb.st_mode & S_IFMT) != S_IFDIR)
+      grep_fd (self, path, fd);
+    else if (!self->recursive)
+      {
+      ret = EISDIR;
+      compat_printf_stderr ("%s: %s: %s\n", self->argv0, path,
+        strerror (ret));
+      }
+    else
+      {
+      DirEntry *de = malloc (sizeof (DirEntry));
+      char *child = malloc (PATH_MAX);
+      if (de && child)
+        {
+        while (ret == 0 && sys_getdent (fd, de) > 0)
+          {
+          fsutil_join_path (path, de->name, child, PATH_MAX);
+          ret = grep_path (self, child);
+          }
+        }
+      else
+        ret = ENOMEM;
+      free (child);
+      free (de);
+      }
     sys_close (fd);
     }
   else
     {
     ret = -fd;
-    compat_printf_stderr ("%s: %s: %s\n", argv0, filename, strerror (ret));
+    compat_printf_stderr ("%s: %s: %s\n", self->argv0, path, strerror (ret));
     }
   return ret;
   }
@@ -190,27 +315,36 @@ Error shell_cmd_grep (int argc, char **argv)
   Error ret = 0;
   int opt;
   optind = 0;
-  BOOL nocase = FALSE;
   BOOL usage = FALSE;
   BOOL no_filename = FALSE;
-  BOOL invert = FALSE;
-  BOOL count = FALSE;
+  Grep grep;
+  memset (&grep, 0, sizeof (grep));
+  grep.argv0 = argv[0];
 
-  while ((opt = getopt (argc, argv, "hinvc")) != -1)
+  while ((opt = getopt (argc, argv, "hilnNrvc")) != -1)
     {
     switch (opt)
       {
       case 'c':
-        count = TRUE;
+        grep.show_count = TRUE;
         break;
       case 'i':
-        nocase = TRUE;
+        grep.nocase = TRUE;
+        break;
+      case 'l':
+        grep.list_files = TRUE;
         break;
       case 'n':
+        grep.line_numbers = TRUE;
+        break;
+      case 'N':
         no_filename = TRUE;
         break;
+      case 'r':
+        grep.recursive = TRUE;
+        break;
       case 'v':
-        invert = TRUE;
+        grep.invert = TRUE;
         break;
       case 'h':
         usage = TRUE;
@@ -225,46 +359,44 @@ Error shell_cmd_grep (int argc, char **argv)
     {
     if (argc - optind == 0)
       {
-      show_usage (argv[0]); 
+      show_usage (argv[0]);
       ret = EINVAL;
       }
     else
-     {
-     struct regex_t *preg;
-     char *pattern = strdup (argv[optind]);
-     if (nocase) strlwr (pattern);
-     if ((preg = re_compile (argv[optind])) != 0)
-       {
-       if (argc - optind == 1)
-         {
-         ret = do_grep_fd ("stdin", preg, 0, invert, FALSE, count, nocase);
-         }
-       else
-         {
-         BOOL show_filename = FALSE;
-         for (int i = optind + 1; i < argc && ret == 0; i++)
-            {
-            if (argc - optind == 2)
-              show_filename = FALSE;
-            else
-              show_filename = !no_filename;
- 
-            ret = do_grep_file (preg, argv[i], argv[0], 
-                   invert, show_filename, count, nocase);
-            }
-          }
-        //regfree (&preg);
+      {
+      int error;
+      grep.regex = regex_compile (argv[optind],
+        grep.nocase ? REGEX_ICASE : 0, &error);
+      grep.buff_size = GREP_BUFF_SIZE;
+      grep.buff = malloc ((size_t)grep.buff_size);
+      if (!grep.regex)
+        {
+        compat_printf_stderr ("%s: bad expression: %s: %s\n", argv[0],
+          argv[optind], regex_error_string (error));
+        ret = EINVAL;
         }
+      else if (!grep.buff)
+        ret = ENOMEM;
       else
         {
-        compat_printf_stderr ("%s: bad expression: %s\n", argv[0], pattern);
-        ret = EINVAL;
+        grep_init_literal (&grep);
+        if (argc - optind == 1)
+          {
+          grep_fd (&grep, "stdin", 0);
+          }
+        else
+          {
+          grep.show_filename = !no_filename
+            && (argc - optind > 2 || grep.recursive);
+          for (int i = optind + 1; i < argc && ret == 0; i++)
+            ret = grep_path (&grep, argv[i]);
+          }
         }
-      free (pattern);
+      if (grep.regex) regex_destroy (grep.regex);
+      free (grep.buff);
       }
     }
   if (usage) ret = 0;
   return ret;
   }
 
-
@@ -0,0 +1,87 @@
+/*============================================================================
+ *  shell/shell_cmd_hash.c
+ *
+ * Copyright (c)2023 Kevin Boone, GPL v3.0
+ * ==========================================================================*/
+
+/*============================================================================
+ * ==========================================================================*/
+
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include <ctype.h>
+#include <pico/stdlib.h>
+#include <stdio.h>
+#include <sys/types.h>
+#include <getopt.h>
+#include <sys/error.h>
+#include <errno.h>
+#include <shell/shell.h>
+#include <shell/shell_hash.h>
+#include <compat/compat.h>
+
+/*=========================================================================
+  show_usage
+=========================================================================*/
+static void show_usage (const char *argv0)
+  {
+  compat_printf ("Usage: %s [-r] [name...]\n", argv0);
+  compat_printf ("Show, add to, or clear the list of resolved commands.\n");
+  compat_printf ("  -r  forget all resolved commands\n");
+  }
+
+/*=========================================================================
+  shell_cmd_hash
+=========================================================================*/
+Error shell_cmd_hash (int argc, char **argv)
+  {
+  Error ret = 0;
+  int opt;
+  optind = 0;
+  BOOL usage = FALSE;
+  BOOL reset = FALSE;
+
+  while ((opt = getopt (argc, argv, "hr")) != -1)
+    {
+    switch (opt)
+      {
+      case 'r':
+        reset = TRUE;
+        break;
+      case 'h':
+        usage = TRUE;
+        // Fall through
+      default:
+        show_usage (argv[0]);
+        ret = EINVAL;
+      }
+    }
+
+  if (ret == 0)
+    {
+    if (reset) shell_hash_clear ();
+
+    if (argc - optind == 0)
+      {
+      if (!reset) shell_hash_dump ();
+      }
+    else
+      {
+      for (int i = optind; i < argc; i++)
+        {
+        const ShellHashEntry *e = shell_hash_lookup (argv[i]);
+        if (e->type == SHELL_HASH_MISSING)
+          {
+          compat_printf_stderr ("%s: %s: %s\n", argv[0], argv[i],
+            strerror (ENOENT));
+          ret = ENOENT;
+          }
+        }
+      }
+    }
+
+  if (usage) ret = 0;
+  return ret;
+  }
+
@@ -0,0 +1,71 @@
+/*============================================================================
+ *  shell/shell_cmd_head.c
+ *
+ *  The newlines in each block are counted a word at a time, and a block
+ *  that does not contain the last line wanted is written as it stands.
+ *  No more of the file is read after that line.
+ *
+ * Copyright (c)2023 Kevin Boone, GPL v3.0
+ * ==========================================================================*/
+
+/*============================================================================
+ * ==========================================================================*/
+
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include <ctype.h>
+#include <pico/stdlib.h>
+#include <stdio.h>
+#include <sys/types.h>
+#include <sys/error.h>
+#include <errno.h>
+#include <shell/shell.h>
+#include <shell/shell_reader.h>
+#include <klib/fastmem.h>
+#include <sys/syscalls.h>
+
+/*=========================================================================
+  head_fd
+=========================================================================*/
+static Error head_fd (int fd, long lines)
+  {
+  if (lines <= 0) return 0;
+  ShellReader reader;
+  Error ret = shell_reader_init (&reader, fd, SHELL_READER_SIZE);
+  if (ret) return ret;
+
+  int n = 0;
+  while (ret == 0 && lines > 0 && (n = shell_reader_fill (&reader)) > 0)
+    {
+    const char *p = reader.buff + reader.start;
+    int len = n;
+    long count = (long)fastmem_count_byte (p, '\n', (size_t)n);
+    if (count >= lines)
+      {
+      // The last line wanted ends in this block
+      const char *q = p;
+      for (; lines > 0; lines--)
+        q = (const char *)fastmem_memchr (q, '\n', (size_t)(p + n - q)) + 1;
+      len = (int)(q - p);
+      }
+    else
+      lines -= count;
+    ret = shell_reader_write (p, len);
+    reader.start = reader.end;
+    }
+  if (n < 0 && ret == 0) ret = -n;
+
+  shell_reader_free (&reader);
+  return ret;
+  }
+
+/*=========================================================================
+  shell_cmd_head
+=========================================================================*/
+Error shell_cmd_head (int argc, char **argv)
+  {
+  return shell_reader_lines_cmd (argc, argv,
+    "Shows the first lines of files.", head_fd);
+  }
+
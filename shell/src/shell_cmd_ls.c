@@ -1,12 +1,18 @@
 /*============================================================================
  *  shell/shell_cmd_ls.c
  *
+ *  A directory is read once, into a snapshot: an array of entries, whose
+ *  names are kept together in one arena. The snapshot is sorted, and the
+ *  column widths worked out from it, without going back to the card.
+ *  Each line of output is made up in a buffer, and written in one go.
+ *
  * Copyright (c)2022 Kevin Boone, GPL v3.0
  * ==========================================================================*/
 
 /*============================================================================
  * ==========================================================================*/
 
+#define _GNU_SOURCE
 #include <stdint.h>
 #include <stdlib.h>
 #include <string.h>
@@ -28,8 +34,52 @@
 #include <compat/compat.h>
 #include <bearos/devctl.h>
 
+// Initial sizes of the snapshot's arrays, which double as needed
+#define LS_ENTRIES 32
+#define LS_NAMES 512
+
+// Spaces between columns
+#define LS_GAP 2
+
+// Room for everything but the name, in a long listing
+#define LS_LONG_MAX 48
+
+#define LS_SORT_NAME 0
+#define LS_SORT_TIME 1
+#define LS_SORT_SIZE 2
+
+typedef struct _Ls
+  {
+  const char *argv0;
+  BOOL fmt_long;
+  BOOL recursive;
+  BOOL reverse;
+  int sort;
+  BOOL isatty;
+  int width;
+  } Ls;
+
+typedef struct _LsEntry
+  {
+  int name; // Offset of the name in the snapshot's arena
+  int name_len;
+  int type;
+  int32_t size;
+  time_t mtime;
+  } LsEntry;
+
+typedef struct _LsSnapshot
+  {
+  LsEntry *entries;
+  int n;
+  int max;
+  char *names;
+  int names_len;
+  int names_size;
+  } LsSnapshot;
+
 /*=========================================================================
-  write_type_char 
+  write_type_char
 =========================================================================*/
 static char get_type_char (uint32_t mode)
   {
@@ -48,15 +98,15 @@ static char get_type_char (uint32_t mode)
   }
 
 /*=========================================================================
-  convert_date 
+  convert_date
 =========================================================================*/
 static void convert_date (time_t datetime, char *s, int len)
   {
   struct tm mytm;
   sys_gmtime_r (datetime, &mytm);
-  
-  snprintf (s, (size_t)len, "%04d/%02d/%02d %02d:%02d", 
-    mytm.tm_year + 1900, 
+
+  snprintf (s, (size_t)len, "%04d/%02d/%02d %02d:%02d",
+    mytm.tm_year + 1900,
     mytm.tm_mon + 1,
     mytm.tm_mday,
     mytm.tm_hour,
@@ -64,31 +114,240 @@ static void convert_date (time_t datetime, char *s, int len)
   }
 
 /*=========================================================================
-  do_path 
+  ls_write_long
+  Write one line of a long listing
 =========================================================================*/
-static void do_path (const char *argv0, const char *path, BOOL fmt_long)
+static void ls_write_long (char *line, int type, int32_t size, time_t mtime,
+         const char *name)
   {
-  char abspath[PATH_MAX];
-  fsutil_make_abs_path (path, abspath, PATH_MAX);
-  int max_across = 1;
-  int fd = sys_open (abspath, O_RDONLY);
-  uint32_t flags;
-  int width = 80;
+  char s[30];
+  convert_date (mtime, s, sizeof (s));
+  int len = snprintf (line, LS_LONG_MAX + PATH_MAX, "%c %8ld %s %s\n",
+    get_type_char ((uint32_t)type), (long)size, s, name);
+  sys_write (1, line, len);
+  }
 
-  BOOL isatty = FALSE; 
-  if (sys_devctl (1, DC_GET_GEN_FLAGS, (intptr_t)&flags) == 0)
+/*=========================================================================
+  ls_snapshot_add
+=========================================================================*/
+static Error ls_snapshot_add (LsSnapshot *self, const DirEntry *de)
+  {
+  int name_len = (int)strlen (de->name);
+  if (self->n == self->max)
     {
-    if (flags & DC_FLAG_ISTTY)
-      isatty = TRUE;
+    LsEntry *entries = realloc (self->entries,
+      (size_t)self->max * 2 * sizeof (LsEntry));
+    if (!entries) return ENOMEM;
+    self->entries = entries;
+    self->max *= 2;
     }
-  if (isatty)
+  while (self->names_len + name_len + 1 > self->names_size)
     {
-    DevCtlTermProps props;
-    if (sys_devctl (1, DC_TERM_GET_PROPS, (intptr_t)&props) == 0)
+    char *names = realloc (self->names, (size_t)self->names_size * 2);
+    if (!names) return ENOMEM;
+    self->names = names;
+    self->names_size *= 2;
+    }
+  LsEntry *e = &self->entries[self->n++];
+  e->name = self->names_len;
+  e->name_len = name_len;
+  e->type = de->type;
+  e->size = de->size;
+  e->mtime = de->mtime;
+  memcpy (self->names + self->names_len, de->name, (size_t)name_len + 1);
+  self->names_len += name_len + 1;
+  return 0;
+  }
+
+/*=========================================================================
+  ls_snapshot_read
+  Read the whole of the directory open on fd
+=========================================================================*/
+static Error ls_snapshot_read (LsSnapshot *self, int fd)
+  {
+  self->n = 0;
+  self->max = LS_ENTRIES;
+  self->names_len = 0;
+  self->names_size = LS_NAMES;
+  self->entries = malloc ((size_t)self->max * sizeof (LsEntry));
+  self->names = malloc ((size_t)self->names_size);
+  if (!self->entries || !self->names) return ENOMEM;
+
+  Error ret = 0;
+  DirEntry *de = malloc (sizeof (DirEntry));
+  if (!de) return ENOMEM;
+  while (ret == 0 && sys_getdent (fd, de) > 0)
+    ret = ls_snapshot_add (self, de);
+  free (de);
+  return ret;
+  }
+
+/*=========================================================================
+  ls_snapshot_free
+=========================================================================*/
+static void ls_snapshot_free (LsSnapshot *self)
+  {
+  free (self->entries);
+  free (self->names);
+  }
+
+typedef struct _LsCompare
+  {
+  const Ls *ls;
+  const char *names;
+  } LsCompare;
+
+/*=========================================================================
+  ls_compare
+=========================================================================*/
+static int ls_compare (const void *a, const void *b, void *data)
+  {
+  const LsCompare *c = data;
+  const LsEntry *ea = a;
+  const LsEntry *eb = b;
+  int r = 0;
+  if (c->ls->sort == LS_SORT_TIME)
+    r = (ea->mtime < eb->mtime) - (ea->mtime > eb->mtime);
+  else if (c->ls->sort == LS_SORT_SIZE)
+    r = (ea->size < eb->size) - (ea->size > eb->size);
+  if (r == 0)
+    r = strcmp (c->names + ea->name, c->names + eb->name);
+  return c->ls->reverse ? -r : r;
+  }
+
+/*=========================================================================
+  ls_layout
+  Find the most columns, listing down each column in turn, that fit in
+  the width, and the width of each column. Returns the number of columns.
+=========================================================================*/
+static int ls_layout (const LsSnapshot *snap, int width, int *col_widths,
+         int max_cols)
+  {
+  int n = snap->n;
+  if (max_cols > n) max_cols = n;
+  for (int cols = max_cols; cols > 1; cols--)
+    {
+    int rows = (n + cols - 1) / cols;
+    // Fewer columns would hold this many rows
+    if ((cols - 1) * rows >= n) continue;
+    int total = 0;
+    int c;
+    for (c = 0; c < cols && total < width; c++)
       {
-      width = props.cols;
+      int w = 0;
+      for (int i = c * rows; i < n && i < (c + 1) * rows; i++)
+        if (snap->entries[i].name_len > w) w = snap->entries[i].name_len;
+      if (c < cols - 1) w += LS_GAP;
+      col_widths[c] = w;
+      total += w;
       }
+    if (c == cols && total < width) return cols;
     }
+  return 1;
+  }
+
+/*=========================================================================
+  ls_show_snapshot
+=========================================================================*/
+static Error ls_show_snapshot (const Ls *self, const LsSnapshot *snap)
+  {
+  char *line = malloc ((size_t)(self->width + LS_LONG_MAX + PATH_MAX));
+  if (!line) return ENOMEM;
+  if (self->fmt_long)
+    {
+    for (int i = 0; i < snap->n; i++)
+      {
+      const LsEntry *e = &snap->entries[i];
+      ls_write_long (line, e->type, e->size, e->mtime, snap->names + e->name);
+      }
+    free (line);
+    return 0;
+    }
+
+  int max_cols = self->isatty ? self->width / (1 + LS_GAP) : 1;
+  if (max_cols < 1) max_cols = 1;
+  int *col_widths = malloc ((size_t)max_cols * sizeof (int));
+  if (!col_widths)
+    {
+    free (line);
+    return ENOMEM;
+    }
+  int cols = ls_layout (snap, self->width, col_widths, max_cols);
+  int rows = (snap->n + cols - 1) / cols;
+  for (int r = 0; r < rows; r++)
+    {
+    int len = 0;
+    for (int c = 0; c < cols; c++)
+      {
+      int i = c * rows + r;
+      if (i >= snap->n) break;
+      const LsEntry *e = &snap->entries[i];
+      memcpy (line + len, snap->names + e->name, (size_t)e->name_len);
+      len += e->name_len;
+      if (i + rows < snap->n)
+        {
+        int pad = col_widths[c] - e->name_len;
+        memset (line + len, ' ', (size_t)pad);
+        len += pad;
+        }
+      }
+    line[len++] = '\n';
+    sys_write (1, line, len);
+    }
+  free (col_widths);
+  free (line);
+  return 0;
+  }
+
+static Error do_path (const Ls *self, const char *path, int depth);
+
+/*=========================================================================
+  ls_recurse
+  For ls -R, list the subdirectories in the snapshot of path, in the
+  order they were shown. Returns EINTR if interrupted.
+=========================================================================*/
+static Error ls_recurse (const Ls *self, const char *path,
+         const LsSnapshot *snap, int depth)
+  {
+  Error ret = 0;
+  char *child = malloc (PATH_MAX);
+  if (!child) return ENOMEM;
+  for (int i = 0; i < snap->n && ret != EINTR; i++)
+    {
+    const LsEntry *e = &snap->entries[i];
+    const char *name = snap->names + e->name;
+    if (e->type != S_IFDIR || strcmp (name, ".") == 0
+        || strcmp (name, "..") == 0)
+      continue;
+    if (shell_poll_interrupt ())
+      {
+      shell_clear_interrupt ();
+      ret = EINTR;
+      break;
+      }
+    fsutil_join_path (path, name, child, PATH_MAX);
+    compat_printf ("\n%s:\n", child);
+    // The same limit as fsutil_walk(), which keeps the stack bounded
+    if (depth + 1 > FSUTIL_WALK_MAX_DEPTH)
+      compat_printf_stderr ("%s: %s: %s\n", self->argv0, child,
+        strerror (EMFILE));
+    else
+      ret = do_path (self, child, depth + 1);
+    }
+  free (child);
+  return ret;
+  }
+
+/*=========================================================================
+  do_path
+  Errors are reported here; only EINTR is returned, to stop ls -R
+=========================================================================*/
+static Error do_path (const Ls *self, const char *path, int depth)
+  {
+  char abspath[PATH_MAX];
+  fsutil_make_abs_path (path, abspath, PATH_MAX);
+  Error ret = 0;
+  int fd = sys_open (abspath, O_RDONLY);
 
   if (fd >= 0)
     {
@@ -96,73 +355,52 @@ static void do_path (const char *argv0, const char *path, BOOL fmt_long)
     sys_fstat (fd, &sb);
     if ((sb.st_mode & S_IFMT) == S_IFDIR)
       {
-      int fd2;
-      DirEntry de;
-      int max_namelen = 1;
-      if (!fmt_long && isatty)
+      LsSnapshot snap;
+      ret = ls_snapshot_read (&snap, fd);
+      // With -R, only the directory being read is open, not its parents
+      sys_close (fd);
+      if (ret == 0)
         {
-        fd2 = sys_open (abspath, O_RDONLY); // Should succeed -- already open
-        while (sys_getdent (fd2, &de) > 0)
-          {
-          int namelen = (int)strlen (de.name); 
-          if (namelen > max_namelen) max_namelen = namelen;
-          }
-        sys_close (fd2);
-        max_namelen += 1; // Allow at least one space between names
-        max_across = width / max_namelen; 
+        LsCompare c;
+        c.ls = self;
+        c.names = snap.names;
+        qsort_r (snap.entries, (size_t)snap.n, sizeof (LsEntry), ls_compare,
+          &c);
+        ret = ls_show_snapshot (self, &snap);
         }
-      else
-        max_across = 1;
-      fd2 = sys_open (abspath, O_RDONLY); // Should succeed -- already open
-      int across = 0;
-      while (sys_getdent (fd2, &de) > 0)
-        {
-        if (fmt_long)
-          {
-          char s[30];
-          convert_date (de.mtime, s, sizeof (s));
-          compat_printf ("%c %8ld %s %s\n", get_type_char ((uint32_t)de.type), 
-            de.size, s, de.name); 
-          }
-        else
-          {
-          compat_printf ("%s", de.name); 
-          int pad = max_namelen - (int)strlen (de.name);
-          for (int j = 0; j < pad; j++) compat_printf (" ");
-          across++;
-          if (across >= max_across)
-            {
-            compat_printf ("\n");
-            across = 0;
-            }
-          }
-        }
-      if (across != 0) compat_printf ("\n");
-      sys_close (fd2);
+      if (ret == 0 && self->recursive)
+        ret = ls_recurse (self, path, &snap, depth);
+      ls_snapshot_free (&snap);
       }
     else
       {
-      char s[30];
-      convert_date (sb.st_mtime, s, sizeof (s));
-      compat_printf ("%c %8ld %s %s\n", get_type_char ((uint32_t)sb.st_mode), 
-          sb.st_size, s, path);
-      } 
-    sys_close (fd);
+      char line[LS_LONG_MAX + PATH_MAX];
+      ls_write_long (line, (int)sb.st_mode, (int32_t)sb.st_size,
+        sb.st_mtime, path);
+      sys_close (fd);
+      }
     }
   else
-    {
-    Error ret = -fd;
-    compat_printf_stderr ("%s: %s: %s\n", argv0, abspath, strerror (ret));
-    }
+    ret = -fd;
+
+  if (ret == EINTR) return ret;
+  if (ret)
+    compat_printf_stderr ("%s: %s: %s\n", self->argv0, abspath,
+      strerror (ret));
+  return 0;
   }
 
 /*=========================================================================
-  show_usage 
+  show_usage
 =========================================================================*/
 static void show_usage (const char *argv0)
   {
-  compat_printf ("Usage: %s [-l] [drive, path, file]\n", argv0);
+  compat_printf ("Usage: %s [-lrRSt] [drive, path, file]\n", argv0);
   compat_printf ("             -l    long listing\n", argv0);
+  compat_printf ("             -r    reverse the order\n", argv0);
+  compat_printf ("             -R    list subdirectories too\n", argv0);
+  compat_printf ("             -S    sort by size, largest first\n", argv0);
+  compat_printf ("             -t    sort by time, newest first\n", argv0);
   compat_printf ("List files or directories\n", argv0);
   }
 
@@ -176,14 +414,29 @@ Error shell_cmd_ls (int argc, char **argv)
   int opt;
   optind = 0;
   BOOL usage = FALSE;
-  BOOL fmt_long = FALSE;
+  Ls ls;
+  memset (&ls, 0, sizeof (ls));
+  ls.argv0 = argv[0];
+  ls.sort = LS_SORT_NAME;
 
-  while ((opt = getopt (argc, argv, "hl")) != -1)
+  while ((opt = getopt (argc, argv, "hlrRSt")) != -1)
     {
     switch (opt)
       {
       case 'l':
-        fmt_long = TRUE;
+        ls.fmt_long = TRUE;
+        break;
+      case 'r':
+        ls.reverse = TRUE;
+        break;
+      case 'R':
+        ls.recursive = TRUE;
+        break;
+      case 'S':
+        ls.sort = LS_SORT_SIZE;
+        break;
+      case 't':
+        ls.sort = LS_SORT_TIME;
         break;
       case 'h':
         usage = TRUE;
@@ -196,19 +449,36 @@ Error shell_cmd_ls (int argc, char **argv)
 
   if (ret == 0)
     {
+    uint32_t flags;
+    ls.width = 80;
+    if (sys_devctl (1, DC_GET_GEN_FLAGS, (intptr_t)&flags) == 0)
+      {
+      if (flags & DC_FLAG_ISTTY)
+        ls.isatty = TRUE;
+      }
+    if (ls.isatty)
+      {
+      DevCtlTermProps props;
+      if (sys_devctl (1, DC_TERM_GET_PROPS, (intptr_t)&props) == 0)
+        {
+        ls.width = props.cols;
+        }
+      }
+
     if (argc - optind == 0)
       {
       Process *p = process_get_current();
       path = process_get_cwd (p);
-      do_path (argv[0], path, fmt_long);
+      if (ls.recursive) compat_printf ("%s:\n", path);
+      ret = do_path (&ls, path, 0);
       }
     else
       {
-      for (int i = optind; i < argc; i++)
+      for (int i = optind; i < argc && ret != EINTR; i++)
         {
         path = argv[i];
         compat_printf ("%s:\n", path);
-        do_path (argv[0], path, fmt_long);
+        ret = do_path (&ls, path, 0);
         }
       }
     }
@@ -216,5 +486,3 @@ Error shell_cmd_ls (int argc, char **argv)
   if (usage) ret = 0;
   return ret;
   }
-
-
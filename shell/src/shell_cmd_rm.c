@@ -25,12 +25,69 @@
 #include <klib/string.h>
 #include <compat/compat.h>
 
+typedef struct _Rm
+  {
+  const char *argv0;
+  BOOL verbose;
+  Error error;
+  } Rm;
+
 /*=========================================================================
   show_usage 
 =========================================================================*/
 static void show_usage (const char *argv0)
   {
-  compat_printf ("Usage: %s {files...}\n", argv0);
+  compat_printf ("Usage: %s [-rv] {files...}\n", argv0);
+  compat_printf ("    -r     remove directories and their contents\n");
+  compat_printf ("    -v     verbose\n");
+  }
+
+/*=========================================================================
+  rm_walk_fn
+  Files are removed as they are found, and directories after their
+  contents
+=========================================================================*/
+static int rm_walk_fn (const FsutilWalkEntry *entry, int event, Error error,
+        void *data)
+  {
+  Rm *self = data;
+  if (event == FSUTIL_WALK_DIR_PRE) return FSUTIL_WALK_CONTINUE;
+  if (event == FSUTIL_WALK_FILE || event == FSUTIL_WALK_DIR_POST)
+    {
+    if (self->verbose) compat_printf ("Deleting '%s'\n", entry->path);
+    if (event == FSUTIL_WALK_FILE)
+      error = sys_unlink (entry->path);
+    else
+      error = sys_rmdir (entry->path);
+    }
+  if (error)
+    {
+    compat_printf_stderr ("%s: %s: %s\n", self->argv0, entry->path,
+      strerror (error));
+    self->error = error;
+    }
+  return FSUTIL_WALK_CONTINUE;
+  }
+
+/*=========================================================================
+  rm_tree 
+=========================================================================*/
+static Error rm_tree (const char *argv0, const char *path, bool verbose)
+  {
+  Rm rm;
+  rm.argv0 = argv0;
+  rm.verbose = verbose;
+  rm.error = 0;
+  FsutilWalkStats stats;
+  Error ret = fsutil_walk (path, -1, rm_walk_fn, &rm, &stats);
+  if (ret)
+    compat_printf_stderr ("%s: %s: %s\n", argv0, path, strerror (ret));
+  else
+    ret = rm.error;
+  if (verbose)
+    compat_printf ("%s: %ld opens, %ld entries read, %d open at most\n",
+      path, stats.opens, stats.entries, stats.max_open);
+  return ret;
   }
 
 /*=========================================================================
@@ -64,10 +121,14 @@ Error shell_cmd_rm (int argc, char **argv)
   optind = 0;
   BOOL usage = FALSE;
   BOOL verbose = FALSE;
-  while ((opt = getopt (argc, argv, "hv")) != -1)
+  BOOL recursive = FALSE;
+  while ((opt = getopt (argc, argv, "hrv")) != -1)
     {
     switch (opt)
       {
+      case 'r':
+        recursive = TRUE;
+        break;
       case 'v':
         verbose = TRUE;
         break;
@@ -92,7 +153,10 @@ Error shell_cmd_rm (int argc, char **argv)
       for (int i = optind; i < argc; i++)
         {
         const char *path = argv[i];
-        ret = rm_path (argv[0], path, verbose);
+        if (recursive)
+          ret = rm_tree (argv[0], path, verbose);
+        else
+          ret = rm_path (argv[0], path, verbose);
         }
       }
     }
@@ -0,0 +1,660 @@
+/*============================================================================
+ *  shell/shell_cmd_sort.c
+ *
+ *  An external merge sort, which can sort files much larger than the
+ *  heap, in a fixed amount of memory. Input is read straight into an
+ *  arena, with the lines' text growing up from the bottom, and pointers
+ *  to them growing down from the top. When the arena is full, the
+ *  pointers are sorted, and the lines written out as a sorted run, in a
+ *  file in $TMP. At the end, the runs are merged, using a heap to find
+ *  the next line. If there are too many runs to give each a reasonable
+ *  buffer, groups of them are merged into longer runs first. If all the
+ *  input fits in the arena, it is sorted there, and no files are used.
+ *
+ * Copyright (c)2023 Kevin Boone, GPL v3.0
+ * ==========================================================================*/
+
+/*============================================================================
+ * ==========================================================================*/
+
+#define _GNU_SOURCE
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include <ctype.h>
+#include <pico/stdlib.h>
+#include <stdio.h>
+#include <sys/types.h>
+#include <fcntl.h>
+#include <sys/error.h>
+#include <errno.h>
+#include <getopt.h>
+#include <sys/limits.h>
+#include <sys/process.h>
+#include <shell/shell.h>
+#include <klib/fastmem.h>
+#include <sys/syscalls.h>
+#include <compat/compat.h>
+
+// Memory that sort may use, unless -S says otherwise. The arena, and
+//   all the buffers for merging, come out of this.
+#ifndef SORT_MEM_BUDGET
+#define SORT_MEM_BUDGET 32768
+#endif
+
+// Smallest budget that -S will accept
+#define SORT_MIN_BUDGET 4096
+
+// Size of a read or write
+#define SORT_BLOCK 512
+
+// When there is less room than this in the arena, it's time to write a
+//   run, rather than do a short read
+#define SORT_MIN_READ 64
+
+typedef struct _Sort
+  {
+  const char *argv0;
+  BOOL reverse;
+  BOOL numeric;
+  BOOL unique;
+  int key; // The field that the key starts at, counting from 1, or 0
+  int budget;
+  const char *tmp;
+  // Runs are numbered; those from first_run to next_run - 1 are still
+  //   to be merged
+  int first_run;
+  int next_run;
+  Error error;
+  } Sort;
+
+typedef struct _SortWriter
+  {
+  int fd;
+  char *buff;
+  int size;
+  int len;
+  // A copy of the last line written, for -u
+  char *last;
+  int last_size;
+  BOOL have_last;
+  } SortWriter;
+
+typedef struct _SortReader
+  {
+  int fd;
+  char *buff;
+  int size;
+  int start;
+  int end;
+  BOOL eof;
+  char *line; // The current line, with a terminating zero
+  } SortReader;
+
+/*=========================================================================
+  show_usage
+=========================================================================*/
+static void show_usage (const char *argv0)
+  {
+  compat_printf ("Usage: %s [options] [files...]\n", argv0);
+  compat_printf ("Sorts lines of text.\n", argv0);
+  compat_printf ("  -k N: sort on the line from field N\n", argv0);
+  compat_printf ("  -n: compare numbers\n", argv0);
+  compat_printf ("  -r: reverse the order\n", argv0);
+  compat_printf ("  -S bytes: memory to use (default %d)\n",
+    SORT_MEM_BUDGET);
+  compat_printf ("  -u: show only the first of equal lines\n", argv0);
+  compat_printf ("If no files are specified, read from stdin\n", argv0);
+  }
+
+/*=========================================================================
+  sort_key
+  The part of line s to compare, which is from the start of field 'key'.
+  Fields are separated by spaces and tabs and, as in POSIX sort, a
+  field includes the blanks in front of it.
+=========================================================================*/
+static const char *sort_key (const Sort *self, const char *s)
+  {
+  if (self->key == 0) return s;
+  for (int f = 1; f < self->key; f++)
+    {
+    while (*s == ' ' || *s == '\t') s++;
+    while (*s && *s != ' ' && *s != '\t') s++;
+    }
+  return s;
+  }
+
+/*=========================================================================
+  sort_compare
+  Compare the keys of two lines. Lines with equal keys are ordered by
+  the whole line, except with -u, where they are the same.
+=========================================================================*/
+static int sort_compare (const Sort *self, const char *a, const char *b)
+  {
+  const char *ka = sort_key (self, a);
+  const char *kb = sort_key (self, b);
+  int r;
+  if (self->numeric)
+    {
+    double x = strtod (ka, NULL);
+    double y = strtod (kb, NULL);
+    r = (x > y) - (x < y);
+    }
+  else
+    r = strcmp (ka, kb);
+  if (r == 0 && !self->unique && (ka != a || kb != b || self->numeric))
+    r = strcmp (a, b);
+  return self->reverse ? -r : r;
+  }
+
+/*=========================================================================
+  sort_qsort_fn
+  Lines that compare equal are kept in the order they are in the arena,
+  which is the order they were read, so that -u keeps the first
+=========================================================================*/
+static int sort_qsort_fn (const void *a, const void *b, void *data)
+  {
+  const char *la = *(char * const *)a;
+  const char *lb = *(char * const *)b;
+  int r = sort_compare (data, la, lb);
+  if (r == 0) r = (la > lb) - (la < lb);
+  return r;
+  }
+
+/*=========================================================================
+  sort_run_name
+=========================================================================*/
+static void sort_run_name (const Sort *self, int run, char *name, int len)
+  {
+  snprintf (name, (size_t)len, "%s/000-sort-%d", self->tmp, run);
+  }
+
+/*=========================================================================
+  sort_flush
+=========================================================================*/
+static void sort_flush (Sort *self, SortWriter *w)
+  {
+  if (w->len > 0 && sys_write (w->fd, w->buff, w->len) != w->len
+       && !self->error)
+    self->error = ENOSPC;
+  w->len = 0;
+  }
+
+/*=========================================================================
+  sort_write_line
+  Write a line and a newline, unless it is the same as the last with -u
+=========================================================================*/
+static void sort_write_line (Sort *self, SortWriter *w, const char *line)
+  {
+  if (self->unique)
+    {
+    if (w->have_last && sort_compare (self, w->last, line) == 0) return;
+    int need = (int)fastmem_strlen (line) + 1;
+    if (need > w->last_size)
+      {
+      char *last = realloc (w->last, (size_t)need);
+      if (!last)
+        {
+        self->error = ENOMEM;
+        return;
+        }
+      w->last = last;
+      w->last_size = need;
+      }
+    memcpy (w->last, line, (size_t)need);
+    w->have_last = TRUE;
+    }
+
+  int len = (int)fastmem_strlen (line);
+  if (w->len + len + 1 > w->size)
+    {
+    sort_flush (self, w);
+    // A line that won't fit in the buffer is written as it is
+    if (len + 1 > w->size)
+      {
+      if (sys_write (w->fd, line, len) != len) self->error = ENOSPC;
+      w->buff[w->len++] = '\n';
+      return;
+      }
+    }
+  memcpy (w->buff + w->len, line, (size_t)len);
+  w->len += len;
+  w->buff[w->len++] = '\n';
+  }
+
+/*=========================================================================
+  sort_writer_init
+  The writer's buffer comes out of the budget. The copy of the last line
+  for -u does not, but is only as big as the longest line.
+=========================================================================*/
+static BOOL sort_writer_init (Sort *self, SortWriter *w, int fd, int size)
+  {
+  memset (w, 0, sizeof (SortWriter));
+  w->fd = fd;
+  w->size = size;
+  w->buff = malloc ((size_t)size);
+  if (!w->buff) self->error = ENOMEM;
+  return w->buff != NULL;
+  }
+
+/*=========================================================================
+  sort_writer_close
+=========================================================================*/
+static void sort_writer_close (Sort *self, SortWriter *w)
+  {
+  if (w->buff) sort_flush (self, w);
+  free (w->buff);
+  free (w->last);
+  w->buff = NULL;
+  w->last = NULL;
+  }
+
+/*=========================================================================
+  sort_write_lines
+  Sort the lines in the arena, and write them to a new run or, if
+  to_stdout is set, to stdout
+=========================================================================*/
+static void sort_write_lines (Sort *self, char **lines, int nlines,
+        BOOL to_stdout)
+  {
+  qsort_r (lines, (size_t)nlines, sizeof (char *), sort_qsort_fn, self);
+
+  int fd = 1;
+  if (!to_stdout)
+    {
+    char name[PATH_MAX];
+    sort_run_name (self, self->next_run, name, sizeof (name));
+    fd = sys_open (name, O_WRONLY | O_CREAT | O_TRUNC);
+    if (fd < 0)
+      {
+      self->error = -fd;
+      compat_printf_stderr ("%s: %s: %s\n", self->argv0, name,
+        strerror (self->error));
+      return;
+      }
+    self->next_run++;
+    }
+
+  // The writer's buffer is the part of the budget not in the arena
+  SortWriter w;
+  if (sort_writer_init (self, &w, fd, SORT_BLOCK))
+    {
+    for (int i = 0; i < nlines && !self->error; i++)
+      sort_write_line (self, &w, lines[i]);
+    }
+  sort_writer_close (self, &w);
+  if (!to_stdout) sys_close (fd);
+  }
+
+/*=========================================================================
+  sort_make_runs
+  Read all the input into the arena, writing sorted runs when it is full.
+  If everything fits, it is written to stdout.
+=========================================================================*/
+static void sort_make_runs (Sort *self, const int *fds, int nfds)
+  {
+  int size = (self->budget - SORT_BLOCK) & ~(int)(sizeof (char *) - 1);
+  char *arena = malloc ((size_t)size);
+  if (!arena)
+    {
+    self->error = ENOMEM;
+    return;
+    }
+  char **top = (char **)(arena + size);
+  int nlines = 0;
+  int text_end = 0;   // End of the text that has been read
+  int line_start = 0; // Start of the line that has not been finished
+
+  for (int i = 0; i < nfds && !self->error; i++)
+    {
+    for (;;)
+      {
+      // Each byte read might be a newline, which needs a pointer; and
+      //   there must be room for a terminator and pointer at the end
+      int room = (int)((char *)(top - nlines) - (arena + text_end))
+        - (int)sizeof (char *) - 1;
+      int chunk = room / (1 + (int)sizeof (char *));
+      if (chunk > SORT_BLOCK) chunk = SORT_BLOCK;
+      if (chunk < SORT_MIN_READ)
+        {
+        if (nlines == 0)
+          {
+          self->error = E2BIG;
+          compat_printf_stderr ("%s: line too long\n", self->argv0);
+          break;
+          }
+        sort_write_lines (self, top - nlines, nlines, FALSE);
+        if (self->error) break;
+        memmove (arena, arena + line_start, (size_t)(text_end - line_start));
+        text_end -= line_start;
+        line_start = 0;
+        nlines = 0;
+        continue;
+        }
+      int n = sys_read (fds[i], arena + text_end, chunk);
+      if (n <= 0) break;
+      char *p = arena + text_end;
+      char *end = p + n;
+      char *nl;
+      while ((nl = fastmem_memchr (p, '\n', (size_t)(end - p))))
+        {
+        *nl = 0;
+        *(top - ++nlines) = arena + line_start;
+        line_start = (int)(nl + 1 - arena);
+        p = nl + 1;
+        }
+      text_end += n;
+      }
+    // A last line with no newline
+    if (text_end > line_start)
+      {
+      arena[text_end++] = 0;
+      *(top - ++nlines) = arena + line_start;
+      line_start = text_end;
+      }
+    }
+
+  if (!self->error && nlines > 0)
+    {
+    sort_write_lines (self, top - nlines, nlines,
+      self->next_run == self->first_run);
+    }
+  free (arena);
+  }
+
+/*=========================================================================
+  sort_reader_next
+  Move to the next line of a run. Returns FALSE at the end.
+=========================================================================*/
+static BOOL sort_reader_next (Sort *self, SortReader *r)
+  {
+  for (;;)
+    {
+    char *nl = fastmem_memchr (r->buff + r->start, '\n',
+      (size_t)(r->end - r->start));
+    if (nl)
+      {
+      *nl = 0;
+      r->line = r->buff + r->start;
+      r->start = (int)(nl + 1 - r->buff);
+      return TRUE;
+      }
+    if (r->eof)
+      {
+      if (r->end == r->start) return FALSE;
+      r->buff[r->end] = 0;
+      r->line = r->buff + r->start;
+      r->start = r->end;
+      return TRUE;
+      }
+    memmove (r->buff, r->buff + r->start, (size_t)(r->end - r->start));
+    r->end -= r->start;
+    r->start = 0;
+    // Room for a terminator is kept at the end. A line longer than the
+    //   buffer makes it grow.
+    if (r->end >= r->size - 1)
+      {
+      char *buff = realloc (r->buff, (size_t)r->size * 2);
+      if (!buff)
+        {
+        self->error = ENOMEM;
+        return FALSE;
+        }
+      r->buff = buff;
+      r->size *= 2;
+      }
+    int n = sys_read (r->fd, r->buff + r->end, r->size - 1 - r->end);
+    if (n <= 0)
+      r->eof = TRUE;
+    else
+      r->end += n;
+    }
+  }
+
+/*=========================================================================
+  sort_heap_less
+  TRUE if reader a's line comes before reader b's. Lines that compare
+  equal are taken from the earlier run first.
+=========================================================================*/
+static BOOL sort_heap_less (const Sort *self, const SortReader *readers,
+        int a, int b)
+  {
+  int r = sort_compare (self, readers[a].line, readers[b].line);
+  return r < 0 || (r == 0 && a < b);
+  }
+
+/*=========================================================================
+  sort_heap_down
+=========================================================================*/
+static void sort_heap_down (const Sort *self, const SortReader *readers,
+        int *heap, int n, int i)
+  {
+  for (;;)
+    {
+    int least = i;
+    int l = 2 * i + 1;
+    int r = l + 1;
+    if (l < n && sort_heap_less (self, readers, heap[l], heap[least]))
+      least = l;
+    if (r < n && sort_heap_less (self, readers, heap[r], heap[least]))
+      least = r;
+    if (least == i) return;
+    int t = heap[i];
+    heap[i] = heap[least];
+    heap[least] = t;
+    i = least;
+    }
+  }
+
+/*=========================================================================
+  sort_merge
+  Merge the next k runs into a new run or, if to_stdout is set, to
+  stdout. The budget is shared equally by the k runs and the output.
+=========================================================================*/
+static void sort_merge (Sort *self, int k, BOOL to_stdout)
+  {
+  int size = self->budget / (k + 1) / SORT_BLOCK * SORT_BLOCK;
+  SortReader *readers = calloc ((size_t)k, sizeof (SortReader));
+  int *heap = malloc ((size_t)k * sizeof (int));
+  char name[PATH_MAX];
+  if (!readers || !heap) self->error = ENOMEM;
+
+  int n = 0;
+  for (int i = 0; i < k && !self->error; i++)
+    {
+    SortReader *r = &readers[i];
+    sort_run_name (self, self->first_run + i, name, sizeof (name));
+    r->fd = sys_open (name, O_RDONLY);
+    r->size = size;
+    r->buff = malloc ((size_t)size);
+    if (r->fd < 0 || !r->buff)
+      self->error = r->fd < 0 ? -r->fd : ENOMEM;
+    else if (sort_reader_next (self, r))
+      heap[n++] = i;
+    }
+
+  int fd = 1;
+  if (!self->error && !to_stdout)
+    {
+    sort_run_name (self, self->next_run, name, sizeof (name));
+    fd = sys_open (name, O_WRONLY | O_CREAT | O_TRUNC);
+    if (fd < 0)
+      self->error = -fd;
+    else
+      self->next_run++;
+    }
+
+  SortWriter w;
+  memset (&w, 0, sizeof (w));
+  if (!self->error && sort_writer_init (self, &w, fd, size))
+    {
+    for (int i = n / 2 - 1; i >= 0; i--)
+      sort_heap_down (self, readers, heap, n, i);
+    while (n > 0 && !self->error)
+      {
+      SortReader *r = &readers[heap[0]];
+      sort_write_line (self, &w, r->line);
+      if (!sort_reader_next (self, r))
+        heap[0] = heap[--n];
+      sort_heap_down (self, readers, heap, n, 0);
+      }
+    }
+  sort_writer_close (self, &w);
+  if (fd > 1) sys_close (fd);
+
+  // The runs that were merged are finished with, whatever happened
+  for (int i = 0; readers && i < k; i++)
+    {
+    if (readers[i].fd > 0) sys_close (readers[i].fd);
+    free (readers[i].buff);
+    sort_run_name (self, self->first_run + i, name, sizeof (name));
+    sys_unlink (name);
+    }
+  self->first_run += k;
+  free (readers);
+  free (heap);
+  }
+
+/*=========================================================================
+  sort_merge_runs
+  Merge the runs in passes, until there are few enough to merge to
+  stdout with a block of buffer each. Each pass merges all the runs of
+  the one before, in groups, so the new runs are in the same order as
+  the input, and lines that compare equal stay in order.
+=========================================================================*/
+static void sort_merge_runs (Sort *self)
+  {
+  int max_k = self->budget / SORT_BLOCK - 1;
+  char name[PATH_MAX];
+  while (!self->error && self->next_run - self->first_run > max_k)
+    {
+    int pass_end = self->next_run;
+    while (!self->error && self->first_run < pass_end)
+      {
+      int k = pass_end - self->first_run;
+      if (k > max_k) k = max_k;
+      if (k > 1)
+        sort_merge (self, k, FALSE);
+      else
+        {
+        // A group of one just moves to the end
+        char new_name[PATH_MAX];
+        sort_run_name (self, self->first_run++, name, sizeof (name));
+        sort_run_name (self, self->next_run++, new_name, sizeof (new_name));
+        int err = sys_rename (name, new_name);
+        if (err) self->error = err;
+        }
+      }
+    }
+  if (!self->error && self->next_run > self->first_run)
+    sort_merge (self, self->next_run - self->first_run, TRUE);
+
+  // Tidy up after an error
+  for (int i = self->first_run; i < self->next_run; i++)
+    {
+    sort_run_name (self, i, name, sizeof (name));
+    sys_unlink (name);
+    }
+  }
+
+/*=========================================================================
+  shell_cmd_sort
+=========================================================================*/
+Error shell_cmd_sort (int argc, char **argv)
+  {
+  Error ret = 0;
+  BOOL usage = FALSE;
+  int opt;
+  Sort sort;
+  memset (&sort, 0, sizeof (sort));
+  sort.argv0 = argv[0];
+  sort.budget = SORT_MEM_BUDGET;
+
+  optind = 0;
+  while ((opt = getopt (argc, argv, "hk:nrS:u")) != -1)
+    {
+    switch (opt)
+      {
+      case 'k':
+        sort.key = atoi (optarg);
+        if (sort.key < 1)
+          {
+          compat_printf_stderr ("%s: bad field: %s\n", argv[0], optarg);
+          ret = EINVAL;
+          }
+        break;
+      case 'n':
+        sort.numeric = TRUE;
+        break;
+      case 'r':
+        sort.reverse = TRUE;
+        break;
+      case 'S':
+        {
+        char *end;
+        long budget = strtol (optarg, &end, 10);
+        if (*end == 'k' || *end == 'K') budget *= 1024;
+        if (budget < SORT_MIN_BUDGET)
+          {
+          compat_printf_stderr ("%s: memory must be at least %d\n",
+            argv[0], SORT_MIN_BUDGET);
+          ret = EINVAL;
+          }
+        sort.budget = (int)budget;
+        }
+        break;
+      case 'u':
+        sort.unique = TRUE;
+        break;
+      case 'h':
+        usage = TRUE;
+        // Fall through
+      default:
+        show_usage (argv[0]);
+        ret = EINVAL;
+      }
+    }
+
+  if (ret == 0)
+    {
+    sort.tmp = process_getenv (process_get_current(), "TMP");
+    if (!sort.tmp) sort.tmp = "/tmp";
+
+    int nfds = argc - optind;
+    int *fds = malloc ((size_t)(nfds > 0 ? nfds : 1) * sizeof (int));
+    if (nfds == 0)
+      {
+      fds[0] = 0;
+      nfds = 1;
+      }
+    else
+      {
+      for (int i = 0; i < nfds && ret == 0; i++)
+        {
+        fds[i] = sys_open (argv[optind + i], O_RDONLY);
+        if (fds[i] < 0)
+          {
+          ret = -fds[i];
+          compat_printf_stderr ("%s: %s: %s\n", argv[0], argv[optind + i],
+            strerror (ret));
+          nfds = i;
+          }
+        }
+      }
+
+    if (ret == 0)
+      {
+      sort_make_runs (&sort, fds, nfds);
+      sort_merge_runs (&sort);
+      ret = sort.error;
+      }
+
+    for (int i = 0; i < nfds; i++)
+      if (fds[i] > 0) sys_close (fds[i]);
+    free (fds);
+    }
+
+  if (usage) ret = 0;
+  return ret;
+  }
+
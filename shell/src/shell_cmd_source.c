@@ -21,76 +21,77 @@
 #include <klib/string.h>
 #include <sys/syscalls.h>
 #include <compat/compat.h>
+#include <klib/fastmem.h>
+
+// Size of a read from the script
+#define SOURCE_BLOCK 512
+
+// Initial size of the buffer, which grows if a line won't fit in it
+#define SOURCE_BUFF_SIZE (2 * SOURCE_BLOCK)
 
 /*=========================================================================
-  shell_cmd_source
+  run_script
+  The script is read in blocks into one buffer, and each line is run
+    where it lies in the buffer. The buffer grows only if a line won't
+    fit in it.
 =========================================================================*/
 static Error run_script (const char *filename, int argc, char **argv)
   {
   int ret = 0;
-  int curr_len = 0;
-  int max_len = 20;
-  int expand = 10;
-  char *line = malloc ((size_t)max_len);
   int fd = sys_open (filename, O_RDONLY);
-  if (fd)
+  if (fd >= 0)
     {
-    int new_argc = argc;
-    char **new_argv = argv;
-
-    /*
-    int new_argc = argc - 1;
-    char **new_argv = malloc ((size_t)(new_argc + 1) * sizeof (char *));
-    for (int i = 0; i < new_argc; i++)
-      new_argv[i] = strdup (argv[i + 1]);
-    new_argv[new_argc] = 0;
-    */
-
-    char buff[8]; // TODO
-    line[0] = 0;
-    curr_len = 0;
-    int n = sys_read (fd, buff, sizeof (buff));
-    while (n > 0)
-       {
-       if (n + curr_len > max_len)
-         {
-         max_len += expand;
-         line = realloc (line, (size_t)max_len); 
-         }
-       strncat (line, buff, (size_t)n);       
-       curr_len += n;
-       line[curr_len] = 0; 
-
-       char *nlpos;
-       while ((nlpos = strchr (line, '\n')) && ret == 0)
-         {
-         int this_len = (int)(nlpos - line);
-         line[this_len] = 0;
-         ret = shell_do_line (line, new_argc, new_argv);
-         memmove (line, line + this_len + 1, (size_t)(curr_len - this_len)); 
-         curr_len -= this_len;
-         }
-
-       n = sys_read (fd, buff, sizeof (buff));
-       }
-  
-    if (curr_len > 0 && line[0] && line[0] != '\n')
-      ret = shell_do_line (line, new_argc, new_argv);
-
-    free (line);
+    int buff_size = SOURCE_BUFF_SIZE;
+    char *buff = malloc ((size_t)buff_size);
+    if (!buff) ret = ENOMEM;
+    int start = 0;
+    int end = 0;
+    int n = 1;
+    while (n > 0 && ret == 0)
+      {
+      if (start > 0)
+        {
+        memmove (buff, buff + start, (size_t)(end - start));
+        end -= start;
+        start = 0;
+        }
+      // Leave room for a terminator after a last line with no newline
+      if (buff_size - end - 1 < SOURCE_BLOCK)
+        {
+        char *new_buff = realloc (buff, (size_t)buff_size * 2);
+        if (!new_buff) break;
+        buff = new_buff;
+        buff_size *= 2;
+        }
+      n = sys_read (fd, buff + end, (buff_size - end - 1) 
+        / SOURCE_BLOCK * SOURCE_BLOCK);
+      if (n > 0)
+        {
+        end += n;
+        char *nlpos;
+        while (ret == 0 && (nlpos = fastmem_memchr (buff + start, '\n', 
+            (size_t)(end - start))))
+          {
+          *nlpos = 0;
+          ret = shell_do_line (buff + start, argc, argv);
+          start = (int)(nlpos - buff) + 1;
+          }
+        }
+      else if (end > start)
+        {
+        buff[end] = 0;
+        ret = shell_do_line (buff + start, argc, argv);
+        }
+      }
+
+    free (buff);
     sys_close (fd);
-
-    /*
-    for (int i = 0; i < new_argc; i++)
-      free (new_argv[i]);
-    free (new_argv);
-    */
     } 
   else
     {
+    ret = -fd;
     compat_printf_stderr ("%s: %s: %s\n", argv[0], filename, 
-       strerror (errno));
-    ret = errno;
+       strerror (ret));
     }
   return ret;
   }
@@ -0,0 +1,174 @@
+/*============================================================================
+ *  shell/shell_cmd_tail.c
+ *
+ *  For a file, tail reads blocks backwards from the end, counting the
+ *  newlines in each one a word at a time, until it has passed enough of
+ *  them. Then it seeks to the start of the first line wanted, and copies
+ *  from there to the end. So only the end of a large file is read. Input
+ *  that can't be seeked, like the console, is read from the start, and
+ *  only the last lines are kept.
+ *
+ * Copyright (c)2023 Kevin Boone, GPL v3.0
+ * ==========================================================================*/
+
+/*============================================================================
+ * ==========================================================================*/
+
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include <ctype.h>
+#include <pico/stdlib.h>
+#include <stdio.h>
+#include <sys/types.h>
+#include <sys/stat.h>
+#include <sys/error.h>
+#include <errno.h>
+#include <shell/shell.h>
+#include <shell/shell_reader.h>
+#include <klib/fastmem.h>
+#include <sys/syscalls.h>
+
+/*=========================================================================
+  tail_read_at
+  Read len bytes from offset into the reader's buffer
+=========================================================================*/
+static Error tail_read_at (ShellReader *reader, int32_t offset, int len)
+  {
+  int32_t r = sys_lseek (reader->fd, offset, SEEK_SET);
+  if (r < 0) return -r;
+  int got = 0;
+  while (got < len)
+    {
+    int n = sys_read (reader->fd, reader->buff + got, len - got);
+    if (n < 0) return -n;
+    if (n == 0) return EIO;
+    got += n;
+    }
+  return 0;
+  }
+
+/*=========================================================================
+  tail_find_start
+  Scan the file backwards from size, a buffer at a time, to find the
+  offset of the first of the last 'lines' lines. The buffers are
+  aligned on multiples of the buffer size, so that every read but the
+  first is of whole sectors.
+=========================================================================*/
+static Error tail_find_start (ShellReader *reader, int32_t size, long lines,
+        int32_t *offset)
+  {
+  int32_t pos = size;
+  BOOL at_end = TRUE;
+  *offset = 0;
+  while (pos > 0)
+    {
+    int32_t block_start = (pos - 1) / reader->size * reader->size;
+    int len = (int)(pos - block_start);
+    Error ret = tail_read_at (reader, block_start, len);
+    if (ret) return ret;
+    // The newline at the end of the file ends the last line; it does not
+    //   start another
+    if (at_end && reader->buff[len - 1] == '\n') len--;
+    at_end = FALSE;
+    long count = (long)fastmem_count_byte (reader->buff, '\n', (size_t)len);
+    if (count >= lines)
+      {
+      for (int i = len - 1; i >= 0; i--)
+        {
+        if (reader->buff[i] == '\n' && --lines == 0)
+          {
+          *offset = block_start + i + 1;
+          return 0;
+          }
+        }
+      }
+    lines -= count;
+    pos = block_start;
+    }
+  return 0;
+  }
+
+/*=========================================================================
+  tail_drop
+  Drop whole lines from the front of the reader's buffer, until there
+  are no more than 'keep' newlines in it
+=========================================================================*/
+static void tail_drop (ShellReader *reader, long *newlines, long keep)
+  {
+  while (*newlines > keep)
+    {
+    const char *p = reader->buff + reader->start;
+    const char *nl = fastmem_memchr (p, '\n',
+      (size_t)(reader->end - reader->start));
+    reader->start += (int)(nl - p) + 1;
+    (*newlines)--;
+    }
+  }
+
+/*=========================================================================
+  tail_stream
+  Read the whole of the input, keeping only the last lines
+=========================================================================*/
+static Error tail_stream (ShellReader *reader, long lines)
+  {
+  long newlines = 0;
+  int n;
+  while ((n = shell_reader_fill (reader)) > 0)
+    {
+    newlines += (long)fastmem_count_byte (reader->buff + reader->end - n,
+      '\n', (size_t)n);
+    tail_drop (reader, &newlines, lines);
+    }
+  if (n < 0) return -n;
+  // A last line with no newline is one of the lines to keep
+  if (reader->end > reader->start && reader->buff[reader->end - 1] != '\n')
+    tail_drop (reader, &newlines, lines - 1);
+  return shell_reader_write (reader->buff + reader->start,
+    reader->end - reader->start);
+  }
+
+/*=========================================================================
+  tail_fd
+=========================================================================*/
+static Error tail_fd (int fd, long lines)
+  {
+  if (lines <= 0) return 0;
+  ShellReader reader;
+  Error ret = shell_reader_init (&reader, fd, SHELL_READER_SIZE);
+  if (ret) return ret;
+
+  struct stat sb;
+  if (sys_fstat (fd, &sb) == 0 && (sb.st_mode & S_IFMT) == S_IFREG)
+    {
+    int32_t offset;
+    ret = tail_find_start (&reader, (int32_t)sb.st_size, lines, &offset);
+    if (ret == 0)
+      {
+      int32_t r = sys_lseek (fd, offset, SEEK_SET);
+      if (r < 0) ret = -r;
+      }
+    int n = 0;
+    while (ret == 0 && (n = shell_reader_fill (&reader)) > 0)
+      {
+      ret = shell_reader_write (reader.buff + reader.start, n);
+      reader.start = reader.end;
+      }
+    if (ret == 0 && n < 0) ret = -n;
+    }
+  else
+    ret = tail_stream (&reader, lines);
+
+  shell_reader_free (&reader);
+  return ret;
+  }
+
+/*=========================================================================
+  shell_cmd_tail
+=========================================================================*/
+Error shell_cmd_tail (int argc, char **argv)
+  {
+  return shell_reader_lines_cmd (argc, argv,
+    "Shows the last lines of files.", tail_fd);
+  }
+
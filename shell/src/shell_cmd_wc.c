@@ -0,0 +1,191 @@
+/*============================================================================
+ *  shell/shell_cmd_wc.c
+ *
+ *  Lines are counted a word at a time, with fastmem_count_byte(), on
+ *  blocks of the file, without looking for line boundaries. Only
+ *  counting words needs a loop over the bytes.
+ *
+ * Copyright (c)2023 Kevin Boone, GPL v3.0
+ * ==========================================================================*/
+
+/*============================================================================
+ * ==========================================================================*/
+
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include <ctype.h>
+#include <pico/stdlib.h>
+#include <stdio.h>
+#include <sys/types.h>
+#include <fcntl.h>
+#include <sys/error.h>
+#include <errno.h>
+#include <getopt.h>
+#include <shell/shell.h>
+#include <shell/shell_reader.h>
+#include <klib/fastmem.h>
+#include <sys/syscalls.h>
+#include <sys/fsutil.h>
+#include <compat/compat.h>
+
+typedef struct _WcCounts
+  {
+  long lines;
+  long words;
+  long bytes;
+  } WcCounts;
+
+typedef struct _Wc
+  {
+  BOOL show_lines;
+  BOOL show_words;
+  BOOL show_bytes;
+  WcCounts total;
+  } Wc;
+
+/*=========================================================================
+  show_usage
+=========================================================================*/
+static void show_usage (const char *argv0)
+  {
+  compat_printf ("Usage: %s [options] [files...]\n", argv0);
+  compat_printf ("Counts lines, words, and bytes.\n", argv0);
+  compat_printf ("  -c: show byte count\n", argv0);
+  compat_printf ("  -l: show line count\n", argv0);
+  compat_printf ("  -w: show word count\n", argv0);
+  compat_printf ("If no files are specified, read from stdin\n", argv0);
+  }
+
+/*=========================================================================
+  wc_show
+=========================================================================*/
+static void wc_show (const Wc *self, const WcCounts *counts,
+        const char *name)
+  {
+  if (self->show_lines) compat_printf ("%7ld ", counts->lines);
+  if (self->show_words) compat_printf ("%7ld ", counts->words);
+  if (self->show_bytes) compat_printf ("%7ld ", counts->bytes);
+  compat_printf ("%s\n", name ? name : "");
+  }
+
+/*=========================================================================
+  wc_fd
+=========================================================================*/
+static Error wc_fd (Wc *self, int fd, const char *name)
+  {
+  ShellReader reader;
+  Error ret = shell_reader_init (&reader, fd, SHELL_READER_SIZE);
+  if (ret) return ret;
+
+  WcCounts counts;
+  memset (&counts, 0, sizeof (counts));
+  BOOL in_word = FALSE;
+  int n;
+  while ((n = shell_reader_fill (&reader)) > 0)
+    {
+    const char *p = reader.buff + reader.start;
+    counts.bytes += n;
+    counts.lines += (long)fastmem_count_byte (p, '\n', (size_t)n);
+    if (self->show_words)
+      {
+      for (int i = 0; i < n; i++)
+        {
+        BOOL space = isspace ((uint8_t)p[i]) != 0;
+        if (!space && !in_word) counts.words++;
+        in_word = !space;
+        }
+      }
+    reader.start = reader.end;
+    }
+  if (n < 0) ret = -n;
+  shell_reader_free (&reader);
+
+  wc_show (self, &counts, name);
+  self->total.lines += counts.lines;
+  self->total.words += counts.words;
+  self->total.bytes += counts.bytes;
+  return ret;
+  }
+
+/*=========================================================================
+  shell_cmd_wc
+=========================================================================*/
+Error shell_cmd_wc (int argc, char **argv)
+  {
+  int ret = 0;
+  BOOL usage = FALSE;
+  Wc wc;
+  memset (&wc, 0, sizeof (wc));
+
+  optind = 0;
+  int opt;
+  while ((opt = getopt (argc, argv, "clwh")) != -1)
+    {
+    switch (opt)
+      {
+      case 'c':
+        wc.show_bytes = TRUE;
+        break;
+      case 'l':
+        wc.show_lines = TRUE;
+        break;
+      case 'w':
+        wc.show_words = TRUE;
+        break;
+      case 'h':
+        usage = TRUE;
+        // Fall through
+      default:
+        show_usage (argv[0]);
+        ret = EINVAL;
+      }
+    }
+
+  if (ret == 0)
+    {
+    if (!wc.show_lines && !wc.show_words && !wc.show_bytes)
+      {
+      wc.show_lines = TRUE;
+      wc.show_words = TRUE;
+      wc.show_bytes = TRUE;
+      }
+    if (argc == optind)
+      {
+      ret = wc_fd (&wc, 0, NULL); // STDIN
+      }
+    else
+      {
+      for (int i = optind; i < argc && ret == 0; i++)
+        {
+        if (fsutil_is_directory (argv[i]))
+          {
+          ret = EISDIR;
+          compat_printf_stderr ("%s: %s: %s\n", argv[0], argv[i],
+            strerror (ret));
+          }
+        else
+          {
+          int fd = sys_open (argv[i], O_RDONLY);
+          if (fd >= 0)
+            {
+            ret = wc_fd (&wc, fd, argv[i]);
+            sys_close (fd);
+            }
+          else
+            {
+            ret = -fd;
+            compat_printf_stderr ("%s: %s: %s\n", argv[0], argv[i],
+               strerror (ret));
+            }
+          }
+        }
+      if (ret == 0 && argc - optind > 1)
+        wc_show (&wc, &wc.total, "total");
+      }
+    }
+
+  if (usage) ret = 0;
+  return ret;
+  }
+
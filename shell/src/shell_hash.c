@@ -0,0 +1,231 @@
+/*============================================================================
+ *  shell/shell_hash.c
+ *
+ *  A cache of resolved command names, like 'hash' in a POSIX shell.
+ *  Searching PATH means opening a file in each PATH directory in turn,
+ *  and on an SD card that is slow. So the result of each search --
+ *  including a failed search -- is kept until PATH changes, or until
+ *  something is created in, or removed from, one of the PATH directories.
+ *
+ * Copyright (c)2023 Kevin Boone, GPL v3.0
+ * ==========================================================================*/
+
+/*============================================================================
+ * ==========================================================================*/
+
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include <strings.h>
+#include <pico/stdlib.h>
+#include <stdio.h>
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <sys/error.h>
+#include <errno.h>
+#include <shell/shell_cmd.h>
+#include <shell/shell_hash.h>
+#include <klib/hashmap.h>
+#include <klib/vector.h>
+#include <sys/fsutil.h>
+#include <sys/fsmanager.h>
+#include <sys/process.h>
+#include <sys/syscalls.h>
+#include <compat/compat.h>
+
+// Resolved commands, keyed on the command name
+static HashMap *cache = NULL;
+
+// The PATH that the cache was built for, and its directories made absolute
+static char *hashed_path = NULL;
+static Vector *path_dirs = NULL;
+
+// If PATH has relative entries, the results depend on the working
+//   directory as well
+static char *hashed_cwd = NULL;
+
+/*============================================================================
+ * shell_hash_entry_destroy
+ * ==========================================================================*/
+static void shell_hash_entry_destroy (ShellHashEntry *self)
+  {
+  free (self->name);
+  if (self->path) free (self->path);
+  free (self);
+  }
+
+/*============================================================================
+ * shell_hash_clear
+ * ==========================================================================*/
+void shell_hash_clear (void)
+  {
+  if (cache) hashmap_clear (cache);
+  }
+
+/*============================================================================
+ * shell_hash_fs_changed
+ * Called by the filesystem manager whenever a directory entry is created
+ * or removed. If it's in a PATH directory, any cached result might now
+ * be wrong.
+ * ==========================================================================*/
+static void shell_hash_fs_changed (const char *abspath)
+  {
+  if (!path_dirs || !cache || hashmap_size (cache) == 0) return;
+  char dir[PATH_MAX];
+  fsutil_get_dir (abspath, dir, PATH_MAX);
+  int n = vector_length (path_dirs);
+  for (int i = 0; i < n; i++)
+    {
+    // FAT filenames are case-insensitive
+    if (strcasecmp (dir, vector_get (path_dirs, i)) == 0)
+      {
+      shell_hash_clear ();
+      return;
+      }
+    }
+  }
+
+/*============================================================================
+ * shell_hash_init
+ * ==========================================================================*/
+void shell_hash_init (void)
+  {
+  if (!cache)
+    cache = hashmap_create_strings (FALSE,
+      (HashMapItemFreeFn)shell_hash_entry_destroy);
+  fsmanager_set_change_callback (shell_hash_fs_changed);
+  }
+
+/*============================================================================
+ * shell_hash_check_path
+ * Throw away the cache if PATH, or the working directory that
+ * relative PATH entries are resolved against, has changed.
+ * ==========================================================================*/
+static void shell_hash_check_path (void)
+  {
+  Process *p = process_get_current();
+  const char *path = process_getenv (p, "PATH");
+  if (!path) path = "";
+  const char *cwd = process_get_cwd (p);
+
+  if (hashed_path && strcmp (path, hashed_path) == 0
+       && (!hashed_cwd || strcmp (cwd, hashed_cwd) == 0))
+    return;
+
+  shell_hash_clear ();
+  if (hashed_path) free (hashed_path);
+  if (hashed_cwd) free (hashed_cwd);
+  if (path_dirs) vector_destroy (path_dirs);
+  hashed_path = strdup (path);
+  hashed_cwd = NULL;
+  path_dirs = vector_create_strings ();
+
+  char *path2 = strdup (path);
+  char *tok = strtok (path2, ";");
+  while (tok)
+    {
+    char abs[PATH_MAX];
+    if (fsutil_make_abs_path (tok, abs, PATH_MAX))
+      vector_append (path_dirs, strdup (abs));
+    if (tok[0] && tok[1] != ':' && tok[0] != '/' && !hashed_cwd)
+      hashed_cwd = strdup (cwd);
+    tok = strtok (NULL, ";");
+    }
+  free (path2);
+  }
+
+/*============================================================================
+ * shell_hash_is_executable
+ * This is the same test as sys_access() followed by fsutil_is_regular(),
+ * but with one open instead of two.
+ * ==========================================================================*/
+static bool shell_hash_is_executable (const char *path)
+  {
+  bool ret = false;
+  int fd = sys_open (path, O_RDONLY);
+  if (fd >= 0)
+    {
+    struct stat sb;
+    if (sys_fstat (fd, &sb) == 0)
+      ret = ((sb.st_mode & S_IFMT) == S_IFREG);
+    sys_close (fd);
+    }
+  return ret;
+  }
+
+/*============================================================================
+ * shell_hash_resolve
+ * External commands take precedence over built-ins, so that a built-in
+ * can be replaced by a better program.
+ * ==========================================================================*/
+static ShellHashEntry *shell_hash_resolve (const char *name)
+  {
+  ShellHashEntry *self = malloc (sizeof (ShellHashEntry));
+  memset (self, 0, sizeof (ShellHashEntry));
+  self->name = strdup (name);
+  self->type = SHELL_HASH_MISSING;
+
+  int n = vector_length (path_dirs);
+  for (int i = 0; i < n && self->type == SHELL_HASH_MISSING; i++)
+    {
+    char try[PATH_MAX];
+    fsutil_join_path (vector_get (path_dirs, i), name, try, PATH_MAX);
+    if (shell_hash_is_executable (try))
+      {
+      self->type = SHELL_HASH_EXTERNAL;
+      self->path = strdup (try);
+      }
+    }
+
+  if (self->type == SHELL_HASH_MISSING)
+    {
+    self->fn = shell_cmd_find_builtin (name);
+    if (self->fn) self->type = SHELL_HASH_BUILTIN;
+    }
+
+  return self;
+  }
+
+/*============================================================================
+ * shell_hash_lookup
+ * ==========================================================================*/
+const ShellHashEntry *shell_hash_lookup (const char *name)
+  {
+  if (!cache) shell_hash_init ();
+  shell_hash_check_path ();
+
+  ShellHashEntry *e = hashmap_get (cache, name);
+  if (!e)
+    {
+    e = shell_hash_resolve (name);
+    hashmap_put (cache, e->name, e);
+    }
+  e->hits++;
+  return e;
+  }
+
+/*============================================================================
+ * shell_hash_dump
+ * ==========================================================================*/
+void shell_hash_dump (void)
+  {
+  if (!cache) return;
+  int pos = 0;
+  void *value;
+  while (hashmap_iterate (cache, &pos, NULL, &value))
+    {
+    const ShellHashEntry *e = value;
+    switch (e->type)
+      {
+      case SHELL_HASH_EXTERNAL:
+        compat_printf ("%4d %s\n", e->hits, e->path);
+        break;
+      case SHELL_HASH_BUILTIN:
+        compat_printf ("%4d %s (built-in)\n", e->hits, e->name);
+        break;
+      default:
+        compat_printf ("%4d %s (not found)\n", e->hits, e->name);
+      }
+    }
+  }
+
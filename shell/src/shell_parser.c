@@ -19,7 +19,7 @@
 #include <errno.h>
 #include <shell/shell_parser.h>
 #include <klib/string.h>
-#include <klib/list.h>
+#include <klib/vector.h>
 #include <compat/compat.h>
 
 /*============================================================================
@@ -67,7 +67,7 @@ void node_destroy (Node *self)
   {
   if (self->val1) free (self->val1);
   if (self->val2) free (self->val2);
-  if (self->nodes) list_destroy (self->nodes);
+  if (self->nodes) vector_destroy (self->nodes);
   free (self);
   }
 
@@ -78,7 +78,7 @@ Node *node_create (int type)
   {
   Node *self = malloc (sizeof (Node));
   memset (self, 0, sizeof (Node));
-  self->nodes = list_create ((ListItemFreeFn)node_destroy);
+  self->nodes = vector_create ((VectorItemFreeFn)node_destroy);
   self->type = type;
   return self;
   };
@@ -108,10 +108,10 @@ void node_dump (const Node *self, int level)
   printf ("%s val1=%s val2=%s\n", name, self->val1, self->val2);
   if (self->nodes)
     {
-    int l = list_length (self->nodes);
+    int l = vector_length (self->nodes);
     for (int i = 0; i < l; i++)
       {
-      node_dump (list_get (self->nodes, i), level + 3);
+      node_dump (vector_get (self->nodes, i), level + 3);
       }
     }
   }
@@ -124,7 +124,7 @@ void node_dump (const Node *self, int level)
  * ==========================================================================*/
 struct _ShellParser
   {
-  const List *tokens;
+  const Vector *tokens;
   int pos;
   int length;
   };
@@ -132,12 +132,12 @@ struct _ShellParser
 /*============================================================================
  * shellparser_new 
  * ==========================================================================*/
-ShellParser *shellparser_new (const List *tokens)
+ShellParser *shellparser_new (const Vector *tokens)
   {
   ShellParser *self = malloc (sizeof (ShellParser));
   self->tokens = tokens;
   self->pos = 0;
-  self->length = list_length (tokens);
+  self->length = vector_length (tokens);
   return self;
   }
 
@@ -146,7 +146,7 @@ ShellParser *shellparser_new (const List *tokens)
  * ==========================================================================*/
 const Token *shellparser_next (ShellParser *self)
   {
-  Token *t = list_get (self->tokens, self->pos);
+  Token *t = vector_get (self->tokens, self->pos);
   if (self->pos < self->length - 1)
     {
     self->pos++;
@@ -182,7 +182,7 @@ Node *shellparser_arglist (ShellParser *self)
       old_t = self->pos;
       Node *n1 = node_create (NODE_ARG);
       n1->val1 = strdup (t1->val);
-      list_append (n->nodes, n1);
+      vector_append (n->nodes, n1);
 
       t1 = shellparser_next (self);
       if (t1->type == TOK_ARG)
@@ -220,7 +220,7 @@ Node *shellparser_redirlist (ShellParser *self)
       Node *n1 = node_create (NODE_REDIR);
       n1->val1 = strdup (t1->val);
       n1->val2 = strdup (t2->val);
-      list_append (n->nodes, n1);
+      vector_append (n->nodes, n1);
 
       t1 = shellparser_next (self);
       t2 = shellparser_next (self);
@@ -256,7 +256,7 @@ Node *shellparser_assignlist (ShellParser *self)
       old_t = self->pos;
       Node *n1 = node_create (NODE_ASSIGN);
       n1->val1 = strdup (t1->val);
-      list_append (n->nodes, n1);
+      vector_append (n->nodes, n1);
 
       t1 = shellparser_next (self);
       if (t1->type == TOK_ARG && strchr (t1->val, '='))
@@ -286,8 +286,8 @@ Node *shellparser_arglist_with_redirlist (ShellParser *self)
     if (n2)
       {
       Node *n3 = node_create (NODE_ARGLIST_WITH_REDIRLIST); 
-      list_append (n3->nodes, n);
-      list_append (n3->nodes, n2);
+      vector_append (n3->nodes, n);
+      vector_append (n3->nodes, n2);
       return n3;
       }
     else 
@@ -319,7 +319,7 @@ Node *shellparser_exec (ShellParser *self)
   if (n)
     {
     Node *n2 = node_create (NODE_EXEC);
-    list_append (n2->nodes, n);
+    vector_append (n2->nodes, n);
     return n2;
     }
 
@@ -342,8 +342,8 @@ Node *shellparser_assignlist_exec (ShellParser *self)
     if (n2)
       {
       Node *n3 = node_create (NODE_ASSIGNLIST_EXEC); 
-      list_append (n3->nodes, n);
-      list_append (n3->nodes, n2);
+      vector_append (n3->nodes, n);
+      vector_append (n3->nodes, n2);
       return n3;
       }
     else 
@@ -366,7 +366,7 @@ Node *shellparser_statement (ShellParser *self)
   if (n)
     {
     Node *n2 = node_create (NODE_STATEMENT);
-    list_append (n2->nodes, n);
+    vector_append (n2->nodes, n);
     return n2;
     }
 
@@ -376,7 +376,7 @@ Node *shellparser_statement (ShellParser *self)
   if (n)
     {
     Node *n2 = node_create (NODE_STATEMENT);
-    list_append (n2->nodes, n);
+    vector_append (n2->nodes, n);
     return n2;
     }
 
@@ -384,7 +384,7 @@ Node *shellparser_statement (ShellParser *self)
   if (n)
     {
     Node *n2 = node_create (NODE_STATEMENT);
-    list_append (n2->nodes, n);
+    vector_append (n2->nodes, n);
     return n2;
     }
 
@@ -410,7 +410,7 @@ Node *shellparser_pipedlist (ShellParser *self)
     BOOL is_statement;
     do
       {
-      list_append (n2->nodes, n1);
+      vector_append (n2->nodes, n1);
       is_statement = FALSE;
 
       old_t = self->pos;
@@ -0,0 +1,184 @@
+/*============================================================================
+ *  shell/shell_reader.c
+ *
+ *  Block reading for the text commands (cat, wc, head, tail). Reads are
+ *  made in multiples of the card's sector size, into one buffer that is
+ *  reused for the whole file, so a large file costs one read per few
+ *  sectors, rather than one per line or per small buffer.
+ *
+ * Copyright (c)2023 Kevin Boone, GPL v3.0
+ * ==========================================================================*/
+
+/*============================================================================
+ * ==========================================================================*/
+
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include <pico/stdlib.h>
+#include <stdio.h>
+#include <fcntl.h>
+#include <getopt.h>
+#include <sys/error.h>
+#include <errno.h>
+#include <shell/shell.h>
+#include <shell/shell_reader.h>
+#include <sys/syscalls.h>
+#include <sys/fsutil.h>
+#include <compat/compat.h>
+
+/*============================================================================
+ * shell_reader_init
+ * ==========================================================================*/
+Error shell_reader_init (ShellReader *self, int fd, int size)
+  {
+  self->fd = fd;
+  self->size = size;
+  self->start = 0;
+  self->end = 0;
+  self->buff = malloc ((size_t)size);
+  return self->buff ? 0 : ENOMEM;
+  }
+
+/*============================================================================
+ * shell_reader_free
+ * ==========================================================================*/
+void shell_reader_free (ShellReader *self)
+  {
+  free (self->buff);
+  self->buff = NULL;
+  }
+
+/*============================================================================
+ * shell_reader_fill
+ * ==========================================================================*/
+int shell_reader_fill (ShellReader *self)
+  {
+  if (self->start > 0)
+    {
+    memmove (self->buff, self->buff + self->start,
+      (size_t)(self->end - self->start));
+    self->end -= self->start;
+    self->start = 0;
+    }
+  if (self->size - self->end < SHELL_READER_BLOCK)
+    {
+    char *buff = realloc (self->buff, (size_t)self->size * 2);
+    if (!buff) return -ENOMEM;
+    self->buff = buff;
+    self->size *= 2;
+    }
+  int room = (self->size - self->end) / SHELL_READER_BLOCK
+    * SHELL_READER_BLOCK;
+  int n = sys_read (self->fd, self->buff + self->end, room);
+  if (n > 0) self->end += n;
+  return n;
+  }
+
+/*============================================================================
+ * shell_reader_write
+ * ==========================================================================*/
+Error shell_reader_write (const char *s, int len)
+  {
+  while (len > 0)
+    {
+    int n = sys_write (1, s, len);
+    if (n < 0) return -n;
+    if (n == 0) return EIO;
+    s += n;
+    len -= n;
+    }
+  return 0;
+  }
+
+/*============================================================================
+ * shell_reader_lines_usage
+ * ==========================================================================*/
+static void shell_reader_lines_usage (const char *argv0,
+         const char *description)
+  {
+  compat_printf ("Usage: %s [-n lines] [files...]\n", argv0);
+  compat_printf ("%s\n", description);
+  compat_printf ("  -n: number of lines (default %d)\n", SHELL_READER_LINES);
+  compat_printf ("If no files are specified, read from stdin\n", argv0);
+  }
+
+/*============================================================================
+ * shell_reader_lines_cmd
+ * ==========================================================================*/
+Error shell_reader_lines_cmd (int argc, char **argv,
+      const char *description, ShellReaderLinesFn fn)
+  {
+  int ret = 0;
+  BOOL usage = FALSE;
+  long lines = SHELL_READER_LINES;
+
+  optind = 0;
+  int opt;
+  while ((opt = getopt (argc, argv, "n:h")) != -1)
+    {
+    switch (opt)
+      {
+      case 'n':
+        {
+        char *end;
+        lines = strtol (optarg, &end, 10);
+        if (*end || lines < 0)
+          {
+          compat_printf_stderr ("%s: bad line count: %s\n", argv[0],
+            optarg);
+          ret = EINVAL;
+          }
+        }
+        break;
+      case 'h':
+        usage = TRUE;
+        // Fall through
+      default:
+        shell_reader_lines_usage (argv[0], description);
+        ret = EINVAL;
+      }
+    }
+
+  if (ret == 0)
+    {
+    if (argc == optind)
+      {
+      ret = fn (0, lines); // STDIN
+      }
+    else
+      {
+      for (int i = optind; i < argc && ret == 0; i++)
+        {
+        if (fsutil_is_directory (argv[i]))
+          {
+          ret = EISDIR;
+          compat_printf_stderr ("%s: %s: %s\n", argv[0], argv[i],
+            strerror (ret));
+          }
+        else
+          {
+          int fd = sys_open (argv[i], O_RDONLY);
+          if (fd >= 0)
+            {
+            if (argc - optind > 1)
+              compat_printf ("%s==> %s <==\n", i > optind ? "\n" : "",
+                argv[i]);
+            ret = fn (fd, lines);
+            sys_close (fd);
+            }
+          else
+            {
+            ret = -fd;
+            compat_printf_stderr ("%s: %s: %s\n", argv[0], argv[i],
+               strerror (ret));
+            }
+          }
+        }
+      }
+    }
+
+  if (usage) ret = 0;
+  return ret;
+  }
+
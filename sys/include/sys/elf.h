@@ -6,26 +6,75 @@
 
 #pragma once
 
+#include <stdint.h>
 #include <sys/error.h>
 
-// Offset of the text segment in the ELF file. In the longer term we
-//   need to work this out by parsing all the headers. But this
-//   value will do for a proof-of-concept
-//#define ELF_TEXT_OFFSET 0x5000
+// Offset of the text segment in the ELF file, for executables that have
+//   no usable program headers. The GCC linker places the code at the
+//   file offset that matches the low bits of the load address, so this
+//   is what older BearOS loaders assumed for every program.
 #define ELF_TEXT_OFFSET 0x5800
 
+// Maximum number of PT_LOAD segments we will handle. BearOS programs are
+//   linked as one text segment and one BSS segment
+#define ELF_MAX_SEGMENTS 4
+
+// Maximum number of program headers of any type
+#define ELF_MAX_PHDRS 16
+
+typedef struct _ElfSegment
+  {
+  uint32_t offset; // Position in the file
+  uint32_t vaddr;  // Load address
+  uint32_t filesz; // Bytes to read from the file
+  uint32_t memsz;  // Bytes in memory; anything beyond filesz is zeroed
+  } ElfSegment;
+
+/** The parts of an executable that the loader needs. low and high are the
+    lowest and highest (exclusive) addresses occupied by any segment. 
+    If packed_size is non-zero, this is a packed executable, and its
+    single segment is an LZ4 block of packed_size bytes that unpacks 
+    to filesz bytes. */
+typedef struct _ElfImage
+  {
+  uint32_t entry;
+  uint32_t low;
+  uint32_t high;
+  uint32_t packed_size;
+  int nsegments;
+  ElfSegment segments[ELF_MAX_SEGMENTS];
+  } ElfImage;
+
+/** Timings of the phases of a program load, in microseconds. */
+typedef struct _ElfLoadStats
+  {
+  uint32_t header_us; // Opening the file and reading the headers
+  uint32_t read_us;   // Reading the segments, including unpacking
+  uint32_t zero_us;   // Zeroing BSS
+  uint32_t bytes;     // Bytes read from the file
+  } ElfLoadStats;
+
 #ifdef __cplusplus
 extern "C" {
 #endif
 
-/** Check that the ELF file is in a suitable format. Eventually this functino
-    will return information about the load address, etc., but these things
-    are all hard-coded for now. */
+/** Check that the ELF file is in a suitable format. */
 Error elf_check (const char *filename);
 
+/** Read and check the ELF header and program headers from an open file,
+    and fill in the ElfImage. A packed executable (see bearos/exec.h) is
+    accepted as well. The filename is used only for messages.
+    Every segment is checked to lie between the program load address
+    and RAMTOP. */
+Error elf_read_image (int fd, const char *filename, ElfImage *image);
+
+/** Read each segment of an image straight into its load address, and
+    zero the parts that are not in the file (BSS). This can only
+    be used on the device. If stats is not NULL, the read and zero
+    timings are filled in. */
+Error elf_load_image (int fd, const ElfImage *image, ElfLoadStats *stats);
+
 #ifdef __cplusplus
 }
 #endif
 
-
-
@@ -23,9 +23,8 @@ extern void environment_destroy (Environment *self);
 
 extern const char *environment_get (const Environment *self, const char *name);
 
-/** Add an entry to the environment, without deleting any existing entry. This
-     is faster than _set but, of course, will break if the entry already 
-     exists. */
+/** Add an entry to the environment. Any existing entry with the same 
+     name is replaced, so this is the same as _set with overwrite. */
 extern Error environment_add (Environment *self, 
          const char *name, const char *value);
 
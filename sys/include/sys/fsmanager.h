@@ -15,6 +15,10 @@
 #include <sys/filedesc.h>
 #include <sys/fsysdesc.h>
 
+/** A function that is called when an entry is created in, or removed from,
+    a directory. The path is the absolute path of the entry. */
+typedef void (*FSManagerChangeFn) (const char *abspath);
+
 #ifdef __cplusplus
 extern "C" {
 #endif
@@ -25,6 +29,13 @@ extern Error fsmanager_unmount (int8_t drive);
 extern FSysDescriptor *fsmanager_get_descriptor (int8_t drive);
 extern FSysDescriptor *fsmanager_get_descriptor_by_path (const char *path);
 
+/** Set the function to be called when a directory entry is created or 
+    removed. There is only one such function; pass NULL to remove it. */
+extern void fsmanager_set_change_callback (FSManagerChangeFn fn);
+
+/** Called by the syscalls that create or remove directory entries. */
+extern void fsmanager_notify_change (const char *abspath);
+
 
 #ifdef __cplusplus
 }
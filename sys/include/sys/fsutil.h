@@ -10,9 +10,52 @@
  * ==========================================================================*/
 
 #include <stdint.h>
+#include <time.h>
 #include <pico/stdlib.h>
 #include <sys/error.h>
 
+// Most directory levels that fsutil_walk() will have open at once. Each
+//   takes a file descriptor, and a process has only NFILES.
+#define FSUTIL_WALK_MAX_DEPTH 8
+
+// Events passed to an FsutilWalkFn
+#define FSUTIL_WALK_FILE     0 // Anything that is not a directory
+#define FSUTIL_WALK_DIR_PRE  1 // A directory, before its contents
+#define FSUTIL_WALK_DIR_POST 2 // A directory, after its contents
+#define FSUTIL_WALK_ERROR    3 // Something that could not be read
+
+// Values that an FsutilWalkFn returns
+#define FSUTIL_WALK_CONTINUE 0
+#define FSUTIL_WALK_PRUNE    1 // After DIR_PRE: skip the contents, and POST
+#define FSUTIL_WALK_STOP     2 // End the walk
+
+/** What fsutil_walk() knows about an entry. path is the whole path,
+    made from the starting path and the names below it, and name is the
+    last part of it. depth is 0 for the starting path. The strings are
+    only valid until the callback returns. */
+typedef struct _FsutilWalkEntry
+  {
+  const char *path;
+  const char *name;
+  int depth;
+  int type; // S_IFDIR, S_IFREG, etc
+  int32_t size;
+  time_t mtime;
+  } FsutilWalkEntry;
+
+/** Counts of the work done by fsutil_walk(), for verbose modes. */
+typedef struct _FsutilWalkStats
+  {
+  long opens;   // Directories (and the starting path) opened
+  long entries; // Directory entries read
+  int max_open; // Most directories open at the same time
+  } FsutilWalkStats;
+
+/** Called for each entry in a walk. For FSUTIL_WALK_ERROR, error says
+    what went wrong. Returns one of the FSUTIL_WALK_ return values. */
+typedef int (*FsutilWalkFn) (const FsutilWalkEntry *entry, int event,
+      Error error, void *data);
+
 #ifdef __cplusplus
 extern "C" {
 #endif
@@ -38,6 +81,18 @@ char *fsutil_make_abs_path (const char *in, char *out, int len);
 
 Error fsutil_copy_file (const char *source, const char *real_target);
 
+/** Walk the tree at path, calling fn for everything in it, and for path
+    itself, in directory order. Each directory is read once, as its
+    entries are reported, with one open handle for each level between it
+    and path. Directories max_depth levels below path are reported, but
+    not read. With max_depth < 0, the limit is FSUTIL_WALK_MAX_DEPTH,
+    and a directory at that depth is reported as an error (EMFILE).
+    Errors below path go to fn, which decides whether to stop. Returns
+    an error if path can't be opened, or EINTR if the walk was
+    interrupted. stats may be NULL. */
+Error fsutil_walk (const char *path, int max_depth, FsutilWalkFn fn,
+      void *data, FsutilWalkStats *stats);
+
 #ifdef __cplusplus
 }
 #endif
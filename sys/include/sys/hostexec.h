@@ -0,0 +1,54 @@
+/*============================================================================
+ *  sys/hostexec.h
+ *
+ * Running programs in the host build of BearOS. On the host, a program is
+ * a shared object, built from the program's source and the BearOS API
+ * library with BEAROS_HOST defined. See docs/PORTING_TO_BEAROS.md.
+ *
+ * Copyright (c)2023 Kevin Boone, GPL v3.0
+ * ==========================================================================*/
+
+#pragma once
+
+#if PICO_ON_DEVICE
+#else
+
+#include <stdint.h>
+#include <sys/error.h>
+#include <sys/limits.h>
+#include <sys/process.h>
+#include <sys/elf.h>
+
+// The size of the arena that stands in for the RAM above the program's
+//   load address. The program break is emulated within it.
+#define HOSTEXEC_ARENA_SIZE (256 * 1024)
+
+typedef struct _HostExecImage
+  {
+  void *handle;
+  EntryFn entry;
+  intptr_t *syscall_vector;
+  } HostExecImage;
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/** Load a program from an open file. The file is copied to a temporary
+    file on the host, so that the host's dynamic loader can read it. The
+    copy is timed as read_us, and the dynamic loading as header_us. */
+extern Error hostexec_load (int fd, const char *filename, 
+         HostExecImage *image, ElfLoadStats *stats);
+
+/** Run a loaded program in the specified process. The program break
+    starts at the bottom of the arena. */
+extern Error hostexec_run (Process *self, const HostExecImage *image, 
+         int argc, char **argv);
+
+extern void hostexec_unload (HostExecImage *image);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // PICO_ON_DEVICE
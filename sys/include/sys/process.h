@@ -24,6 +24,7 @@ typedef struct _Process
   FileDesc *files[NFILES];
   Environment *environment;
   void *brk;
+  void *brk_limit; // NULL means RAMTOP
   char reserved[32];
   jmp_buf exit_jmp;
   } Process;
@@ -61,6 +62,11 @@ extern void process_setenv (Process *self, const char *name, const char *value);
 extern void process_set_break (Process *self, void *brk);
 extern void *process_get_break (const Process *self);
 
+/** Set the address above which the break may not be moved. If it is 
+    never set, the limit is RAMTOP. */
+extern void process_set_break_limit (Process *self, void *limit);
+extern void *process_get_break_limit (const Process *self);
+
 extern char **process_get_envp (Process *self);
 
 extern Error process_open_file (Process *self, int fd, 
@@ -5,6 +5,7 @@
  * ==========================================================================*/
 
 #include <stdint.h>
+#include <pico/stdlib.h>
 #include <stdlib.h>
 #include <stdio.h>
 #include <string.h>
@@ -14,7 +15,11 @@
 #include <sys/syscalls.h>
 #include <sys/error.h>
 #include <errno.h>
+#include <sys/stat.h>
+#include <sys/limits.h>
+#include <bearos/exec.h>
 #include <sys/elf.h>
+#include <klib/lz4.h>
 
 #define TRACE_IN SYSLOG_TRACE_IN
 #define TRACE_OUT SYSLOG_TRACE_OUT
@@ -23,6 +28,16 @@
 #define INFO SYSLOG_INFO
 #define WARN SYSLOG_WARN
 
+// Program header types
+#define PT_LOAD 1
+
+// e_machine for ARM
+#define EM_ARM 0x28
+
+// Size of the buffer used to read a packed executable. Reads of whole
+//   sectors are the most efficient
+#define ELF_PACKED_BUFF_SIZE 2048
+
 typedef struct _ELFHeader
   {
   char magic[4];
@@ -46,6 +61,290 @@ typedef struct _ELFHeader
   int16_t e_shstrndx;
   } ELFHeader;
 
+typedef struct _ELFProgHeader
+  {
+  uint32_t p_type;
+  uint32_t p_offset;
+  uint32_t p_vaddr;
+  uint32_t p_paddr;
+  uint32_t p_filesz;
+  uint32_t p_memsz;
+  uint32_t p_flags;
+  uint32_t p_align;
+  } ELFProgHeader;
+
+/*============================================================================
+ * elf_add_segment
+ * file_bytes is the number of bytes the segment takes up in the file,
+ *   starting at offset, which for a packed executable is not filesz.
+ * ==========================================================================*/
+static Error elf_add_segment (ElfImage *image, const char *filename, 
+        uint32_t file_size, uint32_t offset, uint32_t file_bytes,
+        uint32_t vaddr, uint32_t filesz, uint32_t memsz)
+  {
+  if (image->nsegments >= ELF_MAX_SEGMENTS)
+    {
+    WARN ("Too many segments: %s", filename);
+    return ENOEXEC;
+    }
+  if (offset > file_size || file_bytes > file_size - offset)
+    {
+    WARN ("Segment at offset %lu size %lu is past the end of the file: %s", 
+      (unsigned long)offset, (unsigned long)file_bytes, filename);
+    return ENOEXEC;
+    }
+  if (filesz > memsz || vaddr < BEAROS_LOAD_ADDRESS || vaddr > RAMTOP
+       || memsz > RAMTOP - vaddr)
+    {
+    WARN ("Segment at %08lX size %lu does not fit in RAM: %s", 
+      (unsigned long)vaddr, (unsigned long)memsz, filename);
+    return ENOMEM;
+    }
+  ElfSegment *seg = &image->segments[image->nsegments++];
+  seg->offset = offset;
+  seg->vaddr = vaddr;
+  seg->filesz = filesz;
+  seg->memsz = memsz;
+  if (image->nsegments == 1 || vaddr < image->low) image->low = vaddr;
+  if (vaddr + memsz > image->high) image->high = vaddr + memsz;
+  return 0;
+  }
+
+/*============================================================================
+ * elf_read_packed
+ * Fill in the image from the header of a packed executable. 
+ * ==========================================================================*/
+static Error elf_read_packed (const BearosPackedHeader *ph, 
+        const char *filename, uint32_t file_size, ElfImage *image)
+  {
+  if (ph->packed_size == 0 || ph->size == 0)
+    {
+    WARN ("Packed executable is empty: %s", filename);
+    return ENOEXEC;
+    }
+  Error ret = elf_add_segment (image, filename, file_size,
+    sizeof (BearosPackedHeader), ph->packed_size, ph->load, ph->size,
+    ph->memsz);
+  if (ret == 0)
+    {
+    image->packed_size = ph->packed_size;
+    uint32_t entry = ph->entry & ~1u;
+    if (entry >= image->low && entry < image->high)
+      image->entry = entry;
+    else
+      image->entry = image->low;
+    }
+  return ret;
+  }
+
+/*============================================================================
+ * elf_read_image
+ * ==========================================================================*/
+Error elf_read_image (int fd, const char *filename, ElfImage *image)
+  {
+  memset (image, 0, sizeof (ElfImage));
+
+  struct stat sb;
+  if (sys_fstat (fd, &sb) != 0)
+    {
+    WARN ("Can't get size: %s", filename);
+    return ENOEXEC;
+    }
+  uint32_t file_size = (uint32_t)sb.st_size;
+
+  union
+    {
+    ELFHeader eh;
+    BearosPackedHeader ph;
+    } u;
+  int n = sys_read (fd, &u, sizeof (u));
+  if (n >= (int)sizeof (BearosPackedHeader) 
+       && u.ph.magic == BEAROS_PACKED_MAGIC)
+    return elf_read_packed (&u.ph, filename, file_size, image);
+
+  if (n != sizeof (ELFHeader))
+    {
+    WARN ("Executable too short: %s", filename);
+    return ENOEXEC;
+    }
+  const ELFHeader eh = u.eh;
+  if (!(eh.magic[1] == 'E' && eh.magic[2] == 'L' && eh.magic[3] == 'F'
+        && eh.endian == 1))
+    {
+    WARN ("ELF header incorrect: %s", filename);
+    return ENOEXEC;
+    }
+  if (eh.e_machine != EM_ARM)
+    {
+    WARN ("ELF incorrect architecture: %s (%d)", filename, eh.e_machine);
+    return ENOEXEC;
+    }
+
+  Error ret = 0;
+  if (eh.e_phnum > 0 && eh.e_phnum <= ELF_MAX_PHDRS 
+        && eh.e_phentsize == sizeof (ELFProgHeader))
+    {
+    // Read all the program headers at once
+    ELFProgHeader ph[ELF_MAX_PHDRS];
+    int len = eh.e_phnum * (int)sizeof (ELFProgHeader);
+    if (sys_lseek (fd, eh.e_phoff, SEEK_SET) != eh.e_phoff 
+         || sys_read (fd, ph, len) != len)
+      {
+      WARN ("Can't read program headers: %s", filename);
+      return ENOEXEC;
+      }
+    for (int i = 0; i < eh.e_phnum && ret == 0; i++)
+      {
+      if (ph[i].p_type == PT_LOAD && ph[i].p_memsz > 0)
+        ret = elf_add_segment (image, filename, file_size, ph[i].p_offset,
+          ph[i].p_filesz, ph[i].p_vaddr, ph[i].p_filesz, ph[i].p_memsz);
+      }
+    }
+
+  if (ret == 0 && image->nsegments == 0)
+    {
+    // No usable program headers. Fall back to the old assumption that 
+    //   everything from ELF_TEXT_OFFSET to the end of the file is code,
+    //   with a little room after it for BSS.
+    if (file_size <= ELF_TEXT_OFFSET)
+      {
+      WARN ("Executable too short: %s", filename);
+      return ENOEXEC;
+      }
+    uint32_t size = file_size - ELF_TEXT_OFFSET;
+    ret = elf_add_segment (image, filename, file_size, ELF_TEXT_OFFSET, 
+      size, BEAROS_LOAD_ADDRESS, size, size + 1024);
+    }
+
+  if (ret == 0)
+    {
+    // The start-up code is linked first, so the entry point is the 
+    //   load address, unless the ELF header says something more specific
+    uint32_t entry = (uint32_t)eh.e_entry & ~1u;
+    if (entry >= image->low && entry < image->high)
+      image->entry = entry;
+    else
+      image->entry = image->low;
+    }
+
+  return ret;
+  }
+
+#if PICO_ON_DEVICE
+typedef struct _ElfPackedReader
+  {
+  int fd;
+  uint32_t remaining;
+  } ElfPackedReader;
+
+/*============================================================================
+ * elf_packed_read
+ * The LZ4ReadFn that supplies a packed executable to the decoder 
+ * ==========================================================================*/
+static int elf_packed_read (void *context, uint8_t *buff, int len)
+  {
+  ElfPackedReader *r = context;
+  if ((uint32_t)len > r->remaining) len = (int)r->remaining;
+  if (len == 0) return 0;
+  int n = sys_read (r->fd, buff, len);
+  if (n > 0) r->remaining -= (uint32_t)n;
+  return n;
+  }
+
+/*============================================================================
+ * elf_load_packed
+ * Unpack a packed executable straight to its load address. Only a small
+ * buffer is needed for the compressed data, because LZ4 back-references
+ * are to data that has already been written to its final place.
+ * ==========================================================================*/
+static Error elf_load_packed (int fd, const ElfImage *image)
+  {
+  const ElfSegment *seg = &image->segments[0];
+  if (sys_lseek (fd, (int32_t)seg->offset, SEEK_SET) != (int32_t)seg->offset)
+    return EIO;
+  uint8_t *buff = malloc (ELF_PACKED_BUFF_SIZE);
+  if (!buff) return ENOMEM;
+
+  ElfPackedReader r;
+  r.fd = fd;
+  r.remaining = image->packed_size;
+  int32_t n = lz4_decompress_stream (elf_packed_read, &r, buff, 
+    ELF_PACKED_BUFF_SIZE, (uint8_t *)seg->vaddr, seg->filesz);
+  free (buff);
+
+  if (n == LZ4_ERR_READ) return EIO;
+  if (n != (int32_t)seg->filesz) 
+    {
+    WARN ("Packed executable is corrupt (%ld)", (long)n);
+    return ENOEXEC;
+    }
+  return 0;
+  }
+#endif
+
+/*============================================================================
+ * elf_load_image
+ * ==========================================================================*/
+Error elf_load_image (int fd, const ElfImage *image, ElfLoadStats *stats)
+  {
+#if PICO_ON_DEVICE
+  if (image->packed_size)
+    {
+    uint64_t t0 = time_us_64 ();
+    Error ret = elf_load_packed (fd, image);
+    if (ret) return ret;
+    const ElfSegment *seg = &image->segments[0];
+    uint64_t t1 = time_us_64 ();
+    memset ((char *)seg->vaddr + seg->filesz, 0, seg->memsz - seg->filesz);
+    uint64_t t2 = time_us_64 ();
+    if (stats)
+      {
+      stats->read_us = (uint32_t)(t1 - t0);
+      stats->zero_us = (uint32_t)(t2 - t1);
+      stats->bytes = image->packed_size;
+      }
+    return 0;
+    }
+
+  uint64_t read_us = 0, zero_us = 0;
+  uint32_t bytes = 0;
+  for (int i = 0; i < image->nsegments; i++)
+    {
+    const ElfSegment *seg = &image->segments[i];
+    uint64_t t0 = time_us_64 ();
+    if (sys_lseek (fd, (int32_t)seg->offset, SEEK_SET) != (int32_t)seg->offset)
+      return EIO;
+    // Read straight to the load address. The filesystem can then
+    //   transfer whole sectors without going through its own buffer.
+    char *p = (char *)seg->vaddr;
+    uint32_t to_read = seg->filesz;
+    while (to_read > 0)
+      {
+      int n = sys_read (fd, p, (int)to_read);
+      if (n <= 0) return n < 0 ? -n : ENOEXEC;
+      p += n;
+      to_read -= (uint32_t)n;
+      }
+    bytes += seg->filesz;
+    uint64_t t1 = time_us_64 ();
+    if (seg->memsz > seg->filesz)
+      memset ((char *)seg->vaddr + seg->filesz, 0, seg->memsz - seg->filesz);
+    uint64_t t2 = time_us_64 ();
+    read_us += t1 - t0;
+    zero_us += t2 - t1;
+    }
+  if (stats)
+    {
+    stats->read_us = (uint32_t)read_us;
+    stats->zero_us = (uint32_t)zero_us;
+    stats->bytes = bytes;
+    }
+  return 0;
+#else
+  (void)fd; (void)image; (void)stats;
+  return ENOSYS;
+#endif
+  }
 
 /*============================================================================
  * elf_check 
@@ -61,37 +360,12 @@ Error elf_check (const char *filename)
   int fd = sys_open (filename, O_RDONLY);
   if (fd >= 0)
     {
-    ELFHeader eh;
-    int n = sys_read (fd, &eh, sizeof (eh));
-    if (n == sizeof (eh))
-      {
-      if (eh.magic[1] == 'E' && eh.magic[2] == 'L' && eh.magic[3] == 'F'
-        && eh.endian == 1)
-          {
-          if (eh.e_machine == 0x28)
-            ret = 0;
-          else
-            {
-            WARN ("ELF incorrect architecture: %s (%d)", 
-              filename, eh.e_machine);
-            ret = ENOEXEC;
-            }
-          }
-      else
-        {
-        WARN ("ELF header incorrect: %s", filename);
-        ret = ENOEXEC;
-        }
-      }
-    else
-      {
-      WARN ("Executable too short: %s", filename);
-      ret = ENOEXEC;
-      }
+    ElfImage image;
+    ret = elf_read_image (fd, filename, &image);
     sys_close (fd);
     }
   else
-    ret = -ENOENT;
+    ret = ENOENT;
 
 #ifdef TRACE
   TRACE_OUT;
@@ -99,4 +373,3 @@ Error elf_check (const char *filename)
   return ret;
   }
 
-
@@ -15,16 +15,58 @@
 #include <sys/syscalls.h>
 #include <sys/error.h>
 #include <errno.h>
+#include <klib/hashmap.h>
 #include <sys/environment.h>
 
 /*============================================================================
  * Opaque structure 
+ * The envp array is the environment as programs see it: a null-terminated
+ * list of "name=value" strings. index maps each name to its string in
+ * envp, so lookups don't have to scan the list.
  * ==========================================================================*/
 struct _Environment
   {
   char **envp;
+  int size; // Not including the final null pointer
+  int capacity; // Ditto
+  HashMap *index;
   };
 
+#define ENVIRONMENT_INITIAL_CAPACITY 8
+
+/*============================================================================
+ * environment_hash_name 
+ * The keys in the index are the "name=value" strings in envp, but
+ * lookups are by plain name. So hash and compare only the part before
+ * any '='.
+ * ==========================================================================*/
+static uint32_t environment_hash_name (const void *key)
+  {
+  const unsigned char *s = key;
+  uint32_t h = 2166136261u;
+  while (*s && *s != '=')
+    {
+    h ^= *s++;
+    h *= 16777619u;
+    }
+  return h;
+  }
+
+/*============================================================================
+ * environment_equal_name 
+ * ==========================================================================*/
+static BOOL environment_equal_name (const void *key1, const void *key2)
+  {
+  const char *s1 = key1;
+  const char *s2 = key2;
+  while (*s1 && *s1 != '=' && *s1 == *s2)
+    {
+    s1++;
+    s2++;
+    }
+  return (*s1 == 0 || *s1 == '=') && (*s2 == 0 || *s2 == '=');
+  }
+
 /*============================================================================
  * environment_new 
  * ==========================================================================*/
@@ -32,14 +74,16 @@ Environment *environment_new (void)
   {
   Environment *self = malloc (sizeof (Environment));
   memset (self, 0, sizeof (Environment));
-  self->envp = malloc (1 * sizeof (char *));
+  self->capacity = ENVIRONMENT_INITIAL_CAPACITY;
+  self->envp = malloc ((size_t)(self->capacity + 1) * sizeof (char *));
   self->envp[0] = NULL;
+  self->index = hashmap_create (environment_hash_name, 
+    environment_equal_name, NULL);
   return self;
   }
 
 /*============================================================================
  * environment_clone
- * size does not include the final null pointer
  * ==========================================================================*/
 Environment *environment_clone (const Environment *old)
   {
@@ -61,12 +105,61 @@ Environment *environment_clone (const Environment *old)
  * ==========================================================================*/
 int environment_size (const Environment *self)
   { 
-  int i = 0;
-  while (self->envp[i]) 
+  return self->size;
+  }
+
+/*============================================================================
+ * environment_find_item
+ * Returns the position of the specified string in envp, or -1. Note that
+ * this compares pointers, not names.
+ * ==========================================================================*/
+static int environment_find_item (const Environment *self, const char *entry)
+  {
+  for (int i = 0; i < self->size; i++)
     {
-    i++;
+    if (self->envp[i] == entry) return i;
     }
-  return i;
+  return -1;
+  }
+
+/*============================================================================
+ * environment_delete_item
+ * ==========================================================================*/
+static void environment_delete_item (Environment *self, int item)
+  {
+  if (item < 0 || item >= self->size) return;
+
+  char *to = self->envp[item];
+  hashmap_remove (self->index, to);
+  free (to);
+
+  memmove (self->envp + item, self->envp + item + 1, 
+    (size_t)(self->size - item) * sizeof (char *));
+  self->size--;
+  }
+
+/*============================================================================
+ * environment_append
+ * Add an entry, taking ownership of the string. If there is already
+ * an entry with the same name, it is removed, so that envp and the
+ * index cannot disagree.
+ * ==========================================================================*/
+static void environment_append (Environment *self, char *s)
+  {
+  const char *exist = hashmap_get (self->index, s);
+  if (exist)
+    environment_delete_item (self, environment_find_item (self, exist));
+
+  if (self->size == self->capacity)
+    {
+    self->capacity *= 2;
+    self->envp = realloc (self->envp, 
+      (size_t)(self->capacity + 1) * sizeof (char *));
+    }
+  self->envp[self->size] = s;
+  self->size++;
+  self->envp[self->size] = NULL; 
+  hashmap_put (self->index, s, s);
   }
 
 /*============================================================================
@@ -75,12 +168,9 @@ int environment_size (const Environment *self)
 Error environment_add (Environment *self, const char *name, 
     const char *value) 
   {
-  int i = environment_size (self);
-  self->envp = realloc (self->envp, (size_t)((i + 2) * (int)sizeof (char *)));
   char *s;
-  asprintf (&s, "%s=%s", name, value);
-  self->envp[i] = s;
-  self->envp[i + 1] = 0; 
+  if (asprintf (&s, "%s=%s", name, value) < 0) return ENOMEM;
+  environment_append (self, s);
   return 0;
   }
 
@@ -89,10 +179,7 @@ Error environment_add (Environment *self, const char *name,
  * ==========================================================================*/
 Error environment_add_raw (Environment *self, const char *token)
   {
-  int i = environment_size (self);
-  self->envp = realloc (self->envp, (size_t)((i + 2) * (int)sizeof (char *)));
-  self->envp[i] = strdup (token);
-  self->envp[i + 1] = 0; 
+  environment_append (self, strdup (token));
   return 0;
   }
 
@@ -101,38 +188,13 @@ Error environment_add_raw (Environment *self, const char *token)
  * ==========================================================================*/
 void environment_destroy (Environment *self) 
   {
-  if (self->envp)
-    {
-    int i = 0;
-    while (self->envp[i]) 
-      {
-      free (self->envp[i]);
-      i++;
-      }
-    free (self->envp);
-    }
+  for (int i = 0; i < self->size; i++)
+    free (self->envp[i]);
+  free (self->envp);
+  hashmap_destroy (self->index);
   free (self);
   }
 
-/*============================================================================
- * environment_get_item
- * ==========================================================================*/
-static int environment_get_item (const Environment *self, const char *name)
-  {
-  int i = 0;
-  const char *s;
-  while ((s = self->envp[i])) 
-    {
-    char *eqpos = strchr (s, '=');    
-    if (eqpos)
-      {
-      if (strncmp (name, s, (size_t)(eqpos - s)) == 0) return i;
-      }
-    i++;
-    }
-  return -1;
-  }
-
 /*============================================================================
  * environment_dump
  * ==========================================================================*/
@@ -147,44 +209,15 @@ static void environment_dump (const Environment *self)
     }
   }
 
-/*============================================================================
- * environment_delete_item
- * ==========================================================================*/
-static void environment_delete_item (Environment *self, int item)
-  {
-  if (item < 0) return;
-
-  // We run the risk of freeing and moving memory outside envp here. 
-  // We can't really check that 'item' is in bounds without enumerating
-  //   the whole env array, which would be slow.
-  char *to = self->envp[item];
-  free (to);
-
-  do
-    {
-    self->envp[item] = self->envp[item + 1];
-    item++;
-    } while (self->envp[item]);
-
-  }
-
 /*============================================================================
  * environment_get
  * ==========================================================================*/
 const char *environment_get (const Environment *self, const char *name)
   {
-  int i = 0;
-  const char *s;
-  while ((s = self->envp[i])) 
-    {
-    char *eqpos = strchr (s, '=');    
-    if (eqpos)
-      {
-      if (strncmp (name, s, (size_t)(eqpos - s)) == 0) return eqpos + 1;
-      }
-    i++;
-    }
-  return 0;
+  const char *entry = hashmap_get (self->index, name);
+  if (!entry) return 0;
+  const char *eqpos = strchr (entry, '=');    
+  return eqpos ? eqpos + 1 : ""; 
   }
 
 /*============================================================================
@@ -192,10 +225,10 @@ const char *environment_get (const Environment *self, const char *name)
  * ==========================================================================*/
 void environment_delete (Environment *self, const char *name)
   {
-  int i = environment_get_item (self, name);
-  if (i >= 0)
+  const char *entry = hashmap_get (self->index, name);
+  if (entry)
     {
-    environment_delete_item (self, i);
+    environment_delete_item (self, environment_find_item (self, entry));
     }
   }
 
@@ -206,16 +239,9 @@ void environment_delete (Environment *self, const char *name)
 Error environment_set (Environment *self, const char *name, const char *value,
        bool overwrite)
   {
-  char *exist = (char *)environment_get (self, name);
-  if (exist)
-    {
-    if (overwrite)
-      environment_delete (self, name);
-    else
-      return EINVAL;
-    }
-  environment_add (self, name, value);
-  return 0;
+  if (!overwrite && hashmap_contains (self->index, name))
+    return EINVAL;
+  return environment_add (self, name, value);
   }
 
 /*============================================================================
@@ -226,4 +252,3 @@ char **environment_get_envp (const Environment *self)
   return self->envp;
   }
 
-
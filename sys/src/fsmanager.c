@@ -12,6 +12,8 @@
 
 static FSysDescriptor *mounts [FSMANAGER_MAX_MOUNTS];
 
+static FSManagerChangeFn change_callback = NULL;
+
 /*============================================================================
  * fsmanager_init
  * ==========================================================================*/
@@ -91,6 +93,19 @@ FSysDescriptor *fsmanager_get_descriptor_by_path (const char *path)
   return fsmanager_get_descriptor ((int8_t)drive);
   }
 
+/*============================================================================
+ * fsmanager_set_change_callback
+ * ==========================================================================*/
+void fsmanager_set_change_callback (FSManagerChangeFn fn)
+  {
+  change_callback = fn;
+  }
 
-
+/*============================================================================
+ * fsmanager_notify_change
+ * ==========================================================================*/
+void fsmanager_notify_change (const char *abspath)
+  {
+  if (change_callback) change_callback (abspath);
+  }
 
@@ -19,6 +19,8 @@
 #include <errno.h>
 #include <sys/syscalls.h>
 #include <sys/process.h>
+#include <sys/direntry.h>
+#include <sys/fsutil.h>
 #include <bearos/intr.h>
 
 /*============================================================================
@@ -307,4 +309,215 @@ Error fsutil_copy_file (const char *source, const char *target)
   return ret;
   }
 
+typedef struct _FsutilWalkLevel
+  {
+  int fd;
+  int path_len;
+  int name_off;
+  int type;
+  int32_t size;
+  time_t mtime;
+  } FsutilWalkLevel;
+
+typedef struct _FsutilWalk
+  {
+  char path[PATH_MAX];
+  DirEntry de;
+  FsutilWalkLevel levels[FSUTIL_WALK_MAX_DEPTH + 1];
+  } FsutilWalk;
+
+/*=========================================================================
+  fsutil_walk_report
+  Pass the entry for a level of the walk to the caller's function, with
+  the path as it stands in the path buffer
+=========================================================================*/
+static int fsutil_walk_report (FsutilWalk *self, int depth,
+      const FsutilWalkLevel *level, int event, Error error,
+      FsutilWalkFn fn, void *data)
+  {
+  FsutilWalkEntry entry;
+  entry.path = self->path;
+  entry.name = self->path + level->name_off;
+  entry.depth = depth;
+  entry.type = level->type;
+  entry.size = level->size;
+  entry.mtime = level->mtime;
+  return fn (&entry, event, error, data);
+  }
+
+/*=========================================================================
+  fsutil_walk
+  The walk is a loop, not a recursion, over a stack of open directories,
+  all of whose paths are prefixes of one path buffer. Reading the next
+  entry of the directory on top either reports a file, or pushes a
+  subdirectory, or, at the end, pops the directory and reports it again
+  in post-order.
+=========================================================================*/
+Error fsutil_walk (const char *path, int max_depth, FsutilWalkFn fn,
+      void *data, FsutilWalkStats *stats)
+  {
+  FsutilWalkStats local_stats;
+  if (!stats) stats = &local_stats;
+  memset (stats, 0, sizeof (FsutilWalkStats));
+  // A directory that is too deep to read is only an error if the
+  //   caller didn't ask for the limit
+  Error too_deep = 0;
+  if (max_depth < 0 || max_depth > FSUTIL_WALK_MAX_DEPTH)
+    {
+    max_depth = FSUTIL_WALK_MAX_DEPTH;
+    too_deep = EMFILE;
+    }
 
+  FsutilWalk *self = malloc (sizeof (FsutilWalk));
+  if (!self) return ENOMEM;
+
+  Error ret = 0;
+  FsutilWalkLevel *top = &self->levels[0];
+  strncpy (self->path, path, PATH_MAX - 1);
+  self->path[PATH_MAX - 1] = 0;
+  top->path_len = (int)strlen (self->path);
+  const char *slash = strrchr (self->path, '/');
+  top->name_off = slash && slash[1] ? (int)(slash + 1 - self->path) : 0;
+
+  top->fd = sys_open (path, O_RDONLY);
+  stats->opens++;
+  if (top->fd < 0)
+    {
+    ret = -top->fd;
+    free (self);
+    return ret;
+    }
+  struct stat sb;
+  ret = sys_fstat (top->fd, &sb);
+  if (ret)
+    {
+    sys_close (top->fd);
+    free (self);
+    return ret;
+    }
+  top->type = (int)(sb.st_mode & S_IFMT);
+  top->size = (int32_t)sb.st_size;
+  top->mtime = sb.st_mtime;
+
+  if (top->type != S_IFDIR)
+    {
+    sys_close (top->fd);
+    fsutil_walk_report (self, 0, top, FSUTIL_WALK_FILE, 0, fn, data);
+    free (self);
+    return 0;
+    }
+
+  int r = fsutil_walk_report (self, 0, top, FSUTIL_WALK_DIR_PRE, 0,
+    fn, data);
+  if (r != FSUTIL_WALK_CONTINUE || max_depth == 0)
+    {
+    sys_close (top->fd);
+    if (r == FSUTIL_WALK_CONTINUE)
+      fsutil_walk_report (self, 0, top, FSUTIL_WALK_DIR_POST, 0, fn, data);
+    free (self);
+    return 0;
+    }
+
+  int depth = 0;
+  stats->max_open = 1;
+  while (depth >= 0)
+    {
+    FsutilWalkLevel *level = &self->levels[depth];
+    if (sys_poll_interrupt (SYS_INTR_TERM))
+      {
+      sys_clear_interrupt (SYS_INTR_TERM);
+      ret = EINTR;
+      break;
+      }
+
+    int n = sys_getdent (level->fd, &self->de);
+    if (n <= 0)
+      {
+      // End of this directory. It has to be closed before it is
+      //   reported, in case the caller wants to remove it.
+      sys_close (level->fd);
+      level->fd = -1;
+      self->path[level->path_len] = 0;
+      if (n < 0)
+        r = fsutil_walk_report (self, depth, level, FSUTIL_WALK_ERROR, -n,
+          fn, data);
+      else
+        r = fsutil_walk_report (self, depth, level, FSUTIL_WALK_DIR_POST, 0,
+          fn, data);
+      depth--;
+      if (r == FSUTIL_WALK_STOP) break;
+      continue;
+      }
+    stats->entries++;
+
+    const char *name = self->de.name;
+    if (strcmp (name, ".") == 0 || strcmp (name, "..") == 0) continue;
+
+    FsutilWalkLevel *child = &self->levels[depth + 1];
+    int len = level->path_len;
+    if (len > 0 && self->path[len - 1] != '/' && self->path[len - 1] != ':')
+      self->path[len++] = '/';
+    child->name_off = len;
+    child->path_len = len + (int)strlen (name);
+    child->type = self->de.type;
+    child->size = self->de.size;
+    child->mtime = self->de.mtime;
+    if (child->path_len >= PATH_MAX)
+      {
+      // Report the child, like any other, with as much of its path as fits
+      if (len > PATH_MAX - 1) len = PATH_MAX - 1;
+      child->name_off = len;
+      strncpy (self->path + len, name, (size_t)(PATH_MAX - 1 - len));
+      self->path[PATH_MAX - 1] = 0;
+      r = fsutil_walk_report (self, depth + 1, child, FSUTIL_WALK_ERROR,
+        ENAMETOOLONG, fn, data);
+      self->path[level->path_len] = 0;
+      if (r == FSUTIL_WALK_STOP) break;
+      continue;
+      }
+    strcpy (self->path + len, name);
+
+    if (child->type != S_IFDIR)
+      {
+      r = fsutil_walk_report (self, depth + 1, child, FSUTIL_WALK_FILE, 0,
+        fn, data);
+      }
+    else
+      {
+      r = fsutil_walk_report (self, depth + 1, child, FSUTIL_WALK_DIR_PRE, 0,
+        fn, data);
+      if (r == FSUTIL_WALK_CONTINUE)
+        {
+        if (depth + 1 < max_depth)
+          {
+          child->fd = sys_open (self->path, O_RDONLY);
+          stats->opens++;
+          if (child->fd >= 0)
+            {
+            depth++;
+            if (depth + 1 > stats->max_open) stats->max_open = depth + 1;
+            continue;
+            }
+          r = fsutil_walk_report (self, depth + 1, child, FSUTIL_WALK_ERROR,
+            -child->fd, fn, data);
+          }
+        else if (too_deep)
+          r = fsutil_walk_report (self, depth + 1, child, FSUTIL_WALK_ERROR,
+            too_deep, fn, data);
+        else
+          r = fsutil_walk_report (self, depth + 1, child,
+            FSUTIL_WALK_DIR_POST, 0, fn, data);
+        }
+      }
+    // Any value but STOP just means carry on with this directory
+    if (r == FSUTIL_WALK_STOP) break;
+    self->path[level->path_len] = 0;
+    }
+
+  for (; depth >= 0; depth--)
+    {
+    if (self->levels[depth].fd >= 0) sys_close (self->levels[depth].fd);
+    }
+  free (self);
+  return ret;
+  }
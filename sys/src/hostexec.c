@@ -0,0 +1,164 @@
+/*============================================================================
+ *  sys/hostexec.c
+ *
+ * Copyright (c)2023 Kevin Boone, GPL v3.0
+ * ==========================================================================*/
+
+#if PICO_ON_DEVICE
+#else
+
+#include <stdint.h>
+#include <pico/stdlib.h>
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <dlfcn.h>
+// unistd.h declares a syscall() of its own, which would clash with the
+//   kernel's, in sys/syscall.h
+#define syscall unistd_syscall
+#include <unistd.h>
+#undef syscall
+#include <errno.h>
+#include <sys/error.h>
+#include <sys/syscalls.h>
+#include <sys/syscall.h>
+#include <sys/process.h>
+#include <sys/hostexec.h>
+#include <syslog/syslog.h>
+
+#define TRACE_IN SYSLOG_TRACE_IN
+#define TRACE_OUT SYSLOG_TRACE_OUT
+#define TRACE SYSLOG_TRACE
+#define DEBUG SYSLOG_DEBUG
+#define INFO SYSLOG_INFO
+#define WARN SYSLOG_WARN
+
+// Size of the buffer used to copy the program out of the BearOS
+//   filesystem -- the same as the packed executable buffer
+#define HOSTEXEC_BUFF_SIZE 2048
+
+extern char **environ;
+
+// Stands in for the RAM that a program would use on the device. It's
+//   allocated once, and re-used by each program
+static char *arena = NULL;
+
+/*============================================================================
+ * hostexec_copy
+ * Copy the program file to a host temporary file. The BearOS filesystem
+ * is read exactly as it would be when loading a program on the device.
+ * ==========================================================================*/
+static Error hostexec_copy (int fd, char *tmpname, uint32_t *bytes)
+  {
+  strcpy (tmpname, "/tmp/bearos-XXXXXX");
+  int tmpfd = mkstemp (tmpname);
+  if (tmpfd < 0) return errno;
+  FILE *f = fdopen (tmpfd, "wb");
+  if (!f)
+    {
+    Error ret = errno;
+    close (tmpfd);
+    return ret;
+    }
+
+  Error ret = 0;
+  char buff[HOSTEXEC_BUFF_SIZE];
+  int n;
+  *bytes = 0;
+  while ((n = sys_read (fd, buff, sizeof (buff))) > 0)
+    {
+    if (fwrite (buff, 1, (size_t)n, f) != (size_t)n)
+      {
+      ret = EIO;
+      break;
+      }
+    *bytes += (uint32_t)n;
+    }
+  if (n < 0) ret = -n;
+  fclose (f);
+  return ret;
+  }
+
+/*============================================================================
+ * hostexec_load
+ * ==========================================================================*/
+Error hostexec_load (int fd, const char *filename, HostExecImage *image,
+        ElfLoadStats *stats)
+  {
+  memset (image, 0, sizeof (HostExecImage));
+
+  char tmpname[32];
+  uint64_t t0 = time_us_64 ();
+  uint32_t bytes = 0;
+  Error ret = hostexec_copy (fd, tmpname, &bytes);
+  uint64_t t1 = time_us_64 ();
+  if (ret == 0)
+    {
+    image->handle = dlopen (tmpname, RTLD_NOW | RTLD_LOCAL);
+    if (image->handle)
+      {
+      image->entry = (EntryFn)dlsym (image->handle, "start");
+      image->syscall_vector = dlsym (image->handle, "bearos_syscall_vector");
+      if (!image->entry || !image->syscall_vector)
+        {
+        WARN ("Not a BearOS host program: %s", filename);
+        ret = ENOEXEC;
+        }
+      }
+    else
+      {
+      WARN ("Can't load %s: %s", filename, dlerror());
+      ret = ENOEXEC;
+      }
+    }
+  // The dynamic loader has mapped the file, so its name is not needed
+  remove (tmpname);
+  uint64_t t2 = time_us_64 ();
+
+  if (ret)
+    hostexec_unload (image);
+  else if (stats)
+    {
+    stats->read_us = (uint32_t)(t1 - t0);
+    stats->header_us += (uint32_t)(t2 - t1);
+    stats->bytes = bytes;
+    }
+  return ret;
+  }
+
+/*============================================================================
+ * hostexec_run
+ * ==========================================================================*/
+Error hostexec_run (Process *self, const HostExecImage *image, int argc, 
+        char **argv)
+  {
+  if (!arena)
+    {
+    arena = malloc (HOSTEXEC_ARENA_SIZE);
+    if (!arena) return ENOMEM;
+    }
+
+  *image->syscall_vector = (intptr_t)syscall;
+  process_set_break (self, arena);
+  process_set_break_limit (self, arena + HOSTEXEC_ARENA_SIZE);
+
+  // The program shares the host C library with BearOS, so its 
+  //   environment must be put back when it ends
+  char **old_environ = environ;
+  Error ret = process_run (self, image->entry, argc, argv);
+  environ = old_environ;
+
+  fflush (stdout);
+  return ret;
+  }
+
+/*============================================================================
+ * hostexec_unload
+ * ==========================================================================*/
+void hostexec_unload (HostExecImage *image)
+  {
+  if (image->handle) dlclose (image->handle);
+  memset (image, 0, sizeof (HostExecImage));
+  }
+
+#endif // PICO_ON_DEVICE
@@ -5,6 +5,7 @@
  * ==========================================================================*/
 
 #include <stdint.h>
+#include <pico/stdlib.h>
 #include <stdlib.h>
 #include <stdio.h>
 #include <string.h>
@@ -22,6 +23,7 @@
 #include <sys/process.h>
 #include <sys/environment.h>
 #include <sys/elf.h>
+#include <sys/hostexec.h>
 #include <bearos/exec.h>
 #include <compat/compat.h>
 
@@ -306,6 +308,22 @@ void *process_get_break (const Process *self)
   return self->brk;
   }
 
+/*============================================================================
+ * process_set_break_limit
+ * ==========================================================================*/
+void process_set_break_limit (Process *self, void *limit)
+  {
+  self->brk_limit = limit;
+  }
+
+/*============================================================================
+ * process_get_break_limit
+ * ==========================================================================*/
+void *process_get_break_limit (const Process *self)
+  {
+  return self->brk_limit;
+  }
+
 /*============================================================================
  * process_get_envp
  * ==========================================================================*/
@@ -315,77 +333,102 @@ char **process_get_envp (Process *self)
   }
 
 
+/*============================================================================
+ * process_report_load
+ * Log the time taken by each phase of loading a program. If the
+ * environment variable LOADTIME is set, print it as well, so that
+ * start-up time can be measured without changing the log level.
+ * ==========================================================================*/
+static void process_report_load (const Process *self, const char *path,
+        const ElfLoadStats *stats)
+  {
+  uint32_t total = stats->header_us + stats->read_us + stats->zero_us;
+  DEBUG ("%s: headers %lu us, read %lu bytes in %lu us, bss %lu us", 
+     path, (unsigned long)stats->header_us, (unsigned long)stats->bytes, 
+     (unsigned long)stats->read_us, (unsigned long)stats->zero_us);
+  const char *lt = process_getenv (self, "LOADTIME");
+  if (lt && lt[0])
+    {
+    compat_printf_stderr 
+      ("%s: headers %lu us, read %lu bytes in %lu us, bss %lu us, "
+       "total %lu us\n", path, (unsigned long)stats->header_us, 
+       (unsigned long)stats->bytes, (unsigned long)stats->read_us, 
+       (unsigned long)stats->zero_us, (unsigned long)total);
+    }
+  }
+
 /*============================================================================
  * process_run_file
  * ==========================================================================*/
 Error process_run_file (Process *self, const char *path, int argc,
                          char **argv)
   {
-  // TODO: What do we do with the environment here?
-  Error ret = 0;
-  if (argc >= 1)
+  if (argc < 1)
     {
-    const char *filename = path;
-    ret = elf_check (filename);
-    if (ret == 0)
-      {
-      struct stat sb;
-      int fd = sys_open (filename, O_RDONLY);
-      sys_fstat (fd, &sb); // Should succeed by this point
-  //printf ("size = %d\n", sb.st_size);
-  //printf ("bytes to read = %d\n", to_read);
-      
-      int32_t pos = sys_lseek (fd, ELF_TEXT_OFFSET, SEEK_SET);
-      if (pos == ELF_TEXT_OFFSET)
-	{
+    // This should never happen
+    compat_printf ("usage: %s {filename}\n", argv[0]);
+    return EINVAL;
+    }
+
+  ElfLoadStats stats;
+  memset (&stats, 0, sizeof (stats));
+  uint64_t t0 = time_us_64 ();
+
+  int fd = sys_open (path, O_RDONLY);
+  if (fd < 0) return ENOENT;
 
 #if PICO_ON_DEVICE
-        int to_read = (int)sb.st_size - (int)ELF_TEXT_OFFSET;
-        int prog_size = to_read;
-        // We can't do _any_ of this stuff on the host!
-	//printf ("Seek OK");
-	char *load_pos = (char *)BEAROS_LOAD_ADDRESS;
-	while (to_read > 0)
-	  {
-	  char buff[256];
-	  sys_read (fd, buff, 256);
-	  //printf ("pos = %p\n", load_pos);
-	  memcpy (load_pos, buff, sizeof (buff));
-	  load_pos += (int)sizeof (buff);
-	  to_read -= (int)sizeof (buff);
-	  }
-
-        sys_close (fd);
-
-        int32_t *syscall_addr = (int32_t *)BEAROS_SYSCALL_VECTOR; 
-        *syscall_addr = (int32_t)syscall;
-
-        process_set_break (self, 
-          (void *)(BEAROS_LOAD_ADDRESS + prog_size + 1024));
-
-	EntryFn entry = (EntryFn)(BEAROS_LOAD_ADDRESS | 0x01);
-
-        ret = process_run (self, entry, argc, argv);
-#endif
-	}
-      else
-        {
-        sys_close (fd);
-	compat_printf ("Seek error: %s\n", strerror (-pos));
-	}
-      }
+  ElfImage image;
+  Error ret = elf_read_image (fd, path, &image);
+  stats.header_us = (uint32_t)(time_us_64 () - t0);
+  if (ret)
+    {
+    sys_close (fd);
+    if (ret == ENOMEM)
+      compat_printf ("Program too large: %s\n", path);
     else
-      {
-      ret = ENOEXEC;
-      compat_printf ("Bad ELF file: %s\n", filename);
-      }
+      compat_printf ("Bad ELF file: %s\n", path);
+    return ret;
     }
-  else
+
+  ret = elf_load_image (fd, &image, &stats);
+  sys_close (fd);
+  if (ret)
     {
-    // This should never happen
-    compat_printf ("usage: %s {filename}\n", argv[0]);
-    ret = EINVAL;
+    compat_printf ("Can't load %s: %s\n", path, strerror (ret));
+    return ret;
     }
+
+  process_report_load (self, path, &stats);
+
+  int32_t *syscall_addr = (int32_t *)BEAROS_SYSCALL_VECTOR; 
+  *syscall_addr = (int32_t)syscall;
+
+  // The heap starts immediately after the highest segment, which
+  //   includes the BSS
+  process_set_break (self, (void *)((image.high + 7) & ~7u));
+  process_set_break_limit (self, NULL);
+
+  EntryFn entry = (EntryFn)(image.entry | 0x01);
+  ret = process_run (self, entry, argc, argv);
+#else
+  // On the host, programs are shared objects built for the host
+  stats.header_us = (uint32_t)(time_us_64 () - t0);
+  HostExecImage image;
+  Error ret = hostexec_load (fd, path, &image, &stats);
+  sys_close (fd);
+  if (ret)
+    {
+    compat_printf ("Can't load %s: %s\n", path, strerror (ret));
+    return ret;
+    }
+
+  process_report_load (self, path, &stats);
+
+  ret = hostexec_run (self, &image, argc, argv);
+  hostexec_unload (&image);
+#endif
+
   return ret;
   }
 
@@ -67,7 +67,12 @@ int sys_open (const char *path, int flags)
         fd = -EISDIR;
         }
       else
+        {
         process_set_filedesc (p, fd, filedesc);
+        // We can't tell whether the file already existed, so treat any
+        //   successful O_CREAT as a change to the directory
+        if (flags & O_CREAT) fsmanager_notify_change (abspath);
+        }
       }
     else
       {
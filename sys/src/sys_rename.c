@@ -47,6 +47,11 @@ int sys_rename (const char *source, const char *target)
        if (desc->rename)
          {
          ret = desc->rename (desc, real_source + 2, real_target + 2);
+         if (ret == 0)
+           {
+           fsmanager_notify_change (real_source);
+           fsmanager_notify_change (real_target);
+           }
          }
        else
          ret = ENOSYS;
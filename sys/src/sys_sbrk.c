@@ -41,7 +41,8 @@ intptr_t _sys_sbrk (intptr_t increment, intptr_t notused1, intptr_t notused2)
   intptr_t new_brk = (intptr_t)old_brk + increment;
   //printf ("new=%08lX\n", new_brk);
 
-  if (new_brk >= RAMTOP) return -1;
+  void *limit = process_get_break_limit (p);
+  if (new_brk >= (limit ? (intptr_t)limit : RAMTOP)) return -1;
   //printf ("OK\n");
 
   process_set_break (p, (void *)new_brk);
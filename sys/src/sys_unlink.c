@@ -49,7 +49,10 @@ int sys_unlink (const char *path)
     if (desc)
       {
       if (desc->unlink)
+        {
 	ret = desc->unlink (desc, abspath + 2);
+        if (ret == 0) fsmanager_notify_change (abspath);
+        }
       else
 	ret = ENOSYS;
       }
@@ -16,6 +16,7 @@
 #include <errno.h>
 #include <sys/syscall.h>
 #include <bearos/syscalls.h>
+#include <chardev/picoconsoledev.h>
 
 // **** NOTE ****
 // The order of syscalls in the syscall table must match the syscall
@@ -123,6 +124,10 @@ SyscallFn syscall_table[100] =
 intptr_t syscall (intptr_t num, intptr_t arg1, intptr_t arg2, intptr_t arg3)
   {
   //printf ("SYSCALL!!!! %d %d %s %d\n", num, arg1, (char *)arg2, arg3);
+
+  // A program that computes, and writes nothing more, still makes
+  //   system calls. This is where its partial line gets flushed.
+  picoconsoledev_poll ();
   
   // TODO check bounds
   SyscallFn fn = syscall_table[num];
@@ -10,6 +10,7 @@
 #include <string.h>
 #include <stdarg.h>
 #include <syslog/syslog.h>
+#include <chardev/picoconsoledev.h>
 
 static SyslogLevel level = LOGLEVEL_WARN;
 
@@ -21,6 +22,9 @@ void syslog (SyslogLevel _level, const char *msg, ...)
   va_start (argList, msg);
   vsnprintf (str, sizeof(str), msg, argList);
   va_end (argList);
+  // Messages go straight to stdio, so console output buffered before
+  //   them must go first
+  picoconsoledev_flush ();
   printf ("%d %s\n", level, str);
   }
 
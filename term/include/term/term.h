@@ -10,9 +10,10 @@
  * ==========================================================================*/
 
 #include <stdint.h>
+#include <stdbool.h>
 #include <pico/stdlib.h>
 #include <sys/error.h>
-#include <klib/list.h>
+#include <klib/vector.h>
 
 #ifdef __cplusplus
 extern "C" {
@@ -22,6 +23,10 @@ extern "C" {
       virtual key codes. */
 int term_get_key (int fd_in);
 
+/** Returns true if input has been read ahead by term_get_key, so that the
+      next call will not have to wait. */
+bool term_key_pending (void);
+
 /** Read a line into the buffer, using simple line editing. 
     Returns true unless the user enters
     the end-of-input character (usually ctrl+d). If the user hits
@@ -31,7 +36,7 @@ int term_get_key (int fd_in);
     be one character smaller, to allow for the string to be 
     zero-terminated. The return value is one of the TGL_XXX constants. */
 int term_get_line (int fd_in, char *buff, int len, 
-       int max_history, List *history);
+       int max_history, Vector *history);
 
 #ifdef __cplusplus
 }
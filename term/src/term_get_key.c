@@ -1,6 +1,11 @@
 /*============================================================================
  *  term/term_get_key.c
  *
+ *  Input is read into a small lookahead buffer, as much as is available
+ *  at a time, and keys are taken from the buffer. The escape sequences
+ *  that the terminal sends for special keys are recognized by walking a
+ *  trie, which is built on first use from the tables below.
+ *
  * Copyright (c)2022 Kevin Boone, GPL v3.0
  * ==========================================================================*/
 
@@ -11,152 +16,266 @@
 #include <stdlib.h>
 #include <pico/stdlib.h>
 #include <stdio.h>
+#include <string.h>
 #include <sys/error.h>
 #include <errno.h>
 #include <term/term.h>
 #include <bearos/terminal.h>
 #include <sys/syscalls.h>
 
+// Size of the lookahead buffer. The console never returns more than a
+//   line in one read, so this only needs to hold a line of pasted text.
+#define TERM_LOOKAHEAD_SIZE 128
+
+// Nodes in the trie. The tables below need about 90.
+#define TERM_TRIE_SIZE 128
+
+typedef struct _TermTrieNode
+  {
+  char c;
+  // Index of the first child and the next sibling, or 0 for none;
+  //   node 0 is the root, so cannot be either.
+  uint8_t child;
+  uint8_t sibling;
+  // The key for the sequence that ends here, or 0 if there isn't one
+  int16_t key;
+  } TermTrieNode;
+
+typedef struct _TermSeq
+  {
+  const char *seq;
+  int16_t key;
+  } TermSeq;
+
+// Sequences that follow ESC, other than the cursor keys
+static const TermSeq term_seqs[] =
+  {
+  {"[Z", VK_SHIFTTAB},
+  {"[0~", VK_END},
+  {"[1~", VK_HOME},
+  {"[2~", VK_INS},
+  {"[3~", VK_DEL}, // Usually the key marked "del"
+  {"[4~", VK_END},
+  {"[5~", VK_PGUP},
+  {"[6~", VK_PGDN},
+  {"[7~", VK_HOME},
+  {"[8~", VK_END},
+  };
+
+#define TERM_NSEQS (int)(sizeof (term_seqs) / sizeof (term_seqs[0]))
+
+// The cursor keys, which come as CSI or SS3 sequences ending in one of
+//   term_dirs, perhaps with a modifier. The keys for each modifier are
+//   in the same order as term_dirs.
+static const char term_dirs[] = "ABCDHF";
+
+static const int16_t term_plain[] =
+  { VK_UP, VK_DOWN, VK_RIGHT, VK_LEFT, VK_HOME, VK_END };
+static const int16_t term_shift[] =
+  { VK_SHIFTUP, VK_SHIFTDOWN, VK_SHIFTRIGHT, VK_SHIFTLEFT, VK_SHIFTHOME,
+    VK_SHIFTEND };
+static const int16_t term_ctrl[] =
+  { VK_CTRLUP, VK_CTRLDOWN, VK_CTRLRIGHT, VK_CTRLLEFT, VK_CTRLHOME,
+    VK_CTRLEND };
+static const int16_t term_ctrlshift[] =
+  { VK_CTRLSHIFTUP, VK_CTRLSHIFTDOWN, VK_CTRLSHIFTRIGHT, VK_CTRLSHIFTLEFT,
+    VK_CTRLSHIFTHOME, VK_CTRLSHIFTEND };
+
+// Modifiers are sent as ESC [1;<m>A. We don't support the ones that
+//   involve alt or meta, and return the plain key for them.
+typedef struct _TermMod
+  {
+  char m;
+  const int16_t *keys;
+  } TermMod;
+
+static const TermMod term_mods[] =
+  {
+  {'2', term_shift}, {'3', term_plain}, {'4', term_plain},
+  {'5', term_ctrl}, {'6', term_ctrlshift}, {'7', term_plain},
+  {'8', term_plain}
+  };
+
+#define TERM_NMODS (int)(sizeof (term_mods) / sizeof (term_mods[0]))
+
+static TermTrieNode term_trie[TERM_TRIE_SIZE];
+static int term_trie_len;
+
+static char term_la[TERM_LOOKAHEAD_SIZE];
+static int term_la_pos;
+static int term_la_len;
+
+/*============================================================================
+ * term_trie_add
+ * ==========================================================================*/
+static void term_trie_add (const char *seq, int16_t key)
+  {
+  int node = 0;
+  for (const char *s = seq; *s; s++)
+    {
+    int child = term_trie[node].child;
+    while (child && term_trie[child].c != *s)
+      child = term_trie[child].sibling;
+    if (!child)
+      {
+      if (term_trie_len == TERM_TRIE_SIZE) return;
+      child = term_trie_len++;
+      memset (&term_trie[child], 0, sizeof (TermTrieNode));
+      term_trie[child].c = *s;
+      term_trie[child].sibling = term_trie[node].child;
+      term_trie[node].child = (uint8_t)child;
+      }
+    node = child;
+    }
+  term_trie[node].key = key;
+  }
+
+/*============================================================================
+ * term_trie_build
+ * ==========================================================================*/
+static void term_trie_build (void)
+  {
+  memset (&term_trie[0], 0, sizeof (TermTrieNode));
+  term_trie_len = 1;
+  for (int i = 0; i < TERM_NSEQS; i++)
+    term_trie_add (term_seqs[i].seq, term_seqs[i].key);
+  for (int i = 0; term_dirs[i]; i++)
+    {
+    char seq[] = "[1;0X";
+    char d = term_dirs[i];
+    term_trie_add ((char[]){'[', d, 0}, term_plain[i]);
+    term_trie_add ((char[]){'O', d, 0}, term_plain[i]);
+    seq[4] = d;
+    for (int m = 0; m < TERM_NMODS; m++)
+      {
+      seq[3] = term_mods[m].m;
+      term_trie_add (seq, term_mods[m].keys[i]);
+      }
+    }
+  }
+
+/*============================================================================
+ * term_trie_next
+ * Returns the child of node that matches c, or 0
+ * ==========================================================================*/
+static int term_trie_next (int node, char c)
+  {
+  int child = term_trie[node].child;
+  while (child && term_trie[child].c != c)
+    child = term_trie[child].sibling;
+  return child;
+  }
+
 /*============================================================================
  * term_get_char
+ * Returns the next byte of input, reading as much as is available if the
+ *   lookahead buffer is empty. Returns 0 at the end of input.
  * ==========================================================================*/
 static int term_get_char (int fd_in)
   {
-  char c;
-  if (sys_read (fd_in, &c, 1) >= 1)
-    return c;
-  else
-    return 0;
+  if (term_la_pos == term_la_len)
+    {
+    int n = sys_read (fd_in, term_la, TERM_LOOKAHEAD_SIZE);
+    if (n < 1) return 0;
+    term_la_pos = 0;
+    term_la_len = n;
+    }
+  return (uint8_t)term_la[term_la_pos++];
   }
 
 /*============================================================================
  * term_get_char_timeout
+ * As term_get_char, but returns -1 if nothing arrives in msec
+ *   milliseconds. The console can only wait for one character.
  * ==========================================================================*/
 static int term_get_char_timeout (int fd_in, int msec)
   {
+  if (term_la_pos < term_la_len)
+    return (uint8_t)term_la[term_la_pos++];
   int c = sys_read_timeout (fd_in, msec);
-  return c;
+  if (c < 0) return -1;
+  return (uint8_t)c;
   }
 
 /*============================================================================
- * term_get_key
+ * term_unget_char
+ * Put back the last character returned.
  * ==========================================================================*/
-int term_get_key (int fd_in)
+static void term_unget_char (int c)
   {
-  char c = (char)term_get_char (fd_in);
-  if (c == '\x1b') 
+  if (term_la_pos > 0)
+    term_la[--term_la_pos] = (char)c;
+  else if (term_la_len < TERM_LOOKAHEAD_SIZE)
     {
-    char c1 = (char)term_get_char_timeout (fd_in, I_ESC_TIMEOUT);
-    if (c1 == (char)0xFF) return VK_ESC;
-    //printf ("c1 a =%d %c\n", c1, c1);
-    if (c1 == '[') 
+    memmove (term_la + 1, term_la, (size_t)term_la_len);
+    term_la[0] = (char)c;
+    term_la_len++;
+    }
+  }
+
+/*============================================================================
+ * term_get_sequence
+ * Decode the rest of an escape sequence. If the byte after ESC doesn't
+ *   start a sequence, it is left for next time, and the ESC is returned
+ *   by itself. A CSI sequence that isn't in the trie is read up to its
+ *   final byte and discarded, so that its parameters don't end up in
+ *   the input.
+ * ==========================================================================*/
+static int term_get_sequence (int fd_in)
+  {
+  if (term_trie_len == 0) term_trie_build ();
+
+  int c = term_get_char_timeout (fd_in, I_ESC_TIMEOUT);
+  if (c < 0) return VK_ESC;
+  int node = term_trie_next (0, (char)c);
+  if (!node)
+    {
+    term_unget_char (c);
+    return VK_ESC;
+    }
+  bool csi = (c == '[');
+
+  while (term_trie[node].child)
+    {
+    c = term_get_char_timeout (fd_in, I_ESC_TIMEOUT);
+    if (c < 0) return VK_ESC;
+    int next = term_trie_next (node, (char)c);
+    if (!next)
       {
-      char c2 = (char)term_get_char (fd_in);
-      //printf ("c2 a =%d %c\n", c2, c2);
-      if (c2 >= '0' && c2 <= '9') 
-        {
-        char c3 = (char)term_get_char(fd_in);
-        //printf ("c3 a =%d %c\n", c3, c3);
-        if (c3 == '~') 
-          {
-          switch (c2) 
-            {
-            case '0': return VK_END;
-            case '1': return VK_HOME;
-            case '2': return VK_INS;
-            case '3': return VK_DEL; // Usually the key marked "del"
-            case '5': return VK_PGUP;
-            case '6': return VK_PGDN;
-            }
-          }
-        else if (c3 == ';')
-          {
-          if (c2 == '1') 
-            {
-            char c4 = (char)term_get_char (fd_in); // Modifier
-            char c5 = (char)term_get_char (fd_in); // Direction
-            //printf ("c4 b =%d %c\n", c4, c4);
-            //printf ("c5 b =%d %c\n", c5, c5);
-            if (c4 == '5') // ctrl
-              {
-              switch (c5) 
-        	{
-        	case 'A': return VK_CTRLUP;
-        	case 'B': return VK_CTRLDOWN;
-        	case 'C': return VK_CTRLRIGHT;
-        	case 'D': return VK_CTRLLEFT;
-        	case 'H': return VK_CTRLHOME;
-        	case 'F': return VK_CTRLEND;
-        	}
-              }
-            else if (c4 == '2') // shift 
-              {
-              switch (c5) 
-        	{
-        	case 'A': return VK_SHIFTUP;
-        	case 'B': return VK_SHIFTDOWN;
-        	case 'C': return VK_SHIFTRIGHT;
-        	case 'D': return VK_SHIFTLEFT;
-        	case 'H': return VK_SHIFTHOME;
-        	case 'F': return VK_SHIFTEND;
-        	}
-              }
-            else if (c4 == '6') // shift-ctrl
-              {
-              switch (c5) 
-        	{
-        	case 'A': return VK_CTRLSHIFTUP;
-        	case 'B': return VK_CTRLSHIFTDOWN;
-        	case 'C': return VK_CTRLSHIFTRIGHT;
-        	case 'D': return VK_CTRLSHIFTLEFT;
-        	case 'H': return VK_CTRLSHIFTHOME;
-        	case 'F': return VK_CTRLSHIFTEND;
-        	}
-              }
-            else 
-              {
-              // Any other modifier, we don't support. Just return
-              //   the raw direction code
-              switch (c5) 
-        	{
-        	case 'A': return VK_UP;
-        	case 'B': return VK_DOWN;
-        	case 'C': return VK_RIGHT;
-        	case 'D': return VK_LEFT;
-        	case 'H': return VK_HOME;
-        	case 'F': return VK_END;
-        	}
-              }
-            }
-          else return VK_ESC;
-          }
-        }
-      else
+      while (csi && !(c >= 0x40 && c <= 0x7E))
         {
-        //printf ("c2 b =%d %c\n", c2, c2);
-        switch (c2) 
-          {
-          case 'A': return VK_UP;
-          case 'B': return VK_DOWN;
-          case 'C': return VK_RIGHT;
-          case 'D': return VK_LEFT;
-          case 'H': return VK_HOME;
-          case 'F': return VK_END;
-          case 'Z': return VK_SHIFTTAB;
-          }
+        c = term_get_char_timeout (fd_in, I_ESC_TIMEOUT);
+        if (c < 0) break;
         }
+      return VK_ESC;
       }
-    return '\x1b';
-    } 
- else 
-    {
-    if (c == I_BACKSPACE) return VK_BACK;
-    if (c == I_DEL) return VK_DEL;
-    if (c == I_INTR) return VK_INTR;
-    if (c == I_EOI) return VK_EOI;
-    if (c == 0) return VK_EOI;
-    if (c == I_EOL) return VK_ENTER;
-    return c;
-    } 
+    node = next;
+    }
+  return term_trie[node].key;
+  }
+
+/*============================================================================
+ * term_key_pending
+ * ==========================================================================*/
+bool term_key_pending (void)
+  {
+  return term_la_pos < term_la_len;
+  }
+
+/*============================================================================
+ * term_get_key
+ * ==========================================================================*/
+int term_get_key (int fd_in)
+  {
+  int c = term_get_char (fd_in);
+  if (c == '\x1b')
+    return term_get_sequence (fd_in);
+  if (c == I_BACKSPACE) return VK_BACK;
+  if (c == I_DEL) return VK_DEL;
+  if (c == I_INTR) return VK_INTR;
+  if (c == I_EOI) return VK_EOI;
+  if (c == 0) return VK_EOI;
+  if (c == I_EOL) return VK_ENTER;
+  return c;
   }
 
@@ -19,30 +19,97 @@
 #include <errno.h>
 #include <term/term.h>
 #include <klib/string.h>
+#include <klib/vector.h>
 #include <bearos/devctl.h>
 #include <bearos/terminal.h>
 
+// Size of the buffer that echo and redraw output is collected in
+#define TERM_OUT_SIZE 256
+
 /*============================================================================
- * term_add_line_to_history 
+ * TermOut
+ * Output to the terminal is collected here, and written when all the
+ * input that has arrived has been dealt with, or when the buffer is full.
+ * So a redraw is one write, however many characters it moves over, and
+ * so is the echo of a burst of typing or of pasted text.
+ * ==========================================================================*/
+typedef struct _TermOut
+  {
+  char buff[TERM_OUT_SIZE];
+  int len;
+  } TermOut;
+
+/*============================================================================
+ * term_out_flush
+ * ==========================================================================*/
+static void term_out_flush (TermOut *out)
+  {
+  if (out->len > 0)
+    sys_write (STDOUT_FILENO, out->buff, out->len);
+  out->len = 0;
+  }
+
+/*============================================================================
+ * term_out_char
+ * ==========================================================================*/
+static void term_out_char (TermOut *out, char c)
+  {
+  if (out->len == TERM_OUT_SIZE) term_out_flush (out);
+  out->buff[out->len++] = c;
+  }
+
+/*============================================================================
+ * term_out_chars
+ * ==========================================================================*/
+static void term_out_chars (TermOut *out, const char *s, int n)
+  {
+  for (int i = 0; i < n; i++)
+    term_out_char (out, s[i]);
+  }
+
+/*============================================================================
+ * term_out_repeat
+ * ==========================================================================*/
+static void term_out_repeat (TermOut *out, char c, int n)
+  {
+  for (int i = 0; i < n; i++)
+    term_out_char (out, c);
+  }
+
+/*============================================================================
+ * term_replace_line
+ * Replace the line on the terminal, with the cursor at pos, by newline,
+ *   and leave the cursor at its end.
  * ==========================================================================*/
-static void term_write_string (const char *s)
+static void term_replace_line (TermOut *out, int pos, int oldlen,
+       const char *newline)
   {
-  sys_write (STDOUT_FILENO, s, (int)strlen (s));
+  int newlen = (int)strlen (newline);
+  // Move to the start of the line
+  term_out_repeat (out, O_BACKSPACE, pos);
+  // Write the new line
+  term_out_chars (out, newline, newlen);
+  // Erase from the end of the new line to the end of the old
+  if (oldlen > newlen)
+    {
+    term_out_repeat (out, ' ', oldlen - newlen);
+    term_out_repeat (out, O_BACKSPACE, oldlen - newlen);
+    }
   }
 
 /*============================================================================
  * term_add_line_to_history 
  * ==========================================================================*/
-static void term_add_line_to_history (List *history, int max_history, 
+static void term_add_line_to_history (Vector *history, int max_history, 
         const char *buff)
   {
   BOOL should_add = TRUE;
-  int l = list_length (history);
+  int l = vector_length (history);
   if (l < max_history)
     {
     for (int i = 0; i < l && should_add; i++)
       {
-      if (strcmp (buff, list_get (history, i)) == 0)
+      if (strcmp (buff, vector_get (history, i)) == 0)
         should_add = FALSE;
       }
     }
@@ -51,10 +118,9 @@ static void term_add_line_to_history (List *history, int max_history,
     {
     if (l >= max_history)
       {
-      const char *s = list_get (history, 0);
-      list_remove_object (history, s);
+      vector_remove_at (history, 0);
       }
-    list_append (history, strdup (buff));
+    vector_append (history, strdup (buff));
     }
   }
 
@@ -62,7 +128,7 @@ static void term_add_line_to_history (List *history, int max_history,
  * term_get_line
  * ==========================================================================*/
 int term_get_line (int fd_in, char *buff, int len, 
-        int max_history, List *history)
+        int max_history, Vector *history)
   {
   int pos = 0;
   bool done = 0;
@@ -73,6 +139,8 @@ int term_get_line (int fd_in, char *buff, int len,
   // A copy of the main input buffer, taken when we up-arrow back
   //  into the history. We might need to restore this on a down-arrow
   char *tempstr = NULL;
+  TermOut *out = malloc (sizeof (TermOut));
+  out->len = 0;
 
   bool interrupt = false;
 
@@ -88,6 +156,8 @@ int term_get_line (int fd_in, char *buff, int len,
 
   while (!done)
     {
+    // Only write when we have caught up with the input
+    if (!term_key_pending ()) term_out_flush (out);
     int c = term_get_key (fd_in);
     if (c == VK_INTR)
       {
@@ -106,18 +176,12 @@ int term_get_line (int fd_in, char *buff, int len,
         {
         pos--;
         string_delete_c_at (sbuff, pos);
-        putchar (O_BACKSPACE);
+        term_out_char (out, O_BACKSPACE);
         const char *s = string_cstr (sbuff);
         int l = string_length (sbuff);
-        for (int i = pos; i < l; i++)
-          {
-          putchar (s[i]);
-          }
-        putchar (' ');
-        for (int i = pos; i <= l; i++)
-          {
-          putchar (O_BACKSPACE);
-          }
+        term_out_chars (out, s + pos, l - pos);
+        term_out_char (out, ' ');
+        term_out_repeat (out, O_BACKSPACE, l - pos + 1);
         }
       }
     else if (c == VK_ENTER)
@@ -130,7 +194,7 @@ int term_get_line (int fd_in, char *buff, int len,
       if (pos > 0)
         {
         pos--;
-        putchar (O_BACKSPACE);
+        term_out_char (out, O_BACKSPACE);
         }
       }
     else if (c == VK_CTRLLEFT)
@@ -138,7 +202,7 @@ int term_get_line (int fd_in, char *buff, int len,
       if (pos == 1)
         {
         pos = 0;
-        putchar (O_BACKSPACE);
+        term_out_char (out, O_BACKSPACE);
         }
       else
         {
@@ -146,12 +210,12 @@ int term_get_line (int fd_in, char *buff, int len,
         while (pos > 0 && isspace ((int)s[(pos - 1)]))
           {
           pos--;
-          putchar (O_BACKSPACE);
+          term_out_char (out, O_BACKSPACE);
           }
         while (pos > 0 && !isspace ((int)s[pos - 1]))
           {
           pos--;
-          putchar (O_BACKSPACE);
+          term_out_char (out, O_BACKSPACE);
           }
         }
       }
@@ -161,12 +225,12 @@ int term_get_line (int fd_in, char *buff, int len,
 
       while (s[pos] != 0 && !isspace ((int)s[pos]))
         {
-        putchar (s[pos]);
+        term_out_char (out, s[pos]);
         pos++;
         }
       while (s[pos] != 0 && isspace ((int)s[pos]))
         {
-        putchar (s[pos]);
+        term_out_char (out, s[pos]);
         pos++;
         }
       }
@@ -176,7 +240,7 @@ int term_get_line (int fd_in, char *buff, int len,
       int l = string_length (sbuff);
       if (pos < l)
         {
-        putchar (s[pos]);
+        term_out_char (out, s[pos]);
         pos++;
         }
       }
@@ -184,7 +248,7 @@ int term_get_line (int fd_in, char *buff, int len,
       {
       if (!history) continue;
       if (histpos == 0) continue;
-      int histlen = list_length (history);
+      int histlen = vector_length (history);
       if (histlen == 0) continue;
       //printf ("histlen=%d histpos=%d\n", histlen, histpos);
 
@@ -201,28 +265,16 @@ int term_get_line (int fd_in, char *buff, int len,
         histpos --;
         }
 
-      int oldlen = string_length (sbuff);
-      const char *newline = list_get (history, histpos); 
-      int newlen = (int)strlen (newline);
-      // Move to the start of the line 
-       for (int i = 0; i < pos; i++)
-        putchar (O_BACKSPACE);
-      // Write the new line
-      for (int i = 0; i < newlen; i++)
-        putchar (newline[i]);
-      // Erase from the end of the new line to the end of the old 
-      for (int i = newlen; i < oldlen; i++)
-        putchar (' ');
-      for (int i = newlen; i < oldlen; i++)
-        putchar (O_BACKSPACE);
-      pos = newlen;
+      const char *newline = vector_get (history, histpos); 
+      term_replace_line (out, pos, string_length (sbuff), newline);
+      pos = (int)strlen (newline);
       string_destroy (sbuff);
       sbuff = string_create (newline);
       }
     else if (c == VK_DOWN)
       {
       if (!history) continue;
-      int histlen = list_length (history);
+      int histlen = vector_length (history);
       if (histpos < 0) continue; 
       char *newline = "";
       bool restored_temp = false;
@@ -242,23 +294,11 @@ int term_get_line (int fd_in, char *buff, int len,
         {
         restored_temp = false;
         histpos++;
-        newline = list_get (history, histpos); 
+        newline = vector_get (history, histpos); 
         }
 
-      int oldlen = string_length (sbuff);
-      int newlen = (int)strlen (newline);
-      // Move to the start of the line 
-       for (int i = 0; i < pos; i++)
-          putchar (O_BACKSPACE);
-      // Write the new line
-      for (int i = 0; i < newlen; i++)
-          putchar (newline[i]);
-        // Erase from the end of the new line to the end of the old 
-      for (int i = newlen; i < oldlen; i++)
-          putchar (' ');
-      for (int i = newlen; i < oldlen; i++)
-          putchar (O_BACKSPACE);
-      pos = newlen;
+      term_replace_line (out, pos, string_length (sbuff), newline);
+      pos = (int)strlen (newline);
       string_destroy (sbuff);
       sbuff = string_create (newline);
       if (restored_temp)
@@ -269,19 +309,14 @@ int term_get_line (int fd_in, char *buff, int len,
       }
     else if (c == VK_HOME)
       {
-      if (pos > 0)
-        {
-        for (int i = 0; i < pos; i++)
-          putchar (O_BACKSPACE);
-        pos = 0;
-        }
+      term_out_repeat (out, O_BACKSPACE, pos);
+      pos = 0;
       }
     else if (c == VK_END)
       {
       const char *s = string_cstr (sbuff);
       int l = string_length (sbuff);
-      for (int i = pos; i < l; i++)
-          putchar (s[i]);
+      term_out_chars (out, s + pos, l - pos);
       pos = l;
       }
     else
@@ -295,17 +330,10 @@ int term_get_line (int fd_in, char *buff, int len,
           string_insert_c_at (sbuff, pos, (char)c);
           pos++;
           int l = string_length (sbuff);
-          //if (pos >= l - 1)
-          if (pos >= l)
-            putchar ((char)c); 
-          else
-            {
-            const char *s = string_cstr (sbuff);
-            for (int i = pos - 1; i < l; i++)
-              putchar (s[i]); 
-            for (int i = pos; i < l; i++)
-              putchar (O_BACKSPACE); 
-            }
+          // Write the rest of the line, and go back to the cursor
+          const char *s = string_cstr (sbuff);
+          term_out_chars (out, s + pos - 1, l - pos + 1);
+          term_out_repeat (out, O_BACKSPACE, l - pos);
           }
         }
       }
@@ -316,7 +344,9 @@ int term_get_line (int fd_in, char *buff, int len,
 
   if (tempstr) free (tempstr);
 
-  term_write_string (O_ENDL_STR); 
+  term_out_chars (out, O_ENDL_STR, (int)strlen (O_ENDL_STR));
+  term_out_flush (out);
+  free (out);
   histpos = -1; 
 
   sys_devctl (0, DC_TERM_SET_FLAGS, (int32_t)oldflags);
@@ -339,5 +369,3 @@ int term_get_line (int fd_in, char *buff, int len,
     return TGL_EOI;
   }
 
-
-
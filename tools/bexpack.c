@@ -0,0 +1,455 @@
+/*============================================================================
+ *  tools/bexpack.c
+ *
+ *  Host utility to make a packed BearOS executable from an ELF file. The
+ *  loadable segments are laid out as they will be in memory, and compressed
+ *  as a single LZ4 block, after a BearosPackedHeader. See
+ *  docs/PORTING_TO_BEAROS.md.
+ *
+ *  Build, from the top of the source tree:
+ *
+ *    cc -O2 -o bexpack -Iklib/include -Iapi/bearos tools/bexpack.c \
+ *      klib/src/lz4.c
+ *
+ *  Usage: bexpack [-b] [-v] {input.elf} {output}
+ *
+ *  The packed file is always unpacked again and compared with the 
+ *  original, before it is written. With -b, the time taken to read the
+ *  raw and packed files and to unpack is reported, as a rough guide to
+ *  which will load faster.
+ *
+ * Copyright (c)2023 Kevin Boone, GPL v3.0
+ * ==========================================================================*/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <string.h>
+#include <errno.h>
+#include <time.h>
+#include <unistd.h>
+#include <getopt.h>
+#include <bearos/exec.h>
+#include <klib/lz4.h>
+
+#define PT_LOAD 1
+#define EM_ARM 0x28
+
+// Same as ELF_TEXT_OFFSET in the kernel
+#define TEXT_OFFSET 0x5800
+
+// LZ4 format limits. Matches must not start within MFLIMIT bytes of
+//   the end of the input, and the last LAST_LITERALS bytes are always
+//   literals. These rules are only needed for compatibility with other
+//   LZ4 decoders
+#define MIN_MATCH 4
+#define MFLIMIT 12
+#define LAST_LITERALS 5
+#define MAX_OFFSET 65535
+#define HASH_BITS 16
+
+// The size of the buffer used by the kernel, for the benchmark
+#define READ_BUFF_SIZE 2048
+
+/*============================================================================
+ * rd16, rd32, wr32 
+ * ELF files and packed headers are little-endian, whatever the host is
+ * ==========================================================================*/
+static uint32_t rd16 (const uint8_t *p)
+  {
+  return (uint32_t)(p[0] | (p[1] << 8));
+  }
+
+static uint32_t rd32 (const uint8_t *p)
+  {
+  return (uint32_t)p[0] | ((uint32_t)p[1] << 8) | ((uint32_t)p[2] << 16)
+    | ((uint32_t)p[3] << 24);
+  }
+
+static void wr32 (uint8_t *p, uint32_t v)
+  {
+  p[0] = (uint8_t)v; p[1] = (uint8_t)(v >> 8);
+  p[2] = (uint8_t)(v >> 16); p[3] = (uint8_t)(v >> 24);
+  }
+
+/*============================================================================
+ * now_us 
+ * ==========================================================================*/
+static double now_us (void)
+  {
+  struct timespec ts;
+  clock_gettime (CLOCK_MONOTONIC, &ts);
+  return (double)ts.tv_sec * 1e6 + (double)ts.tv_nsec / 1e3;
+  }
+
+/*============================================================================
+ * read_file 
+ * ==========================================================================*/
+static uint8_t *read_file (const char *filename, uint32_t *len)
+  {
+  FILE *f = fopen (filename, "rb");
+  if (!f) return NULL;
+  fseek (f, 0, SEEK_END);
+  long size = ftell (f);
+  fseek (f, 0, SEEK_SET);
+  uint8_t *buff = malloc ((size_t)size + 1);
+  if (buff && fread (buff, 1, (size_t)size, f) != (size_t)size)
+    {
+    free (buff);
+    buff = NULL;
+    }
+  fclose (f);
+  *len = (uint32_t)size;
+  return buff;
+  }
+
+/*============================================================================
+ * make_image
+ * Lay out the PT_LOAD segments as they will be in memory. Returns 0 or
+ * an error message.
+ * ==========================================================================*/
+static const char *make_image (const uint8_t *elf, uint32_t len, 
+         BearosPackedHeader *hdr, uint8_t **image)
+  {
+  if (len < 52 || memcmp (elf, "\177ELF", 4) != 0 || elf[4] != 1 
+       || elf[5] != 1)
+    return "not a 32-bit little-endian ELF file";
+  if (rd16 (elf + 18) != EM_ARM)
+    return "not an ARM executable";
+
+  uint32_t entry = rd32 (elf + 24);
+  uint32_t phoff = rd32 (elf + 28);
+  uint32_t phentsize = rd16 (elf + 42);
+  uint32_t phnum = rd16 (elf + 44);
+
+  uint32_t low = UINT32_MAX, high_file = 0, high_mem = 0;
+  int nload = 0;
+  for (uint32_t i = 0; i < phnum && phentsize >= 32; i++)
+    {
+    const uint8_t *ph = elf + phoff + i * phentsize;
+    if (phoff + (i + 1) * phentsize > len) return "bad program headers";
+    uint32_t offset = rd32 (ph + 4), vaddr = rd32 (ph + 8);
+    uint32_t filesz = rd32 (ph + 16), memsz = rd32 (ph + 20);
+    if (rd32 (ph) != PT_LOAD || memsz == 0) continue;
+    if (filesz > memsz || offset + filesz > len) return "bad segment";
+    if (vaddr < low) low = vaddr;
+    if (vaddr + filesz > high_file) high_file = vaddr + filesz;
+    if (vaddr + memsz > high_mem) high_mem = vaddr + memsz;
+    nload++;
+    }
+
+  if (nload == 0)
+    {
+    // Same fallback as the kernel
+    if (len <= TEXT_OFFSET) return "no loadable segments";
+    low = BEAROS_LOAD_ADDRESS;
+    high_file = low + len - TEXT_OFFSET;
+    high_mem = high_file + 1024;
+    }
+  if (low < BEAROS_LOAD_ADDRESS) return "segment below the load address";
+  if (high_file <= low) return "no data to load";
+
+  uint32_t size = high_file - low;
+  *image = calloc (1, size);
+  if (nload == 0)
+    memcpy (*image, elf + TEXT_OFFSET, size);
+  else
+    {
+    for (uint32_t i = 0; i < phnum; i++)
+      {
+      const uint8_t *ph = elf + phoff + i * phentsize;
+      if (rd32 (ph) != PT_LOAD || rd32 (ph + 20) == 0) continue;
+      memcpy (*image + rd32 (ph + 8) - low, elf + rd32 (ph + 4), 
+        rd32 (ph + 16));
+      }
+    }
+
+  entry &= ~1u;
+  memset (hdr, 0, sizeof (*hdr));
+  hdr->magic = BEAROS_PACKED_MAGIC;
+  hdr->entry = (entry >= low && entry < high_mem) ? entry : low;
+  hdr->load = low;
+  hdr->size = size;
+  hdr->memsz = high_mem - low;
+  return NULL;
+  }
+
+/*============================================================================
+ * put_length
+ * ==========================================================================*/
+static uint8_t *put_length (uint8_t *op, uint32_t len)
+  {
+  while (len >= 255)
+    {
+    *op++ = 255;
+    len -= 255;
+    }
+  *op++ = (uint8_t)len;
+  return op;
+  }
+
+/*============================================================================
+ * put_sequence
+ * ==========================================================================*/
+static uint8_t *put_sequence (uint8_t *op, const uint8_t *lit, 
+         uint32_t nlit, uint32_t offset, uint32_t mlen)
+  {
+  uint8_t *token = op++;
+  *token = (uint8_t)((nlit >= 15 ? 15 : nlit) << 4);
+  if (nlit >= 15) op = put_length (op, nlit - 15);
+  memcpy (op, lit, nlit);
+  op += nlit;
+  if (mlen)
+    {
+    *op++ = (uint8_t)offset;
+    *op++ = (uint8_t)(offset >> 8);
+    mlen -= MIN_MATCH;
+    *token |= (uint8_t)(mlen >= 15 ? 15 : mlen);
+    if (mlen >= 15) op = put_length (op, mlen - 15);
+    }
+  return op;
+  }
+
+/*============================================================================
+ * hash4
+ * ==========================================================================*/
+static uint32_t hash4 (const uint8_t *p)
+  {
+  return (rd32 (p) * 2654435761u) >> (32 - HASH_BITS);
+  }
+
+/*============================================================================
+ * lz4_compress
+ * A simple greedy compressor. out must have room for lz4_bound(len) bytes.
+ * ==========================================================================*/
+static uint32_t lz4_bound (uint32_t len)
+  {
+  return len + len / 255 + 16;
+  }
+
+static uint32_t lz4_compress (const uint8_t *in, uint32_t len, uint8_t *out)
+  {
+  uint32_t *table = calloc (1 << HASH_BITS, sizeof (uint32_t));
+  uint8_t *op = out;
+  uint32_t anchor = 0, ip = 0;
+  uint32_t limit = len > MFLIMIT ? len - MFLIMIT : 0;
+
+  while (ip < limit)
+    {
+    uint32_t h = hash4 (in + ip);
+    uint32_t cand = table[h];
+    table[h] = ip + 1; // Zero means empty
+    if (cand && ip - (cand - 1) <= MAX_OFFSET 
+         && rd32 (in + cand - 1) == rd32 (in + ip))
+      {
+      uint32_t ref = cand - 1;
+      // Extend backwards over literals, then forwards
+      while (ip > anchor && ref > 0 && in[ip - 1] == in[ref - 1])
+        { ip--; ref--; }
+      uint32_t mlen = MIN_MATCH;
+      while (ip + mlen < len - LAST_LITERALS && in[ip + mlen] == in[ref + mlen])
+        mlen++;
+      op = put_sequence (op, in + anchor, ip - anchor, ip - ref, mlen);
+      ip += mlen;
+      anchor = ip;
+      if (ip >= 2 && ip - 2 < limit) table[hash4 (in + ip - 2)] = ip - 1;
+      }
+    else
+      ip++;
+    }
+
+  op = put_sequence (op, in + anchor, len - anchor, 0, 0);
+  free (table);
+  return (uint32_t)(op - out);
+  }
+
+typedef struct _MemReader
+  {
+  const uint8_t *p;
+  uint32_t remaining;
+  } MemReader;
+
+/*============================================================================
+ * mem_read
+ * The LZ4ReadFn for unpacking from memory, a buffer at a time as the 
+ * kernel does it.
+ * ==========================================================================*/
+static int mem_read (void *context, uint8_t *buff, int len)
+  {
+  MemReader *r = context;
+  if ((uint32_t)len > r->remaining) len = (int)r->remaining;
+  memcpy (buff, r->p, (size_t)len);
+  r->p += len;
+  r->remaining -= (uint32_t)len;
+  return len;
+  }
+
+/*============================================================================
+ * unpack 
+ * ==========================================================================*/
+static int32_t unpack (const uint8_t *packed, uint32_t packed_size,
+         uint8_t *out, uint32_t size)
+  {
+  uint8_t buff[READ_BUFF_SIZE];
+  MemReader r = { packed, packed_size };
+  return lz4_decompress_stream (mem_read, &r, buff, sizeof (buff), 
+    out, size);
+  }
+
+/*============================================================================
+ * time_read
+ * The time to read a file in READ_BUFF_SIZE chunks, after the OS has
+ * cached it.
+ * ==========================================================================*/
+static double time_read (const char *filename)
+  {
+  uint8_t buff[READ_BUFF_SIZE];
+  double best = 1e30;
+  for (int i = 0; i < 10; i++)
+    {
+    FILE *f = fopen (filename, "rb");
+    if (!f) return 0;
+    double t0 = now_us ();
+    while (fread (buff, 1, sizeof (buff), f) > 0) {}
+    double t = now_us () - t0;
+    fclose (f);
+    if (t < best) best = t;
+    }
+  return best;
+  }
+
+/*============================================================================
+ * benchmark
+ * ==========================================================================*/
+static void benchmark (const char *in_name, const char *out_name, 
+         uint32_t raw_len, const uint8_t *packed, 
+         const BearosPackedHeader *hdr)
+  {
+  uint8_t *out = malloc (hdr->size);
+  double best = 1e30;
+  for (int i = 0; i < 20; i++)
+    {
+    double t0 = now_us ();
+    unpack (packed, hdr->packed_size, out, hdr->size);
+    double t = now_us () - t0;
+    if (t < best) best = t;
+    }
+  free (out);
+
+  double t_raw = time_read (in_name);
+  double t_packed = time_read (out_name);
+  printf ("raw:    %8lu bytes, read %8.1f us\n", (unsigned long)raw_len, 
+    t_raw);
+  printf ("packed: %8lu bytes, read %8.1f us, unpack %8.1f us "
+    "(%.1f MB/s)\n", (unsigned long)(hdr->packed_size + sizeof (*hdr)), 
+    t_packed, best, (double)hdr->size / best);
+  // The device reads an SD card at very roughly 500 kB/s, and unpacks
+  //   perhaps fifty times more slowly than a desktop CPU
+  double sd_raw = (double)raw_len / 0.5;
+  double sd_packed = (double)(hdr->packed_size + sizeof (*hdr)) / 0.5 
+    + best * 50;
+  printf ("estimated on device: raw %.0f ms, packed %.0f ms\n", 
+    sd_raw / 1000, sd_packed / 1000);
+  }
+
+/*============================================================================
+ * show_usage 
+ * ==========================================================================*/
+static void show_usage (const char *argv0)
+  {
+  fprintf (stderr, "Usage: %s [-b] [-v] {input.elf} {output}\n", argv0);
+  fprintf (stderr, "  -b  compare load times for the raw and packed files\n");
+  fprintf (stderr, "  -v  show details of the image\n");
+  }
+
+/*============================================================================
+ * main 
+ * ==========================================================================*/
+int main (int argc, char **argv)
+  {
+  int opt;
+  int bench = 0, verbose = 0;
+  while ((opt = getopt (argc, argv, "bhv")) != -1)
+    {
+    switch (opt)
+      {
+      case 'b': bench = 1; break;
+      case 'v': verbose = 1; break;
+      default: show_usage (argv[0]); return 1;
+      }
+    }
+  if (argc - optind != 2)
+    {
+    show_usage (argv[0]);
+    return 1;
+    }
+  const char *in_name = argv[optind];
+  const char *out_name = argv[optind + 1];
+
+  uint32_t len;
+  uint8_t *elf = read_file (in_name, &len);
+  if (!elf)
+    {
+    fprintf (stderr, "%s: %s: %s\n", argv[0], in_name, strerror (errno));
+    return 1;
+    }
+
+  BearosPackedHeader hdr;
+  uint8_t *image = NULL;
+  const char *msg = make_image (elf, len, &hdr, &image);
+  if (msg)
+    {
+    fprintf (stderr, "%s: %s: %s\n", argv[0], in_name, msg);
+    return 1;
+    }
+
+  uint8_t *packed = malloc (lz4_bound (hdr.size));
+  hdr.packed_size = lz4_compress (image, hdr.size, packed);
+
+  uint8_t *check = malloc (hdr.size);
+  int32_t n = unpack (packed, hdr.packed_size, check, hdr.size);
+  if (n != (int32_t)hdr.size || memcmp (check, image, hdr.size) != 0)
+    {
+    fprintf (stderr, "%s: internal error: image does not unpack (%ld)\n", 
+      argv[0], (long)n);
+    return 1;
+    }
+  free (check);
+
+  if (verbose)
+    {
+    printf ("load %08lX entry %08lX size %lu memsz %lu packed %lu\n",
+      (unsigned long)hdr.load, (unsigned long)hdr.entry, 
+      (unsigned long)hdr.size, (unsigned long)hdr.memsz,
+      (unsigned long)hdr.packed_size);
+    }
+
+  uint8_t raw_hdr[sizeof (hdr)];
+  memset (raw_hdr, 0, sizeof (raw_hdr));
+  wr32 (raw_hdr + 0, hdr.magic);
+  wr32 (raw_hdr + 4, hdr.entry);
+  wr32 (raw_hdr + 8, hdr.load);
+  wr32 (raw_hdr + 12, hdr.size);
+  wr32 (raw_hdr + 16, hdr.memsz);
+  wr32 (raw_hdr + 20, hdr.packed_size);
+
+  FILE *f = fopen (out_name, "wb");
+  if (!f || fwrite (raw_hdr, 1, sizeof (raw_hdr), f) != sizeof (raw_hdr)
+     || fwrite (packed, 1, hdr.packed_size, f) != hdr.packed_size)
+    {
+    fprintf (stderr, "%s: %s: %s\n", argv[0], out_name, strerror (errno));
+    return 1;
+    }
+  fclose (f);
+
+  printf ("%s: %lu -> %lu bytes (%.0f%%)\n", out_name, (unsigned long)len,
+    (unsigned long)(hdr.packed_size + sizeof (hdr)), 
+    100.0 * (double)(hdr.packed_size + sizeof (hdr)) / (double)len);
+
+  if (bench) benchmark (in_name, out_name, len, packed, &hdr);
+
+  free (packed);
+  free (image);
+  free (elf);
+  return 0;
+  }
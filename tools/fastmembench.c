@@ -0,0 +1,261 @@
+/*============================================================================
+ *  tools/fastmembench.c
+ *
+ *  Host check and benchmark for klib/fastmem. It first compares every
+ *  function with a plain byte loop, for all lengths up to 70 bytes at
+ *  every alignment, with the byte sought at every position and with
+ *  random fill, including bytes above 127. It then times each function
+ *  against the byte loop it replaces, and the C library's version where
+ *  there is one, over a buffer of text. The host's C library uses SIMD,
+ *  so it is no guide to the device. Neither are byte loops that the
+ *  compiler has vectorized, or turned into library calls, so build
+ *  without that. Run with -c to do only the checks.
+ *
+ *  Build, from the top of the source tree:
+ *
+ *    cc -O2 -fno-tree-vectorize -fno-tree-loop-distribute-patterns \
+ *      -o fastmembench -Iklib/include tools/fastmembench.c \
+ *      klib/src/fastmem.c
+ *
+ * Copyright (c)2023 Kevin Boone, GPL v3.0
+ * ==========================================================================*/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <string.h>
+#include <time.h>
+#include <klib/fastmem.h>
+
+#define MAX_LEN 70
+#define BENCH_SIZE 65536
+#define BENCH_BYTES 500000000.0
+
+static int failures;
+
+// Stops the compiler from optimizing the benchmark loops away
+static volatile size_t sink;
+
+/*============================================================================
+ * now
+ * ==========================================================================*/
+static double now (void)
+  {
+  struct timespec ts;
+  clock_gettime (CLOCK_MONOTONIC, &ts);
+  return (double)ts.tv_sec + (double)ts.tv_nsec / 1e9;
+  }
+
+/*============================================================================
+ * Byte loops, which are both the reference for checking, and what fastmem
+ *   is timed against
+ * ==========================================================================*/
+static const void *byte_memchr (const void *s, int c, size_t n)
+  {
+  const uint8_t *p = s;
+  for (size_t i = 0; i < n; i++)
+    if (p[i] == (uint8_t)c) return p + i;
+  return NULL;
+  }
+
+static size_t byte_strlen (const char *s)
+  {
+  size_t n = 0;
+  while (s[n]) n++;
+  return n;
+  }
+
+static size_t byte_count (const void *s, int c, size_t n)
+  {
+  const uint8_t *p = s;
+  size_t count = 0;
+  for (size_t i = 0; i < n; i++)
+    count += (p[i] == (uint8_t)c);
+  return count;
+  }
+
+static void byte_tolower (char *dest, const char *src, size_t n)
+  {
+  for (size_t i = 0; i < n; i++)
+    dest[i] = (src[i] >= 'A' && src[i] <= 'Z') ? (char)(src[i] + 32) : src[i];
+  }
+
+/*============================================================================
+ * fail
+ * ==========================================================================*/
+static void fail (const char *what, int align, int len, int pos)
+  {
+  if (failures < 20)
+    printf ("FAILED: %s, alignment %d, length %d, position %d\n", what,
+      align, len, pos);
+  failures++;
+  }
+
+/*============================================================================
+ * check_one
+ * Check everything on the len bytes at buff + align. The byte sought is
+ *   put at pos, if pos < len.
+ * ==========================================================================*/
+static void check_one (uint8_t *buff, int align, int len, int pos)
+  {
+  uint8_t *s = buff + align;
+  int c = pos < len ? s[pos] : 'x';
+
+  if (fastmem_memchr (s, c, (size_t)len) != byte_memchr (s, c, (size_t)len))
+    fail ("memchr", align, len, pos);
+  if (fastmem_count_byte (s, c, (size_t)len) != byte_count (s, c, (size_t)len))
+    fail ("count_byte", align, len, pos);
+
+  // Put a terminator at pos, for strlen, and take it away again
+  uint8_t saved = s[pos];
+  s[pos] = 0;
+  if (fastmem_strlen ((char *)s) != byte_strlen ((char *)s))
+    fail ("strlen", align, len, pos);
+  s[pos] = saved;
+
+  // Same and different alignments, and in place
+  char want[MAX_LEN + 8], got[MAX_LEN + 8];
+  byte_tolower (want, (char *)s, (size_t)len);
+  for (int d = 0; d < 4; d++)
+    {
+    memset (got, '#', sizeof (got));
+    fastmem_tolower (got + d, (char *)s, (size_t)len);
+    if (memcmp (got + d, want, (size_t)len) != 0 || got[d + len] != '#')
+      fail ("tolower", align, len, d);
+    }
+  char copy[MAX_LEN + 8];
+  memcpy (copy + align, s, (size_t)len);
+  fastmem_tolower (copy + align, copy + align, (size_t)len);
+  if (memcmp (copy + align, want, (size_t)len) != 0)
+    fail ("tolower in place", align, len, pos);
+  }
+
+/*============================================================================
+ * check
+ * ==========================================================================*/
+static void check (void)
+  {
+  static uint8_t buff[MAX_LEN + 16];
+  srand (1);
+  for (int fill = 0; fill < 3; fill++)
+    {
+    for (int align = 0; align < 8; align++)
+      {
+      for (int len = 0; len <= MAX_LEN; len++)
+        {
+        for (int pos = 0; pos <= len; pos++)
+          {
+          // Fill with one repeated byte, then text, then anything
+          for (size_t i = 0; i < sizeof (buff); i++)
+            {
+            if (fill == 0)
+              buff[i] = 0x01;
+            else if (fill == 1)
+              buff[i] = (uint8_t)("Hello, World\n@[`{AZaz"[rand () % 21]);
+            else
+              buff[i] = (uint8_t)(1 + rand () % 255);
+            }
+          // Every byte value is sought at least once
+          if (pos < len) buff[align + pos] = (uint8_t)(len * 37 + pos);
+          if (buff[align + pos] == 0) buff[align + pos] = 0x80;
+          check_one (buff, align, len, pos);
+          }
+        }
+      }
+    }
+  printf ("checks: %s\n", failures ? "FAILED" : "ok");
+  }
+
+/*============================================================================
+ * report
+ * ==========================================================================*/
+static void report (const char *what, double t_byte, double t_fast,
+         double t_libc)
+  {
+  double mb = BENCH_BYTES / 1e6;
+  printf ("%-12s byte loop %7.0f MB/s  fastmem %7.0f MB/s (%4.1fx)",
+    what, mb / t_byte, mb / t_fast, t_byte / t_fast);
+  if (t_libc > 0)
+    printf ("  libc %7.0f MB/s", mb / t_libc);
+  printf ("\n");
+  }
+
+/*============================================================================
+ * bench
+ * ==========================================================================*/
+static void bench (void)
+  {
+  char *text = malloc (BENCH_SIZE + 1);
+  char *out = malloc (BENCH_SIZE + 1);
+  const char *words = "The Quick brown FOX jumps over the lazy dog. ";
+  for (int i = 0; i < BENCH_SIZE; i++)
+    text[i] = words[i % 45];
+  text[BENCH_SIZE] = 0;
+  int reps = (int)(BENCH_BYTES / BENCH_SIZE);
+  double t0, t1, t2, t3;
+
+  // memchr for a byte that isn't there, as when looking for the end of
+  //   a long line
+  t0 = now ();
+  for (int i = 0; i < reps; i++)
+    sink += (size_t)byte_memchr (text, '\n', BENCH_SIZE);
+  t1 = now ();
+  for (int i = 0; i < reps; i++)
+    sink += (size_t)fastmem_memchr (text, '\n', BENCH_SIZE);
+  t2 = now ();
+  for (int i = 0; i < reps; i++)
+    sink += (size_t)memchr (text, '\n', BENCH_SIZE);
+  t3 = now ();
+  report ("memchr", t1 - t0, t2 - t1, t3 - t2);
+
+  t0 = now ();
+  for (int i = 0; i < reps; i++)
+    sink += byte_strlen (text + (i & 3));
+  t1 = now ();
+  for (int i = 0; i < reps; i++)
+    sink += fastmem_strlen (text + (i & 3));
+  t2 = now ();
+  for (int i = 0; i < reps; i++)
+    sink += strlen (text + (i & 3));
+  t3 = now ();
+  report ("strlen", t1 - t0, t2 - t1, t3 - t2);
+
+  t0 = now ();
+  for (int i = 0; i < reps; i++)
+    sink += byte_count (text, ' ', BENCH_SIZE);
+  t1 = now ();
+  for (int i = 0; i < reps; i++)
+    sink += fastmem_count_byte (text, ' ', BENCH_SIZE);
+  t2 = now ();
+  report ("count_byte", t1 - t0, t2 - t1, 0);
+
+  t0 = now ();
+  for (int i = 0; i < reps; i++)
+    {
+    byte_tolower (out, text, BENCH_SIZE);
+    sink += (size_t)out[i & 1023];
+    }
+  t1 = now ();
+  for (int i = 0; i < reps; i++)
+    {
+    fastmem_tolower (out, text, BENCH_SIZE);
+    sink += (size_t)out[i & 1023];
+    }
+  t2 = now ();
+  report ("tolower", t1 - t0, t2 - t1, 0);
+
+  free (text);
+  free (out);
+  }
+
+/*============================================================================
+ * main
+ * ==========================================================================*/
+int main (int argc, char **argv)
+  {
+  check ();
+  if (!(argc > 1 && strcmp (argv[1], "-c") == 0))
+    bench ();
+  return failures ? 1 : 0;
+  }
+
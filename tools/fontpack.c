@@ -0,0 +1,312 @@
+/*============================================================================
+ *  tools/fontpack.c
+ *
+ *  Host converter from the bitmap font tables in gfx/fonts to the packed
+ *  format of gfx/packedfont.h. Every packed glyph is decoded again and
+ *  checked against the original bitmap before anything is written. A
+ *  font whose glyphs take less flash as plain bitmaps of the cell, with
+ *  no glyph table, is written that way instead.
+ *
+ *    fontpack 16 > gfx/src/pfont16.c   -- write the packed Font16
+ *    fontpack -r                       -- report the flash each font needs
+ *
+ *  Build, from the top of the source tree:
+ *
+ *    cc -O2 -o fontpack -Igfx/include tools/fontpack.c gfx/fonts/font*.c \
+ *      gfx/src/packedfont.c
+ *
+ * Copyright (c)2023 Kevin Boone, GPL v3.0
+ * ==========================================================================*/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <string.h>
+#include <gfx/fonts.h>
+#include <gfx/packedfont.h>
+
+// The bitmap fonts contain the printable ASCII characters
+#define FIRST ' '
+#define LAST 126
+#define GLYPHS (LAST - FIRST + 1)
+
+typedef struct _Source
+  {
+  int size;
+  const sFONT *font;
+  } Source;
+
+static const Source sources[] =
+  {
+  {8, &Font8}, {12, &Font12}, {16, &Font16}, {20, &Font20}, {24, &Font24}
+  };
+
+#define NSOURCES (int)(sizeof (sources) / sizeof (sources[0]))
+
+/*============================================================================
+ * get_bit
+ * ==========================================================================*/
+static bool get_bit (const sFONT *font, int c, int x, int y)
+  {
+  const uint8_t *row = font->table + (c - FIRST) * (font->Bytes * font->Height)
+    + y * font->Bytes;
+  return (row[x >> 3] & (0x80 >> (x & 7))) != 0;
+  }
+
+/*============================================================================
+ * encode_row
+ * Append one row of the bounding box to data, as runs. Returns the new
+ *   length of data.
+ * ==========================================================================*/
+static int encode_row (const sFONT *font, int c, int x0, int w, int y,
+         uint8_t *data, int len)
+  {
+  int x = 0;
+  while (x < w)
+    {
+    int b = 0, f = 0;
+    while (x + b < w && !get_bit (font, c, x0 + x + b, y)) b++;
+    while (x + b + f < w && get_bit (font, c, x0 + x + b + f, y)) f++;
+    x += b + f;
+    while (b > 15) { data[len++] = 0xF0; b -= 15; }
+    while (f > 15) { data[len++] = (uint8_t)((b << 4) | 15); b = 0; f -= 15; }
+    if (b || f) data[len++] = (uint8_t)((b << 4) | f);
+    }
+  return len;
+  }
+
+/*============================================================================
+ * pack
+ * Fill in glyphs and data, and return the length of data.
+ * ==========================================================================*/
+static int pack (const sFONT *font, PackedGlyph *glyphs, uint8_t *data)
+  {
+  int len = 0;
+  for (int c = FIRST; c <= LAST; c++)
+    {
+    // Find the bounding box
+    int x0 = font->Width, x1 = -1, y0 = font->Height, y1 = -1;
+    for (int y = 0; y < font->Height; y++)
+      for (int x = 0; x < font->Width; x++)
+        {
+        if (!get_bit (font, c, x, y)) continue;
+        if (x < x0) x0 = x;
+        if (x > x1) x1 = x;
+        if (y < y0) y0 = y;
+        if (y > y1) y1 = y;
+        }
+
+    PackedGlyph *g = &glyphs[c - FIRST];
+    memset (g, 0, sizeof (PackedGlyph));
+    g->offset = (uint16_t)len;
+    if (x1 < 0) continue;
+    g->x = (uint8_t)x0;
+    g->y = (uint8_t)y0;
+    g->w = (uint8_t)(x1 - x0 + 1);
+    g->h = (uint8_t)(y1 - y0 + 1);
+
+    // A row that is the same as the one above becomes a single zero.
+    //   prev and prev_len are the encoding of the last row that was
+    //   not a repeat.
+    int prev = -1, prev_len = 0;
+    for (int y = y0; y <= y1; y++)
+      {
+      int start = len;
+      len = encode_row (font, c, x0, g->w, y, data, len);
+      if (prev >= 0 && len - start == prev_len
+           && memcmp (data + prev, data + start, (size_t)prev_len) == 0)
+        {
+        data[start] = 0;
+        len = start + 1;
+        }
+      else
+        {
+        prev = start;
+        prev_len = len - start;
+        }
+      }
+
+    // Small glyphs are often smaller as a plain bitmap
+    int start = g->offset;
+    int bits = g->w * g->h;
+    if ((bits + 7) / 8 < len - start)
+      {
+      memset (data + start, 0, (size_t)((bits + 7) / 8));
+      for (int i = 0; i < bits; i++)
+        if (get_bit (font, c, x0 + i % g->w, y0 + i / g->w))
+          data[start + i / 8] |= (uint8_t)(0x80 >> (i % 8));
+      len = start + (bits + 7) / 8;
+      g->offset |= PACKEDFONT_BITMAP;
+      }
+    }
+  return len;
+  }
+
+/*============================================================================
+ * pack_plain
+ * Fill in data with a bitmap of the cell for each glyph, and return the
+ *   length of data.
+ * ==========================================================================*/
+static int pack_plain (const sFONT *font, uint8_t *data)
+  {
+  int bits = font->Width * font->Height;
+  int len = GLYPHS * ((bits + 7) / 8);
+  memset (data, 0, (size_t)len);
+  uint8_t *p = data;
+  for (int c = FIRST; c <= LAST; c++, p += (bits + 7) / 8)
+    for (int i = 0; i < bits; i++)
+      if (get_bit (font, c, i % font->Width, i / font->Width))
+        p[i / 8] |= (uint8_t)(0x80 >> (i % 8));
+  return len;
+  }
+
+/*============================================================================
+ * verify
+ * Decode every glyph, and compare it with the bitmap. Returns the number
+ *   of glyphs that differ.
+ * ==========================================================================*/
+static int verify (const sFONT *font, const PackedFont *packed)
+  {
+  int bad = 0;
+  uint8_t *buff = malloc ((size_t)(font->Width * font->Height));
+  for (int c = FIRST; c <= LAST; c++)
+    {
+    packedfont_render (packed, 1, 1, 0, 1, c, buff);
+    for (int i = 0; i < font->Width * font->Height; i++)
+      {
+      if (buff[i] != get_bit (font, c, i % font->Width, i / font->Width))
+        {
+        fprintf (stderr, "fontpack: Font%d, character %d differs\n",
+          font->Height, c);
+        bad++;
+        break;
+        }
+      }
+    }
+  free (buff);
+  return bad;
+  }
+
+/*============================================================================
+ * write_c
+ * ==========================================================================*/
+static void write_c (int size, const PackedFont *packed, int len)
+  {
+  printf ("/*==========================================================="
+    "=================\n");
+  printf (" *  gfx/pfont%d.c\n", size);
+  printf (" *\n");
+  printf (" *  Font%d, packed by tools/fontpack.c from gfx/fonts/font%d.c,"
+    " which\n", size, size);
+  printf (" *  carries the font's licence. Do not edit.\n");
+  printf (" * ========================================================="
+    "=================*/\n");
+  printf ("#ifdef GFX_FONT_%d\n\n", size);
+  printf ("#include <gfx/packedfont.h>\n\n");
+
+  printf ("static const uint8_t pfont%d_data[%d] =\n  {", size, len);
+  for (int i = 0; i < len; i++)
+    printf ("%s0x%02X,", i % 12 ? " " : "\n  ", packed->data[i]);
+  printf ("\n  };\n\n");
+
+  char glyphs[32];
+  if (packed->glyphs)
+    {
+    printf ("static const PackedGlyph pfont%d_glyphs[%d] =\n  {\n", size,
+      GLYPHS);
+    for (int c = FIRST; c <= LAST; c++)
+      {
+      const PackedGlyph *g = &packed->glyphs[c - FIRST];
+      printf ("  {0x%04X, %2d, %2d, %2d, %2d}, // ", g->offset, g->x, g->y,
+        g->w, g->h);
+      if (c == '\\') printf ("backslash\n");
+      else printf ("'%c'\n", c);
+      }
+    printf ("  };\n\n");
+    snprintf (glyphs, sizeof (glyphs), "pfont%d_glyphs", size);
+    }
+  else
+    strcpy (glyphs, "NULL");
+
+  printf ("const PackedFont PackedFont%d =\n  {\n", size);
+  printf ("  %d, %d, %d, %d, %s, pfont%d_data, %d\n",
+    packed->width, packed->height, FIRST, LAST, glyphs, size, len);
+  printf ("  };\n\n");
+  printf ("#endif\n\n");
+  }
+
+/*============================================================================
+ * main
+ * ==========================================================================*/
+int main (int argc, char **argv)
+  {
+  bool report = argc == 2 && strcmp (argv[1], "-r") == 0;
+  int size = argc == 2 ? atoi (argv[1]) : 0;
+  if (!report && size == 0)
+    {
+    fprintf (stderr, "Usage: fontpack {size | -r}\n");
+    return 1;
+    }
+
+  if (report)
+    printf ("font    bitmap   packed    saved  form\n");
+  uint32_t total_raw = 0, total_packed = 0;
+  int found = 0, failures = 0;
+  for (int i = 0; i < NSOURCES; i++)
+    {
+    if (!report && sources[i].size != size) continue;
+    found++;
+    const sFONT *font = sources[i].font;
+    PackedGlyph glyphs[GLYPHS];
+    uint8_t *data = malloc ((size_t)(GLYPHS * font->Width * font->Height));
+    int len = pack (font, glyphs, data);
+    PackedFont packed;
+    packed.width = font->Width;
+    packed.height = font->Height;
+    packed.first = FIRST;
+    packed.last = LAST;
+    packed.glyphs = glyphs;
+    packed.data = data;
+    packed.data_size = (uint16_t)len;
+
+    // Per-glyph boxes don't pay for their table in a small cell
+    uint8_t *plain = malloc ((size_t)(GLYPHS * font->Width * font->Height));
+    PackedFont packed_plain = packed;
+    packed_plain.glyphs = NULL;
+    packed_plain.data = plain;
+    packed_plain.data_size = (uint16_t)pack_plain (font, plain);
+    if (packedfont_get_size (&packed_plain) < packedfont_get_size (&packed))
+      {
+      packed = packed_plain;
+      len = packed.data_size;
+      }
+    failures += verify (font, &packed);
+
+    // The bitmap font is its table and its sFONT
+    uint32_t raw = (uint32_t)(GLYPHS * font->Bytes * font->Height)
+      + (uint32_t)sizeof (sFONT);
+    uint32_t size_packed = packedfont_get_size (&packed);
+    total_raw += raw;
+    total_packed += size_packed;
+    if (report)
+      printf ("Font%-3d %7u  %7u  %6.1f%%  %s\n", sources[i].size, raw,
+        size_packed, 100.0 * ((double)raw - size_packed) / raw,
+        packed.glyphs ? "runs" : "plain");
+    else if (!failures)
+      write_c (size, &packed, len);
+    free (plain);
+    free (data);
+    }
+
+  if (!found)
+    {
+    fprintf (stderr, "fontpack: no font of size %d\n", size);
+    return 1;
+    }
+  if (report)
+    printf ("all     %7u  %7u  %6.1f%%\n", total_raw, total_packed,
+      100.0 * ((double)total_raw - total_packed) / total_raw);
+  return failures ? 1 : 0;
+  }
+
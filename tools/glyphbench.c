@@ -0,0 +1,102 @@
+/*============================================================================
+ *  tools/glyphbench.c
+ *
+ *  Host benchmark for the graphical console's glyph drawing. It measures
+ *  how many characters per second can be turned into pixel data and 
+ *  copied to a frame buffer, first by expanding each glyph as it is drawn,
+ *  and then using the glyph cache. Only the CPU cost is measured; on the
+ *  device, the SPI transfer to the panel is added to both.
+ *
+ *  Build, from the top of the source tree:
+ *
+ *    cc -O2 -DGFX_FONT_16 -o glyphbench -Igfx/include -Iklib/include \
+ *      tools/glyphbench.c gfx/src/glyphcache.c gfx/src/packedfont.c \
+ *      gfx/src/pfont16.c klib/src/hashmap.c
+ *
+ * Copyright (c)2023 Kevin Boone, GPL v3.0
+ * ==========================================================================*/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <string.h>
+#include <time.h>
+#include <gfx/packedfont.h>
+#include <gfx/glyphcache.h>
+
+#define COLS 43 
+#define ROWS 18 
+#define BYTES_PP 2
+#define CHARS 2000000
+
+/*============================================================================
+ * now
+ * ==========================================================================*/
+static double now (void)
+  {
+  struct timespec ts;
+  clock_gettime (CLOCK_MONOTONIC, &ts);
+  return (double)ts.tv_sec + (double)ts.tv_nsec / 1e9;
+  }
+
+/*============================================================================
+ * blit
+ * Copy a glyph into the frame buffer, as the panel driver would 
+ * ==========================================================================*/
+static void blit (uint8_t *fb, const uint8_t *glyph, const PackedFont *font, 
+         int pos)
+  {
+  int row = (pos / COLS) % ROWS;
+  int col = pos % COLS;
+  int stride = COLS * font->width * BYTES_PP;
+  int glyph_stride = font->width * BYTES_PP;
+  uint8_t *p = fb + row * font->height * stride + col * glyph_stride;
+  for (int i = 0; i < font->height; i++)
+    memcpy (p + i * stride, glyph + i * glyph_stride, (size_t)glyph_stride);
+  }
+
+/*============================================================================
+ * main
+ * ==========================================================================*/
+int main (void)
+  {
+  const PackedFont *font = &PackedFont16;
+  size_t glyph_size = (size_t)(font->width * font->height * BYTES_PP);
+  uint8_t *fb = calloc ((size_t)(COLS * ROWS), glyph_size);
+  uint8_t *buff = malloc (glyph_size);
+
+  // Text with a realistic mix of characters
+  const char *text = "The quick brown fox jumps over the lazy dog. "
+    "int main (int argc, char **argv) { return 0; } 0123456789 ";
+  int textlen = (int)strlen (text);
+
+  double t0 = now ();
+  for (int i = 0; i < CHARS; i++)
+    {
+    packedfont_render (font, 1, 0xFFFF, 0, BYTES_PP, text[i % textlen], buff);
+    blit (fb, buff, font, i);
+    }
+  double t1 = now ();
+
+  GlyphCache *cache = glyphcache_create (16 * 1024);
+  for (int i = 0; i < CHARS; i++)
+    {
+    const uint8_t *glyph = glyphcache_get (cache, font, 1, 0xFFFF, 0, BYTES_PP,
+      text[i % textlen]);
+    blit (fb, glyph, font, i);
+    }
+  double t2 = now ();
+
+  GlyphCacheStats stats;
+  glyphcache_get_stats (cache, &stats);
+  printf ("expand each time: %10.0f chars/sec\n", CHARS / (t1 - t0));
+  printf ("glyph cache:      %10.0f chars/sec\n", CHARS / (t2 - t1));
+  printf ("cache: %lu hits, %lu misses, %lu evictions, %lu bytes\n",
+    (unsigned long)stats.hits, (unsigned long)stats.misses,
+    (unsigned long)stats.evictions, (unsigned long)stats.bytes);
+
+  glyphcache_destroy (cache);
+  free (buff);
+  free (fb);
+  return 0;
+  }
@@ -0,0 +1,167 @@
+/*============================================================================
+ *  tools/i2clcdcap.c
+ *
+ *  Host check of the I2C LCD driver's bus traffic. The host build of the
+ *  driver writes to a mock I2C bus, which feeds an emulated HD44780. This
+ *  program drives it through some typical operations, checks that the
+ *  emulated panel shows what it should, and that no command reached it
+ *  while it was busy. It reports how long each operation keeps the bus
+ *  busy, alongside an estimate for the old driver, which sent each
+ *  nibble as three one-byte writes with a 600us sleep after each, and
+ *  redrew the whole panel to scroll.
+ *
+ *  Build, from the top of the source tree:
+ *
+ *    cc -O2 -o i2clcdcap -Idrivers/i2c_lcd/include tools/i2clcdcap.c \
+ *      drivers/i2c_lcd/src/i2c_lcd.c
+ *
+ * Copyright (c)2023 Kevin Boone, GPL v3.0
+ * ==========================================================================*/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <string.h>
+#include <i2c_lcd/i2c_lcd.h>
+
+// The same as I2C_BAUD in config.h
+#define BAUD 100000
+
+// Each command or character is two nibbles, and each nibble is three bus
+//   bytes: set up, enable high, enable low
+#define BYTES_PER_INSTRUCTION 6
+
+#define WIDTH 20
+#define HEIGHT 4
+
+static const int offsets[HEIGHT] = {0, 0x40, WIDTH, 0x40 + WIDTH};
+static int failures;
+static double total_new_ms, total_old_ms;
+
+/*============================================================================
+ * old_ms
+ * The old driver's time for n commands and characters: each was six
+ *   one-byte writes (start, address, data, stop: 20 bits), and six
+ *   600us sleeps.
+ * ==========================================================================*/
+static double old_ms (int n)
+  {
+  return n * (6 * 20 * 1000.0 / BAUD + 6 * 0.6);
+  }
+
+/*============================================================================
+ * check
+ * Compare the emulated panel with the rows, report, and reset the
+ * counters for the next operation. old_n is the number of commands and
+ * characters the old driver sent for the same operation.
+ * ==========================================================================*/
+static void check (const char *what, I2C_LCDMockBus *bus,
+         const char *rows[HEIGHT], int old_n)
+  {
+  const char *result = "ok";
+  for (int r = 0; r < HEIGHT; r++)
+    {
+    char want[WIDTH];
+    memset (want, ' ', WIDTH);
+    memcpy (want, rows[r], strlen (rows[r]));
+    if (memcmp (bus->ddram + offsets[r], want, WIDTH) != 0)
+      result = "FAILED (content)";
+    }
+  if (bus->errors)
+    result = "FAILED (timing)";
+  if (result[0] == 'F') failures++;
+
+  double ms = (double)(bus->bus_ns + bus->wait_ns) / 1e6;
+  double old = old_ms (old_n);
+  printf ("%-20s %4u %4u %5u %8.2f ms %8.2f ms %6.1fx  %s\n", what,
+    bus->instructions, bus->transactions, bus->bytes, ms, old, old / ms,
+    result);
+  total_new_ms += ms;
+  total_old_ms += old;
+  bus->transactions = 0;
+  bus->bytes = 0;
+  bus->instructions = 0;
+  bus->errors = 0;
+  bus->bus_ns = 0;
+  bus->wait_ns = 0;
+  bus->busy_until_ns = 0;
+  }
+
+/*============================================================================
+ * main
+ * ==========================================================================*/
+int main (void)
+  {
+  I2C_LCDMockBus bus;
+  memset (&bus, 0, sizeof (bus));
+  memset (bus.ddram, ' ', sizeof (bus.ddram));
+  bus.baud_rate = BAUD;
+
+  I2C_LCD *lcd = i2c_lcd_new (WIDTH, HEIGHT);
+  i2c_lcd_set_mock_bus (lcd, &bus);
+
+  printf ("%-20s %4s %4s %5s %11s %11s\n", "", "cmds", "wr", "bytes",
+    "bus", "old");
+
+  // One character at a time, as a shell echoes typing
+  const char *typed = "Hello";
+  for (const char *s = typed; *s; s++)
+    i2c_lcd_write (lcd, s, 1);
+  check ("type 5 characters", &bus,
+    (const char *[]){"Hello", "", "", ""}, 5);
+
+  // Three lines in one write. The old driver set the cursor twice for
+  //   each CR, once for the CR and once for the implied LF.
+  const char *lines = "\rLine two\rLine three\rLine four";
+  i2c_lcd_write (lcd, lines, (int)strlen (lines));
+  check ("write 3 lines", &bus,
+    (const char *[]){"Hello", "Line two", "Line three", "Line four"},
+    27 + 6);
+
+  // The old driver cleared the panel to scroll, and redrew all but the
+  //   bottom row, setting the cursor for each
+  i2c_lcd_write (lcd, "\r", 1);
+  check ("scroll", &bus,
+    (const char *[]){"Line two", "Line three", "Line four", ""},
+    1 + 1 + (HEIGHT - 1) * (1 + WIDTH) + 1 + 1);
+
+  i2c_lcd_write (lcd, "Line five", 9);
+  check ("write 9 characters", &bus,
+    (const char *[]){"Line two", "Line three", "Line four", "Line five"},
+    9);
+
+  // The old driver redrew the whole panel for each step
+  i2c_lcd_scrollback_line_up (lcd);
+  check ("scrollback up", &bus,
+    (const char *[]){"Hello", "Line two", "Line three", "Line four"},
+    HEIGHT * (1 + WIDTH));
+
+  i2c_lcd_scrollback_line_down (lcd);
+  check ("scrollback down", &bus,
+    (const char *[]){"Line two", "Line three", "Line four", "Line five"},
+    HEIGHT * (1 + WIDTH) + 1);
+
+  i2c_lcd_write (lcd, "\f", 1);
+  check ("clear", &bus, (const char *[]){"", "", "", ""}, 1);
+
+  // Two characters either side of one that is unchanged: the one in the
+  //   middle is sent again, and no address is, so each of the three
+  //   characters is a single instruction.
+  i2c_lcd_write (lcd, "a b", 3);
+  if (bus.instructions != 3 || bus.bytes != 3 * BYTES_PER_INSTRUCTION)
+    {
+    printf ("gap of one: %u instructions, %u bytes; expected 3, %d\n",
+      bus.instructions, bus.bytes, 3 * BYTES_PER_INSTRUCTION);
+    failures++;
+    }
+  check ("gap of one", &bus, (const char *[]){"a b", "", "", ""}, 3);
+
+  printf ("%-20s %28.2f ms %8.2f ms %6.1fx\n", "total", total_new_ms,
+    total_old_ms, total_old_ms / total_new_ms);
+
+  i2c_lcd_destroy (lcd);
+  if (failures)
+    printf ("%d check(s) failed\n", failures);
+  return failures ? 1 : 0;
+  }
+
@@ -0,0 +1,183 @@
+/*============================================================================
+ *  tools/tokbench.c
+ *
+ *  Host benchmark for klib/string, as the shell uses it. It times
+ *  string_tokenize2() on command lines of 128 bytes to 8 kB, made of
+ *  quoted text, long and short words, redirections, pipes and
+ *  semicolons. It also times building a long string a byte at a time,
+ *  which is what the tokenizer does with each word. With -d, it prints
+ *  the tokens of each line instead, so that two builds can be compared.
+ *
+ *  For before-and-after figures, build it twice: once as below, and once
+ *  with an older string.c in place of klib/src/string.c, for example
+ *  from 'git show <commit>:klib/src/string.c'. Then compare the output
+ *  of 'tokbench -d' from each, and the times.
+ *
+ *  string.c includes the shell's headers, which need the Pico SDK's
+ *  host headers. PICO_INC is the -I options that the host build
+ *  (docs/BUILD_LINUX.md) passes when it compiles klib.
+ *
+ *  Build, from the top of the source tree:
+ *
+ *    cc -O2 -o tokbench $PICO_INC -Iklib/include -Ishell/include \
+ *      -Isys/include -Iapi/bearos -Iapi/include tools/tokbench.c \
+ *      klib/src/string.c klib/src/vector.c klib/src/list.c \
+ *      klib/src/fastmem.c
+ *
+ * Copyright (c)2023 Kevin Boone, GPL v3.0
+ * ==========================================================================*/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <string.h>
+#include <time.h>
+#include <klib/string.h>
+#include <klib/vector.h>
+#include <shell/shell_parser.h>
+
+// Time each test for about this long
+#define BENCH_SECONDS 0.5
+
+static const int lengths[] = {128, 1024, 8192};
+
+#define NLENGTHS (int)(sizeof (lengths) / sizeof (lengths[0]))
+
+// Repeated to make up a command line
+static const char fragment[] = "echo \"some quoted text here\" "
+  "averyveryverylongargumentwithoutspaces_abcdefghijklmnopqrstuvwxyz0123 "
+  "> out ; ls -l | grep x ";
+
+/*============================================================================
+ * token_create, token_destroy
+ * Stand-ins for the shell parser's, which the tokenizer calls, so that the
+ *   rest of the parser need not be linked
+ * ==========================================================================*/
+Token *token_create (TokenType type, const char *val, int line, int col)
+  {
+  Token *self = malloc (sizeof (Token));
+  self->type = type;
+  self->val = val ? strdup (val) : NULL;
+  self->line = line;
+  self->col = col;
+  return self;
+  }
+
+void token_destroy (Token *self)
+  {
+  free (self->val);
+  free (self);
+  }
+
+/*============================================================================
+ * now
+ * ==========================================================================*/
+static double now (void)
+  {
+  struct timespec ts;
+  clock_gettime (CLOCK_MONOTONIC, &ts);
+  return (double)ts.tv_sec + (double)ts.tv_nsec / 1e9;
+  }
+
+/*============================================================================
+ * make_line
+ * ==========================================================================*/
+static String *make_line (int len)
+  {
+  char *s = malloc ((size_t)len + 1);
+  int flen = (int)strlen (fragment);
+  for (int i = 0; i < len; i++)
+    s[i] = fragment[i % flen];
+  s[len] = 0;
+  String *line = string_create (s);
+  free (s);
+  return line;
+  }
+
+/*============================================================================
+ * dump
+ * ==========================================================================*/
+static void dump (const String *line)
+  {
+  Vector *tokens = string_tokenize2 (line, NULL);
+  int n = vector_length (tokens);
+  printf ("%d bytes, %d tokens\n", string_length (line), n);
+  for (int i = 0; i < n; i++)
+    {
+    const Token *t = vector_get (tokens, i);
+    printf ("%d %d:%d %s\n", t->type, t->line, t->col,
+      t->val ? t->val : "(null)");
+    }
+  vector_destroy (tokens);
+  }
+
+/*============================================================================
+ * time_tokenize
+ * Returns microseconds per line
+ * ==========================================================================*/
+static double time_tokenize (const String *line)
+  {
+  long count = 0;
+  double start = now (), elapsed;
+  do
+    {
+    for (int i = 0; i < 10; i++, count++)
+      vector_destroy (string_tokenize2 (line, NULL));
+    elapsed = now () - start;
+    } while (elapsed < BENCH_SECONDS);
+  return elapsed / (double)count * 1e6;
+  }
+
+/*============================================================================
+ * time_append
+ * Returns microseconds to build a string of len bytes, one at a time
+ * ==========================================================================*/
+static double time_append (int len)
+  {
+  long count = 0;
+  double start = now (), elapsed;
+  do
+    {
+    String *s = string_create_empty ();
+    for (int i = 0; i < len; i++)
+      string_append_byte (s, 'x');
+    string_destroy (s);
+    count++;
+    elapsed = now () - start;
+    } while (elapsed < BENCH_SECONDS);
+  return elapsed / (double)count * 1e6;
+  }
+
+/*============================================================================
+ * main
+ * ==========================================================================*/
+int main (int argc, char **argv)
+  {
+  int dump_only = argc == 2 && strcmp (argv[1], "-d") == 0;
+  if (argc > 1 && !dump_only)
+    {
+    fprintf (stderr, "Usage: tokbench [-d]\n");
+    return 1;
+    }
+
+  if (!dump_only)
+    printf ("%-8s %8s %14s %14s\n", "length", "tokens", "tokenize",
+      "append bytes");
+  for (int i = 0; i < NLENGTHS; i++)
+    {
+    String *line = make_line (lengths[i]);
+    if (dump_only)
+      dump (line);
+    else
+      {
+      Vector *tokens = string_tokenize2 (line, NULL);
+      int n = vector_length (tokens);
+      vector_destroy (tokens);
+      printf ("%-8d %8d %11.1f us %11.1f us\n", lengths[i], n,
+        time_tokenize (line), time_append (lengths[i]));
+      }
+    string_destroy (line);
+    }
+  return 0;
+  }
+
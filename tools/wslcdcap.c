@@ -0,0 +1,173 @@
+/*============================================================================
+ *  tools/wslcdcap.c
+ *
+ *  Host check of the Waveshare LCD driver's SPI traffic. The host build of
+ *  the driver records the bytes it would send to the panel, rather than
+ *  sending them. This program drives it through some typical operations,
+ *  checks that the bytes are what the panel expects -- in particular,
+ *  that pixels go out most significant byte first -- and reports how
+ *  long each operation would keep the SPI bus busy.
+ *
+ *  Build, from the top of the source tree:
+ *
+ *    cc -O2 -o wslcdcap -Idrivers/waveshare_lcd/include tools/wslcdcap.c \
+ *      drivers/waveshare_lcd/src/wslcd.c
+ *
+ * Copyright (c)2023 Kevin Boone, GPL v3.0
+ * ==========================================================================*/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <string.h>
+#include <waveshare_lcd/waveshare_lcd.h>
+
+// The same as WSLCD_BAUD in config.h
+#define BAUD (20000 * 1000)
+
+static uint8_t *expected;
+static size_t nexpected;
+static int failures;
+
+/*============================================================================
+ * expect_xxx
+ * Build up the byte stream that the panel should receive. Command bytes
+ * are sent alone; parameters are sent as a zero byte followed by the
+ * value, which is how the 3.5" panel takes them.
+ * ==========================================================================*/
+static void expect_byte (uint8_t b)
+  {
+  expected[nexpected++] = b;
+  }
+
+static void expect_cmd (uint8_t cmd)
+  {
+  expect_byte (cmd);
+  }
+
+static void expect_param (uint8_t p)
+  {
+  expect_byte (0);
+  expect_byte (p);
+  }
+
+static void expect_pixel (uint16_t p)
+  {
+  expect_byte ((uint8_t)(p >> 8));
+  expect_byte ((uint8_t)(p & 0xFF));
+  }
+
+static void expect_window (int xs, int ys, int xe, int ye)
+  {
+  expect_cmd (0x2A);
+  expect_param ((uint8_t)(xs >> 8));
+  expect_param ((uint8_t)(xs & 0xFF));
+  expect_param ((uint8_t)((xe - 1) >> 8));
+  expect_param ((uint8_t)((xe - 1) & 0xFF));
+  expect_cmd (0x2B);
+  expect_param ((uint8_t)(ys >> 8));
+  expect_param ((uint8_t)(ys & 0xFF));
+  expect_param ((uint8_t)((ye - 1) >> 8));
+  expect_param ((uint8_t)((ye - 1) & 0xFF));
+  expect_cmd (0x2C);
+  }
+
+/*============================================================================
+ * check
+ * Compare the captured bytes with the expected ones, report, and reset
+ * both for the next operation.
+ * ==========================================================================*/
+static void check (const char *what, WSLCDCapture *cap)
+  {
+  const char *result = "ok";
+  if (cap->bytes != nexpected)
+    {
+    result = "FAILED (length)";
+    failures++;
+    }
+  else if (memcmp (cap->buff, expected, nexpected) != 0)
+    {
+    result = "FAILED (content)";
+    failures++;
+    }
+  printf ("%-28s %8zu bytes %6u cmds %9.3f ms  %s\n", what, cap->bytes,
+    cap->commands, (double)cap->bus_ns / 1e6, result);
+  cap->bytes = 0;
+  cap->commands = 0;
+  cap->transfers = 0;
+  cap->bus_ns = 0;
+  nexpected = 0;
+  }
+
+/*============================================================================
+ * main
+ * ==========================================================================*/
+int main (void)
+  {
+  size_t size = 1024 * 1024;
+  expected = malloc (size);
+  WSLCDCapture cap;
+  memset (&cap, 0, sizeof (cap));
+  cap.buff = malloc (size);
+  cap.size = size;
+  cap.baud_rate = BAUD;
+
+  WSLCD *lcd = wslcd_new ();
+  wslcd_init (lcd);
+  int w = wslcd_get_width (lcd);
+  int h = wslcd_get_height (lcd);
+  wslcd_set_capture (lcd, &cap);
+
+  // A glyph-sized transfer, with distinct high and low bytes
+  uint16_t glyph[11 * 16];
+  for (int i = 0; i < 11 * 16; i++) glyph[i] = (uint16_t)(0x1200 + i);
+  wslcd_transfer_window (lcd, glyph, 11, 16, 22, 34);
+  expect_window (22, 34, 33, 50);
+  for (int i = 0; i < 11 * 16; i++) expect_pixel (glyph[i]);
+  check ("glyph transfer", &cap);
+
+  // A one-row fill
+  wslcd_fill_area (lcd, 0, 17, (uint16_t)w, 34, 0xF81F);
+  expect_window (0, 17, w, 34);
+  for (int i = 0; i < w * 17; i++) expect_pixel (0xF81F);
+  check ("row fill", &cap);
+
+  // After a hardware scroll, windows are offset by the scroll position
+  wslcd_scroll_up (lcd, 17);
+  expect_cmd (0x37);
+  expect_param (0);
+  expect_param (17);
+  check ("scroll", &cap);
+  wslcd_set_pixel (lcd, 5, 10, 0xABCD);
+  expect_window (5, 27, 5, 27);
+  expect_pixel (0xABCD);
+  check ("pixel after scroll", &cap);
+
+  // Clearing the screen resets the scroll position and scroll area,
+  //   fills, and then restores the scroll area
+  wslcd_clear (lcd, 0);
+  expect_cmd (0x37);
+  expect_param (0);
+  expect_param (0);
+  expect_cmd (0x33);
+  expect_param (0); expect_param (0);
+  expect_param ((uint8_t)(h >> 8)); expect_param ((uint8_t)(h & 0xFF));
+  expect_param (0); expect_param (0);
+  expect_window (0, 0, w, h);
+  for (int i = 0; i < w * h; i++) expect_pixel (0);
+  expect_cmd (0x33);
+  expect_param (0); expect_param (0);
+  expect_param ((uint8_t)(h >> 8)); expect_param ((uint8_t)(h & 0xFF));
+  expect_param (0); expect_param (0);
+  check ("full-screen clear", &cap);
+
+  wslcd_set_capture (lcd, NULL);
+  wslcd_destroy (lcd);
+  free (cap.buff);
+  free (expected);
+
+  if (failures)
+    printf ("%d check(s) failed\n", failures);
+  return failures ? 1 : 0;
+  }
+